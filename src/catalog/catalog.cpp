@@ -14,6 +14,7 @@
 #include <iostream>
 
 #include "catalog/catalog.h"
+#include "common/plan_cache.h"
 
 #define CATALOG_DATABASE_NAME "catalog_db"
 #define DATABASE_CATALOG_NAME "database_catalog"
@@ -86,6 +87,8 @@ Result Catalog::CreateTable(std::string database_name, std::string table_name, s
 	  //  Another way of insertion using transaction manager
 	  catalog::InsertTuple(databases[START_OID]->GetTableWithName(TABLE_CATALOG_NAME), std::move(tuple));
 //	  databases[START_OID]->GetTableWithName(TABLE_CATALOG_NAME)->InsertTuple(tuple.get());
+	  // Cached plans may resolve names differently now
+	  PlanCache::GetInstance().Invalidate();
 	  return Result::RESULT_SUCCESS;
   }
   else{
@@ -115,6 +118,8 @@ Result Catalog::DropDatabase(std::string database_name) {
 	// Drop the database
     LOG_INFO("Deleting database from database vector");
 	databases.erase(databases.begin() + database_offset);
+	// Cached plans may reference the tables of the database
+	PlanCache::GetInstance().Invalidate();
   }
   else{
 	  LOG_INFO("Database is not found!");
@@ -138,6 +143,8 @@ Result Catalog::DropTable(std::string database_name, std::string table_name) {
 		  catalog::DeleteTuple(GetDatabaseWithName(CATALOG_DATABASE_NAME)->GetTableWithName(TABLE_CATALOG_NAME), table_id);
 		  LOG_INFO("Deleting table!");
 		  database->DropTableWithOid(table_id);
+		  // Cached plans may reference the table
+		  PlanCache::GetInstance().Invalidate();
 		  return Result::RESULT_SUCCESS;
 	  }
 	  else{
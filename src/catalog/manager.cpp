@@ -13,6 +13,7 @@
 
 #include "common/exception.h"
 #include "common/logger.h"
+#include "common/thread_epoch.h"
 #include "catalog/manager.h"
 #include "catalog/foreign_key.h"
 #include "storage/database.h"
@@ -31,14 +32,73 @@ Manager &Manager::GetInstance() {
 // OBJECT MAP
 //===--------------------------------------------------------------------===//
 
+Manager::Manager() {
+  locator = new std::atomic<locator_slot *>[LOCATOR_SEGMENT_COUNT];
+  for (size_t segment_itr = 0; segment_itr < LOCATOR_SEGMENT_COUNT;
+       segment_itr++) {
+    locator[segment_itr].store(nullptr);
+  }
+}
+
+Manager::~Manager() {
+  for (size_t segment_itr = 0; segment_itr < LOCATOR_SEGMENT_COUNT;
+       segment_itr++) {
+    auto segment = locator[segment_itr].load();
+    if (segment == nullptr) {
+      continue;
+    }
+
+    for (size_t slot_itr = 0; slot_itr < LOCATOR_SEGMENT_SIZE; slot_itr++) {
+      delete segment[slot_itr].load();
+    }
+    delete[] segment;
+  }
+  delete[] locator;
+}
+
+locator_slot *Manager::GetLocatorSlot(const oid_t oid, bool allocate) {
+  auto &segment_ptr = locator[oid >> LOCATOR_SEGMENT_BITS];
+  auto segment = segment_ptr.load();
+
+  if (segment == nullptr) {
+    if (allocate == false) {
+      return nullptr;
+    }
+
+    auto new_segment = new locator_slot[LOCATOR_SEGMENT_SIZE];
+    for (size_t slot_itr = 0; slot_itr < LOCATOR_SEGMENT_SIZE; slot_itr++) {
+      new_segment[slot_itr].store(nullptr);
+    }
+
+    // someone else might have installed the segment first
+    if (segment_ptr.compare_exchange_strong(segment, new_segment)) {
+      segment = new_segment;
+    } else {
+      delete[] new_segment;
+    }
+  }
+
+  return &segment[oid & (LOCATOR_SEGMENT_SIZE - 1)];
+}
+
+void Manager::RetireLocation(std::shared_ptr<storage::TileGroup> *location) {
+  if (location == nullptr) {
+    return;
+  }
+
+  ThreadEpochManager::GetInstance().Retire([location]() { delete location; });
+}
+
 void Manager::AddTileGroup(const oid_t oid,
                            std::shared_ptr<storage::TileGroup> location) {
+  auto new_location = new std::shared_ptr<storage::TileGroup>(location);
 
   {
     std::lock_guard<std::mutex> lock(locator_mutex);
 
     // add/update the catalog reference to the tile group
-    locator[oid] = location;
+    auto slot = GetLocatorSlot(oid, true);
+    RetireLocation(slot->exchange(new_location));
   }
 
 }
@@ -51,7 +111,10 @@ void Manager::DropTileGroup(const oid_t oid) {
     std::lock_guard<std::mutex> lock(locator_mutex);
 
     // drop the catalog reference to the tile group
-    locator.erase(oid);
+    auto slot = GetLocatorSlot(oid, false);
+    if (slot != nullptr) {
+      RetireLocation(slot->exchange(nullptr));
+    }
   }
 
 }
@@ -60,10 +123,15 @@ std::shared_ptr<storage::TileGroup> Manager::GetTileGroup(const oid_t oid) {
   std::shared_ptr<storage::TileGroup> location;
 
   {
-    std::lock_guard<std::mutex> lock(locator_mutex);
-
-    if(locator.count(oid) != 0) {
-      location = locator.at(oid);
+    // keeps the entry alive until we have copied it
+    ThreadEpochGuard epoch_guard;
+
+    auto slot = GetLocatorSlot(oid, false);
+    if (slot != nullptr) {
+      auto current_location = slot->load();
+      if (current_location != nullptr) {
+        location = *current_location;
+      }
     }
 
   }
@@ -77,7 +145,17 @@ void Manager::ClearTileGroup() {
   {
     std::lock_guard<std::mutex> lock(locator_mutex);
 
-    locator.clear();
+    for (size_t segment_itr = 0; segment_itr < LOCATOR_SEGMENT_COUNT;
+         segment_itr++) {
+      auto segment = locator[segment_itr].load();
+      if (segment == nullptr) {
+        continue;
+      }
+
+      for (size_t slot_itr = 0; slot_itr < LOCATOR_SEGMENT_SIZE; slot_itr++) {
+        RetireLocation(segment[slot_itr].exchange(nullptr));
+      }
+    }
   }
 
 }
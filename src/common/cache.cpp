@@ -124,6 +124,7 @@ template <class Key, class Value>
 void Cache<Key, Value>::clear(void) {
   list_.clear();
   map_.clear();
+  counts_.clear();
 }
 
 /** @brief is the cache empty
@@ -43,4 +43,28 @@ void PelotonConfiguration::SetSocketFamily(const std::string& socket_family_){
   socket_family = socket_family_;
 }
 
+std::string PelotonConfiguration::GetServerMode() const{
+  return server_mode;
+}
+
+void PelotonConfiguration::SetServerMode(const std::string& server_mode_){
+  server_mode = server_mode_;
+}
+
+int PelotonConfiguration::GetIOThreadCount() const{
+  return io_thread_count;
+}
+
+void PelotonConfiguration::SetIOThreadCount(const int io_thread_count_){
+  io_thread_count = io_thread_count_;
+}
+
+int PelotonConfiguration::GetWorkerThreadCount() const{
+  return worker_thread_count;
+}
+
+void PelotonConfiguration::SetWorkerThreadCount(const int worker_thread_count_){
+  worker_thread_count = worker_thread_count_;
+}
+
 }  // End peloton namespace
@@ -0,0 +1,122 @@
+//===----------------------------------------------------------------------===//
+//
+//                         Peloton
+//
+// plan_cache.cpp
+//
+// Identification: src/common/plan_cache.cpp
+//
+// Copyright (c) 2015-16, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+
+#include "common/plan_cache.h"
+
+#include <cctype>
+
+#include "common/logger.h"
+
+namespace peloton {
+
+// global singleton
+PlanCache &PlanCache::GetInstance(void) {
+  static PlanCache plan_cache;
+  return plan_cache;
+}
+
+PlanCache::PlanCache() : version(0), statements(PLAN_CACHE_SIZE) {}
+
+std::string PlanCache::NormalizeQuery(const std::string &query_string) {
+  std::string normalized;
+  normalized.reserve(query_string.size());
+
+  // the quote character of the literal or identifier we are in, if any
+  char quote = '\0';
+  bool pending_space = false;
+
+  for (char c : query_string) {
+    if (quote != '\0') {
+      normalized.push_back(c);
+      if (c == quote) {
+        quote = '\0';
+      }
+      continue;
+    }
+
+    if (std::isspace(static_cast<unsigned char>(c))) {
+      pending_space = !normalized.empty();
+      continue;
+    }
+    if (pending_space) {
+      normalized.push_back(' ');
+      pending_space = false;
+    }
+
+    if (c == '\'' || c == '"') {
+      quote = c;
+    }
+    normalized.push_back(std::tolower(static_cast<unsigned char>(c)));
+  }
+
+  // drop the trailing semicolon
+  if (quote == '\0' && normalized.empty() == false &&
+      normalized.back() == ';') {
+    normalized.pop_back();
+    if (normalized.empty() == false && normalized.back() == ' ') {
+      normalized.pop_back();
+    }
+  }
+
+  return normalized;
+}
+
+std::string PlanCache::GetKey(const std::string &query_string,
+                              const std::vector<int32_t> &param_types) {
+  // the query string cannot contain a NUL byte, so the key is unambiguous
+  std::string key = NormalizeQuery(query_string);
+  key.push_back('\0');
+  for (auto param_type : param_types) {
+    key.append(std::to_string(param_type));
+    key.push_back(',');
+  }
+  return key;
+}
+
+std::shared_ptr<Statement> PlanCache::Find(const std::string &key) {
+  std::lock_guard<std::mutex> lock(cache_mutex);
+  auto statement_itr = statements.find(key);
+  if (statement_itr == statements.end()) {
+    return nullptr;
+  }
+  return *statement_itr;
+}
+
+void PlanCache::Insert(const std::string &key,
+                       const std::shared_ptr<Statement> &statement,
+                       size_t planned_version) {
+  std::lock_guard<std::mutex> lock(cache_mutex);
+
+  // the catalog changed while the statement was being planned
+  if (planned_version != version.load()) {
+    LOG_TRACE("Not caching statement planned at version %lu",
+              planned_version);
+    return;
+  }
+
+  statements.insert(std::make_pair(key, statement));
+}
+
+void PlanCache::Invalidate(void) {
+  std::lock_guard<std::mutex> lock(cache_mutex);
+  version++;
+  statements.clear();
+  LOG_TRACE("Plan cache invalidated, version %lu", version.load());
+}
+
+size_t PlanCache::GetSize(void) {
+  std::lock_guard<std::mutex> lock(cache_mutex);
+  return statements.size();
+}
+
+}  // End peloton namespace
@@ -41,5 +41,10 @@ std::shared_ptr<Statement> Portal::GetStatement() const {
   return statement;
 }
 
+const std::vector<std::pair<int, std::string>>& Portal::GetBindParameters()
+    const {
+  return bind_parameters;
+}
+
 
 }  // namespace peloton
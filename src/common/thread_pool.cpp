@@ -50,30 +50,6 @@ ThreadPool::ThreadPool(size_t num_threads_) :
     );
 }
 
-// add new work item to the pool
-template<class Func, class... Args>
-auto ThreadPool::Enqueue(Func&& f, Args&&... args)
-    -> std::future<typename std::result_of<Func(Args...)>::type>{
-    using return_type = typename std::result_of<Func(Args...)>::type;
-
-    auto task = std::make_shared< std::packaged_task<return_type()> >(
-            std::bind(std::forward<Func>(f), std::forward<Args>(args)...)
-        );
-
-    std::future<return_type> res = task->get_future();
-    {
-        std::unique_lock<std::mutex> lock(queue_mutex);
-
-        // don't allow enqueueing after stopping the pool
-        if(stop)
-            throw std::runtime_error("enqueue on stopped ThreadPool");
-
-        tasks.emplace([task](){ (*task)(); });
-    }
-    condition.notify_one();
-    return res;
-}
-
 // the destructor joins all threads
 ThreadPool::~ThreadPool() {
 
@@ -387,6 +387,19 @@ void AtomicUpdateItemPointer(ItemPointer* src_ptr, const ItemPointer& value) {
   __sync_bool_compare_and_swap(cast_src_ptr, *cast_src_ptr, *cast_value_ptr);
 }
 
+bool AtomicCompareAndSwapItemPointer(ItemPointer* src_ptr,
+                                     const ItemPointer& expected,
+                                     const ItemPointer& value) {
+  PL_ASSERT(sizeof(ItemPointer) == sizeof(int64_t));
+  int64_t* cast_src_ptr = reinterpret_cast<int64_t*>((void*)src_ptr);
+  const int64_t* cast_expected_ptr =
+      reinterpret_cast<const int64_t*>((const void*)&expected);
+  const int64_t* cast_value_ptr =
+      reinterpret_cast<const int64_t*>((const void*)&value);
+  return __sync_bool_compare_and_swap(cast_src_ptr, *cast_expected_ptr,
+                                      *cast_value_ptr);
+}
+
 //===--------------------------------------------------------------------===//
 // Expression - String Utilities
 //===--------------------------------------------------------------------===//
@@ -675,6 +688,7 @@ std::string PlanNodeTypeToString(PlanNodeType type) {
     case PLAN_NODE_TYPE_HASH: { return "HASH"; }
     case PLAN_NODE_TYPE_DROP: { return "DROP"; }
     case PLAN_NODE_TYPE_CREATE: { return "CREATE"; }
+    case PLAN_NODE_TYPE_IMPORT: { return "IMPORT"; }
   }
   return "INVALID";
 }
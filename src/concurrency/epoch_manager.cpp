@@ -16,6 +16,8 @@
 namespace peloton {
 namespace concurrency {
 
+EpochType EpochManagerFactory::epoch_type_ = EPOCH_TYPE_DECENTRALIZED;
+
 //  volatile cid_t EpochManager::curr_epoch_ = 1;
 }
 }
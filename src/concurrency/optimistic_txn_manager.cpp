@@ -125,6 +125,16 @@ bool OptimisticTxnManager::PerformRead(const ItemPointer &location) {
   return true;
 }
 
+bool OptimisticTxnManager::PerformReads(
+    const oid_t tile_group_id,
+    const storage::TileGroupHeader *const tile_group_header UNUSED_ATTRIBUTE,
+    const std::vector<oid_t> &tuple_ids) {
+  for (auto tuple_id : tuple_ids) {
+    current_txn->RecordRead(ItemPointer(tile_group_id, tuple_id));
+  }
+  return true;
+}
+
 bool OptimisticTxnManager::PerformInsert(const ItemPointer &location) {
   oid_t tile_group_id = location.block;
   oid_t tuple_id = location.offset;
@@ -272,28 +282,32 @@ Result OptimisticTxnManager::CommitTransaction() {
   // we can optimize read-only transaction.
   if (current_txn->IsReadOnly() == true) {
     // validate read set.
-    for (auto &tile_group_entry : rw_set) {
-      oid_t tile_group_id = tile_group_entry.first;
-      auto tile_group = manager.GetTileGroup(tile_group_id);
-      auto tile_group_header = tile_group->GetHeader();
-      for (auto &tuple_entry : tile_group_entry.second) {
-        auto tuple_slot = tuple_entry.first;
-        // if this tuple is not newly inserted.
-        if (tuple_entry.second == RW_TYPE_READ) {
-          if (tile_group_header->GetTransactionId(tuple_slot) ==
-                  INITIAL_TXN_ID &&
-              tile_group_header->GetBeginCommitId(tuple_slot) <=
-                  current_txn->GetBeginCommitId() &&
-              tile_group_header->GetEndCommitId(tuple_slot) >=
-                  current_txn->GetBeginCommitId()) {
-            // the version is not owned by other txns and is still visible.
-            continue;
-          }
-          // otherwise, validation fails. abort transaction.
-          return AbortTransaction();
-        } else {
-          PL_ASSERT(tuple_entry.second == RW_TYPE_INS_DEL);
+    oid_t tile_group_id = INVALID_OID;
+    std::shared_ptr<storage::TileGroup> tile_group;
+    storage::TileGroupHeader *tile_group_header = nullptr;
+    for (auto &rw_entry : rw_set) {
+      // consecutive entries mostly share their tile group
+      if (rw_entry.location.block != tile_group_id) {
+        tile_group_id = rw_entry.location.block;
+        tile_group = manager.GetTileGroup(tile_group_id);
+        tile_group_header = tile_group->GetHeader();
+      }
+      auto tuple_slot = rw_entry.location.offset;
+      // if this tuple is not newly inserted.
+      if (rw_entry.type == RW_TYPE_READ) {
+        if (tile_group_header->GetTransactionId(tuple_slot) ==
+                INITIAL_TXN_ID &&
+            tile_group_header->GetBeginCommitId(tuple_slot) <=
+                current_txn->GetBeginCommitId() &&
+            tile_group_header->GetEndCommitId(tuple_slot) >=
+                current_txn->GetBeginCommitId()) {
+          // the version is not owned by other txns and is still visible.
+          continue;
         }
+        // otherwise, validation fails. abort transaction.
+        return AbortTransaction();
+      } else {
+        PL_ASSERT(rw_entry.type == RW_TYPE_INS_DEL);
       }
     }
     // is it always true???
@@ -311,134 +325,140 @@ Result OptimisticTxnManager::CommitTransaction() {
   current_txn->SetEndCommitId(end_commit_id);
   LOG_INFO("Before the loops");
   // validate read set.
-  for (auto &tile_group_entry : rw_set) {
-    oid_t tile_group_id = tile_group_entry.first;
-    auto tile_group = manager.GetTileGroup(tile_group_id);
-    auto tile_group_header = tile_group->GetHeader();
-    for (auto &tuple_entry : tile_group_entry.second) {
-      auto tuple_slot = tuple_entry.first;
-      // if this tuple is not newly inserted.
-      if (tuple_entry.second != RW_TYPE_INSERT &&
-          tuple_entry.second != RW_TYPE_INS_DEL) {
-        // if this tuple is owned by this txn, then it is safe.
+  oid_t tile_group_id = INVALID_OID;
+  std::shared_ptr<storage::TileGroup> tile_group;
+  storage::TileGroupHeader *tile_group_header = nullptr;
+  for (auto &rw_entry : rw_set) {
+    // consecutive entries mostly share their tile group
+    if (rw_entry.location.block != tile_group_id) {
+      tile_group_id = rw_entry.location.block;
+      tile_group = manager.GetTileGroup(tile_group_id);
+      tile_group_header = tile_group->GetHeader();
+    }
+    auto tuple_slot = rw_entry.location.offset;
+    // if this tuple is not newly inserted.
+    if (rw_entry.type != RW_TYPE_INSERT &&
+        rw_entry.type != RW_TYPE_INS_DEL) {
+      // if this tuple is owned by this txn, then it is safe.
+      if (tile_group_header->GetTransactionId(tuple_slot) ==
+          current_txn->GetTransactionId()) {
+        // the version is owned by the transaction.
+        continue;
+      } else {
         if (tile_group_header->GetTransactionId(tuple_slot) ==
-            current_txn->GetTransactionId()) {
-          // the version is owned by the transaction.
+                INITIAL_TXN_ID &&
+            tile_group_header->GetBeginCommitId(tuple_slot) <=
+                end_commit_id &&
+            tile_group_header->GetEndCommitId(tuple_slot) >= end_commit_id) {
+          // the version is not owned by other txns and is still visible.
           continue;
-        } else {
-          if (tile_group_header->GetTransactionId(tuple_slot) ==
-                  INITIAL_TXN_ID &&
-              tile_group_header->GetBeginCommitId(tuple_slot) <=
-                  end_commit_id &&
-              tile_group_header->GetEndCommitId(tuple_slot) >= end_commit_id) {
-            // the version is not owned by other txns and is still visible.
-            continue;
-          }
         }
-        LOG_INFO("transaction id=%lu",
-                  tile_group_header->GetTransactionId(tuple_slot));
-        LOG_INFO("begin commit id=%lu",
-                  tile_group_header->GetBeginCommitId(tuple_slot));
-        LOG_INFO("end commit id=%lu",
-                  tile_group_header->GetEndCommitId(tuple_slot));
-        // otherwise, validation fails. abort transaction.
-        log_manager.DoneLogging();
-        return AbortTransaction();
       }
+      LOG_INFO("transaction id=%lu",
+                tile_group_header->GetTransactionId(tuple_slot));
+      LOG_INFO("begin commit id=%lu",
+                tile_group_header->GetBeginCommitId(tuple_slot));
+      LOG_INFO("end commit id=%lu",
+                tile_group_header->GetEndCommitId(tuple_slot));
+      // otherwise, validation fails. abort transaction.
+      log_manager.DoneLogging();
+      return AbortTransaction();
     }
   }
   //////////////////////////////////////////////////////////
 
   log_manager.LogBeginTransaction(end_commit_id);
   // install everything.
-  for (auto &tile_group_entry : rw_set) {
-    oid_t tile_group_id = tile_group_entry.first;
-    auto tile_group = manager.GetTileGroup(tile_group_id);
-    auto tile_group_header = tile_group->GetHeader();
-    for (auto &tuple_entry : tile_group_entry.second) {
-      auto tuple_slot = tuple_entry.first;
-      if (tuple_entry.second == RW_TYPE_UPDATE) {
-        // logging.
-        ItemPointer new_version =
-            tile_group_header->GetNextItemPointer(tuple_slot);
-        ItemPointer old_version(tile_group_id, tuple_slot);
+  tile_group_id = INVALID_OID;
+  for (auto &rw_entry : rw_set) {
+    // consecutive entries mostly share their tile group
+    if (rw_entry.location.block != tile_group_id) {
+      tile_group_id = rw_entry.location.block;
+      tile_group = manager.GetTileGroup(tile_group_id);
+      tile_group_header = tile_group->GetHeader();
+    }
+    auto tuple_slot = rw_entry.location.offset;
+    if (rw_entry.type == RW_TYPE_UPDATE) {
+      // logging.
+      ItemPointer new_version =
+          tile_group_header->GetNextItemPointer(tuple_slot);
+      ItemPointer old_version(tile_group_id, tuple_slot);
 
-        // logging.
-        log_manager.LogUpdate(end_commit_id, old_version, new_version);
+      // logging.
+      log_manager.LogUpdate(end_commit_id, old_version, new_version);
 
-        // we must guarantee that, at any time point, AT LEAST ONE version is
-        // visible.
-        // we do not change begin cid for old tuple.
-        auto new_tile_group_header =
-            manager.GetTileGroup(new_version.block)->GetHeader();
+      // we must guarantee that, at any time point, AT LEAST ONE version is
+      // visible.
+      // we do not change begin cid for old tuple.
+      auto new_tile_group_header =
+          manager.GetTileGroup(new_version.block)->GetHeader();
 
-        new_tile_group_header->SetEndCommitId(new_version.offset, MAX_CID);
-        new_tile_group_header->SetBeginCommitId(new_version.offset,
-                                                end_commit_id);
+      new_tile_group_header->SetEndCommitId(new_version.offset, MAX_CID);
+      new_tile_group_header->SetBeginCommitId(new_version.offset,
+                                              end_commit_id);
 
-        COMPILER_MEMORY_FENCE;
+      COMPILER_MEMORY_FENCE;
 
-        tile_group_header->SetEndCommitId(tuple_slot, end_commit_id);
+      tile_group_header->SetEndCommitId(tuple_slot, end_commit_id);
 
-        COMPILER_MEMORY_FENCE;
+      COMPILER_MEMORY_FENCE;
 
-        new_tile_group_header->SetTransactionId(new_version.offset,
-                                                INITIAL_TXN_ID);
-        tile_group_header->SetTransactionId(tuple_slot, INITIAL_TXN_ID);
+      new_tile_group_header->SetTransactionId(new_version.offset,
+                                              INITIAL_TXN_ID);
+      tile_group_header->SetTransactionId(tuple_slot, INITIAL_TXN_ID);
 
-      } else if (tuple_entry.second == RW_TYPE_DELETE) {
-        ItemPointer new_version =
-            tile_group_header->GetNextItemPointer(tuple_slot);
-        ItemPointer delete_location(tile_group_id, tuple_slot);
+    } else if (rw_entry.type == RW_TYPE_DELETE) {
+      ItemPointer new_version =
+          tile_group_header->GetNextItemPointer(tuple_slot);
+      ItemPointer delete_location(tile_group_id, tuple_slot);
 
-        // logging.
-        log_manager.LogDelete(end_commit_id, delete_location);
+      // logging.
+      log_manager.LogDelete(end_commit_id, delete_location);
 
-        // we do not change begin cid for old tuple.
-        auto new_tile_group_header =
-            manager.GetTileGroup(new_version.block)->GetHeader();
+      // we do not change begin cid for old tuple.
+      auto new_tile_group_header =
+          manager.GetTileGroup(new_version.block)->GetHeader();
 
-        new_tile_group_header->SetEndCommitId(new_version.offset, MAX_CID);
-        new_tile_group_header->SetBeginCommitId(new_version.offset,
-                                                end_commit_id);
+      new_tile_group_header->SetEndCommitId(new_version.offset, MAX_CID);
+      new_tile_group_header->SetBeginCommitId(new_version.offset,
+                                              end_commit_id);
 
-        COMPILER_MEMORY_FENCE;
+      COMPILER_MEMORY_FENCE;
 
-        tile_group_header->SetEndCommitId(tuple_slot, end_commit_id);
+      tile_group_header->SetEndCommitId(tuple_slot, end_commit_id);
 
-        COMPILER_MEMORY_FENCE;
+      COMPILER_MEMORY_FENCE;
 
-        new_tile_group_header->SetTransactionId(new_version.offset,
-                                                INVALID_TXN_ID);
-        tile_group_header->SetTransactionId(tuple_slot, INITIAL_TXN_ID);
+      new_tile_group_header->SetTransactionId(new_version.offset,
+                                              INVALID_TXN_ID);
+      tile_group_header->SetTransactionId(tuple_slot, INITIAL_TXN_ID);
 
-      } else if (tuple_entry.second == RW_TYPE_INSERT) {
-        // TODO: Reenable assert
-        //PL_ASSERT(tile_group_header->GetTransactionId(tuple_slot) ==
-        //          current_txn->GetTransactionId());
-        // set the begin commit id to persist insert
-        ItemPointer insert_location(tile_group_id, tuple_slot);
-        log_manager.LogInsert(end_commit_id, insert_location);
+    } else if (rw_entry.type == RW_TYPE_INSERT) {
+      // TODO: Reenable assert
+      //PL_ASSERT(tile_group_header->GetTransactionId(tuple_slot) ==
+      //          current_txn->GetTransactionId());
+      // set the begin commit id to persist insert
+      ItemPointer insert_location(tile_group_id, tuple_slot);
+      log_manager.LogInsert(end_commit_id, insert_location);
 
-        tile_group_header->SetEndCommitId(tuple_slot, MAX_CID);
-        tile_group_header->SetBeginCommitId(tuple_slot, end_commit_id);
+      tile_group_header->SetEndCommitId(tuple_slot, MAX_CID);
+      tile_group_header->SetBeginCommitId(tuple_slot, end_commit_id);
 
-        COMPILER_MEMORY_FENCE;
+      COMPILER_MEMORY_FENCE;
 
-        tile_group_header->SetTransactionId(tuple_slot, INITIAL_TXN_ID);
+      tile_group_header->SetTransactionId(tuple_slot, INITIAL_TXN_ID);
 
-      } else if (tuple_entry.second == RW_TYPE_INS_DEL) {
-        PL_ASSERT(tile_group_header->GetTransactionId(tuple_slot) ==
-                  current_txn->GetTransactionId());
+    } else if (rw_entry.type == RW_TYPE_INS_DEL) {
+      PL_ASSERT(tile_group_header->GetTransactionId(tuple_slot) ==
+                current_txn->GetTransactionId());
 
-        // set the begin commit id to persist insert
-        tile_group_header->SetEndCommitId(tuple_slot, MAX_CID);
-        tile_group_header->SetBeginCommitId(tuple_slot, MAX_CID);
+      // set the begin commit id to persist insert
+      tile_group_header->SetEndCommitId(tuple_slot, MAX_CID);
+      tile_group_header->SetBeginCommitId(tuple_slot, MAX_CID);
 
-        COMPILER_MEMORY_FENCE;
+      COMPILER_MEMORY_FENCE;
 
-        tile_group_header->SetTransactionId(tuple_slot, INVALID_TXN_ID);
-      }
+      tile_group_header->SetTransactionId(tuple_slot, INVALID_TXN_ID);
     }
   }
   log_manager.LogCommitTransaction(end_commit_id);
@@ -453,85 +473,88 @@ Result OptimisticTxnManager::AbortTransaction() {
 
   auto &rw_set = current_txn->GetRWSet();
 
-  for (auto &tile_group_entry : rw_set) {
-    oid_t tile_group_id = tile_group_entry.first;
-    auto tile_group = manager.GetTileGroup(tile_group_id);
-    auto tile_group_header = tile_group->GetHeader();
-
-    for (auto &tuple_entry : tile_group_entry.second) {
-      auto tuple_slot = tuple_entry.first;
-      if (tuple_entry.second == RW_TYPE_UPDATE) {
-        // we do not set begin cid for old tuple.
-        ItemPointer new_version =
-            tile_group_header->GetNextItemPointer(tuple_slot);
+  oid_t tile_group_id = INVALID_OID;
+  std::shared_ptr<storage::TileGroup> tile_group;
+  storage::TileGroupHeader *tile_group_header = nullptr;
+  for (auto &rw_entry : rw_set) {
+    // consecutive entries mostly share their tile group
+    if (rw_entry.location.block != tile_group_id) {
+      tile_group_id = rw_entry.location.block;
+      tile_group = manager.GetTileGroup(tile_group_id);
+      tile_group_header = tile_group->GetHeader();
+    }
+    auto tuple_slot = rw_entry.location.offset;
+    if (rw_entry.type == RW_TYPE_UPDATE) {
+      // we do not set begin cid for old tuple.
+      ItemPointer new_version =
+          tile_group_header->GetNextItemPointer(tuple_slot);
 
-        auto new_tile_group_header =
-            manager.GetTileGroup(new_version.block)->GetHeader();
-        new_tile_group_header->SetBeginCommitId(new_version.offset, MAX_CID);
-        new_tile_group_header->SetEndCommitId(new_version.offset, MAX_CID);
+      auto new_tile_group_header =
+          manager.GetTileGroup(new_version.block)->GetHeader();
+      new_tile_group_header->SetBeginCommitId(new_version.offset, MAX_CID);
+      new_tile_group_header->SetEndCommitId(new_version.offset, MAX_CID);
 
-        COMPILER_MEMORY_FENCE;
+      COMPILER_MEMORY_FENCE;
 
-        tile_group_header->SetEndCommitId(tuple_slot, MAX_CID);
+      tile_group_header->SetEndCommitId(tuple_slot, MAX_CID);
 
-        COMPILER_MEMORY_FENCE;
+      COMPILER_MEMORY_FENCE;
 
-        new_tile_group_header->SetTransactionId(new_version.offset,
-                                                INVALID_TXN_ID);
+      new_tile_group_header->SetTransactionId(new_version.offset,
+                                              INVALID_TXN_ID);
 
-        // reset the item pointers.
-        tile_group_header->SetNextItemPointer(tuple_slot, INVALID_ITEMPOINTER);
-        new_tile_group_header->SetPrevItemPointer(new_version.offset,
-                                                  INVALID_ITEMPOINTER);
+      // reset the item pointers.
+      tile_group_header->SetNextItemPointer(tuple_slot, INVALID_ITEMPOINTER);
+      new_tile_group_header->SetPrevItemPointer(new_version.offset,
+                                                INVALID_ITEMPOINTER);
 
-        COMPILER_MEMORY_FENCE;
+      COMPILER_MEMORY_FENCE;
 
-        tile_group_header->SetTransactionId(tuple_slot, INITIAL_TXN_ID);
+      tile_group_header->SetTransactionId(tuple_slot, INITIAL_TXN_ID);
 
-      } else if (tuple_entry.second == RW_TYPE_DELETE) {
-        ItemPointer new_version =
-            tile_group_header->GetNextItemPointer(tuple_slot);
+    } else if (rw_entry.type == RW_TYPE_DELETE) {
+      ItemPointer new_version =
+          tile_group_header->GetNextItemPointer(tuple_slot);
 
-        auto new_tile_group_header =
-            manager.GetTileGroup(new_version.block)->GetHeader();
+      auto new_tile_group_header =
+          manager.GetTileGroup(new_version.block)->GetHeader();
 
-        new_tile_group_header->SetBeginCommitId(new_version.offset, MAX_CID);
-        new_tile_group_header->SetEndCommitId(new_version.offset, MAX_CID);
+      new_tile_group_header->SetBeginCommitId(new_version.offset, MAX_CID);
+      new_tile_group_header->SetEndCommitId(new_version.offset, MAX_CID);
 
-        COMPILER_MEMORY_FENCE;
+      COMPILER_MEMORY_FENCE;
 
-        tile_group_header->SetEndCommitId(tuple_slot, MAX_CID);
+      tile_group_header->SetEndCommitId(tuple_slot, MAX_CID);
 
-        COMPILER_MEMORY_FENCE;
+      COMPILER_MEMORY_FENCE;
 
-        new_tile_group_header->SetTransactionId(new_version.offset,
-                                                INVALID_TXN_ID);
+      new_tile_group_header->SetTransactionId(new_version.offset,
+                                              INVALID_TXN_ID);
 
-        // reset the item pointers.
-        tile_group_header->SetNextItemPointer(tuple_slot, INVALID_ITEMPOINTER);
-        new_tile_group_header->SetPrevItemPointer(new_version.offset,
-                                                  INVALID_ITEMPOINTER);
+      // reset the item pointers.
+      tile_group_header->SetNextItemPointer(tuple_slot, INVALID_ITEMPOINTER);
+      new_tile_group_header->SetPrevItemPointer(new_version.offset,
+                                                INVALID_ITEMPOINTER);
 
-        COMPILER_MEMORY_FENCE;
+      COMPILER_MEMORY_FENCE;
 
-        tile_group_header->SetTransactionId(tuple_slot, INITIAL_TXN_ID);
+      tile_group_header->SetTransactionId(tuple_slot, INITIAL_TXN_ID);
 
-      } else if (tuple_entry.second == RW_TYPE_INSERT) {
-        tile_group_header->SetEndCommitId(tuple_slot, MAX_CID);
-        tile_group_header->SetBeginCommitId(tuple_slot, MAX_CID);
+    } else if (rw_entry.type == RW_TYPE_INSERT) {
+      tile_group_header->SetEndCommitId(tuple_slot, MAX_CID);
+      tile_group_header->SetBeginCommitId(tuple_slot, MAX_CID);
 
-        COMPILER_MEMORY_FENCE;
+      COMPILER_MEMORY_FENCE;
 
-        tile_group_header->SetTransactionId(tuple_slot, INVALID_TXN_ID);
+      tile_group_header->SetTransactionId(tuple_slot, INVALID_TXN_ID);
 
-      } else if (tuple_entry.second == RW_TYPE_INS_DEL) {
-        tile_group_header->SetEndCommitId(tuple_slot, MAX_CID);
-        tile_group_header->SetBeginCommitId(tuple_slot, MAX_CID);
+    } else if (rw_entry.type == RW_TYPE_INS_DEL) {
+      tile_group_header->SetEndCommitId(tuple_slot, MAX_CID);
+      tile_group_header->SetBeginCommitId(tuple_slot, MAX_CID);
 
-        COMPILER_MEMORY_FENCE;
+      COMPILER_MEMORY_FENCE;
 
-        tile_group_header->SetTransactionId(tuple_slot, INVALID_TXN_ID);
-      }
+      tile_group_header->SetTransactionId(tuple_slot, INVALID_TXN_ID);
     }
   }
 
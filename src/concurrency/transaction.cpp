@@ -16,6 +16,7 @@
 #include "common/logger.h"
 #include "common/platform.h"
 #include "common/macros.h"
+#include "storage/rollback_segment.h"
 
 #include <chrono>
 #include <thread>
@@ -25,41 +26,33 @@ namespace peloton {
 namespace concurrency {
 
 void Transaction::RecordRead(const ItemPointer &location) {
-  oid_t tile_group_id = location.block;
-  oid_t tuple_id = location.offset;
-
-  if (rw_set_.find(tile_group_id) != rw_set_.end() &&
-      rw_set_.at(tile_group_id).find(tuple_id) !=
-          rw_set_.at(tile_group_id).end()) {
-    PL_ASSERT(rw_set_.at(tile_group_id).at(tuple_id) != RW_TYPE_DELETE &&
-              rw_set_.at(tile_group_id).at(tuple_id) != RW_TYPE_INS_DEL);
+  RWType *type = FindRWType(location);
+
+  if (type != nullptr) {
+    PL_ASSERT(*type != RW_TYPE_DELETE && *type != RW_TYPE_INS_DEL);
     return;
   } else {
-    rw_set_[tile_group_id][tuple_id] = RW_TYPE_READ;
+    AddRWEntry(location, RW_TYPE_READ);
   }
 }
 
 void Transaction::RecordUpdate(const ItemPointer &location) {
-  oid_t tile_group_id = location.block;
-  oid_t tuple_id = location.offset;
-
-  if (rw_set_.find(tile_group_id) != rw_set_.end() &&
-      rw_set_.at(tile_group_id).find(tuple_id) !=
-          rw_set_.at(tile_group_id).end()) {
-    RWType &type = rw_set_.at(tile_group_id).at(tuple_id);
-    if (type == RW_TYPE_READ) {
-      type = RW_TYPE_UPDATE;
+  RWType *type = FindRWType(location);
+
+  if (type != nullptr) {
+    if (*type == RW_TYPE_READ) {
+      *type = RW_TYPE_UPDATE;
       // record write.
       is_written_ = true;
       return;
     }
-    if (type == RW_TYPE_UPDATE) {
+    if (*type == RW_TYPE_UPDATE) {
       return;
     }
-    if (type == RW_TYPE_INSERT) {
+    if (*type == RW_TYPE_INSERT) {
       return;
     }
-    if (type == RW_TYPE_DELETE) {
+    if (*type == RW_TYPE_DELETE) {
       PL_ASSERT(false);
       return;
     }
@@ -68,44 +61,36 @@ void Transaction::RecordUpdate(const ItemPointer &location) {
 }
 
 void Transaction::RecordInsert(const ItemPointer &location) {
-  oid_t tile_group_id = location.block;
-  oid_t tuple_id = location.offset;
+  RWType *type = FindRWType(location);
 
-  if (rw_set_.find(tile_group_id) != rw_set_.end() &&
-      rw_set_.at(tile_group_id).find(tuple_id) !=
-          rw_set_.at(tile_group_id).end()) {
-    // RWType &type = rw_set_.at(tile_group_id).at(tuple_id);
+  if (type != nullptr) {
     PL_ASSERT(false);
   } else {
-    rw_set_[tile_group_id][tuple_id] = RW_TYPE_INSERT;
+    AddRWEntry(location, RW_TYPE_INSERT);
     ++insert_count_;
   }
 }
 
 bool Transaction::RecordDelete(const ItemPointer &location) {
-  oid_t tile_group_id = location.block;
-  oid_t tuple_id = location.offset;
-
-  if (rw_set_.find(tile_group_id) != rw_set_.end() &&
-      rw_set_.at(tile_group_id).find(tuple_id) !=
-          rw_set_.at(tile_group_id).end()) {
-    RWType &type = rw_set_.at(tile_group_id).at(tuple_id);
-    if (type == RW_TYPE_READ) {
-      type = RW_TYPE_DELETE;
+  RWType *type = FindRWType(location);
+
+  if (type != nullptr) {
+    if (*type == RW_TYPE_READ) {
+      *type = RW_TYPE_DELETE;
       // record write.
       is_written_ = true;
       return false;
     }
-    if (type == RW_TYPE_UPDATE) {
-      type = RW_TYPE_DELETE;
+    if (*type == RW_TYPE_UPDATE) {
+      *type = RW_TYPE_DELETE;
       return false;
     }
-    if (type == RW_TYPE_INSERT) {
-      type = RW_TYPE_INS_DEL;
+    if (*type == RW_TYPE_INSERT) {
+      *type = RW_TYPE_INS_DEL;
       --insert_count_;
       return true;
     }
-    if (type == RW_TYPE_DELETE) {
+    if (*type == RW_TYPE_DELETE) {
       PL_ASSERT(false);
       return false;
     }
@@ -116,8 +101,45 @@ bool Transaction::RecordDelete(const ItemPointer &location) {
   return false;
 }
 
-const std::map<oid_t, std::map<oid_t, RWType>> &Transaction::GetRWSet() {
-  return rw_set_;
+const ReadWriteSet &Transaction::GetRWSet() { return rw_set_; }
+
+RWType *Transaction::FindRWType(const ItemPointer &location) {
+  if (rw_set_index_.empty() == false) {
+    auto itr = rw_set_index_.find(location);
+    if (itr == rw_set_index_.end()) {
+      return nullptr;
+    }
+    return &rw_set_[itr->second].type;
+  }
+
+  // the tuples accessed last are the most likely to be accessed again
+  for (auto itr = rw_set_.rbegin(); itr != rw_set_.rend(); ++itr) {
+    if (itr->location.block == location.block &&
+        itr->location.offset == location.offset) {
+      return &itr->type;
+    }
+  }
+  return nullptr;
+}
+
+void Transaction::AddRWEntry(const ItemPointer &location, const RWType type) {
+  rw_set_.emplace_back(location, type);
+
+  if (rw_set_index_.empty() == false) {
+    rw_set_index_.emplace(location, rw_set_.size() - 1);
+  } else if (rw_set_.size() > TXN_RW_SET_LINEAR_SEARCH_LIMIT) {
+    rw_set_index_.reserve(2 * rw_set_.size());
+    for (size_t entry_itr = 0; entry_itr < rw_set_.size(); entry_itr++) {
+      rw_set_index_.emplace(rw_set_[entry_itr].location, entry_itr);
+    }
+  }
+}
+
+storage::RollbackSegmentPool *Transaction::GetRollbackSegmentPool() {
+  if (rb_seg_pool_ == nullptr) {
+    rb_seg_pool_.reset(new storage::RollbackSegmentPool(BACKEND_TYPE_MM));
+  }
+  return rb_seg_pool_.get();
 }
 
 const std::string Transaction::GetInfo() const {
@@ -78,5 +78,67 @@ bool TransactionManager::IsOccupied(const ItemPointer &position) {
   }
 }
 
+void TransactionManager::GetVisibleTuples(
+    const storage::TileGroupHeader *const tile_group_header,
+    const oid_t tuple_count, std::vector<oid_t> &visible_tuples) {
+  cid_t txn_begin_cid = current_txn->GetBeginCommitId();
+
+  // Fast path: every tuple of a frozen tile group committed no later than
+  // the frozen commit id and has not been invalidated since.
+  cid_t frozen_cid = tile_group_header->GetFrozenCommitId();
+  if (frozen_cid != INVALID_CID && txn_begin_cid >= frozen_cid &&
+      HasDirtyRange() == false) {
+    for (oid_t tuple_id = 0; tuple_id < tuple_count; tuple_id++) {
+      visible_tuples.push_back(tuple_id);
+    }
+    return;
+  }
+
+  // Slow path: check every tuple, and see on the way whether the tile group
+  // can be frozen for the following scans.
+  auto header = const_cast<storage::TileGroupHeader *>(tile_group_header);
+  bool claimed = (HasDirtyRange() == false) && header->BeginFreeze();
+  bool freezing = claimed;
+  cid_t max_begin_cid = START_CID;
+
+  for (oid_t tuple_id = 0; tuple_id < tuple_count; tuple_id++) {
+    if (IsVisible(tile_group_header, tuple_id)) {
+      visible_tuples.push_back(tuple_id);
+    }
+
+    if (freezing) {
+      cid_t tuple_begin_cid = tile_group_header->GetBeginCommitId(tuple_id);
+      if (tile_group_header->GetTransactionId(tuple_id) != INITIAL_TXN_ID ||
+          tile_group_header->GetEndCommitId(tuple_id) != MAX_CID ||
+          tuple_begin_cid == MAX_CID) {
+        freezing = false;
+      } else if (tuple_begin_cid > max_begin_cid) {
+        max_begin_cid = tuple_begin_cid;
+      }
+    }
+  }
+
+  // Only the whole tile group can be frozen
+  if (tuple_count != tile_group_header->GetCurrentNextTupleSlot()) {
+    freezing = false;
+  }
+
+  if (claimed) {
+    header->EndFreeze(freezing ? max_begin_cid : INVALID_CID);
+  }
+}
+
+bool TransactionManager::PerformReads(
+    const oid_t tile_group_id,
+    const storage::TileGroupHeader *const tile_group_header UNUSED_ATTRIBUTE,
+    const std::vector<oid_t> &tuple_ids) {
+  for (auto tuple_id : tuple_ids) {
+    if (PerformRead(ItemPointer(tile_group_id, tuple_id)) == false) {
+      return false;
+    }
+  }
+  return true;
+}
+
 }  // End concurrency namespace
 }  // End peloton namespace
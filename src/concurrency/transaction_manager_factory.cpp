@@ -19,5 +19,7 @@ ConcurrencyType TransactionManagerFactory::protocol_ =
     CONCURRENCY_TYPE_TO;
 IsolationLevelType TransactionManagerFactory::isolation_level_ =
     ISOLATION_LEVEL_TYPE_FULL;
+VersionStorageType TransactionManagerFactory::version_storage_ =
+    VERSION_STORAGE_TYPE_FULL;
 }
 }
@@ -20,9 +20,12 @@
 #include "catalog/manager.h"
 #include "common/exception.h"
 #include "common/logger.h"
+#include "expression/container_tuple.h"
+#include "gc/gc_manager_factory.h"
 #include "storage/data_table.h"
 #include "storage/tile_group.h"
 #include "storage/tile_group_header.h"
+#include "storage/tuple.h"
 
 namespace peloton {
 namespace concurrency {
@@ -53,6 +56,12 @@ bool TsOrderTxnManager::IsVisible(
       PL_ASSERT(tuple_end_cid == MAX_CID);
       // the only version that is visible is the newly inserted one.
       return true;
+    } else if (tuple_end_cid == MAX_CID &&
+               tile_group_header->GetNextItemPointer(tuple_id).IsNull()) {
+      // unless the version was updated in place by the transaction.
+      char *rb_seg = GetDeltaChainHead(tile_group_header, tuple_id);
+      return rb_seg != nullptr &&
+             storage::RollbackSegmentPool::GetTimeStamp(rb_seg) == MAX_CID;
     } else {
       // the older version is not visible.
       return false;
@@ -70,6 +79,9 @@ bool TsOrderTxnManager::IsVisible(
         // the older version may be visible.
         if (activated && !invalidated) {
           return true;
+        } else if (!activated && !invalidated) {
+          // the version may have been updated in place.
+          return IsVisibleInDeltaChain(tile_group_header, tuple_id);
         } else {
           return false;
         }
@@ -78,6 +90,9 @@ bool TsOrderTxnManager::IsVisible(
       // if the tuple is not owned by any transaction.
       if (activated && !invalidated) {
         return true;
+      } else if (!activated && !invalidated) {
+        // the version may have been updated in place.
+        return IsVisibleInDeltaChain(tile_group_header, tuple_id);
       } else {
         return false;
       }
@@ -85,6 +100,27 @@ bool TsOrderTxnManager::IsVisible(
   }
 }
 
+// check whether the version visible to the current transaction is one that
+// was overwritten in place, and can be rebuilt from the delta chain.
+bool TsOrderTxnManager::IsVisibleInDeltaChain(
+    const storage::TileGroupHeader *const tile_group_header,
+    const oid_t &tuple_id) {
+  cid_t read_cid = current_txn->GetBeginCommitId();
+
+  // the oldest rollback segment to apply restores the visible version.
+  char *oldest_rb_seg = nullptr;
+  char *rb_seg = GetDeltaChainHead(tile_group_header, tuple_id);
+  while (rb_seg != nullptr &&
+         storage::RollbackSegmentPool::GetTimeStamp(rb_seg) > read_cid) {
+    oldest_rb_seg = rb_seg;
+    rb_seg = storage::RollbackSegmentPool::GetNextPtr(rb_seg);
+  }
+
+  return oldest_rb_seg != nullptr &&
+         storage::RollbackSegmentPool::GetBeginTimeStamp(oldest_rb_seg) <=
+             read_cid;
+}
+
 // check whether the current transaction owns the tuple.
 // this function is called by update/delete executors.
 bool TsOrderTxnManager::IsOwner(
@@ -154,6 +190,30 @@ bool TsOrderTxnManager::PerformRead(const ItemPointer &location) {
   }
 }
 
+// same as PerformRead, but the tile group header is looked up only once
+bool TsOrderTxnManager::PerformReads(
+    const oid_t tile_group_id,
+    const storage::TileGroupHeader *const tile_group_header,
+    const std::vector<oid_t> &tuple_ids) {
+  cid_t txn_begin_cid = current_txn->GetBeginCommitId();
+
+  for (auto tuple_id : tuple_ids) {
+    if (IsOwner(tile_group_header, tuple_id)) {
+      continue;
+    }
+
+    txn_id_t tuple_txn_id = tile_group_header->GetTransactionId(tuple_id);
+    if (tuple_txn_id != INITIAL_TXN_ID) {
+      // if the version we want to read is uncommitted, then abort.
+      return false;
+    }
+
+    SetLastReaderCid(tile_group_header, tuple_id, txn_begin_cid);
+    current_txn->RecordRead(ItemPointer(tile_group_id, tuple_id));
+  }
+  return true;
+}
+
 bool TsOrderTxnManager::PerformInsert(const ItemPointer &location) {
   oid_t tile_group_id = location.block;
   oid_t tuple_id = location.offset;
@@ -289,6 +349,125 @@ void TsOrderTxnManager::PerformDelete(const ItemPointer &location) {
   }
 }
 
+// this function is invoked to update the latest version of a tuple in place,
+// before its slot is overwritten. the tuple must be owned by the current txn.
+void TsOrderTxnManager::PerformInPlaceUpdate(const ItemPointer &location,
+                                             const TargetList &target_list) {
+  oid_t tile_group_id = location.block;
+  oid_t tuple_id = location.offset;
+
+  auto &manager = catalog::Manager::GetInstance();
+  auto tile_group = manager.GetTileGroup(tile_group_id);
+  auto tile_group_header = tile_group->GetHeader();
+
+  PL_ASSERT(tile_group_header->GetTransactionId(tuple_id) ==
+            current_txn->GetTransactionId());
+  PL_ASSERT(tile_group_header->GetBeginCommitId(tuple_id) != MAX_CID);
+  PL_ASSERT(tile_group_header->GetNextItemPointer(tuple_id).IsNull());
+
+  // save the current value of the updated columns.
+  auto schema = tile_group->GetAbstractTable()->GetSchema();
+  expression::ContainerTuple<storage::TileGroup> tuple(tile_group.get(),
+                                                       tuple_id);
+  auto rb_seg =
+      current_txn->GetRollbackSegmentPool()->CreateSegmentFromTuple(
+          schema, target_list, &tuple);
+  storage::RollbackSegmentPool::SetBeginTimeStamp(
+      rb_seg, tile_group_header->GetBeginCommitId(tuple_id));
+
+  // the segment must be on the chain before the slot is overwritten.
+  LockDeltaChain(tile_group_header, tuple_id);
+  storage::RollbackSegmentPool::SetNextPtr(
+      rb_seg, GetDeltaChainHead(tile_group_header, tuple_id));
+
+  COMPILER_MEMORY_FENCE;
+
+  SetDeltaChainHead(tile_group_header, tuple_id, rb_seg);
+  UnlockDeltaChain(tile_group_header, tuple_id);
+
+  current_txn->RecordUpdate(location);
+}
+
+bool TsOrderTxnManager::ReconstructVersion(storage::TileGroup *tile_group,
+                                           const oid_t &tuple_id,
+                                           storage::Tuple *tuple,
+                                           VarlenPool *data_pool) {
+  auto tile_group_header = tile_group->GetHeader();
+  if (IsOwner(tile_group_header, tuple_id)) {
+    return false;
+  }
+
+  // the caller pinned the tile group, so a writer that takes the tuple from
+  // now on creates a new version instead of overwriting the slot. the slot
+  // is read in place unless a writer owns it, or one overwrote it after the
+  // snapshot.
+  cid_t read_cid = current_txn->GetBeginCommitId();
+  if (tile_group_header->GetTransactionId(tuple_id) == INITIAL_TXN_ID) {
+    char *rb_seg = GetDeltaChainHead(tile_group_header, tuple_id);
+    if (rb_seg == nullptr ||
+        storage::RollbackSegmentPool::GetTimeStamp(rb_seg) <= read_cid) {
+      return false;
+    }
+  }
+
+  // copy the slot first. a writer pushes its segment before it overwrites
+  // the slot, so the chain read afterwards covers every column it changed.
+  auto schema = tile_group->GetAbstractTable()->GetSchema();
+  auto column_count = schema->GetColumnCount();
+  for (oid_t column_itr = 0; column_itr < column_count; column_itr++) {
+    tuple->SetValue(column_itr, tile_group->GetValue(tuple_id, column_itr),
+                    data_pool);
+  }
+
+  COMPILER_MEMORY_FENCE;
+
+  char *rb_seg = GetDeltaChainHead(tile_group_header, tuple_id);
+  while (rb_seg != nullptr &&
+         storage::RollbackSegmentPool::GetTimeStamp(rb_seg) > read_cid) {
+    storage::RollbackSegmentPool::ApplyToTuple(rb_seg, schema, tuple,
+                                               data_pool);
+    rb_seg = storage::RollbackSegmentPool::GetNextPtr(rb_seg);
+  }
+
+  return true;
+}
+
+// stamp the uncommitted segments at the head of the delta chain with the
+// commit id. returns false if there is none.
+bool TsOrderTxnManager::CommitDeltaChain(
+    const storage::TileGroupHeader *const tile_group_header,
+    const oid_t &tuple_id, const cid_t &end_commit_id) {
+  bool committed = false;
+  char *rb_seg = GetDeltaChainHead(tile_group_header, tuple_id);
+  while (rb_seg != nullptr &&
+         storage::RollbackSegmentPool::GetTimeStamp(rb_seg) == MAX_CID) {
+    storage::RollbackSegmentPool::SetTimeStamp(rb_seg, end_commit_id);
+    rb_seg = storage::RollbackSegmentPool::GetNextPtr(rb_seg);
+    committed = true;
+  }
+  return committed;
+}
+
+// restore the slot from the uncommitted segments at the head of the delta
+// chain, newest first, and unlink them.
+void TsOrderTxnManager::AbortDeltaChain(storage::TileGroup *tile_group,
+                                        const oid_t &tuple_id) {
+  auto tile_group_header = tile_group->GetHeader();
+
+  LockDeltaChain(tile_group_header, tuple_id);
+  char *rb_seg = GetDeltaChainHead(tile_group_header, tuple_id);
+  while (rb_seg != nullptr &&
+         storage::RollbackSegmentPool::GetTimeStamp(rb_seg) == MAX_CID) {
+    tile_group->ApplyRollbackSegment(rb_seg, tuple_id);
+    rb_seg = storage::RollbackSegmentPool::GetNextPtr(rb_seg);
+  }
+
+  COMPILER_MEMORY_FENCE;
+
+  SetDeltaChainHead(tile_group_header, tuple_id, rb_seg);
+  UnlockDeltaChain(tile_group_header, tuple_id);
+}
+
 Result TsOrderTxnManager::CommitTransaction() {
   LOG_TRACE("Committing peloton txn : %lu ", current_txn->GetTransactionId());
 
@@ -307,82 +486,116 @@ Result TsOrderTxnManager::CommitTransaction() {
 
   auto &rw_set = current_txn->GetRWSet();
 
+  // tuples whose delta chain got segments of this transaction
+  std::vector<ItemPointer> delta_locations;
+
   // TODO: Add optimization for read only
 
-  for (auto &tile_group_entry : rw_set) {
-    oid_t tile_group_id = tile_group_entry.first;
-    auto tile_group = manager.GetTileGroup(tile_group_id);
-    auto tile_group_header = tile_group->GetHeader();
-    for (auto &tuple_entry : tile_group_entry.second) {
-      auto tuple_slot = tuple_entry.first;
-      if (tuple_entry.second == RW_TYPE_READ) {
-        continue;
-      } else if (tuple_entry.second == RW_TYPE_UPDATE) {
-        // we must guarantee that, at any time point, only one version is
-        // visible.
-        ItemPointer new_version =
-            tile_group_header->GetNextItemPointer(tuple_slot);
-
-        auto new_tile_group_header =
-            manager.GetTileGroup(new_version.block)->GetHeader();
-        new_tile_group_header->SetBeginCommitId(new_version.offset,
-                                                end_commit_id);
-        new_tile_group_header->SetEndCommitId(new_version.offset, MAX_CID);
+  oid_t tile_group_id = INVALID_OID;
+  std::shared_ptr<storage::TileGroup> tile_group;
+  storage::TileGroupHeader *tile_group_header = nullptr;
+  for (auto &rw_entry : rw_set) {
+    // consecutive entries mostly share their tile group
+    if (rw_entry.location.block != tile_group_id) {
+      tile_group_id = rw_entry.location.block;
+      tile_group = manager.GetTileGroup(tile_group_id);
+      tile_group_header = tile_group->GetHeader();
+    }
+    auto tuple_slot = rw_entry.location.offset;
+    if (rw_entry.type == RW_TYPE_READ) {
+      continue;
+    } else if (rw_entry.type == RW_TYPE_UPDATE) {
+      // we must guarantee that, at any time point, only one version is
+      // visible.
+      ItemPointer new_version =
+          tile_group_header->GetNextItemPointer(tuple_slot);
+
+      if (new_version.IsNull() == true) {
+        // the tuple was updated in place.
+        CommitDeltaChain(tile_group_header, tuple_slot, end_commit_id);
+        delta_locations.emplace_back(tile_group_id, tuple_slot);
 
         COMPILER_MEMORY_FENCE;
 
-        tile_group_header->SetEndCommitId(tuple_slot, end_commit_id);
+        tile_group_header->SetBeginCommitId(tuple_slot, end_commit_id);
 
         COMPILER_MEMORY_FENCE;
 
-        new_tile_group_header->SetTransactionId(new_version.offset,
-                                                INITIAL_TXN_ID);
         tile_group_header->SetTransactionId(tuple_slot, INITIAL_TXN_ID);
-      } else if (tuple_entry.second == RW_TYPE_DELETE) {
-        ItemPointer new_version =
-            tile_group_header->GetNextItemPointer(tuple_slot);
+        continue;
+      }
 
-        auto new_tile_group_header =
-            manager.GetTileGroup(new_version.block)->GetHeader();
-        new_tile_group_header->SetBeginCommitId(new_version.offset,
-                                                end_commit_id);
-        new_tile_group_header->SetEndCommitId(new_version.offset, MAX_CID);
+      auto new_tile_group_header =
+          manager.GetTileGroup(new_version.block)->GetHeader();
+      new_tile_group_header->SetBeginCommitId(new_version.offset,
+                                              end_commit_id);
+      new_tile_group_header->SetEndCommitId(new_version.offset, MAX_CID);
 
-        COMPILER_MEMORY_FENCE;
+      COMPILER_MEMORY_FENCE;
 
-        tile_group_header->SetEndCommitId(tuple_slot, end_commit_id);
+      tile_group_header->SetEndCommitId(tuple_slot, end_commit_id);
 
-        COMPILER_MEMORY_FENCE;
+      COMPILER_MEMORY_FENCE;
 
-        new_tile_group_header->SetTransactionId(new_version.offset,
-                                                INVALID_TXN_ID);
-        tile_group_header->SetTransactionId(tuple_slot, INITIAL_TXN_ID);
-      } else if (tuple_entry.second == RW_TYPE_INSERT) {
-        // TODO: Fix this
-        //PL_ASSERT(tile_group_header->GetTransactionId(tuple_slot) ==
-        //          current_txn->GetTransactionId());
-        // set the begin commit id to persist insert
-        tile_group_header->SetBeginCommitId(tuple_slot, end_commit_id);
-        tile_group_header->SetEndCommitId(tuple_slot, MAX_CID);
+      new_tile_group_header->SetTransactionId(new_version.offset,
+                                              INITIAL_TXN_ID);
+      tile_group_header->SetTransactionId(tuple_slot, INITIAL_TXN_ID);
+    } else if (rw_entry.type == RW_TYPE_DELETE) {
+      // the tuple may have been updated in place before it was deleted.
+      if (CommitDeltaChain(tile_group_header, tuple_slot, end_commit_id)) {
+        delta_locations.emplace_back(tile_group_id, tuple_slot);
+      }
 
-        COMPILER_MEMORY_FENCE;
+      ItemPointer new_version =
+          tile_group_header->GetNextItemPointer(tuple_slot);
 
-        tile_group_header->SetTransactionId(tuple_slot, INITIAL_TXN_ID);
-      } else if (tuple_entry.second == RW_TYPE_INS_DEL) {
-        PL_ASSERT(tile_group_header->GetTransactionId(tuple_slot) ==
-                  current_txn->GetTransactionId());
+      auto new_tile_group_header =
+          manager.GetTileGroup(new_version.block)->GetHeader();
+      new_tile_group_header->SetBeginCommitId(new_version.offset,
+                                              end_commit_id);
+      new_tile_group_header->SetEndCommitId(new_version.offset, MAX_CID);
 
-        tile_group_header->SetBeginCommitId(tuple_slot, MAX_CID);
-        tile_group_header->SetEndCommitId(tuple_slot, MAX_CID);
+      COMPILER_MEMORY_FENCE;
 
-        COMPILER_MEMORY_FENCE;
+      tile_group_header->SetEndCommitId(tuple_slot, end_commit_id);
 
-        // set the begin commit id to persist insert
-        tile_group_header->SetTransactionId(tuple_slot, INVALID_TXN_ID);
-      }
+      COMPILER_MEMORY_FENCE;
+
+      new_tile_group_header->SetTransactionId(new_version.offset,
+                                              INVALID_TXN_ID);
+      tile_group_header->SetTransactionId(tuple_slot, INITIAL_TXN_ID);
+    } else if (rw_entry.type == RW_TYPE_INSERT) {
+      // TODO: Fix this
+      //PL_ASSERT(tile_group_header->GetTransactionId(tuple_slot) ==
+      //          current_txn->GetTransactionId());
+      // set the begin commit id to persist insert
+      tile_group_header->SetBeginCommitId(tuple_slot, end_commit_id);
+      tile_group_header->SetEndCommitId(tuple_slot, MAX_CID);
+
+      COMPILER_MEMORY_FENCE;
+
+      tile_group_header->SetTransactionId(tuple_slot, INITIAL_TXN_ID);
+    } else if (rw_entry.type == RW_TYPE_INS_DEL) {
+      PL_ASSERT(tile_group_header->GetTransactionId(tuple_slot) ==
+                current_txn->GetTransactionId());
+
+      tile_group_header->SetBeginCommitId(tuple_slot, MAX_CID);
+      tile_group_header->SetEndCommitId(tuple_slot, MAX_CID);
+
+      COMPILER_MEMORY_FENCE;
+
+      // set the begin commit id to persist insert
+      tile_group_header->SetTransactionId(tuple_slot, INVALID_TXN_ID);
     }
   }
 
+  // the segments are reclaimed once no transaction can read them.
+  auto &rb_seg_pool = current_txn->GetRollbackSegmentPoolRef();
+  if (rb_seg_pool != nullptr) {
+    gc::GCManagerFactory::GetInstance().RecycleRollbackSegments(
+        rb_seg_pool, delta_locations, end_commit_id);
+  }
+
   Result ret = current_txn->GetResult();
 
   EndTransaction();
@@ -396,81 +609,105 @@ Result TsOrderTxnManager::AbortTransaction() {
 
   auto &rw_set = current_txn->GetRWSet();
 
-  for (auto &tile_group_entry : rw_set) {
-    oid_t tile_group_id = tile_group_entry.first;
-    auto tile_group = manager.GetTileGroup(tile_group_id);
-    auto tile_group_header = tile_group->GetHeader();
+  oid_t tile_group_id = INVALID_OID;
+  std::shared_ptr<storage::TileGroup> tile_group;
+  storage::TileGroupHeader *tile_group_header = nullptr;
+  for (auto &rw_entry : rw_set) {
+    // consecutive entries mostly share their tile group
+    if (rw_entry.location.block != tile_group_id) {
+      tile_group_id = rw_entry.location.block;
+      tile_group = manager.GetTileGroup(tile_group_id);
+      tile_group_header = tile_group->GetHeader();
+    }
+    auto tuple_slot = rw_entry.location.offset;
+    if (rw_entry.type == RW_TYPE_READ) {
+      continue;
+    } else if (rw_entry.type == RW_TYPE_UPDATE) {
+      ItemPointer new_version =
+          tile_group_header->GetNextItemPointer(tuple_slot);
 
-    for (auto &tuple_entry : tile_group_entry.second) {
-      auto tuple_slot = tuple_entry.first;
-      if (tuple_entry.second == RW_TYPE_READ) {
-        continue;
-      } else if (tuple_entry.second == RW_TYPE_UPDATE) {
-        ItemPointer new_version =
-            tile_group_header->GetNextItemPointer(tuple_slot);
-        auto new_tile_group_header =
-            manager.GetTileGroup(new_version.block)->GetHeader();
-        new_tile_group_header->SetBeginCommitId(new_version.offset, MAX_CID);
-        new_tile_group_header->SetEndCommitId(new_version.offset, MAX_CID);
+      if (new_version.IsNull() == true) {
+        // the tuple was updated in place.
+        AbortDeltaChain(tile_group.get(), tuple_slot);
 
         COMPILER_MEMORY_FENCE;
 
-        new_tile_group_header->SetTransactionId(new_version.offset,
-                                                INVALID_TXN_ID);
+        tile_group_header->SetTransactionId(tuple_slot, INITIAL_TXN_ID);
+        continue;
+      }
 
-        // reset the item pointers.
-        tile_group_header->SetNextItemPointer(tuple_slot, INVALID_ITEMPOINTER);
-        new_tile_group_header->SetPrevItemPointer(new_version.offset,
-                                                  INVALID_ITEMPOINTER);
+      auto new_tile_group_header =
+          manager.GetTileGroup(new_version.block)->GetHeader();
+      new_tile_group_header->SetBeginCommitId(new_version.offset, MAX_CID);
+      new_tile_group_header->SetEndCommitId(new_version.offset, MAX_CID);
 
-        COMPILER_MEMORY_FENCE;
+      COMPILER_MEMORY_FENCE;
 
-        tile_group_header->SetEndCommitId(tuple_slot, MAX_CID);
+      new_tile_group_header->SetTransactionId(new_version.offset,
+                                              INVALID_TXN_ID);
 
-        COMPILER_MEMORY_FENCE;
+      // reset the item pointers.
+      tile_group_header->SetNextItemPointer(tuple_slot, INVALID_ITEMPOINTER);
+      new_tile_group_header->SetPrevItemPointer(new_version.offset,
+                                                INVALID_ITEMPOINTER);
 
-        tile_group_header->SetTransactionId(tuple_slot, INITIAL_TXN_ID);
+      COMPILER_MEMORY_FENCE;
 
-      } else if (tuple_entry.second == RW_TYPE_DELETE) {
-        tile_group_header->SetEndCommitId(tuple_slot, MAX_CID);
-        ItemPointer new_version =
-            tile_group_header->GetNextItemPointer(tuple_slot);
-        auto new_tile_group_header =
-            manager.GetTileGroup(new_version.block)->GetHeader();
-        new_tile_group_header->SetBeginCommitId(new_version.offset, MAX_CID);
-        new_tile_group_header->SetEndCommitId(new_version.offset, MAX_CID);
+      tile_group_header->SetEndCommitId(tuple_slot, MAX_CID);
 
-        COMPILER_MEMORY_FENCE;
+      COMPILER_MEMORY_FENCE;
 
-        new_tile_group_header->SetTransactionId(new_version.offset,
-                                                INVALID_TXN_ID);
+      tile_group_header->SetTransactionId(tuple_slot, INITIAL_TXN_ID);
 
-        // reset the item pointers.
-        tile_group_header->SetNextItemPointer(tuple_slot, INVALID_ITEMPOINTER);
-        new_tile_group_header->SetPrevItemPointer(new_version.offset,
-                                                  INVALID_ITEMPOINTER);
+    } else if (rw_entry.type == RW_TYPE_DELETE) {
+      // the tuple may have been updated in place before it was deleted.
+      AbortDeltaChain(tile_group.get(), tuple_slot);
 
-        COMPILER_MEMORY_FENCE;
-        tile_group_header->SetTransactionId(tuple_slot, INITIAL_TXN_ID);
+      tile_group_header->SetEndCommitId(tuple_slot, MAX_CID);
+      ItemPointer new_version =
+          tile_group_header->GetNextItemPointer(tuple_slot);
+      auto new_tile_group_header =
+          manager.GetTileGroup(new_version.block)->GetHeader();
+      new_tile_group_header->SetBeginCommitId(new_version.offset, MAX_CID);
+      new_tile_group_header->SetEndCommitId(new_version.offset, MAX_CID);
 
-      } else if (tuple_entry.second == RW_TYPE_INSERT) {
-        tile_group_header->SetBeginCommitId(tuple_slot, MAX_CID);
-        tile_group_header->SetEndCommitId(tuple_slot, MAX_CID);
+      COMPILER_MEMORY_FENCE;
 
-        COMPILER_MEMORY_FENCE;
+      new_tile_group_header->SetTransactionId(new_version.offset,
+                                              INVALID_TXN_ID);
 
-        tile_group_header->SetTransactionId(tuple_slot, INVALID_TXN_ID);
-      } else if (tuple_entry.second == RW_TYPE_INS_DEL) {
-        tile_group_header->SetBeginCommitId(tuple_slot, MAX_CID);
-        tile_group_header->SetEndCommitId(tuple_slot, MAX_CID);
+      // reset the item pointers.
+      tile_group_header->SetNextItemPointer(tuple_slot, INVALID_ITEMPOINTER);
+      new_tile_group_header->SetPrevItemPointer(new_version.offset,
+                                                INVALID_ITEMPOINTER);
 
-        COMPILER_MEMORY_FENCE;
+      COMPILER_MEMORY_FENCE;
+      tile_group_header->SetTransactionId(tuple_slot, INITIAL_TXN_ID);
 
-        tile_group_header->SetTransactionId(tuple_slot, INVALID_TXN_ID);
-      }
+    } else if (rw_entry.type == RW_TYPE_INSERT) {
+      tile_group_header->SetBeginCommitId(tuple_slot, MAX_CID);
+      tile_group_header->SetEndCommitId(tuple_slot, MAX_CID);
+
+      COMPILER_MEMORY_FENCE;
+
+      tile_group_header->SetTransactionId(tuple_slot, INVALID_TXN_ID);
+    } else if (rw_entry.type == RW_TYPE_INS_DEL) {
+      tile_group_header->SetBeginCommitId(tuple_slot, MAX_CID);
+      tile_group_header->SetEndCommitId(tuple_slot, MAX_CID);
+
+      COMPILER_MEMORY_FENCE;
+
+      tile_group_header->SetTransactionId(tuple_slot, INVALID_TXN_ID);
     }
   }
 
+  // the unlinked segments are reclaimed once no transaction can read them.
+  auto &rb_seg_pool = current_txn->GetRollbackSegmentPoolRef();
+  if (rb_seg_pool != nullptr) {
+    gc::GCManagerFactory::GetInstance().RecycleRollbackSegments(
+        rb_seg_pool, std::vector<ItemPointer>(), INVALID_CID);
+  }
+
   EndTransaction();
   return Result::RESULT_ABORTED;
 }
@@ -100,9 +100,44 @@ bool AggregateExecutor::DExecute() {
   // Get an aggregator
   std::unique_ptr<AbstractAggregator> aggregator(nullptr);
 
+  // Input tiles buffered before aggregating them
+  std::vector<std::unique_ptr<LogicalTile>> input_tiles;
+  bool child_done = false;
+
+  // Large hash aggregations run in parallel over all the input tiles
+  if (node.GetAggregateStrategy() == AGGREGATE_TYPE_HASH &&
+      ParallelHashAggregator::IsSupported(&node)) {
+    size_t input_tuple_count = 0;
+    while (children_[0]->Execute() == true) {
+      input_tiles.emplace_back(children_[0]->GetOutput());
+      input_tuple_count += input_tiles.back()->GetTupleCount();
+    }
+    child_done = true;
+
+    if (input_tuple_count >= PARALLEL_AGGREGATE_MIN_TUPLE_COUNT) {
+      LOG_TRACE("Use ParallelHashAggregator");
+      ParallelHashAggregator parallel_aggregator(
+          &node, output_table, executor_context_,
+          input_tiles[0]->GetColumnCount());
+      if (parallel_aggregator.Execute(input_tiles) == false) {
+        done = true;
+        return false;
+      }
+      input_tiles.clear();
+      return ReturnResult();
+    }
+  }
+
   // Get input tiles and aggregate them
-  while (children_[0]->Execute() == true) {
-    std::unique_ptr<LogicalTile> tile(children_[0]->GetOutput());
+  for (size_t input_tile_itr = 0;; input_tile_itr++) {
+    std::unique_ptr<LogicalTile> tile;
+    if (input_tile_itr < input_tiles.size()) {
+      tile = std::move(input_tiles[input_tile_itr]);
+    } else if (child_done == false && children_[0]->Execute() == true) {
+      tile.reset(children_[0]->GetOutput());
+    } else {
+      break;
+    }
 
     if (nullptr == aggregator.get()) {
       // Initialize the aggregator
@@ -167,6 +202,14 @@ bool AggregateExecutor::DExecute() {
     }
   }
 
+  return ReturnResult();
+}
+
+/**
+ * @brief Wraps the output table in logical tiles and returns the first one.
+ * @return true if there is a result tile, false otherwise.
+ */
+bool AggregateExecutor::ReturnResult() {
   // Transform output table into result
   auto tile_group_count = output_table->GetTileGroupCount();
 
@@ -11,11 +11,15 @@
 //===----------------------------------------------------------------------===//
 
 
+#include <future>
 #include <set>
 
 #include "executor/aggregator.h"
 #include "executor/executor_context.h"
 #include "common/logger.h"
+#include "common/thread_pool.h"
+#include "common/value_peeker.h"
+#include "expression/tuple_value_expression.h"
 #include "storage/data_table.h"
 #include "concurrency/transaction_manager_factory.h"
 
@@ -90,28 +94,16 @@ Value Agg::Finalize() {
  * used to retrieve pass-through values;
  * Right is the tuple holding all aggregated values.
  */
-bool Helper(const planner::AggregatePlan *node, Agg **aggregates,
-            storage::DataTable *output_table,
-            const AbstractTuple *delegate_tuple,
-            executor::ExecutorContext *econtext) {
+bool InsertAggregateTuple(const planner::AggregatePlan *node,
+                          std::vector<Value> &aggregate_values,
+                          storage::DataTable *output_table,
+                          const AbstractTuple *delegate_tuple,
+                          executor::ExecutorContext *econtext) {
   auto schema = output_table->GetSchema();
   std::unique_ptr<storage::Tuple> tuple(new storage::Tuple(schema, true));
 
   /*
-   * 1) Construct a vector of aggregated values
-   */
-  std::vector<Value> aggregate_values;
-  auto &aggregate_terms = node->GetUniqueAggTerms();
-  for (oid_t column_itr = 0; column_itr < aggregate_terms.size();
-       column_itr++) {
-    if (aggregates[column_itr] != nullptr) {
-      Value final_val = aggregates[column_itr]->Finalize();
-      aggregate_values.push_back(final_val);
-    }
-  }
-
-  /*
-   * 2) Evaluate filter predicate;
+   * 1) Evaluate filter predicate;
    * if fail, just return
    */
   std::unique_ptr<expression::ContainerTuple<std::vector<Value>>> aggref_tuple(
@@ -125,7 +117,7 @@ bool Helper(const planner::AggregatePlan *node, Agg **aggregates,
   }
 
   /*
-   * 3) Construct the tuple to insert using projectInfo
+   * 2) Construct the tuple to insert using projectInfo
    */
   node->GetProjectInfo()->Evaluate(tuple.get(), delegate_tuple,
                                    aggref_tuple.get(), econtext);
@@ -146,6 +138,201 @@ bool Helper(const planner::AggregatePlan *node, Agg **aggregates,
   return true;
 }
 
+/*
+ * Finalize the aggregates of a group and insert its output tuple
+ */
+bool Helper(const planner::AggregatePlan *node, Agg **aggregates,
+            storage::DataTable *output_table,
+            const AbstractTuple *delegate_tuple,
+            executor::ExecutorContext *econtext) {
+  // Construct a vector of aggregated values
+  std::vector<Value> aggregate_values;
+  auto &aggregate_terms = node->GetUniqueAggTerms();
+  for (oid_t column_itr = 0; column_itr < aggregate_terms.size();
+       column_itr++) {
+    if (aggregates[column_itr] != nullptr) {
+      Value final_val = aggregates[column_itr]->Finalize();
+      aggregate_values.push_back(final_val);
+    }
+  }
+
+  return InsertAggregateTuple(node, aggregate_values, output_table,
+                              delegate_tuple, econtext);
+}
+
+//===--------------------------------------------------------------------===//
+// Typed Aggregate
+//===--------------------------------------------------------------------===//
+
+bool TypedAgg::IsSupported(const planner::AggregatePlan::AggTerm &agg_term) {
+  if (agg_term.distinct) {
+    return false;
+  }
+
+  switch (agg_term.aggtype) {
+    case EXPRESSION_TYPE_AGGREGATE_COUNT_STAR:
+      return true;
+    case EXPRESSION_TYPE_AGGREGATE_COUNT:
+    case EXPRESSION_TYPE_AGGREGATE_SUM:
+    case EXPRESSION_TYPE_AGGREGATE_AVG:
+    case EXPRESSION_TYPE_AGGREGATE_MIN:
+    case EXPRESSION_TYPE_AGGREGATE_MAX:
+      break;
+    default:
+      return false;
+  }
+
+  // The input must be a fixed-width numeric column of the input tuple
+  auto expression = agg_term.expression;
+  if (expression == nullptr ||
+      expression->GetExpressionType() != EXPRESSION_TYPE_VALUE_TUPLE ||
+      static_cast<const expression::TupleValueExpression *>(expression)
+              ->GetTupleIdx() != 0) {
+    return false;
+  }
+
+  switch (expression->GetValueType()) {
+    case VALUE_TYPE_TINYINT:
+    case VALUE_TYPE_SMALLINT:
+    case VALUE_TYPE_INTEGER:
+    case VALUE_TYPE_BIGINT:
+    case VALUE_TYPE_DOUBLE:
+      return true;
+    default:
+      return false;
+  }
+}
+
+void TypedAgg::AddInteger(int64_t val) {
+  if (__builtin_add_overflow(int_aggregate, val, &int_aggregate)) {
+    char message[4096];
+    snprintf(message, 4096, "Adding %jd will overflow BigInt storage",
+             (intmax_t)val);
+    throw Exception(message);
+  }
+}
+
+void TypedAgg::Advance(const Value &val) {
+  if (agg_type == EXPRESSION_TYPE_AGGREGATE_COUNT_STAR) {
+    count++;
+    return;
+  }
+  if (val.IsNull()) {
+    return;
+  }
+
+  switch (agg_type) {
+    case EXPRESSION_TYPE_AGGREGATE_SUM:
+    case EXPRESSION_TYPE_AGGREGATE_AVG:
+      if (IsDouble()) {
+        double_aggregate += ValuePeeker::PeekDouble(val);
+      } else {
+        AddInteger(ValuePeeker::PeekAsRawInt64(val));
+      }
+      break;
+    case EXPRESSION_TYPE_AGGREGATE_MIN:
+    case EXPRESSION_TYPE_AGGREGATE_MAX: {
+      bool is_max = (agg_type == EXPRESSION_TYPE_AGGREGATE_MAX);
+      if (IsDouble()) {
+        double cur_val = ValuePeeker::PeekDouble(val);
+        if (count == 0 || (is_max ? cur_val > double_aggregate
+                                  : cur_val < double_aggregate)) {
+          double_aggregate = cur_val;
+        }
+      } else {
+        int64_t cur_val = ValuePeeker::PeekAsRawInt64(val);
+        if (count == 0 ||
+            (is_max ? cur_val > int_aggregate : cur_val < int_aggregate)) {
+          int_aggregate = cur_val;
+        }
+      }
+    } break;
+    default:
+      break;
+  }
+
+  count++;
+}
+
+void TypedAgg::Merge(const TypedAgg &other) {
+  PL_ASSERT(agg_type == other.agg_type);
+  if (other.count == 0) {
+    return;
+  }
+
+  switch (agg_type) {
+    case EXPRESSION_TYPE_AGGREGATE_SUM:
+    case EXPRESSION_TYPE_AGGREGATE_AVG:
+      if (IsDouble()) {
+        double_aggregate += other.double_aggregate;
+      } else {
+        AddInteger(other.int_aggregate);
+      }
+      break;
+    case EXPRESSION_TYPE_AGGREGATE_MIN:
+    case EXPRESSION_TYPE_AGGREGATE_MAX: {
+      bool is_max = (agg_type == EXPRESSION_TYPE_AGGREGATE_MAX);
+      if (IsDouble()) {
+        if (count == 0 || (is_max ? other.double_aggregate > double_aggregate
+                                  : other.double_aggregate < double_aggregate)) {
+          double_aggregate = other.double_aggregate;
+        }
+      } else {
+        if (count == 0 || (is_max ? other.int_aggregate > int_aggregate
+                                  : other.int_aggregate < int_aggregate)) {
+          int_aggregate = other.int_aggregate;
+        }
+      }
+    } break;
+    default:
+      break;
+  }
+
+  count += other.count;
+}
+
+Value TypedAgg::Finalize() const {
+  switch (agg_type) {
+    case EXPRESSION_TYPE_AGGREGATE_COUNT:
+    case EXPRESSION_TYPE_AGGREGATE_COUNT_STAR:
+      return ValueFactory::GetBigIntValue(count);
+    default:
+      break;
+  }
+
+  if (count == 0) {
+    return ValueFactory::GetNullValue();
+  }
+
+  switch (agg_type) {
+    case EXPRESSION_TYPE_AGGREGATE_SUM:
+      return IsDouble() ? ValueFactory::GetDoubleValue(double_aggregate)
+                        : ValueFactory::GetBigIntValue(int_aggregate);
+    case EXPRESSION_TYPE_AGGREGATE_AVG:
+      return ValueFactory::GetDoubleValue(
+          (IsDouble() ? double_aggregate
+                      : static_cast<double>(int_aggregate)) /
+          static_cast<double>(count));
+    default:
+      break;
+  }
+
+  // MIN and MAX keep the type of their input
+  switch (value_type) {
+    case VALUE_TYPE_TINYINT:
+      return ValueFactory::GetTinyIntValue(static_cast<int8_t>(int_aggregate));
+    case VALUE_TYPE_SMALLINT:
+      return ValueFactory::GetSmallIntValue(
+          static_cast<int16_t>(int_aggregate));
+    case VALUE_TYPE_INTEGER:
+      return ValueFactory::GetIntegerValue(static_cast<int32_t>(int_aggregate));
+    case VALUE_TYPE_DOUBLE:
+      return ValueFactory::GetDoubleValue(double_aggregate);
+    default:
+      return ValueFactory::GetBigIntValue(int_aggregate);
+  }
+}
+
 //===--------------------------------------------------------------------===//
 // Hash Aggregator
 //===--------------------------------------------------------------------===//
@@ -406,5 +593,196 @@ PlainAggregator::~PlainAggregator() {
   delete[] aggregates;
 }
 
+//===--------------------------------------------------------------------===//
+// Parallel Hash Aggregator
+//===--------------------------------------------------------------------===//
+
+namespace {
+
+// Workers shared by all parallel aggregations
+ThreadPool &GetAggregateThreadPool() {
+  static ThreadPool aggregate_thread_pool;
+  return aggregate_thread_pool;
+}
+
+// Wait for all the tasks before rethrowing the first exception of a worker,
+// the other workers still use the tables of the caller until they are done
+void WaitForTasks(std::vector<std::future<void>> &tasks) {
+  for (auto &task : tasks) {
+    task.wait();
+  }
+  for (auto &task : tasks) {
+    task.get();
+  }
+}
+}
+
+ParallelHashAggregator::ParallelHashAggregator(
+    const planner::AggregatePlan *node, storage::DataTable *output_table,
+    executor::ExecutorContext *econtext, size_t num_input_columns)
+    : node(node),
+      output_table(output_table),
+      executor_context(econtext),
+      num_input_columns(num_input_columns) {
+  PL_ASSERT(IsSupported(node));
+
+  for (auto &agg_term : node->GetUniqueAggTerms()) {
+    if (agg_term.aggtype == EXPRESSION_TYPE_AGGREGATE_COUNT_STAR) {
+      aggregate_column_ids.push_back(INVALID_OID);
+    } else {
+      auto tuple_value =
+          static_cast<const expression::TupleValueExpression *>(
+              agg_term.expression);
+      aggregate_column_ids.push_back(tuple_value->GetColumnId());
+    }
+  }
+}
+
+bool ParallelHashAggregator::IsSupported(const planner::AggregatePlan *node) {
+  if (node->GetGroupbyColIds().empty()) {
+    return false;
+  }
+  for (auto &agg_term : node->GetUniqueAggTerms()) {
+    if (TypedAgg::IsSupported(agg_term) == false) {
+      return false;
+    }
+  }
+  return true;
+}
+
+void ParallelHashAggregator::AggregateMorsels(
+    const std::vector<std::unique_ptr<LogicalTile>> &tiles,
+    std::atomic<size_t> &next_morsel, PartitionedTable &table) {
+  auto &agg_terms = node->GetUniqueAggTerms();
+  auto &group_by_col_ids = node->GetGroupbyColIds();
+  ValueVectorHasher hasher;
+  std::vector<Value> group_by_key_values;
+
+  for (size_t morsel = next_morsel++; morsel < tiles.size();
+       morsel = next_morsel++) {
+    auto tile = tiles[morsel].get();
+
+    for (oid_t tuple_id : *tile) {
+      // Find the group in the partition its key hashes to
+      group_by_key_values.clear();
+      for (auto column_id : group_by_col_ids) {
+        group_by_key_values.push_back(tile->GetValue(tuple_id, column_id));
+      }
+      auto &partition = table[hasher(group_by_key_values) % table.size()];
+      auto map_itr = partition.find(group_by_key_values);
+
+      GroupEntry *group_entry;
+      if (map_itr == partition.end()) {
+        // Keys and pass-through values must outlive the input tiles
+        std::unique_ptr<GroupEntry> new_entry(new GroupEntry());
+        for (size_t col_id = 0; col_id < num_input_columns; col_id++) {
+          new_entry->first_tuple_values.push_back(
+              ValueFactory::Clone(tile->GetValue(tuple_id, col_id), nullptr));
+        }
+        for (auto &agg_term : agg_terms) {
+          auto value_type = (agg_term.expression != nullptr)
+                                ? agg_term.expression->GetValueType()
+                                : VALUE_TYPE_BIGINT;
+          new_entry->aggregates.emplace_back(agg_term.aggtype, value_type);
+        }
+
+        std::vector<Value> group_by_key;
+        for (auto column_id : group_by_col_ids) {
+          group_by_key.push_back(new_entry->first_tuple_values[column_id]);
+        }
+        group_entry = new_entry.get();
+        partition.emplace(std::move(group_by_key), std::move(new_entry));
+      } else {
+        group_entry = map_itr->second.get();
+      }
+
+      // Update the aggregation calculation
+      for (size_t aggno = 0; aggno < aggregate_column_ids.size(); aggno++) {
+        auto column_id = aggregate_column_ids[aggno];
+        if (column_id == INVALID_OID) {
+          group_entry->aggregates[aggno].Advance(Value());
+        } else {
+          group_entry->aggregates[aggno].Advance(
+              tile->GetValue(tuple_id, column_id));
+        }
+      }
+    }
+  }
+}
+
+void ParallelHashAggregator::MergePartition(
+    std::vector<PartitionedTable> &tables, size_t partition) {
+  // Merge the partition of every worker into the one of the first worker
+  auto &merged = tables[0][partition];
+
+  for (size_t table_itr = 1; table_itr < tables.size(); table_itr++) {
+    for (auto &entry : tables[table_itr][partition]) {
+      auto map_itr = merged.find(entry.first);
+      if (map_itr == merged.end()) {
+        merged.emplace(entry.first, std::move(entry.second));
+        continue;
+      }
+
+      auto &aggregates = map_itr->second->aggregates;
+      for (size_t aggno = 0; aggno < aggregates.size(); aggno++) {
+        aggregates[aggno].Merge(entry.second->aggregates[aggno]);
+      }
+    }
+    tables[table_itr][partition].clear();
+  }
+}
+
+bool ParallelHashAggregator::Execute(
+    const std::vector<std::unique_ptr<LogicalTile>> &tiles) {
+  auto &thread_pool = GetAggregateThreadPool();
+  size_t worker_count = std::max<size_t>(
+      1, std::min(thread_pool.GetNumThreads(), tiles.size()));
+  size_t partition_count = worker_count;
+
+  std::vector<PartitionedTable> tables(worker_count);
+  for (auto &table : tables) {
+    table.resize(partition_count);
+  }
+
+  // Phase 1 : pre-aggregate the morsels
+  std::atomic<size_t> next_morsel(0);
+  std::vector<std::future<void>> tasks;
+  for (size_t worker_itr = 0; worker_itr < worker_count; worker_itr++) {
+    tasks.push_back(thread_pool.Enqueue(
+        &ParallelHashAggregator::AggregateMorsels, this, std::cref(tiles),
+        std::ref(next_morsel), std::ref(tables[worker_itr])));
+  }
+  WaitForTasks(tasks);
+
+  // Phase 2 : merge the partitions
+  tasks.clear();
+  for (size_t partition = 0; partition < partition_count; partition++) {
+    tasks.push_back(thread_pool.Enqueue(&ParallelHashAggregator::MergePartition,
+                                        this, std::ref(tables), partition));
+  }
+  WaitForTasks(tasks);
+
+  // Phase 3 : output the groups
+  std::vector<Value> aggregate_values;
+  for (auto &partition : tables[0]) {
+    LOG_TRACE("Partition holds %lu groups", partition.size());
+    for (auto &entry : partition) {
+      aggregate_values.clear();
+      for (auto &aggregate : entry.second->aggregates) {
+        aggregate_values.push_back(aggregate.Finalize());
+      }
+
+      expression::ContainerTuple<std::vector<Value>> first_tuple(
+          &entry.second->first_tuple_values);
+      if (InsertAggregateTuple(node, aggregate_values, output_table,
+                               &first_tuple, executor_context) == false) {
+        return false;
+      }
+    }
+  }
+
+  return true;
+}
+
 }  // namespace executor
 }  // namespace peloton
@@ -46,8 +46,6 @@ bool DeleteExecutor::DInit() {
   PL_ASSERT(children_.size() == 1);
   PL_ASSERT(executor_context_);
 
-  PL_ASSERT(target_table_ == nullptr);
-
   // Delete tuples in logical tile
   LOG_TRACE("Delete executor :: 1 child ");
 
@@ -76,12 +74,24 @@ bool DeleteExecutor::DExecute() {
   auto &pos_lists = source_tile.get()->GetPositionLists();
   storage::Tile *tile = source_tile->GetBaseTile(0);
   storage::TileGroup *tile_group = tile->GetTileGroup();
-  storage::TileGroupHeader *tile_group_header = tile_group->GetHeader();
-
-  auto tile_group_id = tile_group->GetTileGroupId();
   auto &transaction_manager =
       concurrency::TransactionManagerFactory::GetInstance();
 
+  // Versions rebuilt from delta chains are not the latest versions
+  if (tile_group == nullptr) {
+    LOG_TRACE("Fail to delete an older version. Set txn failure.");
+    transaction_manager.SetTransactionResult(Result::RESULT_FAILURE);
+    return false;
+  }
+
+  storage::TileGroupHeader *tile_group_header = tile_group->GetHeader();
+  auto tile_group_id = tile_group->GetTileGroupId();
+
+  // Tuples updated in place are owned without a newer version
+  bool delta_storage =
+      (concurrency::TransactionManagerFactory::GetVersionStorage() ==
+       VERSION_STORAGE_TYPE_DELTA);
+
   LOG_INFO("Source tile : %p Tuples : %lu ", source_tile.get(),
             source_tile->GetTupleCount());
 
@@ -99,8 +109,26 @@ bool DeleteExecutor::DExecute() {
     LOG_INFO("Visible Tuple id : %u, Physical Tuple id : %u ",
               visible_tuple_id, physical_tuple_id);
 
-    if (transaction_manager.IsOwner(tile_group_header, physical_tuple_id) ==
-        true) {
+    if (delta_storage == true &&
+        transaction_manager.IsOwner(tile_group_header, physical_tuple_id) ==
+            true &&
+        tile_group_header->GetBeginCommitId(physical_tuple_id) != MAX_CID) {
+      // the tuple was updated in place by the transaction, so it is still the
+      // committed version and needs an empty version like any other one.
+      std::unique_ptr<storage::Tuple> new_tuple(
+          new storage::Tuple(target_table_->GetSchema(), true));
+      ItemPointer new_location =
+          target_table_->InsertEmptyVersion(new_tuple.get());
+
+      if (new_location.IsNull() == true) {
+        LOG_TRACE("Fail to insert new tuple. Set txn failure.");
+        transaction_manager.SetTransactionResult(Result::RESULT_FAILURE);
+        return false;
+      }
+      transaction_manager.PerformDelete(old_location, new_location);
+
+    } else if (transaction_manager.IsOwner(tile_group_header,
+                                           physical_tuple_id) == true) {
       // if the thread is the owner of the tuple, then directly update in place.
       LOG_INFO("Thread is owner of the tuple");
       transaction_manager.PerformDelete(old_location);
@@ -13,6 +13,8 @@
 
 #include "common/value.h"
 #include "executor/executor_context.h"
+#include "storage/tile_group.h"
+#include "storage/tile_group_header.h"
 
 namespace peloton {
 namespace executor {
@@ -28,6 +30,19 @@ ExecutorContext::ExecutorContext(concurrency::Transaction *transaction,
 
 ExecutorContext::~ExecutorContext() {
   // params will be freed automatically
+  UnpinTileGroups();
+}
+
+void ExecutorContext::Reset(concurrency::Transaction *transaction,
+                            const std::vector<Value> &params) {
+  transaction_ = transaction;
+  params_ = params;
+  params_exec_flag_ = INVALID_FLAG;
+  num_processed = 0;
+  UnpinTileGroups();
+
+  // keep the chunks of the pool for the next execution
+  if (pool_.get() != nullptr) pool_->Purge();
 }
 
 VarlenPool *ExecutorContext::GetExecutorContextPool() {
@@ -38,5 +53,21 @@ VarlenPool *ExecutorContext::GetExecutorContextPool() {
   return pool_.get();
 }
 
+void ExecutorContext::PinTileGroup(
+    const std::shared_ptr<storage::TileGroup> &tile_group) {
+  auto tile_group_id = tile_group->GetTileGroupId();
+  if (IsTileGroupPinned(tile_group_id)) return;
+
+  tile_group->GetHeader()->Pin();
+  pinned_tile_groups_.emplace(tile_group_id, tile_group);
+}
+
+void ExecutorContext::UnpinTileGroups() {
+  for (auto &pinned_tile_group : pinned_tile_groups_) {
+    pinned_tile_group.second->GetHeader()->Unpin();
+  }
+  pinned_tile_groups_.clear();
+}
+
 }  // namespace executor
 }  // namespace peloton
@@ -51,9 +51,14 @@ bool HashExecutor::DExecute() {
   if (done_ == false) {
     const planner::HashPlan &node = GetPlanNode<planner::HashPlan>();
 
-    // First, get all the input logical tiles
+    // First, get all the input logical tiles. Empty tiles are dropped here,
+    // so that the tile offsets in the hash table match the tiles returned
+    // to the parent.
     while (children_[0]->Execute()) {
-      child_tiles_.emplace_back(children_[0]->GetOutput());
+      std::unique_ptr<LogicalTile> child_tile(children_[0]->GetOutput());
+      if (child_tile->GetTupleCount() > 0) {
+        child_tiles_.push_back(std::move(child_tile));
+      }
     }
 
     if (child_tiles_.size() == 0) {
@@ -78,34 +83,18 @@ bool HashExecutor::DExecute() {
       column_ids_.push_back(tuple_value->GetColumnId());
     }
 
-    // Construct the hash table by going over each child logical tile and
-    // hashing
-    for (size_t child_tile_itr = 0; child_tile_itr < child_tiles_.size();
-         child_tile_itr++) {
-      auto tile = child_tiles_[child_tile_itr].get();
-
-      // Go over all tuples in the logical tile
-      for (oid_t tuple_id : *tile) {
-        // Key : container tuple with a subset of tuple attributes
-        // Value : < child_tile offset, tuple offset >
-        hash_table_[HashMapType::key_type(tile, tuple_id, &column_ids_)].insert(
-            std::make_pair(child_tile_itr, tuple_id));
-      }
-    }
+    // Construct the hash table over all the child logical tiles at once, so
+    // that it is sized for all their tuples up front
+    hash_table_.Build(child_tiles_, &column_ids_);
 
     done_ = true;
   }
 
   // Return logical tiles one at a time
-  while (result_itr < child_tiles_.size()) {
-    if (child_tiles_[result_itr]->GetTupleCount() == 0) {
-      result_itr++;
-      continue;
-    } else {
-      SetOutput(child_tiles_[result_itr++].release());
-      LOG_TRACE("Hash Executor : true -- return tile one at a time ");
-      return true;
-    }
+  if (result_itr < child_tiles_.size()) {
+    SetOutput(child_tiles_[result_itr++].release());
+    LOG_TRACE("Hash Executor : true -- return tile one at a time ");
+    return true;
   }
 
   LOG_TRACE("Hash Executor : false -- done ");
@@ -11,6 +11,7 @@
 //===----------------------------------------------------------------------===//
 
 
+#include <algorithm>
 #include <vector>
 
 #include "common/types.h"
@@ -109,21 +110,48 @@ bool HashJoinExecutor::DExecute() {
     std::unique_ptr<LogicalTile> output_tile;
     LogicalTile::PositionListsBuilder pos_lists_builder;
 
-    // Go over the left tile
-    for (auto left_tile_itr : *left_tile) {
-      const expression::ContainerTuple<executor::LogicalTile> left_tuple(
-          left_tile, left_tile_itr, &hashed_col_ids);
+    // Go over the left tile a batch at a time. The keys of a batch are all
+    // hashed, and their slots prefetched, before the first one is probed.
+    std::vector<oid_t> left_tuple_ids;
+    left_tuple_ids.reserve(left_tile->GetTupleCount());
+    for (oid_t left_tile_itr : *left_tile) {
+      left_tuple_ids.push_back(left_tile_itr);
+    }
+    size_t probe_hashes[HASH_JOIN_PROBE_BATCH_SIZE];
+
+    for (size_t batch_begin = 0; batch_begin < left_tuple_ids.size();
+         batch_begin += HASH_JOIN_PROBE_BATCH_SIZE) {
+      size_t batch_size = std::min<size_t>(HASH_JOIN_PROBE_BATCH_SIZE,
+                                           left_tuple_ids.size() - batch_begin);
+
+      for (size_t batch_itr = 0; batch_itr < batch_size; batch_itr++) {
+        const JoinHashTable::KeyType left_tuple(
+            left_tile, left_tuple_ids[batch_begin + batch_itr],
+            &hashed_col_ids);
+        probe_hashes[batch_itr] = JoinHashTable::HashKey(left_tuple);
+        hash_table.Prefetch(probe_hashes[batch_itr]);
+      }
 
-      // Find matching tuples in the hash table built on top of the right table
-      auto right_tuples = hash_table.find(left_tuple);
+      for (size_t batch_itr = 0; batch_itr < batch_size; batch_itr++) {
+        oid_t left_tile_itr = left_tuple_ids[batch_begin + batch_itr];
+        const JoinHashTable::KeyType left_tuple(left_tile, left_tile_itr,
+                                                &hashed_col_ids);
+
+        // Find matching tuples in the hash table built on top of the right
+        // table
+        auto right_tuples =
+            hash_table.Find(left_tuple, probe_hashes[batch_itr]);
+        if (right_tuples.first == right_tuples.second) {
+          continue;
+        }
 
-      if (right_tuples != hash_table.end()) {
         RecordMatchedLeftRow(left_result_tiles_.size() - 1, left_tile_itr);
 
         // Go over the matching right tuples
-        for (auto &location : right_tuples->second) {
+        for (auto location = right_tuples.first;
+             location != right_tuples.second; location++) {
           // Check if we got a new right tile itr
-          if (prev_tile != location.first) {
+          if (prev_tile != location->first) {
             // Check if we have any join tuples
             if (pos_lists_builder.Size() > 0) {
               LOG_TRACE("Join tile size : %lu \n", pos_lists_builder.Size());
@@ -133,7 +161,8 @@ bool HashJoinExecutor::DExecute() {
             }
 
             // Get the logical tile from right child
-            LogicalTile *right_tile = right_result_tiles_[location.first].get();
+            LogicalTile *right_tile =
+                right_result_tiles_[location->first].get();
 
             // Build output logical tile
             output_tile = BuildOutputLogicalTile(left_tile, right_tile);
@@ -143,16 +172,16 @@ bool HashJoinExecutor::DExecute() {
                 LogicalTile::PositionListsBuilder(left_tile, right_tile);
 
             pos_lists_builder.SetRightSource(
-                &right_result_tiles_[location.first]->GetPositionLists());
+                &right_result_tiles_[location->first]->GetPositionLists());
           }
 
           // Add join tuple
-          pos_lists_builder.AddRow(left_tile_itr, location.second);
+          pos_lists_builder.AddRow(left_tile_itr, location->second);
 
-          RecordMatchedRightRow(location.first, location.second);
+          RecordMatchedRightRow(location->first, location->second);
 
           // Cache prev logical tile itr
-          prev_tile = location.first;
+          prev_tile = location->first;
         }
       }
     }
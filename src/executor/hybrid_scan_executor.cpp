@@ -11,6 +11,8 @@
 //===----------------------------------------------------------------------===//
 
 
+#include <algorithm>
+#include <iterator>
 #include <memory>
 #include <utility>
 #include <vector>
@@ -50,6 +52,13 @@ bool HybridScanExecutor::DInit() {
 
   if (!status) return false;
 
+  // the hybrid scan reads tuples in place and does not walk delta chains
+  if (concurrency::TransactionManagerFactory::GetVersionStorage() ==
+      VERSION_STORAGE_TYPE_DELTA) {
+    LOG_ERROR("Hybrid scan is not supported with delta version storage");
+    return false;
+  }
+
   const planner::HybridScanPlan &node = GetPlanNode<planner::HybridScanPlan>();
 
   table_ = node.GetTable();
@@ -199,8 +208,21 @@ bool HybridScanExecutor::SeqScanUtil() {
       upper_bound_block = reverse_iter->block;
     }
 
+    // Check transaction visibility of the whole tile group at once
+    std::vector<oid_t> visible_list;
+    transaction_manager.GetVisibleTuples(tile_group_header, active_tuple_count,
+                                         visible_list);
+
     std::vector<oid_t> position_list;
+    std::vector<oid_t> invisible_list;
+    auto visible_itr = visible_list.begin();
     for (oid_t tuple_id = 0; tuple_id < active_tuple_count; tuple_id++) {
+      bool visible =
+          (visible_itr != visible_list.end() && *visible_itr == tuple_id);
+      if (visible) {
+        visible_itr++;
+      }
+
       ItemPointer location(tile_group->GetTileGroupId(), tuple_id);
       if (type_ == HYBRID_SCAN_TYPE_HYBRID && item_pointers_.size() > 0 &&
           location.block <= upper_bound_block) {
@@ -209,37 +231,36 @@ bool HybridScanExecutor::SeqScanUtil() {
         }
       }
 
-      // Check transaction visibility
-      if (transaction_manager.IsVisible(tile_group_header, tuple_id)) {
-        // If the tuple is visible, then perform predicate evaluation.
-        if (predicate_ == nullptr) {
-          position_list.push_back(tuple_id);
-        }
-        else {
-          expression::ContainerTuple<storage::TileGroup> tuple(tile_group.get(),
-                                                               tuple_id);
-          auto eval = predicate_->Evaluate(&tuple, nullptr, executor_context_).IsTrue();
-          if (eval == true) {
-            position_list.push_back(tuple_id);
-          }
-        }
-      }
-      else {
-        expression::ContainerTuple<storage::TileGroup> tuple(tile_group.get(),
-                                                             tuple_id);
-        auto eval =
-            predicate_->Evaluate(&tuple, nullptr, executor_context_).IsTrue();
-        if (eval == true) {
-          position_list.push_back(tuple_id);
-          auto res = transaction_manager.PerformRead(location);
-          if (!res) {
-            transaction_manager.SetTransactionResult(RESULT_FAILURE);
-            return res;
-          }
-        }
+      if (visible) {
+        position_list.push_back(tuple_id);
+      } else if (predicate_ != nullptr) {
+        invisible_list.push_back(tuple_id);
       }
     }
 
+    // Evaluate the predicate over the whole batch of tuples.
+    if (predicate_ != nullptr) {
+      predicate_->EvaluateBatch(tile_group.get(), position_list,
+                                executor_context_);
+      predicate_->EvaluateBatch(tile_group.get(), invisible_list,
+                                executor_context_);
+    }
+
+    auto res = transaction_manager.PerformReads(
+        tile_group->GetTileGroupId(), tile_group_header, invisible_list);
+    if (!res) {
+      transaction_manager.SetTransactionResult(RESULT_FAILURE);
+      return res;
+    }
+
+    if (invisible_list.empty() == false) {
+      std::vector<oid_t> visible_list;
+      visible_list.swap(position_list);
+      std::merge(visible_list.begin(), visible_list.end(),
+                 invisible_list.begin(), invisible_list.end(),
+                 std::back_inserter(position_list));
+    }
+
     // Don't return empty tiles
     if (position_list.size() == 0) {
       continue;
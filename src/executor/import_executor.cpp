@@ -0,0 +1,545 @@
+//===----------------------------------------------------------------------===//
+//
+//                         Peloton
+//
+// import_executor.cpp
+//
+// Identification: src/executor/import_executor.cpp
+//
+// Copyright (c) 2015-16, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+
+#include <algorithm>
+#include <cerrno>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <thread>
+
+#include "catalog/bootstrapper.h"
+#include "catalog/catalog.h"
+#include "common/exception.h"
+#include "common/logger.h"
+#include "common/pool.h"
+#include "common/value_factory.h"
+#include "concurrency/transaction.h"
+#include "concurrency/transaction_manager_factory.h"
+#include "executor/import_executor.h"
+#include "index/index.h"
+#include "logging/log_manager.h"
+#include "storage/data_table.h"
+#include "storage/database.h"
+#include "storage/tile_group.h"
+#include "storage/tile_group_header.h"
+#include "storage/tuple.h"
+
+namespace peloton {
+namespace executor {
+
+size_t ImportExecutor::worker_count_ = 0;
+
+//===--------------------------------------------------------------------===//
+// Record parsing
+//===--------------------------------------------------------------------===//
+
+/**
+ * @brief Split a record into its fields. A field may be enclosed in double
+ * quotes, inside which a doubled quote stands for a single quote and the
+ * delimiter is part of the field. An empty unquoted field is NULL.
+ * @return false if the quoting of the record is malformed
+ */
+static bool SplitRecord(const char *begin, const char *end, char delimiter,
+                        std::vector<std::string> &fields,
+                        std::vector<bool> &nulls) {
+  fields.clear();
+  nulls.clear();
+
+  const char *position = begin;
+  while (true) {
+    std::string field;
+    bool quoted = false;
+
+    if (position < end && *position == '"') {
+      quoted = true;
+      position++;
+      while (true) {
+        if (position == end) return false;
+        if (*position == '"') {
+          if (position + 1 < end && position[1] == '"') {
+            field.push_back('"');
+            position += 2;
+            continue;
+          }
+          position++;
+          break;
+        }
+        field.push_back(*position++);
+      }
+      if (position < end && *position != delimiter) return false;
+    } else {
+      auto field_end = static_cast<const char *>(
+          memchr(position, delimiter, end - position));
+      if (field_end == nullptr) field_end = end;
+      field.assign(position, field_end);
+      position = field_end;
+    }
+
+    nulls.push_back(quoted == false && field.empty());
+    fields.push_back(std::move(field));
+
+    if (position == end) return true;
+    // skip the delimiter
+    position++;
+  }
+}
+
+/**
+ * @brief Convert the text of a field to a value of the given type. Numbers
+ * must span the whole field.
+ */
+static Value ParseValue(ValueType type, const std::string &field,
+                        VarlenPool *pool) {
+  switch (type) {
+    case VALUE_TYPE_TINYINT:
+    case VALUE_TYPE_SMALLINT:
+    case VALUE_TYPE_INTEGER:
+    case VALUE_TYPE_BIGINT:
+    case VALUE_TYPE_TIMESTAMP: {
+      char *number_end = nullptr;
+      errno = 0;
+      int64_t number = strtoll(field.c_str(), &number_end, 10);
+      if (number_end == field.c_str() || *number_end != '\0' || errno != 0) {
+        throw ConversionException("Invalid integer value : " + field);
+      }
+      return ValueFactory::GetBigIntValue(number).CastAs(type);
+    }
+    case VALUE_TYPE_DOUBLE: {
+      char *number_end = nullptr;
+      double number = strtod(field.c_str(), &number_end);
+      if (number_end == field.c_str() || *number_end != '\0') {
+        throw ConversionException("Invalid double value : " + field);
+      }
+      return ValueFactory::GetDoubleValue(number);
+    }
+    case VALUE_TYPE_BOOLEAN: {
+      if (field == "t" || field == "true" || field == "1") {
+        return ValueFactory::GetBooleanValue(true);
+      } else if (field == "f" || field == "false" || field == "0") {
+        return ValueFactory::GetBooleanValue(false);
+      }
+      throw ConversionException("Invalid boolean value : " + field);
+    }
+    default:
+      return ValueFactory::ValueFromSQLDefaultType(type, field, pool);
+  }
+}
+
+//===--------------------------------------------------------------------===//
+// Executor
+//===--------------------------------------------------------------------===//
+
+/**
+ * @brief Constructor for import executor.
+ * @param node Import node corresponding to this executor.
+ */
+ImportExecutor::ImportExecutor(const planner::AbstractPlan *node,
+                               ExecutorContext *executor_context)
+    : AbstractExecutor(node, executor_context) {}
+
+size_t ImportExecutor::GetWorkerCount() {
+  if (worker_count_ != 0) return worker_count_;
+  return std::max(std::thread::hardware_concurrency(), 1u);
+}
+
+/**
+ * @brief Resolve the target table.
+ * @return true on success, false otherwise.
+ */
+bool ImportExecutor::DInit() {
+  PL_ASSERT(children_.size() == 0);
+
+  const planner::ImportPlan &node = GetPlanNode<planner::ImportPlan>();
+  delimiter_ = node.GetDelimiter();
+  loaded_tuple_count_ = 0;
+
+  target_table_ = node.GetTable();
+  if (target_table_ == nullptr) {
+    catalog::Bootstrapper::bootstrap();
+    auto database = catalog::Bootstrapper::global_catalog->GetDatabaseWithName(
+        "default_database");
+    if (database != nullptr) {
+      target_table_ = database->GetTableWithName(node.GetTableName());
+    }
+  }
+
+  if (target_table_ == nullptr) {
+    LOG_ERROR("Import target table %s does not exist",
+              node.GetTableName().c_str());
+    return false;
+  }
+
+  return true;
+}
+
+/**
+ * @brief Load the whole file into the target table, one batch at a time.
+ * @return false, the executor produces no output.
+ */
+bool ImportExecutor::DExecute() {
+  const planner::ImportPlan &node = GetPlanNode<planner::ImportPlan>();
+  auto file_path = node.GetFilePath();
+
+  FILE *file = fopen(file_path.c_str(), "rb");
+  if (file == nullptr) {
+    throw ExecutorException("Failed to open import file " + file_path);
+  }
+
+  std::vector<char> buffer(IMPORT_BATCH_SIZE);
+  // Bytes in the buffer, the tail after the last batch is carried over
+  size_t length = 0;
+
+  try {
+    while (true) {
+      length += fread(buffer.data() + length, 1, buffer.size() - length, file);
+      if (ferror(file)) {
+        throw ExecutorException("Failed to read import file " + file_path);
+      }
+
+      bool at_end = (length < buffer.size());
+      if (length == 0) break;
+
+      // A batch only holds complete records
+      size_t batch_length = length;
+      if (at_end == false) {
+        auto last_line_end = static_cast<const char *>(
+            memrchr(buffer.data(), '\n', length));
+        if (last_line_end == nullptr) {
+          // the record does not fit in the buffer
+          buffer.resize(buffer.size() * 2);
+          continue;
+        }
+        batch_length = last_line_end - buffer.data() + 1;
+      }
+
+      LoadBatch(buffer, batch_length);
+
+      memmove(buffer.data(), buffer.data() + batch_length,
+              length - batch_length);
+      length -= batch_length;
+
+      if (at_end) break;
+    }
+  } catch (...) {
+    fclose(file);
+    throw;
+  }
+
+  fclose(file);
+
+  LOG_INFO("Imported %lu tuples into %s", loaded_tuple_count_,
+           target_table_->GetName().c_str());
+  return false;
+}
+
+/**
+ * @brief Parse the records between begin and end into new tile groups,
+ * which are not yet added to the table.
+ */
+void ImportExecutor::ParseChunk(const char *begin, const char *end,
+                                import_chunk_t &chunk) const {
+  auto schema = target_table_->GetSchema();
+  oid_t column_count = schema->GetColumnCount();
+
+  std::vector<index::Index *> indexes;
+  std::vector<std::vector<oid_t>> indexed_columns;
+  oid_t index_count = target_table_->GetIndexCount();
+  for (oid_t index_itr = 0; index_itr < index_count; index_itr++) {
+    auto index = target_table_->GetIndex(index_itr);
+    indexes.push_back(index);
+    indexed_columns.push_back(index->GetKeySchema()->GetIndexedColumns());
+  }
+  chunk.keys.resize(index_count);
+  chunk.locations.resize(index_count);
+
+  // Holds the values of the current tuple until they are copied into the
+  // tile group
+  VarlenPool pool(BACKEND_TYPE_MM);
+  storage::Tuple tuple(schema, true);
+  std::vector<std::string> fields;
+  std::vector<bool> nulls;
+  std::shared_ptr<storage::TileGroup> tile_group;
+
+  const char *line = begin;
+  while (line < end) {
+    auto line_end =
+        static_cast<const char *>(memchr(line, '\n', end - line));
+    if (line_end == nullptr) line_end = end;
+    auto record_end = line_end;
+    if (record_end > line && record_end[-1] == '\r') record_end--;
+
+    // skip blank lines
+    if (record_end == line) {
+      line = line_end + 1;
+      continue;
+    }
+
+    if (SplitRecord(line, record_end, delimiter_, fields, nulls) == false) {
+      chunk.error =
+          "Malformed quoting in record : " + std::string(line, record_end);
+      return;
+    }
+    if (fields.size() != column_count) {
+      chunk.error = "Expected " + std::to_string(column_count) +
+                    " fields in record : " + std::string(line, record_end);
+      return;
+    }
+
+    try {
+      for (oid_t column_itr = 0; column_itr < column_count; column_itr++) {
+        auto type = schema->GetType(column_itr);
+        if (nulls[column_itr]) {
+          if (schema->AllowNull(column_itr) == false) {
+            chunk.error = "NULL in non-nullable column of record : " +
+                          std::string(line, record_end);
+            return;
+          }
+          tuple.SetValue(column_itr, Value::GetNullValue(type), &pool);
+        } else {
+          tuple.SetValue(column_itr,
+                         ParseValue(type, fields[column_itr], &pool), &pool);
+        }
+      }
+    } catch (std::exception &e) {
+      // nothing may escape the worker thread
+      chunk.error =
+          std::string(e.what()) + " in record : " + std::string(line, record_end);
+      return;
+    }
+
+    oid_t tuple_slot = INVALID_OID;
+    if (tile_group != nullptr) tuple_slot = tile_group->InsertTuple(&tuple);
+    if (tuple_slot == INVALID_OID) {
+      tile_group.reset(target_table_->GetDefaultTileGroup());
+      chunk.tile_groups.push_back(tile_group);
+      tuple_slot = tile_group->InsertTuple(&tuple);
+    }
+
+    ItemPointer location(tile_group->GetTileGroupId(), tuple_slot);
+    for (oid_t index_itr = 0; index_itr < index_count; index_itr++) {
+      auto index = indexes[index_itr];
+      std::unique_ptr<storage::Tuple> key(
+          new storage::Tuple(index->GetKeySchema(), true));
+      key->SetFromTuple(&tuple, indexed_columns[index_itr], index->GetPool());
+      chunk.keys[index_itr].push_back(std::move(key));
+      chunk.locations[index_itr].push_back(location);
+    }
+    chunk.tuple_count++;
+
+    // values of a full tile group have all been copied into its tiles
+    if (tuple_slot + 1 == tile_group->GetAllocatedTupleCount()) pool.Purge();
+
+    line = line_end + 1;
+  }
+}
+
+/**
+ * @brief Set the header of every tuple in the tile groups. The commit ids
+ * are written before the owner, like the transaction managers do.
+ */
+static void SetTupleHeaders(
+    const std::vector<std::shared_ptr<storage::TileGroup>> &tile_groups,
+    cid_t begin_cid, txn_id_t txn_id) {
+  for (auto &tile_group : tile_groups) {
+    auto tile_group_header = tile_group->GetHeader();
+    oid_t slot_count = tile_group->GetNextTupleSlot();
+    for (oid_t tuple_slot = 0; tuple_slot < slot_count; tuple_slot++) {
+      tile_group_header->SetEndCommitId(tuple_slot, MAX_CID);
+      tile_group_header->SetBeginCommitId(tuple_slot, begin_cid);
+    }
+
+    COMPILER_MEMORY_FENCE;
+
+    for (oid_t tuple_slot = 0; tuple_slot < slot_count; tuple_slot++) {
+      tile_group_header->SetTransactionId(tuple_slot, txn_id);
+    }
+  }
+}
+
+/**
+ * @brief Parse the first length bytes of the buffer in parallel, then make
+ * the parsed tuples part of the table as a single commit.
+ */
+void ImportExecutor::LoadBatch(const std::vector<char> &buffer,
+                               size_t length) {
+  const char *data = buffer.data();
+
+  // Cut the batch into one chunk per worker at line boundaries
+  size_t worker_count = GetWorkerCount();
+  std::vector<size_t> chunk_bounds = {0};
+  for (size_t worker_itr = 1; worker_itr < worker_count; worker_itr++) {
+    size_t bound =
+        std::max(length / worker_count * worker_itr, chunk_bounds.back());
+    auto line_end = static_cast<const char *>(
+        memchr(data + bound, '\n', length - bound));
+    bound = (line_end == nullptr) ? length : line_end - data + 1;
+    chunk_bounds.push_back(bound);
+  }
+  chunk_bounds.push_back(length);
+
+  std::vector<import_chunk_t> chunks(worker_count);
+  std::vector<std::thread> workers;
+  for (size_t worker_itr = 0; worker_itr < worker_count; worker_itr++) {
+    if (chunk_bounds[worker_itr] == chunk_bounds[worker_itr + 1]) continue;
+    workers.push_back(std::thread(&ImportExecutor::ParseChunk, this,
+                                  data + chunk_bounds[worker_itr],
+                                  data + chunk_bounds[worker_itr + 1],
+                                  std::ref(chunks[worker_itr])));
+  }
+  for (auto &worker : workers) {
+    worker.join();
+  }
+
+  size_t tuple_count = 0;
+  for (auto &chunk : chunks) {
+    if (chunk.error.empty() == false) {
+      throw ExecutorException("Failed to import into " +
+                              target_table_->GetName() + " : " + chunk.error);
+    }
+    tuple_count += chunk.tuple_count;
+  }
+  if (tuple_count == 0) return;
+
+  std::vector<std::shared_ptr<storage::TileGroup>> tile_groups;
+  for (auto &chunk : chunks) {
+    tile_groups.insert(tile_groups.end(), chunk.tile_groups.begin(),
+                       chunk.tile_groups.end());
+  }
+
+  // The tuples stay owned by the transaction until the batch is indexed and
+  // logged, so other transactions neither see them nor insert their keys
+  auto txn_id = executor_context_->GetTransaction()->GetTransactionId();
+  SetTupleHeaders(tile_groups, MAX_CID, txn_id);
+  for (auto &tile_group : tile_groups) {
+    target_table_->AddTileGroup(tile_group);
+  }
+
+  // Build every index from all keys of the batch at once, the indexes sort
+  // the entries themselves. Primary and unique indexes go first, so a
+  // rejected batch never reaches the others.
+  std::vector<oid_t> unique_offsets;
+  std::vector<oid_t> other_offsets;
+  oid_t index_count = target_table_->GetIndexCount();
+  for (oid_t index_itr = 0; index_itr < index_count; index_itr++) {
+    auto index_type = target_table_->GetIndex(index_itr)->GetIndexType();
+    if (index_type == INDEX_CONSTRAINT_TYPE_PRIMARY_KEY ||
+        index_type == INDEX_CONSTRAINT_TYPE_UNIQUE) {
+      unique_offsets.push_back(index_itr);
+    } else {
+      other_offsets.push_back(index_itr);
+    }
+  }
+
+  if (BuildIndexes(chunks, unique_offsets, true) == false) {
+    // drop the tuples like the inserts of an aborted transaction
+    SetTupleHeaders(tile_groups, MAX_CID, INVALID_TXN_ID);
+    throw ExecutorException("Failed to import into " +
+                            target_table_->GetName() + " : duplicate key");
+  }
+  BuildIndexes(chunks, other_offsets, false);
+
+  auto &txn_manager = concurrency::TransactionManagerFactory::GetInstance();
+  auto &log_manager = logging::LogManager::GetInstance();
+
+  // Log the batch as one transaction, so it is flushed once
+  log_manager.PrepareLogging();
+  cid_t commit_id = txn_manager.GetNextCommitId();
+
+  log_manager.LogBeginTransaction(commit_id);
+  if (log_manager.IsInLoggingMode()) {
+    for (auto &tile_group : tile_groups) {
+      oid_t tile_group_id = tile_group->GetTileGroupId();
+      oid_t slot_count = tile_group->GetNextTupleSlot();
+      for (oid_t tuple_slot = 0; tuple_slot < slot_count; tuple_slot++) {
+        log_manager.LogInsert(commit_id, ItemPointer(tile_group_id, tuple_slot));
+      }
+    }
+  }
+  log_manager.LogCommitTransaction(commit_id);
+
+  // The whole batch becomes visible with one commit id
+  SetTupleHeaders(tile_groups, commit_id, INITIAL_TXN_ID);
+
+  target_table_->IncreaseNumberOfTuplesBy(tuple_count);
+  for (oid_t index_itr = 0; index_itr < index_count; index_itr++) {
+    target_table_->GetIndex(index_itr)->IncreaseNumberOfTuplesBy(tuple_count);
+  }
+
+  loaded_tuple_count_ += tuple_count;
+}
+
+bool ImportExecutor::BuildIndexes(const std::vector<import_chunk_t> &chunks,
+                                  const std::vector<oid_t> &index_offsets,
+                                  bool unique) {
+  // one flag per index, vector<bool> packs them into shared words
+  std::vector<char> loaded(index_offsets.size(), true);
+  std::vector<std::thread> index_builders;
+  for (size_t offset_itr = 0; offset_itr < index_offsets.size();
+       offset_itr++) {
+    auto index_itr = index_offsets[offset_itr];
+    auto index = target_table_->GetIndex(index_itr);
+    auto loaded_flag = &loaded[offset_itr];
+    index_builders.push_back(
+        std::thread([&chunks, index, index_itr, unique, loaded_flag] {
+          std::vector<const storage::Tuple *> keys;
+          std::vector<ItemPointer> locations;
+          GetIndexEntries(chunks, index_itr, keys, locations);
+
+          if (unique) {
+            *loaded_flag = index->CondInsertEntries(keys, locations);
+          } else {
+            index->InsertEntries(keys, locations);
+          }
+        }));
+  }
+  for (auto &index_builder : index_builders) {
+    index_builder.join();
+  }
+
+  if (std::find(loaded.begin(), loaded.end(), false) == loaded.end()) {
+    return true;
+  }
+
+  // take the keys back out of the indexes that accepted them
+  for (size_t offset_itr = 0; offset_itr < index_offsets.size();
+       offset_itr++) {
+    if (loaded[offset_itr] == false) continue;
+
+    auto index_itr = index_offsets[offset_itr];
+    auto index = target_table_->GetIndex(index_itr);
+    std::vector<const storage::Tuple *> keys;
+    std::vector<ItemPointer> locations;
+    GetIndexEntries(chunks, index_itr, keys, locations);
+    for (size_t entry_itr = 0; entry_itr < keys.size(); entry_itr++) {
+      index->DeleteEntry(keys[entry_itr], locations[entry_itr]);
+    }
+  }
+  return false;
+}
+
+void ImportExecutor::GetIndexEntries(const std::vector<import_chunk_t> &chunks,
+                                     oid_t index_offset,
+                                     std::vector<const storage::Tuple *> &keys,
+                                     std::vector<ItemPointer> &locations) {
+  for (auto &chunk : chunks) {
+    for (auto &key : chunk.keys[index_offset]) {
+      keys.push_back(key.get());
+    }
+    locations.insert(locations.end(), chunk.locations[index_offset].begin(),
+                     chunk.locations[index_offset].end());
+  }
+}
+
+}  // namespace executor
+}  // namespace peloton
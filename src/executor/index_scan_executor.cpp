@@ -14,6 +14,7 @@
 #include "executor/index_scan_executor.h"
 
 #include <memory>
+#include <numeric>
 #include <utility>
 #include <vector>
 
@@ -27,6 +28,7 @@
 #include "storage/data_table.h"
 #include "storage/tile_group.h"
 #include "storage/tile_group_header.h"
+#include "storage/tuple.h"
 #include "concurrency/transaction_manager_factory.h"
 #include "common/logger.h"
 #include "catalog/manager.h"
@@ -64,6 +66,11 @@ bool IndexScanExecutor::DInit() {
   index_ = node.GetIndex();
   PL_ASSERT(index_ != nullptr);
 
+  // drop the tiles of a previous execution that were never returned
+  for (oid_t tile_itr = result_itr_; tile_itr < result_.size(); tile_itr++) {
+    delete result_[tile_itr];
+  }
+
   result_itr_ = START_OID;
   result_.clear();
   done_ = false;
@@ -163,6 +170,7 @@ bool IndexScanExecutor::ExecPrimaryIndexLookup() {
       concurrency::TransactionManagerFactory::GetInstance();
 
   std::map<oid_t, std::vector<oid_t>> visible_tuples;
+  std::vector<std::unique_ptr<storage::Tuple>> delta_tuples;
   std::vector<ItemPointer> garbage_tuples;
   // for every tuple that is found in the index.
   for (auto tuple_location_ptr : tuple_location_ptrs) {
@@ -183,30 +191,11 @@ bool IndexScanExecutor::ExecPrimaryIndexLookup() {
         LOG_TRACE("perform read: %u, %u", tuple_location.block,
                   tuple_location.offset);
 
-        // perform predicate evaluation.
-        if (predicate_ == nullptr) {
-          visible_tuples[tuple_location.block].push_back(tuple_location.offset);
-
-          auto res = transaction_manager.PerformRead(tuple_location);
-          if (!res) {
-            transaction_manager.SetTransactionResult(RESULT_FAILURE);
-            return res;
-          }
-        } else {
-          expression::ContainerTuple<storage::TileGroup> tuple(
-              tile_group.get(), tuple_location.offset);
-          auto eval =
-              predicate_->Evaluate(&tuple, nullptr, executor_context_).IsTrue();
-          if (eval == true) {
-            visible_tuples[tuple_location.block].push_back(
-                tuple_location.offset);
-
-            auto res = transaction_manager.PerformRead(tuple_location);
-            if (!res) {
-              transaction_manager.SetTransactionResult(RESULT_FAILURE);
-              return res;
-            }
-          }
+        auto res = AddVisibleTuple(tile_group, tuple_location, visible_tuples,
+                                   delta_tuples);
+        if (!res) {
+          transaction_manager.SetTransactionResult(RESULT_FAILURE);
+          return res;
         }
         break;
       }
@@ -294,6 +283,17 @@ bool IndexScanExecutor::ExecPrimaryIndexLookup() {
     result_.push_back(logical_tile.release());
   }
 
+  // Construct a logical tile for the versions copied in delta storage
+  if (delta_tuples.empty() == false) {
+    std::unique_ptr<LogicalTile> logical_tile(
+        LogicalTileFactory::WrapTuples(delta_tuples, table_->GetSchema()));
+    if (column_ids_.size() != 0) {
+      logical_tile->ProjectColumns(full_column_ids_, column_ids_);
+    }
+
+    result_.push_back(logical_tile.release());
+  }
+
   done_ = true;
 
   LOG_TRACE("Result tiles : %lu", result_.size());
@@ -330,37 +330,21 @@ bool IndexScanExecutor::ExecSecondaryIndexLookup() {
       concurrency::TransactionManagerFactory::GetInstance();
 
   std::map<oid_t, std::vector<oid_t>> visible_tuples;
+  std::vector<std::unique_ptr<storage::Tuple>> delta_tuples;
   // for every tuple that is found in the index.
   for (auto tuple_location : tuple_locations) {
     auto &manager = catalog::Manager::GetInstance();
     auto tile_group = manager.GetTileGroup(tuple_location.block);
     auto tile_group_header = tile_group.get()->GetHeader();
-    auto tile_group_id = tuple_location.block;
     auto tuple_id = tuple_location.offset;
 
     // if the tuple is visible.
     if (transaction_manager.IsVisible(tile_group_header, tuple_id)) {
-      // perform predicate evaluation.
-      if (predicate_ == nullptr) {
-        visible_tuples[tile_group_id].push_back(tuple_id);
-        auto res = transaction_manager.PerformRead(tuple_location);
-        if (!res) {
-          transaction_manager.SetTransactionResult(RESULT_FAILURE);
-          return res;
-        }
-      } else {
-        expression::ContainerTuple<storage::TileGroup> tuple(tile_group.get(),
-                                                             tuple_id);
-        auto eval =
-            predicate_->Evaluate(&tuple, nullptr, executor_context_).IsTrue();
-        if (eval == true) {
-          visible_tuples[tile_group_id].push_back(tuple_id);
-          auto res = transaction_manager.PerformRead(tuple_location);
-          if (!res) {
-            transaction_manager.SetTransactionResult(RESULT_FAILURE);
-            return res;
-          }
-        }
+      auto res = AddVisibleTuple(tile_group, tuple_location, visible_tuples,
+                                 delta_tuples);
+      if (!res) {
+        transaction_manager.SetTransactionResult(RESULT_FAILURE);
+        return res;
       }
     }
   }
@@ -381,6 +365,17 @@ bool IndexScanExecutor::ExecSecondaryIndexLookup() {
     result_.push_back(logical_tile.release());
   }
 
+  // Construct a logical tile for the versions copied in delta storage
+  if (delta_tuples.empty() == false) {
+    std::unique_ptr<LogicalTile> logical_tile(
+        LogicalTileFactory::WrapTuples(delta_tuples, table_->GetSchema()));
+    if (column_ids_.size() != 0) {
+      logical_tile->ProjectColumns(full_column_ids_, column_ids_);
+    }
+
+    result_.push_back(logical_tile.release());
+  }
+
   done_ = true;
 
   LOG_TRACE("Result tiles : %lu", result_.size());
@@ -388,5 +383,59 @@ bool IndexScanExecutor::ExecSecondaryIndexLookup() {
   return true;
 }
 
+/**
+ * @brief Adds a visible tuple to the result if it satisfies the predicate.
+ * @param tile_group Tile group of the tuple.
+ * @param location Location of the tuple.
+ * @param visible_tuples Visible tuples read in place, per tile group.
+ * @param delta_tuples Visible versions copied in delta storage.
+ * @return false if the tuple can not be read, true otherwise.
+ */
+bool IndexScanExecutor::AddVisibleTuple(
+    const std::shared_ptr<storage::TileGroup> &tile_group,
+    const ItemPointer &location,
+    std::map<oid_t, std::vector<oid_t>> &visible_tuples,
+    std::vector<std::unique_ptr<storage::Tuple>> &delta_tuples) {
+  auto &transaction_manager =
+      concurrency::TransactionManagerFactory::GetInstance();
+
+  // the pin keeps other transactions from overwriting the slot while the
+  // result is in use. the version is copied only if the slot no longer
+  // holds it.
+  if (concurrency::TransactionManagerFactory::GetVersionStorage() ==
+      VERSION_STORAGE_TYPE_DELTA) {
+    executor_context_->PinTileGroup(tile_group);
+
+    std::unique_ptr<storage::Tuple> tuple(
+        new storage::Tuple(table_->GetSchema(), true));
+    if (transaction_manager.ReconstructVersion(
+            tile_group.get(), location.offset, tuple.get(),
+            executor_context_->GetExecutorContextPool())) {
+      if (predicate_ != nullptr &&
+          predicate_->Evaluate(tuple.get(), nullptr, executor_context_)
+              .IsTrue() == false) {
+        return true;
+      }
+
+      delta_tuples.push_back(std::move(tuple));
+      return transaction_manager.PerformRead(location);
+    }
+  }
+
+  // perform predicate evaluation.
+  if (predicate_ != nullptr) {
+    expression::ContainerTuple<storage::TileGroup> tuple(tile_group.get(),
+                                                         location.offset);
+    auto eval =
+        predicate_->Evaluate(&tuple, nullptr, executor_context_).IsTrue();
+    if (eval == false) {
+      return true;
+    }
+  }
+
+  visible_tuples[location.block].push_back(location.offset);
+  return transaction_manager.PerformRead(location);
+}
+
 }  // namespace executor
 }  // namespace peloton
@@ -0,0 +1,187 @@
+//===----------------------------------------------------------------------===//
+//
+//                         Peloton
+//
+// join_hash_table.cpp
+//
+// Identification: src/executor/join_hash_table.cpp
+//
+// Copyright (c) 2015-16, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+
+#include "executor/join_hash_table.h"
+
+#include <algorithm>
+
+#include "common/logger.h"
+#include "common/value_peeker.h"
+
+namespace peloton {
+namespace executor {
+
+bool JoinHashTable::PackKey(const KeyType &key, int64_t *packed_key) const {
+  oid_t key_column_itr = 0;
+  for (auto column_id : *column_ids_) {
+    const Value value = key.GetValue(column_id);
+    if (value.IsNull()) {
+      return false;
+    }
+
+    switch (value.GetValueType()) {
+      case VALUE_TYPE_TINYINT:
+      case VALUE_TYPE_SMALLINT:
+      case VALUE_TYPE_INTEGER:
+      case VALUE_TYPE_BIGINT:
+        packed_key[key_column_itr++] = ValuePeeker::PeekAsBigInt(value);
+        break;
+      default:
+        return false;
+    }
+  }
+
+  return true;
+}
+
+bool JoinHashTable::SlotMatches(const Slot &slot, const KeyType &key,
+                                size_t hash, const int64_t *packed_key) const {
+  if (slot.hash != hash) {
+    return false;
+  }
+
+  // Both keys are inline, the tiles need not be touched
+  if (packed_key != nullptr) {
+    for (size_t key_column_itr = 0; key_column_itr < column_ids_->size();
+         key_column_itr++) {
+      if (slot.key[key_column_itr] != packed_key[key_column_itr]) {
+        return false;
+      }
+    }
+    return true;
+  }
+
+  return key.EqualsNoSchemaCheck(GetKey(locations_[slot.begin]));
+}
+
+void JoinHashTable::Build(
+    const std::vector<std::unique_ptr<LogicalTile>> &tiles,
+    const std::vector<oid_t> *column_ids) {
+  column_ids_ = column_ids;
+  key_count_ = 0;
+
+  // Collect the locations of all tuples
+  std::vector<Location> rows;
+  size_t tuple_count = 0;
+  tiles_.clear();
+  for (auto &tile : tiles) {
+    tiles_.push_back(tile.get());
+    tuple_count += tile->GetTupleCount();
+  }
+  rows.reserve(tuple_count);
+  for (oid_t tile_itr = 0; tile_itr < tiles.size(); tile_itr++) {
+    for (oid_t tuple_id : *tiles[tile_itr]) {
+      rows.emplace_back(tile_itr, tuple_id);
+    }
+  }
+
+  // Size the table so that it is at most half full
+  size_t slot_count = JOIN_HASH_TABLE_MIN_SLOTS;
+  while (slot_count < 2 * rows.size()) {
+    slot_count <<= 1;
+  }
+  slots_.assign(slot_count, Slot());
+  slot_mask_ = slot_count - 1;
+
+  // The keys are inline until a key that cannot be packed shows up. Slots
+  // filled before that were only compared inline with packed keys, so they
+  // stay correct when the table falls back to comparing the tuples.
+  inline_keys_ = (column_ids_->size() <= JOIN_HASH_TABLE_INLINE_KEY_COLUMNS);
+
+  // Assign every tuple to the slot of its key. Until the locations are laid
+  // out, the begin of a slot is the offset of the first row with the key,
+  // so that the keys are compared against the rows.
+  locations_.swap(rows);
+  std::vector<size_t> row_slots(locations_.size());
+  int64_t packed_key[JOIN_HASH_TABLE_INLINE_KEY_COLUMNS];
+  for (size_t row_itr = 0; row_itr < locations_.size(); row_itr++) {
+    auto key = GetKey(locations_[row_itr]);
+    size_t hash = HashKey(key);
+    size_t slot_itr = hash & slot_mask_;
+
+    if (inline_keys_ == true && PackKey(key, packed_key) == false) {
+      inline_keys_ = false;
+    }
+    const int64_t *probe_key = inline_keys_ ? packed_key : nullptr;
+
+    for (;;) {
+      auto &slot = slots_[slot_itr];
+      if (slot.count == 0) {
+        slot.hash = hash;
+        slot.begin = row_itr;
+        if (probe_key != nullptr) {
+          std::copy(probe_key, probe_key + column_ids_->size(), slot.key);
+        }
+        key_count_++;
+        break;
+      }
+      if (SlotMatches(slot, key, hash, probe_key)) {
+        break;
+      }
+      slot_itr = (slot_itr + 1) & slot_mask_;
+    }
+
+    slots_[slot_itr].count++;
+    row_slots[row_itr] = slot_itr;
+  }
+
+  // Lay out the locations grouped by key, preserving the order of the rows
+  // within a key
+  rows.swap(locations_);
+  oid_t offset = 0;
+  for (auto &slot : slots_) {
+    slot.begin = offset;
+    offset += slot.count;
+  }
+
+  locations_.resize(rows.size());
+  for (size_t row_itr = 0; row_itr < rows.size(); row_itr++) {
+    locations_[slots_[row_slots[row_itr]].begin++] = rows[row_itr];
+  }
+  for (auto &slot : slots_) {
+    slot.begin -= slot.count;
+  }
+
+  LOG_TRACE("Built join hash table : %lu tuples, %lu keys, %lu slots",
+            locations_.size(), key_count_, slots_.size());
+}
+
+JoinHashTable::LocationRange JoinHashTable::Find(const KeyType &key,
+                                                 size_t hash) const {
+  if (locations_.empty()) {
+    return LocationRange(nullptr, nullptr);
+  }
+
+  int64_t packed_key[JOIN_HASH_TABLE_INLINE_KEY_COLUMNS];
+  const int64_t *probe_key = nullptr;
+  if (inline_keys_ == true && PackKey(key, packed_key) == true) {
+    probe_key = packed_key;
+  }
+
+  size_t slot_itr = hash & slot_mask_;
+  for (;;) {
+    auto &slot = slots_[slot_itr];
+    if (slot.count == 0) {
+      return LocationRange(nullptr, nullptr);
+    }
+
+    if (SlotMatches(slot, key, hash, probe_key)) {
+      auto begin = &locations_[slot.begin];
+      return LocationRange(begin, begin + slot.count);
+    }
+    slot_itr = (slot_itr + 1) & slot_mask_;
+  }
+}
+
+} /* namespace executor */
+} /* namespace peloton */
@@ -11,7 +11,10 @@
 //===----------------------------------------------------------------------===//
 
 
+#include <limits>
+
 #include "executor/limit_executor.h"
+#include "executor/order_by_executor.h"
 
 #include "planner/limit_plan.h"
 #include "common/logger.h"
@@ -39,6 +42,17 @@ bool LimitExecutor::DInit() {
   num_skipped_ = 0;
   num_returned_ = 0;
 
+  // An order by right below only has to produce the first offset + limit
+  // tuples, which it can do without sorting its entire input
+  auto order_by_executor = dynamic_cast<OrderByExecutor *>(children_[0]);
+  if (order_by_executor != nullptr) {
+    const planner::LimitPlan &node = GetPlanNode<planner::LimitPlan>();
+    if (node.GetLimit() <=
+        std::numeric_limits<size_t>::max() - node.GetOffset()) {
+      order_by_executor->SetLimit(node.GetLimit() + node.GetOffset());
+    }
+  }
+
   return true;
 }
 
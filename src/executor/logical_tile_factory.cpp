@@ -22,6 +22,7 @@
 #include "storage/tile_group.h"
 #include "storage/data_table.h"
 #include "storage/tile_group_header.h"
+#include "storage/tuple.h"
 
 namespace peloton {
 namespace executor {
@@ -109,5 +110,30 @@ LogicalTile *LogicalTileFactory::WrapTileGroup(
   return new_tile.release();
 }
 
+/**
+ * @brief Convenience method to construct a logical tile holding copies of
+ *        tuples, such as the versions rebuilt from the delta chains.
+ * @param tuples Tuples to be copied into the logical tile.
+ * @param schema Schema of the tuples.
+ *
+ * @return Logical tile wrapping a temporary tile with the tuples.
+ */
+LogicalTile *LogicalTileFactory::WrapTuples(
+    const std::vector<std::unique_ptr<storage::Tuple>> &tuples,
+    const catalog::Schema *schema) {
+  PL_ASSERT(tuples.size() > 0);
+
+  std::shared_ptr<storage::Tile> dest_tile(
+      storage::TileFactory::GetTempTile(*schema, tuples.size()));
+
+  oid_t tuple_id = 0;
+  for (auto &tuple : tuples) {
+    dest_tile->InsertTuple(tuple_id, tuple.get());
+    tuple_id++;
+  }
+
+  return WrapTiles({dest_tile});
+}
+
 }  // namespace executor
 }  // namespace peloton
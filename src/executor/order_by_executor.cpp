@@ -11,8 +11,13 @@
 //===----------------------------------------------------------------------===//
 
 
+#include <algorithm>
+#include <cstring>
+
+#include "common/exception.h"
 #include "common/logger.h"
 #include "common/pool.h"
+#include "common/value_peeker.h"
 #include "executor/logical_tile.h"
 #include "executor/logical_tile_factory.h"
 #include "executor/order_by_executor.h"
@@ -24,6 +29,162 @@
 namespace peloton {
 namespace executor {
 
+size_t OrderByExecutor::memory_budget_ = ORDER_BY_MEMORY_BUDGET;
+
+//===--------------------------------------------------------------------===//
+// Normalized sort keys
+//===--------------------------------------------------------------------===//
+
+// Append the lowest width bytes of the value, most significant first
+static void AppendBigEndian(std::vector<char> &buffer, uint64_t value,
+                            size_t width) {
+  for (size_t byte_itr = width; byte_itr > 0; byte_itr--) {
+    buffer.push_back(static_cast<char>((value >> ((byte_itr - 1) * 8)) & 0xFF));
+  }
+}
+
+// Flipping the sign bit makes signed integers order as unsigned bytes
+static void AppendSigned(std::vector<char> &buffer, int64_t value,
+                         size_t width) {
+  AppendBigEndian(buffer,
+                  static_cast<uint64_t>(value) ^ (1ULL << (width * 8 - 1)),
+                  width);
+}
+
+/**
+ * @brief Append the normalized form of a sort key value, two keys compare
+ * with memcmp the same way as the values do. NULL is smaller than any other
+ * value. A descending key is the ascending one with every bit inverted.
+ */
+static void AppendSortKey(std::vector<char> &buffer, const Value &value,
+                          bool descend) {
+  size_t key_begin = buffer.size();
+
+  if (value.IsNull()) {
+    buffer.push_back(0);
+  } else {
+    buffer.push_back(1);
+
+    switch (value.GetValueType()) {
+      case VALUE_TYPE_BOOLEAN:
+        buffer.push_back(ValuePeeker::PeekBoolean(value) ? 1 : 0);
+        break;
+      case VALUE_TYPE_TINYINT:
+        AppendSigned(buffer, ValuePeeker::PeekTinyInt(value), 1);
+        break;
+      case VALUE_TYPE_SMALLINT:
+        AppendSigned(buffer, ValuePeeker::PeekSmallInt(value), 2);
+        break;
+      case VALUE_TYPE_INTEGER:
+        AppendSigned(buffer, ValuePeeker::PeekInteger(value), 4);
+        break;
+      case VALUE_TYPE_DATE:
+        AppendSigned(buffer, ValuePeeker::PeekDate(value), 4);
+        break;
+      case VALUE_TYPE_BIGINT:
+        AppendSigned(buffer, ValuePeeker::PeekBigInt(value), 8);
+        break;
+      case VALUE_TYPE_TIMESTAMP:
+        AppendSigned(buffer, ValuePeeker::PeekTimestamp(value), 8);
+        break;
+      case VALUE_TYPE_REAL:
+      case VALUE_TYPE_DOUBLE: {
+        double number = ValuePeeker::PeekDouble(value);
+        // -0.0 and 0.0 are equal
+        if (number == 0) number = 0;
+        uint64_t bits;
+        PL_MEMCPY(&bits, &number, sizeof(bits));
+        // negative numbers order backwards
+        if (bits >> 63) {
+          bits = ~bits;
+        } else {
+          bits ^= (1ULL << 63);
+        }
+        AppendBigEndian(buffer, bits, 8);
+      } break;
+      case VALUE_TYPE_DECIMAL: {
+        // a decimal is a scaled 128-bit integer
+        TTInt decimal = ValuePeeker::PeekDecimal(value);
+        AppendSigned(buffer, static_cast<int64_t>(decimal.table[1]), 8);
+        AppendBigEndian(buffer, static_cast<uint64_t>(decimal.table[0]), 8);
+      } break;
+      case VALUE_TYPE_VARCHAR:
+      case VALUE_TYPE_VARBINARY: {
+        // escape zero bytes and terminate with two zero bytes, so that a
+        // string sorts before any longer string it is a prefix of
+        const char *data = static_cast<const char *>(
+            ValuePeeker::PeekObjectValueWithoutNull(value));
+        int32_t length = ValuePeeker::PeekObjectLengthWithoutNull(value);
+        for (int32_t byte_itr = 0; byte_itr < length; byte_itr++) {
+          buffer.push_back(data[byte_itr]);
+          if (data[byte_itr] == 0) buffer.push_back(static_cast<char>(0xFF));
+        }
+        buffer.push_back(0);
+        buffer.push_back(0);
+      } break;
+      default:
+        throw ExecutorException("Unsupported sort key type " +
+                                ValueTypeToString(value.GetValueType()));
+    }
+  }
+
+  if (descend) {
+    for (size_t byte_itr = key_begin; byte_itr < buffer.size(); byte_itr++) {
+      buffer[byte_itr] = ~buffer[byte_itr];
+    }
+  }
+}
+
+static int CompareSortKeys(const char *lhs, uint32_t lhs_length,
+                           const char *rhs, uint32_t rhs_length) {
+  int result = memcmp(lhs, rhs, std::min(lhs_length, rhs_length));
+  if (result != 0) return result;
+  if (lhs_length == rhs_length) return 0;
+  return (lhs_length < rhs_length) ? -1 : 1;
+}
+
+//===--------------------------------------------------------------------===//
+// Run files
+//===--------------------------------------------------------------------===//
+
+static void WriteRunRecord(FILE *file, uint32_t key_length,
+                           uint32_t row_length, const char *record) {
+  size_t record_length = key_length + row_length;
+  if (fwrite(&key_length, sizeof(key_length), 1, file) != 1 ||
+      fwrite(&row_length, sizeof(row_length), 1, file) != 1 ||
+      fwrite(record, 1, record_length, file) != record_length) {
+    throw ExecutorException("Failed to write a sort run to disk");
+  }
+}
+
+static bool ReadRunRecord(FILE *file, std::vector<char> &record,
+                          uint32_t &key_length, uint32_t &row_length) {
+  if (fread(&key_length, sizeof(key_length), 1, file) != 1) {
+    return false;
+  }
+
+  if (fread(&row_length, sizeof(row_length), 1, file) != 1) {
+    throw ExecutorException("Failed to read a sort run from disk");
+  }
+
+  size_t record_length = key_length + row_length;
+  record.resize(record_length);
+  if (fread(record.data(), 1, record_length, file) != record_length) {
+    throw ExecutorException("Failed to read a sort run from disk");
+  }
+
+  return true;
+}
+
+static FILE *CreateRunFile() {
+  FILE *file = std::tmpfile();
+  if (file == nullptr) {
+    throw ExecutorException("Failed to create a temporary file for sorting");
+  }
+  setvbuf(file, nullptr, _IOFBF, ORDER_BY_RUN_BUFFER_SIZE);
+  return file;
+}
+
 /**
  * @brief Constructor
  * @param node  OrderByNode plan node corresponding to this executor
@@ -32,12 +193,19 @@ OrderByExecutor::OrderByExecutor(const planner::AbstractPlan *node,
                                  ExecutorContext *executor_context)
     : AbstractExecutor(node, executor_context) {}
 
-OrderByExecutor::~OrderByExecutor() {}
+OrderByExecutor::~OrderByExecutor() { CloseRuns(); }
 
 bool OrderByExecutor::DInit() {
   PL_ASSERT(children_.size() == 1);
 
+  CloseRuns();
+  sort_buffer_.clear();
+  sort_entries_.clear();
+  live_bytes_ = 0;
+
   sort_done_ = false;
+  top_n_ = false;
+  num_tuples_ = 0;
   num_tuples_returned_ = 0;
 
   return true;
@@ -48,36 +216,46 @@ bool OrderByExecutor::DExecute() {
 
   if (!sort_done_) DoSort();
 
-  if (!(num_tuples_returned_ < sort_buffer_.size())) {
+  if (!(num_tuples_returned_ < num_tuples_)) {
     return false;
   }
 
   PL_ASSERT(sort_done_);
   PL_ASSERT(input_schema_.get());
-  PL_ASSERT(input_tiles_.size() > 0);
 
   // Returned tiles must be newly created physical tiles,
   // which have the same physical schema as input tiles.
   size_t tile_size = std::min(size_t(DEFAULT_TUPLES_PER_TILEGROUP),
-                              sort_buffer_.size() - num_tuples_returned_);
+                              num_tuples_ - num_tuples_returned_);
 
   std::shared_ptr<storage::Tile> ptile(storage::TileFactory::GetTile(
       BACKEND_TYPE_MM, INVALID_OID, INVALID_OID, INVALID_OID, INVALID_OID,
       nullptr, *input_schema_, nullptr, tile_size));
 
+  if (output_pool_.get() == nullptr) {
+    output_pool_.reset(new VarlenPool(BACKEND_TYPE_MM));
+  }
+
   for (size_t id = 0; id < tile_size; id++) {
-    oid_t source_tile_id =
-        sort_buffer_[num_tuples_returned_ + id].item_pointer.block;
-    oid_t source_tuple_id =
-        sort_buffer_[num_tuples_returned_ + id].item_pointer.offset;
+    const char *row = nullptr;
+    uint32_t row_length = 0;
+    if (NextSortRecord(row, row_length) == false) {
+      throw ExecutorException("Sort ran out of tuples");
+    }
+
     // Insert a physical tuple into physical tile
+    ReferenceSerializeInputBE row_input(row, row_length);
     for (oid_t col = 0; col < input_schema_->GetColumnCount(); col++) {
-      ptile.get()->SetValue(
-          input_tiles_[source_tile_id]->GetValue(source_tuple_id, col), id,
-          col);
+      Value value;
+      value.DeserializeFromAllocateForStorage(input_schema_->GetType(col),
+                                              row_input, output_pool_.get());
+      ptile.get()->SetValue(value, id, col);
     }
   }
 
+  // The tile has copied the variable length values
+  output_pool_->Purge();
+
   // Create an owner wrapper of this physical tile
   std::vector<std::shared_ptr<storage::Tile>> singleton({ptile});
   std::unique_ptr<LogicalTile> ltile(LogicalTileFactory::WrapTiles(singleton));
@@ -85,9 +263,7 @@ bool OrderByExecutor::DExecute() {
 
   SetOutput(ltile.release());
 
-  num_tuples_returned_ += tile_size;
-
-  PL_ASSERT(num_tuples_returned_ <= sort_buffer_.size());
+  PL_ASSERT(num_tuples_returned_ <= num_tuples_);
 
   return true;
 }
@@ -98,97 +274,289 @@ bool OrderByExecutor::DoSort() {
   PL_ASSERT(!sort_done_);
   PL_ASSERT(executor_context_ != nullptr);
 
-  // Extract all data from child
+  // Grab data from plan node
+  const planner::OrderByPlan &node = GetPlanNode<planner::OrderByPlan>();
+  sort_keys_ = node.GetSortKeys();
+  descend_flags_ = node.GetDescendFlags();
+
+  top_n_ = has_limit_;
+
+  // Turn every tuple from child into a sort record, the input tiles are
+  // released as soon as they are consumed
   while (children_[0]->Execute()) {
-    input_tiles_.emplace_back(children_[0]->GetOutput());
+    std::unique_ptr<LogicalTile> tile(children_[0]->GetOutput());
+
+    if (input_schema_.get() == nullptr) {
+      input_schema_.reset(tile->GetPhysicalSchema());
+    }
+
+    if (has_limit_ && limit_ == 0) continue;
+
+    for (oid_t tuple_id : *tile) {
+      AddSortRecord(tile.get(), tuple_id);
+    }
   }
 
-  /** Number of valid tuples to be sorted. */
-  size_t count = 0;
-  for (auto &tile : input_tiles_) {
-    count += tile->GetTupleCount();
+  if (runs_.empty()) {
+    num_tuples_ = sort_entries_.size();
+
+    auto comp = [this](const sort_entry_t &lhs, const sort_entry_t &rhs) {
+      return SortEntryLess(lhs, rhs);
+    };
+
+    // Finally ... sort it !
+    if (top_n_) {
+      std::sort_heap(sort_entries_.begin(), sort_entries_.end(), comp);
+    } else {
+      std::sort(sort_entries_.begin(), sort_entries_.end(), comp);
+    }
+  } else {
+    SpillRun();
+
+    // Merge the oldest runs until they can all be merged at once
+    while (runs_.size() > ORDER_BY_MERGE_FAN_IN) {
+      FILE *run = MergeRuns(0, ORDER_BY_MERGE_FAN_IN);
+      runs_.erase(runs_.begin(), runs_.begin() + ORDER_BY_MERGE_FAN_IN);
+      runs_.push_back(run);
+    }
+
+    StartMerge(0, runs_.size());
   }
 
-  if (count == 0) return true;
+  if (has_limit_) {
+    num_tuples_ = std::min(num_tuples_, limit_);
+  }
 
-  // Grab data from plan node
-  const planner::OrderByPlan &node = GetPlanNode<planner::OrderByPlan>();
-  descend_flags_ = node.GetDescendFlags();
+  LOG_TRACE("Sorted %lu tuples in %lu runs", num_tuples_, runs_.size());
 
-  // Extract the schema for sort keys.
-  input_schema_.reset(input_tiles_[0]->GetPhysicalSchema());
-  std::vector<catalog::Column> sort_key_columns;
-  for (auto id : node.GetSortKeys()) {
-    sort_key_columns.push_back(input_schema_->GetColumn(id));
-  }
-  sort_key_tuple_schema_.reset(new catalog::Schema(sort_key_columns));
-  auto executor_pool = executor_context_->GetExecutorContextPool();
-
-  // Extract all valid tuples into a single std::vector (the sort buffer)
-  sort_buffer_.reserve(count);
-  for (oid_t tile_id = 0; tile_id < input_tiles_.size(); tile_id++) {
-    for (oid_t tuple_id : *input_tiles_[tile_id]) {
-      // Extract the sort key tuple
-      std::unique_ptr<storage::Tuple> tuple(
-          new storage::Tuple(sort_key_tuple_schema_.get(), true));
-      for (oid_t id = 0; id < node.GetSortKeys().size(); id++) {
-        tuple->SetValue(id, input_tiles_[tile_id]->GetValue(
-                                tuple_id, node.GetSortKeys()[id]),
-                        executor_pool);
-      }
-      // Inert the sort key tuple into sort buffer
-      sort_buffer_.emplace_back(sort_buffer_entry_t(
-          ItemPointer(tile_id, tuple_id), std::move(tuple)));
+  sort_done_ = true;
+
+  return true;
+}
+
+void OrderByExecutor::AddSortRecord(LogicalTile *tile, oid_t tuple_id) {
+  size_t record_offset = sort_buffer_.size();
+
+  for (oid_t id = 0; id < sort_keys_.size(); id++) {
+    AppendSortKey(sort_buffer_, tile->GetValue(tuple_id, sort_keys_[id]),
+                  descend_flags_[id]);
+  }
+  uint32_t key_length = sort_buffer_.size() - record_offset;
+
+  // The heap holds the smallest limit_ records seen so far, anything not
+  // smaller than its largest record is not part of the result
+  if (top_n_ && sort_entries_.size() == limit_) {
+    const sort_entry_t &largest = sort_entries_.front();
+    if (CompareSortKeys(sort_buffer_.data() + record_offset, key_length,
+                        sort_buffer_.data() + largest.offset,
+                        largest.key_length) >= 0) {
+      sort_buffer_.resize(record_offset);
+      return;
     }
   }
 
-  PL_ASSERT(count == sort_buffer_.size());
-
-  // Prepare the compare function
-  // Note: This is a less-than comparer, NOT an equality comparer.
-  struct TupleComparer {
-    TupleComparer(std::vector<bool> &_descend_flags)
-        : descend_flags(_descend_flags) {}
-
-    bool operator()(const storage::Tuple *ta, const storage::Tuple *tb) {
-      for (oid_t id = 0; id < descend_flags.size(); id++) {
-        if (!descend_flags[id]) {
-          if (ta->GetValue(id).OpLessThan(tb->GetValue(id)).IsTrue()) {
-            return true;
-          } else if (ta->GetValue(id)
-                         .OpGreaterThan(tb->GetValue(id))
-                         .IsTrue()) {
-            return false;
-          }
-        } else {
-          if (tb->GetValue(id).OpLessThan(ta->GetValue(id)).IsTrue()) {
-            return true;
-          } else if (tb->GetValue(id)
-                         .OpGreaterThan(ta->GetValue(id))
-                         .IsTrue()) {
-            return false;
-          }
-        }
-      }
-      return false;  // Will return false if all keys equal
+  row_output_.Reset();
+  for (oid_t col = 0; col < input_schema_->GetColumnCount(); col++) {
+    tile->GetValue(tuple_id, col).SerializeTo(row_output_);
+  }
+  sort_buffer_.insert(sort_buffer_.end(), row_output_.Data(),
+                      row_output_.Data() + row_output_.Size());
+
+  sort_entry_t entry;
+  entry.offset = record_offset;
+  entry.key_length = key_length;
+  entry.row_length = row_output_.Size();
+  sort_entries_.push_back(entry);
+  live_bytes_ += entry.key_length + entry.row_length;
+
+  if (top_n_) {
+    auto comp = [this](const sort_entry_t &lhs, const sort_entry_t &rhs) {
+      return SortEntryLess(lhs, rhs);
+    };
+    std::push_heap(sort_entries_.begin(), sort_entries_.end(), comp);
+
+    if (sort_entries_.size() > limit_) {
+      std::pop_heap(sort_entries_.begin(), sort_entries_.end(), comp);
+      live_bytes_ -= sort_entries_.back().key_length +
+                     sort_entries_.back().row_length;
+      sort_entries_.pop_back();
+    }
+
+    // Records evicted from the heap leave holes behind
+    if (sort_buffer_.size() > 2 * live_bytes_) {
+      CompactSortBuffer();
+    }
+  }
+
+  if (sort_buffer_.size() + sort_entries_.size() * sizeof(sort_entry_t) >
+      memory_budget_) {
+    // The heap outgrew the budget, fall back to sorting everything
+    top_n_ = false;
+    SpillRun();
+  }
+}
+
+bool OrderByExecutor::SortEntryLess(const sort_entry_t &lhs,
+                                    const sort_entry_t &rhs) const {
+  return CompareSortKeys(sort_buffer_.data() + lhs.offset, lhs.key_length,
+                         sort_buffer_.data() + rhs.offset,
+                         rhs.key_length) < 0;
+}
+
+// merge_heap_ is a min heap, so it is ordered by a greater-than
+bool OrderByExecutor::MergeReaderGreater(size_t lhs, size_t rhs) const {
+  auto &lhs_reader = merge_readers_[lhs];
+  auto &rhs_reader = merge_readers_[rhs];
+  return CompareSortKeys(rhs_reader.record.data(), rhs_reader.key_length,
+                         lhs_reader.record.data(), lhs_reader.key_length) < 0;
+}
+
+void OrderByExecutor::CompactSortBuffer() {
+  std::vector<char> compacted;
+  compacted.reserve(live_bytes_);
+
+  for (auto &entry : sort_entries_) {
+    size_t offset = compacted.size();
+    auto record = sort_buffer_.begin() + entry.offset;
+    compacted.insert(compacted.end(), record,
+                     record + entry.key_length + entry.row_length);
+    entry.offset = offset;
+  }
+
+  sort_buffer_.swap(compacted);
+}
+
+/**
+ * @brief Sort the records in memory and write them out as a new run.
+ */
+void OrderByExecutor::SpillRun() {
+  if (sort_entries_.empty()) return;
+
+  std::sort(sort_entries_.begin(), sort_entries_.end(),
+            [this](const sort_entry_t &lhs, const sort_entry_t &rhs) {
+              return SortEntryLess(lhs, rhs);
+            });
+
+  FILE *run = CreateRunFile();
+  runs_.push_back(run);
+
+  for (auto &entry : sort_entries_) {
+    WriteRunRecord(run, entry.key_length, entry.row_length,
+                   sort_buffer_.data() + entry.offset);
+  }
+
+  LOG_TRACE("Spilled a run of %lu tuples", sort_entries_.size());
+
+  num_tuples_ += sort_entries_.size();
+  sort_buffer_.clear();
+  sort_entries_.clear();
+  live_bytes_ = 0;
+}
+
+/**
+ * @brief Merge the given runs into a new run. The merged runs are closed.
+ */
+FILE *OrderByExecutor::MergeRuns(size_t run_begin, size_t run_end) {
+  FILE *merged_run = CreateRunFile();
+
+  StartMerge(run_begin, run_end);
+  for (auto reader = NextMergedRecord(); reader != nullptr;
+       reader = NextMergedRecord()) {
+    WriteRunRecord(merged_run, reader->key_length, reader->row_length,
+                   reader->record.data());
+  }
+
+  for (size_t run_itr = run_begin; run_itr < run_end; run_itr++) {
+    fclose(runs_[run_itr]);
+  }
+  merge_readers_.clear();
+
+  return merged_run;
+}
+
+void OrderByExecutor::StartMerge(size_t run_begin, size_t run_end) {
+  merge_readers_.clear();
+  merge_heap_.clear();
+  merge_pending_ = false;
+
+  merge_readers_.reserve(run_end - run_begin);
+  for (size_t run_itr = run_begin; run_itr < run_end; run_itr++) {
+    rewind(runs_[run_itr]);
+
+    run_reader_t reader;
+    reader.file = runs_[run_itr];
+    if (ReadRunRecord(reader.file, reader.record, reader.key_length,
+                      reader.row_length)) {
+      merge_heap_.push_back(merge_readers_.size());
     }
+    merge_readers_.push_back(std::move(reader));
+  }
 
-    std::vector<bool> descend_flags;
+  std::make_heap(merge_heap_.begin(), merge_heap_.end(),
+                 [this](size_t lhs, size_t rhs) {
+                   return MergeReaderGreater(lhs, rhs);
+                 });
+}
+
+/**
+ * @brief Return the reader holding the smallest record among all runs being
+ * merged, or nullptr once they are exhausted. The record stays valid until
+ * the next call.
+ */
+OrderByExecutor::run_reader_t *OrderByExecutor::NextMergedRecord() {
+  auto comp = [this](size_t lhs, size_t rhs) {
+    return MergeReaderGreater(lhs, rhs);
   };
 
-  TupleComparer comp(descend_flags_);
+  // Advance the run of the record handed out last time
+  if (merge_pending_) {
+    auto &reader = merge_readers_[merge_current_];
+    if (ReadRunRecord(reader.file, reader.record, reader.key_length,
+                      reader.row_length)) {
+      merge_heap_.push_back(merge_current_);
+      std::push_heap(merge_heap_.begin(), merge_heap_.end(), comp);
+    }
+    merge_pending_ = false;
+  }
 
-  // Finally ... sort it !
-  std::sort(
-      sort_buffer_.begin(), sort_buffer_.end(),
-      [&comp](const sort_buffer_entry_t &a, const sort_buffer_entry_t &b) {
-        return comp(a.tuple.get(), b.tuple.get());
-      });
+  if (merge_heap_.empty()) return nullptr;
 
-  sort_done_ = true;
+  std::pop_heap(merge_heap_.begin(), merge_heap_.end(), comp);
+  merge_current_ = merge_heap_.back();
+  merge_heap_.pop_back();
+  merge_pending_ = true;
+
+  return &merge_readers_[merge_current_];
+}
+
+bool OrderByExecutor::NextSortRecord(const char *&row, uint32_t &row_length) {
+  if (runs_.empty()) {
+    if (num_tuples_returned_ >= sort_entries_.size()) return false;
+
+    auto &entry = sort_entries_[num_tuples_returned_];
+    row = sort_buffer_.data() + entry.offset + entry.key_length;
+    row_length = entry.row_length;
+  } else {
+    auto reader = NextMergedRecord();
+    if (reader == nullptr) return false;
+
+    row = reader->record.data() + reader->key_length;
+    row_length = reader->row_length;
+  }
 
+  num_tuples_returned_++;
   return true;
 }
 
+void OrderByExecutor::CloseRuns() {
+  for (auto run : runs_) {
+    fclose(run);
+  }
+  runs_.clear();
+  merge_readers_.clear();
+  merge_heap_.clear();
+  merge_pending_ = false;
+}
+
 } /* namespace executor */
 } /* namespace peloton */
@@ -11,6 +11,7 @@
 //===----------------------------------------------------------------------===//
 
 
+#include <unordered_map>
 #include <vector>
 
 #include "common/logger.h"
@@ -35,6 +36,35 @@ executor::AbstractExecutor *BuildExecutorTree(
 
 void CleanExecutorTree(executor::AbstractExecutor *root);
 
+void DeleteExecutorTree(executor::AbstractExecutor *root);
+
+bool IsReusablePlan(const planner::AbstractPlan *plan);
+
+peloton_status RunExecutorTree(executor::AbstractExecutor *executor_tree,
+                               executor::ExecutorContext *executor_context,
+                               concurrency::Transaction *txn,
+                               bool single_statement_txn,
+                               const ResultTileCallback &callback);
+
+/*
+ * Executor tree built for a plan shared by cached statements. Every thread
+ * keeps its own trees, so a tree is never executed concurrently.
+ */
+struct CachedExecutorTree {
+  ~CachedExecutorTree() { DeleteExecutorTree(executor_tree); }
+
+  // to detect another plan allocated at the address of a freed one
+  std::weak_ptr<planner::AbstractPlan> plan;
+
+  std::unique_ptr<executor::ExecutorContext> executor_context;
+
+  executor::AbstractExecutor *executor_tree = nullptr;
+};
+
+thread_local static std::unordered_map<
+    const planner::AbstractPlan *, std::unique_ptr<CachedExecutorTree>>
+    cached_executor_trees;
+
 /**
  * @brief Build a executor tree and execute it.
  * Use std::vector<Value> as params to make it more elegant for networking
@@ -43,15 +73,14 @@ void CleanExecutorTree(executor::AbstractExecutor *root);
  * @return status of execution.
  */
 peloton_status PlanExecutor::ExecutePlan(const planner::AbstractPlan *plan,
-                                         const std::vector<Value> &params) {
+                                         const std::vector<Value> &params,
+                                         const ResultTileCallback &callback) {
   peloton_status p_status;
 
   if (plan == nullptr) return p_status;
 
   LOG_INFO("PlanExecutor Start ");
 
-  bool status;
-  bool init_failure = false;
   bool single_statement_txn = false;
 
   auto &txn_manager = concurrency::TransactionManagerFactory::GetInstance();
@@ -74,72 +103,83 @@ peloton_status PlanExecutor::ExecutePlan(const planner::AbstractPlan *plan,
   std::unique_ptr<executor::AbstractExecutor> executor_tree(
       BuildExecutorTree(nullptr, plan, executor_context.get()));
 
-  LOG_INFO("Initializing the executor tree");
+  p_status = RunExecutorTree(executor_tree.get(), executor_context.get(), txn,
+                             single_statement_txn, callback);
 
-  // Initialize the executor tree
-  status = executor_tree->Init();
-
-  // Abort and cleanup
-  if (status == false) {
-    init_failure = true;
-    txn->SetResult(Result::RESULT_FAILURE);
-    goto cleanup;
-  }
-
-  LOG_INFO("Running the executor tree");
+  // clean up executor tree
+  CleanExecutorTree(executor_tree.get());
 
-  // Execute the tree until we get result tiles from root node
-  for (;;) {
-    status = executor_tree->Execute();
+  return p_status;
+}
 
-    // Stop
-    if (status == false) {
-      break;
-    }
+/**
+ * @brief Execute a plan with the executor tree of the calling thread.
+ * Plans that contain an executor that can not be re-initialized get a new
+ * executor tree every time.
+ * @return status of execution.
+ */
+peloton_status PlanExecutor::ExecutePlan(
+    const std::shared_ptr<planner::AbstractPlan> &plan,
+    const std::vector<Value> &params, const ResultTileCallback &callback) {
+  if (plan.get() == nullptr || IsReusablePlan(plan.get()) == false) {
+    return ExecutePlan(plan.get(), params, callback);
+  }
 
-    std::unique_ptr<executor::LogicalTile> logical_tile(
-        executor_tree->GetOutput());
+  LOG_INFO("PlanExecutor Start ");
 
-    // Some executors don't return logical tiles (e.g., Update).
-    if (logical_tile.get() == nullptr) {
-      continue;
-    }
+  bool single_statement_txn = false;
 
-    // Go over the logical tile
+  auto &txn_manager = concurrency::TransactionManagerFactory::GetInstance();
+  auto txn = peloton::concurrency::current_txn;
+  // This happens for single statement queries in PG
+  if (txn == nullptr) {
+    single_statement_txn = true;
+    txn = txn_manager.BeginTransaction();
   }
+  PL_ASSERT(txn);
 
-  // Set the result
-  p_status.m_processed = executor_context->num_processed;
-  p_status.m_result_slots = nullptr;
+  LOG_INFO("Txn ID = %lu ", txn->GetTransactionId());
 
-// final cleanup
-cleanup:
+  auto itr = cached_executor_trees.find(plan.get());
+  if (itr != cached_executor_trees.end() && itr->second->plan.lock() != plan) {
+    cached_executor_trees.erase(itr);
+    itr = cached_executor_trees.end();
+  }
 
-  LOG_INFO("About to commit: single stmt: %d, init_failure: %d, status: %d",
-            single_statement_txn, init_failure, txn->GetResult());
+  if (itr != cached_executor_trees.end()) {
+    LOG_INFO("Reusing the executor tree");
+    itr->second->executor_context->Reset(txn, params);
+  } else {
+    LOG_INFO("Building the executor tree");
+
+    // make room by dropping the trees of freed plans, or all of them
+    if (cached_executor_trees.size() >= EXECUTOR_TREE_CACHE_SIZE) {
+      for (auto tree_itr = cached_executor_trees.begin();
+           tree_itr != cached_executor_trees.end();) {
+        if (tree_itr->second->plan.expired()) {
+          tree_itr = cached_executor_trees.erase(tree_itr);
+        } else {
+          ++tree_itr;
+        }
+      }
+      if (cached_executor_trees.size() >= EXECUTOR_TREE_CACHE_SIZE) {
+        cached_executor_trees.clear();
+      }
+    }
 
-  // should we commit or abort ?
-  if (single_statement_txn == true || init_failure == true) {
-    auto status = txn->GetResult();
-    switch (status) {
-      case Result::RESULT_SUCCESS:
-        // Commit
-    	LOG_INFO("Commit Transaction");
-        p_status.m_result = txn_manager.CommitTransaction();
-        break;
+    std::unique_ptr<CachedExecutorTree> cached_tree(new CachedExecutorTree());
+    cached_tree->plan = plan;
+    cached_tree->executor_context.reset(BuildExecutorContext(params, txn));
+    cached_tree->executor_tree = BuildExecutorTree(
+        nullptr, plan.get(), cached_tree->executor_context.get());
 
-      case Result::RESULT_FAILURE:
-      default:
-        // Abort
-    	LOG_INFO("Abort Transaction");
-        p_status.m_result = txn_manager.AbortTransaction();
-    }
+    itr = cached_executor_trees.emplace(plan.get(), std::move(cached_tree))
+              .first;
   }
 
-  // clean up executor tree
-  CleanExecutorTree(executor_tree.get());
-
-  return p_status;
+  return RunExecutorTree(itr->second->executor_tree,
+                         itr->second->executor_context.get(), txn,
+                         single_statement_txn, callback);
 }
 
 /**
@@ -269,6 +309,94 @@ void PlanExecutor::PrintPlan(const planner::AbstractPlan *plan,
   }
 }
 
+/**
+ * @brief Initialize and run an executor tree, then end the transaction if
+ * the statement runs in its own one. Every result tile is handed to the
+ * callback, if there is one, before the next one is produced.
+ * @return status of execution.
+ */
+peloton_status RunExecutorTree(executor::AbstractExecutor *executor_tree,
+                               executor::ExecutorContext *executor_context,
+                               concurrency::Transaction *txn,
+                               bool single_statement_txn,
+                               const ResultTileCallback &callback) {
+  peloton_status p_status;
+
+  bool status;
+  bool init_failure = false;
+
+  auto &txn_manager = concurrency::TransactionManagerFactory::GetInstance();
+
+  LOG_INFO("Initializing the executor tree");
+
+  // Initialize the executor tree
+  status = executor_tree->Init();
+
+  // Abort and cleanup
+  if (status == false) {
+    init_failure = true;
+    txn->SetResult(Result::RESULT_FAILURE);
+    goto cleanup;
+  }
+
+  LOG_INFO("Running the executor tree");
+
+  // Execute the tree until we get result tiles from root node
+  for (;;) {
+    status = executor_tree->Execute();
+
+    // Stop
+    if (status == false) {
+      break;
+    }
+
+    std::unique_ptr<executor::LogicalTile> logical_tile(
+        executor_tree->GetOutput());
+
+    // Some executors don't return logical tiles (e.g., Update).
+    if (logical_tile.get() == nullptr) {
+      continue;
+    }
+
+    // Go over the logical tile
+    if (callback != nullptr && callback(logical_tile.get()) == false) {
+      LOG_INFO("Result consumer stopped the execution");
+      txn->SetResult(Result::RESULT_FAILURE);
+      break;
+    }
+  }
+
+  // Set the result
+  p_status.m_processed = executor_context->num_processed;
+  p_status.m_result_slots = nullptr;
+
+// final cleanup
+cleanup:
+
+  LOG_INFO("About to commit: single stmt: %d, init_failure: %d, status: %d",
+            single_statement_txn, init_failure, txn->GetResult());
+
+  // should we commit or abort ?
+  if (single_statement_txn == true || init_failure == true) {
+    auto status = txn->GetResult();
+    switch (status) {
+      case Result::RESULT_SUCCESS:
+        // Commit
+    	LOG_INFO("Commit Transaction");
+        p_status.m_result = txn_manager.CommitTransaction();
+        break;
+
+      case Result::RESULT_FAILURE:
+      default:
+        // Abort
+    	LOG_INFO("Abort Transaction");
+        p_status.m_result = txn_manager.AbortTransaction();
+    }
+  }
+
+  return p_status;
+}
+
 /**
  * @brief Build Executor Context
  */
@@ -364,6 +492,10 @@ executor::AbstractExecutor *BuildExecutorTree(
       child_executor = new executor::CreateExecutor(plan, executor_context);
       break;
 
+    case PLAN_NODE_TYPE_IMPORT:
+      child_executor = new executor::ImportExecutor(plan, executor_context);
+      break;
+
     default:
       LOG_ERROR("Unsupported plan node type : %d ", plan_node_type);
       break;
@@ -387,6 +519,37 @@ executor::AbstractExecutor *BuildExecutorTree(
   return root;
 }
 
+/**
+ * @brief Check whether every executor of the plan resets its state in
+ * DInit, so that its executor tree can be executed again.
+ * @param The plan tree
+ * @return true if the executor tree of the plan can be reused.
+ */
+bool IsReusablePlan(const planner::AbstractPlan *plan) {
+  switch (plan->GetPlanNodeType()) {
+    case PLAN_NODE_TYPE_SEQSCAN:
+    case PLAN_NODE_TYPE_INDEXSCAN:
+    case PLAN_NODE_TYPE_INSERT:
+    case PLAN_NODE_TYPE_DELETE:
+    case PLAN_NODE_TYPE_UPDATE:
+    case PLAN_NODE_TYPE_LIMIT:
+    case PLAN_NODE_TYPE_PROJECTION:
+    case PLAN_NODE_TYPE_MATERIALIZE:
+      break;
+
+    default:
+      return false;
+  }
+
+  for (auto &child : plan->GetChildren()) {
+    if (IsReusablePlan(child.get()) == false) {
+      return false;
+    }
+  }
+
+  return true;
+}
+
 /**
  * @brief Clean up the executor tree.
  * @param The current executor tree
@@ -402,5 +565,20 @@ void CleanExecutorTree(executor::AbstractExecutor *root) {
   }
 }
 
+/**
+ * @brief Free the executor tree.
+ * @param The current executor tree
+ * @return none.
+ */
+void DeleteExecutorTree(executor::AbstractExecutor *root) {
+  if (root == nullptr) return;
+
+  for (auto child : root->GetChildren()) {
+    DeleteExecutorTree(child);
+  }
+
+  delete root;
+}
+
 }  // namespace bridge
 }  // namespace peloton
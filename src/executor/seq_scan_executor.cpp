@@ -14,6 +14,7 @@
 #include "executor/seq_scan_executor.h"
 
 #include <memory>
+#include <numeric>
 #include <utility>
 #include <vector>
 
@@ -26,6 +27,7 @@
 #include "storage/data_table.h"
 #include "storage/tile_group_header.h"
 #include "storage/tile.h"
+#include "storage/tuple.h"
 #include "concurrency/transaction_manager_factory.h"
 #include "common/logger.h"
 #include "index/index.h"
@@ -56,6 +58,7 @@ bool SeqScanExecutor::DInit() {
   target_table_ = node.GetTable();
 
   current_tile_group_offset_ = START_OID;
+  delta_tile_.reset();
 
   if (target_table_ != nullptr) {
     table_tile_group_count_ = target_table_->GetTileGroupCount();
@@ -121,6 +124,12 @@ bool SeqScanExecutor::DExecute() {
     // LOG_TRACE("Number of tuples: %f",
     // target_table_->GetIndex(0)->GetNumberOfTuples());
 
+    // Emit the rebuilt versions of the previous tile group.
+    if (delta_tile_ != nullptr) {
+      SetOutput(delta_tile_.release());
+      return true;
+    }
+
     // Retrieve next tile group.
     while (current_tile_group_offset_ < table_tile_group_count_) {
       auto tile_group =
@@ -129,41 +138,42 @@ bool SeqScanExecutor::DExecute() {
 
       oid_t active_tuple_count = tile_group->GetNextTupleSlot();
 
-      // Construct position list by looping through tile group
-      // and applying the predicate.
+      // Construct position list by checking the visibility of the whole
+      // tile group at once and then applying the predicate.
       std::vector<oid_t> position_list;
-      for (oid_t tuple_id = 0; tuple_id < active_tuple_count; tuple_id++) {
-        ItemPointer location(tile_group->GetTileGroupId(), tuple_id);
-
-        // check transaction visibility
-        if (transaction_manager.IsVisible(tile_group_header, tuple_id)) {
-          // if the tuple is visible, then perform predicate evaluation.
-          if (predicate_ == nullptr) {
-            position_list.push_back(tuple_id);
-            auto res = transaction_manager.PerformRead(location);
-            if (!res) {
-              transaction_manager.SetTransactionResult(RESULT_FAILURE);
-              return res;
-            }
-          } else {
-            expression::ContainerTuple<storage::TileGroup> tuple(
-                tile_group.get(), tuple_id);
-            auto eval = predicate_->Evaluate(&tuple, nullptr, executor_context_)
-                            .IsTrue();
-            if (eval == true) {
-              position_list.push_back(tuple_id);
-              auto res = transaction_manager.PerformRead(location);
-              if (!res) {
-                transaction_manager.SetTransactionResult(RESULT_FAILURE);
-                return res;
-              }
-            }
-          }
+      transaction_manager.GetVisibleTuples(tile_group_header,
+                                           active_tuple_count, position_list);
+
+      // versions that are no longer in their slots are copied and emitted
+      // separately.
+      if (concurrency::TransactionManagerFactory::GetVersionStorage() ==
+          VERSION_STORAGE_TYPE_DELTA) {
+        auto res = ReconstructVersions(tile_group, position_list);
+        if (!res) {
+          transaction_manager.SetTransactionResult(RESULT_FAILURE);
+          return res;
         }
       }
 
+      // if there is a predicate, evaluate it over all visible tuples at once.
+      if (predicate_ != nullptr) {
+        predicate_->EvaluateBatch(tile_group.get(), position_list,
+                                  executor_context_);
+      }
+
+      auto res = transaction_manager.PerformReads(
+          tile_group->GetTileGroupId(), tile_group_header, position_list);
+      if (!res) {
+        transaction_manager.SetTransactionResult(RESULT_FAILURE);
+        return res;
+      }
+
       // Don't return empty tiles
       if (position_list.size() == 0) {
+        if (delta_tile_ != nullptr) {
+          SetOutput(delta_tile_.release());
+          return true;
+        }
         continue;
       }
 
@@ -180,5 +190,61 @@ bool SeqScanExecutor::DExecute() {
   return false;
 }
 
+/**
+ * @brief Copies the visible versions of the tuples that other transactions
+ *        overwrote in place, rebuilding them from the delta chains.
+ * @param tile_group Tile group being scanned.
+ * @param position_list Visible tuples, the copied ones are removed from it.
+ * @return false if a copied version can not be read, true otherwise.
+ *
+ * The tile group is pinned first, so the tuples left in the position list
+ * are not overwritten while the result is in use. The copies that satisfy
+ * the predicate are kept in delta_tile_.
+ */
+bool SeqScanExecutor::ReconstructVersions(
+    const std::shared_ptr<storage::TileGroup> &tile_group,
+    std::vector<oid_t> &position_list) {
+  concurrency::TransactionManager &transaction_manager =
+      concurrency::TransactionManagerFactory::GetInstance();
+  auto schema = target_table_->GetSchema();
+  auto pool = executor_context_->GetExecutorContextPool();
+
+  executor_context_->PinTileGroup(tile_group);
+
+  std::vector<std::unique_ptr<storage::Tuple>> delta_tuples;
+  oid_t kept_count = 0;
+  for (auto tuple_id : position_list) {
+    std::unique_ptr<storage::Tuple> tuple(new storage::Tuple(schema, true));
+    if (transaction_manager.ReconstructVersion(tile_group.get(), tuple_id,
+                                               tuple.get(), pool) == false) {
+      position_list[kept_count++] = tuple_id;
+      continue;
+    }
+
+    if (predicate_ != nullptr &&
+        predicate_->Evaluate(tuple.get(), nullptr, executor_context_)
+            .IsTrue() == false) {
+      continue;
+    }
+
+    ItemPointer location(tile_group->GetTileGroupId(), tuple_id);
+    if (transaction_manager.PerformRead(location) == false) {
+      return false;
+    }
+    delta_tuples.push_back(std::move(tuple));
+  }
+  position_list.resize(kept_count);
+
+  if (delta_tuples.empty()) {
+    return true;
+  }
+
+  delta_tile_.reset(LogicalTileFactory::WrapTuples(delta_tuples, schema));
+  std::vector<oid_t> original_column_ids(schema->GetColumnCount());
+  std::iota(original_column_ids.begin(), original_column_ids.end(), 0);
+  delta_tile_->ProjectColumns(original_column_ids, column_ids_);
+  return true;
+}
+
 }  // namespace executor
 }  // namespace peloton
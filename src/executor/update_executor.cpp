@@ -12,12 +12,16 @@
 
 
 #include "executor/update_executor.h"
+
+#include <set>
+
 #include "planner/update_plan.h"
 #include "common/logger.h"
 #include "catalog/manager.h"
 #include "executor/logical_tile.h"
 #include "executor/executor_context.h"
 #include "expression/container_tuple.h"
+#include "index/index.h"
 #include "concurrency/transaction.h"
 #include "concurrency/transaction_manager_factory.h"
 #include "storage/data_table.h"
@@ -42,8 +46,6 @@ UpdateExecutor::UpdateExecutor(const planner::AbstractPlan *node,
  */
 bool UpdateExecutor::DInit() {
   PL_ASSERT(children_.size() == 1);
-  PL_ASSERT(target_table_ == nullptr);
-  PL_ASSERT(project_info_ == nullptr);
 
   // Grab settings from node
   const planner::UpdatePlan &node = GetPlanNode<planner::UpdatePlan>();
@@ -53,6 +55,42 @@ bool UpdateExecutor::DInit() {
   PL_ASSERT(target_table_);
   PL_ASSERT(project_info_);
 
+  // Collect the columns modified by the update
+  std::set<oid_t> modified_columns;
+  for (auto &target : project_info_->GetTargetList()) {
+    modified_columns.insert(target.first);
+  }
+  for (auto &direct_map : project_info_->GetDirectMapList()) {
+    if (direct_map.second.first != 0 ||
+        direct_map.first != direct_map.second.second) {
+      modified_columns.insert(direct_map.first);
+    }
+  }
+
+  delta_columns_.clear();
+  for (auto column_id : modified_columns) {
+    delta_columns_.emplace_back(column_id, nullptr);
+  }
+
+  // Tuples are only updated in place if no index has to change
+  delta_update_ =
+      (concurrency::TransactionManagerFactory::GetVersionStorage() ==
+       VERSION_STORAGE_TYPE_DELTA);
+  auto index_count = target_table_->GetIndexCount();
+  for (oid_t index_itr = 0; index_itr < index_count && delta_update_;
+       index_itr++) {
+    auto index = target_table_->GetIndex(index_itr);
+    if (index == nullptr) {
+      continue;
+    }
+    for (auto column_id : index->GetKeySchema()->GetIndexedColumns()) {
+      if (modified_columns.count(column_id) != 0) {
+        delta_update_ = false;
+        break;
+      }
+    }
+  }
+
   return true;
 }
 
@@ -76,12 +114,25 @@ bool UpdateExecutor::DExecute() {
   auto &pos_lists = source_tile.get()->GetPositionLists();
   storage::Tile *tile = source_tile->GetBaseTile(0);
   storage::TileGroup *tile_group = tile->GetTileGroup();
-  storage::TileGroupHeader *tile_group_header = tile_group->GetHeader();
-  auto tile_group_id = tile_group->GetTileGroupId();
 
   auto &transaction_manager =
       concurrency::TransactionManagerFactory::GetInstance();
 
+  // Versions rebuilt from delta chains are not the latest versions
+  if (tile_group == nullptr) {
+    LOG_TRACE("Fail to update an older version. Set txn failure.");
+    transaction_manager.SetTransactionResult(Result::RESULT_FAILURE);
+    return false;
+  }
+
+  storage::TileGroupHeader *tile_group_header = tile_group->GetHeader();
+  auto tile_group_id = tile_group->GetTileGroupId();
+
+  // Tuples updated in place are owned without a newer version
+  bool delta_storage =
+      (concurrency::TransactionManagerFactory::GetVersionStorage() ==
+       VERSION_STORAGE_TYPE_DELTA);
+
   // Update tuples in given table
   for (oid_t visible_tuple_id : *source_tile) {
     oid_t physical_tuple_id = pos_lists[0][visible_tuple_id];
@@ -91,8 +142,20 @@ bool UpdateExecutor::DExecute() {
     LOG_TRACE("Visible Tuple id : %u, Physical Tuple id : %u ",
               visible_tuple_id, physical_tuple_id);
 
-    if (transaction_manager.IsOwner(tile_group_header, physical_tuple_id) ==
-        true) {
+    if (delta_storage == true &&
+        transaction_manager.IsOwner(tile_group_header, physical_tuple_id) ==
+            true &&
+        tile_group_header->GetBeginCommitId(physical_tuple_id) != MAX_CID) {
+      // the tuple was already updated in place by the transaction
+      if (delta_update_ == false) {
+        LOG_TRACE("Fail to update tuple. Set txn failure.");
+        transaction_manager.SetTransactionResult(Result::RESULT_FAILURE);
+        return false;
+      }
+      PerformInPlaceUpdate(tile_group, physical_tuple_id);
+
+    } else if (transaction_manager.IsOwner(tile_group_header,
+                                           physical_tuple_id) == true) {
       // Make a copy of the original tuple and allocate a new tuple
       expression::ContainerTuple<storage::TileGroup> old_tuple(
           tile_group, physical_tuple_id);
@@ -120,6 +183,19 @@ bool UpdateExecutor::DExecute() {
         transaction_manager.SetTransactionResult(Result::RESULT_FAILURE);
         return false;
       }
+
+      // the slot is overwritten only if no other executor context may still
+      // read it in place. the pins are read after the ownership is taken,
+      // so a later reader sees the owner and copies the version instead.
+      size_t own_pin_count =
+          executor_context_->IsTileGroupPinned(tile_group_id) ? 1 : 0;
+      if (delta_update_ == true &&
+          tile_group_header->GetPinCount() == own_pin_count) {
+        PerformInPlaceUpdate(tile_group, physical_tuple_id);
+        executor_context_->num_processed += 1;  // updated one
+        continue;
+      }
+
       // if it is the latest version and not locked by other threads, then
       // insert a new version.
       std::unique_ptr<storage::Tuple> new_tuple(
@@ -165,5 +241,28 @@ bool UpdateExecutor::DExecute() {
   return true;
 }
 
+/**
+ * @brief Overwrites a tuple owned by the transaction in place, after its
+ *        modified columns are saved in a rollback segment.
+ */
+void UpdateExecutor::PerformInPlaceUpdate(storage::TileGroup *tile_group,
+                                          const oid_t physical_tuple_id) {
+  auto &transaction_manager =
+      concurrency::TransactionManagerFactory::GetInstance();
+
+  expression::ContainerTuple<storage::TileGroup> old_tuple(tile_group,
+                                                           physical_tuple_id);
+  std::unique_ptr<storage::Tuple> new_tuple(
+      new storage::Tuple(target_table_->GetSchema(), true));
+  project_info_->Evaluate(new_tuple.get(), &old_tuple, nullptr,
+                          executor_context_);
+
+  ItemPointer location(tile_group->GetTileGroupId(), physical_tuple_id);
+  transaction_manager.PerformInPlaceUpdate(location, delta_columns_);
+  // concurrent readers copy the slot and restore the modified columns from
+  // the segment pushed above
+  tile_group->CopyTuple(new_tuple.get(), physical_tuple_id);
+}
+
 }  // namespace executor
 }  // namespace peloton
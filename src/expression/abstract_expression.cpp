@@ -21,6 +21,7 @@
 #include "common/serializer.h"
 #include "common/types.h"
 #include "expression/abstract_expression.h"
+#include "expression/container_tuple.h"
 #include "executor/executor_context.h"
 #include "expression/expression_util.h"
 
@@ -48,6 +49,21 @@ AbstractExpression::~AbstractExpression() {
   }
 }
 
+void AbstractExpression::EvaluateBatch(storage::TileGroup *tile_group,
+                                       std::vector<oid_t> &selection_vector,
+                                       executor::ExecutorContext *context) const {
+  size_t selected_count = 0;
+
+  for (auto tuple_id : selection_vector) {
+    ContainerTuple<storage::TileGroup> tuple(tile_group, tuple_id);
+    if (Evaluate(&tuple, nullptr, context).IsTrue()) {
+      selection_vector[selected_count++] = tuple_id;
+    }
+  }
+
+  selection_vector.resize(selected_count);
+}
+
 bool AbstractExpression::HasParameter() const {
   if (m_left && m_left->HasParameter()) return true;
   return (m_right && m_right->HasParameter());
@@ -0,0 +1,170 @@
+//===----------------------------------------------------------------------===//
+//
+//                         Peloton
+//
+// comparison_expression.cpp
+//
+// Identification: src/expression/comparison_expression.cpp
+//
+// Copyright (c) 2015-16, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+
+#include <limits>
+
+#include "common/value_peeker.h"
+#include "expression/comparison_expression.h"
+#include "storage/tile.h"
+#include "storage/tile_group.h"
+
+namespace peloton {
+namespace expression {
+
+//===--------------------------------------------------------------------===//
+// Batch evaluation kernels
+//===--------------------------------------------------------------------===//
+
+// Filter the selection vector with "column OP constant" (or "constant OP
+// column" if the column is on the right side). The column is a strided array
+// of native values; NULLs are stored as the type's minimum value and never
+// satisfy a comparison. Compaction is branch-free so the loop vectorizes.
+template <typename OP, typename ColumnType, bool column_on_left>
+static void FilterColumn(const char *column_base, const size_t stride,
+                         const int64_t constant,
+                         std::vector<oid_t> &selection_vector) {
+  const ColumnType null_value = std::numeric_limits<ColumnType>::min();
+  size_t selected_count = 0;
+
+  for (auto tuple_id : selection_vector) {
+    const ColumnType raw_value =
+        *reinterpret_cast<const ColumnType *>(column_base + tuple_id * stride);
+    const int64_t value = raw_value;
+
+    bool selected = (raw_value != null_value) &&
+                    (column_on_left ? OP::compare_raw(value, constant)
+                                    : OP::compare_raw(constant, value));
+
+    selection_vector[selected_count] = tuple_id;
+    selected_count += selected;
+  }
+
+  selection_vector.resize(selected_count);
+}
+
+template <typename OP, bool column_on_left>
+static bool FilterColumn(const ValueType column_type, const char *column_base,
+                         const size_t stride, const int64_t constant,
+                         std::vector<oid_t> &selection_vector) {
+  switch (column_type) {
+    case VALUE_TYPE_TINYINT:
+      FilterColumn<OP, int8_t, column_on_left>(column_base, stride, constant,
+                                               selection_vector);
+      return true;
+    case VALUE_TYPE_SMALLINT:
+      FilterColumn<OP, int16_t, column_on_left>(column_base, stride, constant,
+                                                selection_vector);
+      return true;
+    case VALUE_TYPE_INTEGER:
+      FilterColumn<OP, int32_t, column_on_left>(column_base, stride, constant,
+                                                selection_vector);
+      return true;
+    case VALUE_TYPE_BIGINT:
+      FilterColumn<OP, int64_t, column_on_left>(column_base, stride, constant,
+                                                selection_vector);
+      return true;
+    default:
+      return false;
+  }
+}
+
+static bool IsConstantOrParameter(const AbstractExpression *expression) {
+  auto expression_type = expression->GetExpressionType();
+  return (expression_type == EXPRESSION_TYPE_VALUE_CONSTANT ||
+          expression_type == EXPRESSION_TYPE_VALUE_PARAMETER);
+}
+
+// Run the batch kernel if the comparison is between an integral column of
+// the tile group and an integral constant. Returns false if it is not.
+template <typename OP>
+static bool EvaluateComparisonBatch(const AbstractExpression *left,
+                                    const AbstractExpression *right,
+                                    storage::TileGroup *tile_group,
+                                    std::vector<oid_t> &selection_vector,
+                                    executor::ExecutorContext *context) {
+  const TupleValueExpression *column_expression = nullptr;
+  const AbstractExpression *constant_expression = nullptr;
+  bool column_on_left = true;
+
+  if (left->GetExpressionType() == EXPRESSION_TYPE_VALUE_TUPLE &&
+      IsConstantOrParameter(right)) {
+    column_expression = static_cast<const TupleValueExpression *>(left);
+    constant_expression = right;
+  } else if (right->GetExpressionType() == EXPRESSION_TYPE_VALUE_TUPLE &&
+             IsConstantOrParameter(left)) {
+    column_expression = static_cast<const TupleValueExpression *>(right);
+    constant_expression = left;
+    column_on_left = false;
+  } else {
+    return false;
+  }
+
+  if (column_expression->GetTupleIdx() != 0) {
+    return false;
+  }
+
+  // Evaluate the constant side once for the whole batch
+  Value constant = constant_expression->Evaluate(nullptr, nullptr, context);
+  if (IsIntegralType(constant.GetValueType()) == false) {
+    return false;
+  }
+
+  // A comparison with NULL is never true
+  if (constant.IsNull()) {
+    selection_vector.clear();
+    return true;
+  }
+
+  // Locate the column in the tile group
+  oid_t tile_offset, tile_column_id;
+  tile_group->LocateTileAndColumn(column_expression->GetColumnId(),
+                                  tile_offset, tile_column_id);
+  auto tile = tile_group->GetTile(tile_offset);
+  auto tile_schema = tile->GetSchema();
+
+  const char *column_base =
+      tile->GetTupleLocation(0) + tile_schema->GetOffset(tile_column_id);
+  const size_t stride = tile_schema->GetLength();
+  const ValueType column_type = tile_schema->GetType(tile_column_id);
+  const int64_t constant_value = ValuePeeker::PeekAsBigInt(constant);
+
+  if (column_on_left) {
+    return FilterColumn<OP, true>(column_type, column_base, stride,
+                                  constant_value, selection_vector);
+  } else {
+    return FilterColumn<OP, false>(column_type, column_base, stride,
+                                   constant_value, selection_vector);
+  }
+}
+
+#define COMPARISON_EVALUATE_BATCH(OP)                                       \
+  template <>                                                               \
+  void ComparisonExpression<OP>::EvaluateBatch(                             \
+      storage::TileGroup *tile_group, std::vector<oid_t> &selection_vector, \
+      executor::ExecutorContext *context) const {                           \
+    if (EvaluateComparisonBatch<OP>(m_left, m_right, tile_group,            \
+                                    selection_vector, context) == false) {  \
+      AbstractExpression::EvaluateBatch(tile_group, selection_vector,       \
+                                        context);                           \
+    }                                                                       \
+  }
+
+COMPARISON_EVALUATE_BATCH(CmpEq)
+COMPARISON_EVALUATE_BATCH(CmpNe)
+COMPARISON_EVALUATE_BATCH(CmpLt)
+COMPARISON_EVALUATE_BATCH(CmpGt)
+COMPARISON_EVALUATE_BATCH(CmpLte)
+COMPARISON_EVALUATE_BATCH(CmpGte)
+
+}  // End expression namespace
+}  // End peloton namespace
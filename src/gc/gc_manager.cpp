@@ -16,8 +16,11 @@
 #include "gc/gc_manager_factory.h"
 #include "index/index.h"
 #include "concurrency/transaction_manager_factory.h"
-
-#include <list>
+#include "concurrency/ts_order_txn_manager.h"
+#include "storage/data_table.h"
+#include "storage/rollback_segment.h"
+#include "storage/tile_group.h"
+#include "storage/tuple.h"
 
 namespace peloton {
 namespace gc {
@@ -42,7 +45,10 @@ void GCManager::StartGC() {
     return;
   }
   this->is_running_ = true;
-  gc_thread_.reset(new std::thread(&GCManager::Running, this));
+  for (size_t thread_itr = 0; thread_itr < thread_count_; thread_itr++) {
+    gc_threads_.emplace_back(
+        new std::thread(&GCManager::Running, this, thread_itr));
+  }
 }
 
 void GCManager::StopGC() {
@@ -51,7 +57,10 @@ void GCManager::StopGC() {
     return;
   }
   this->is_running_ = false;
-  this->gc_thread_->join();
+  for (auto &gc_thread : gc_threads_) {
+    gc_thread->join();
+  }
+  gc_threads_.clear();
   ClearGarbage();
 }
 
@@ -78,6 +87,14 @@ bool GCManager::ResetTuple(const TupleMetadata &tuple_metadata) {
 
   auto tile_group_header = tile_group->GetHeader();
 
+  // Remove the index entries of the version before its slot is reused
+  UnlinkIndexEntries(tile_group.get(), tuple_metadata.tuple_slot_id);
+
+  // The delta chain of the slot is dropped with the reserved field, under its
+  // latch as the chain of a reused slot may still be trimmed
+  concurrency::TsOrderTxnManager::LockDeltaChain(tile_group_header,
+                                                 tuple_metadata.tuple_slot_id);
+
   // Reset the header
   tile_group_header->SetTransactionId(tuple_metadata.tuple_slot_id,
                                       INVALID_TXN_ID);
@@ -87,6 +104,7 @@ bool GCManager::ResetTuple(const TupleMetadata &tuple_metadata) {
                                         INVALID_ITEMPOINTER);
   tile_group_header->SetNextItemPointer(tuple_metadata.tuple_slot_id,
                                         INVALID_ITEMPOINTER);
+  COMPILER_MEMORY_FENCE;
   PL_MEMSET(
       tile_group_header->GetReservedFieldRef(tuple_metadata.tuple_slot_id), 0,
       storage::TileGroupHeader::GetReservedSize());
@@ -97,49 +115,212 @@ bool GCManager::ResetTuple(const TupleMetadata &tuple_metadata) {
   return true;
 }
 
+/**
+ * @brief Remove the index entries that point at a dead version.
+ *
+ * Every version is inserted in the secondary indexes, so their entries are
+ * simply deleted. The primary index only points at the oldest version of a
+ * tuple, the one without a previous version. If there is a next version,
+ * the location stored in its entry is swapped to it in place, so that a
+ * concurrent lookup never finds the key missing. The primary index keeps
+ * its locations out of line, so the stored location has a stable address.
+ */
+void GCManager::UnlinkIndexEntries(storage::TileGroup *tile_group,
+                                   const oid_t &tuple_slot_id) {
+  auto table = static_cast<storage::DataTable *>(tile_group->GetAbstractTable());
+  if (table == nullptr) {
+    return;
+  }
+
+  auto tile_group_header = tile_group->GetHeader();
+  ItemPointer location(tile_group->GetTileGroupId(), tuple_slot_id);
+  ItemPointer prev_location =
+      tile_group_header->GetPrevItemPointer(tuple_slot_id);
+  ItemPointer next_location =
+      tile_group_header->GetNextItemPointer(tuple_slot_id);
+
+  auto index_count = table->GetIndexCount();
+  for (oid_t index_itr = 0; index_itr < index_count; index_itr++) {
+    auto index = table->GetIndex(index_itr);
+    if (index == nullptr) {
+      continue;
+    }
+
+    bool is_primary =
+        (index->GetIndexType() == INDEX_CONSTRAINT_TYPE_PRIMARY_KEY);
+    if (is_primary == true && prev_location.IsNull() == false) {
+      continue;
+    }
+
+    auto index_schema = index->GetKeySchema();
+    auto indexed_columns = index_schema->GetIndexedColumns();
+    std::unique_ptr<storage::Tuple> key(new storage::Tuple(index_schema, true));
+    for (oid_t column_itr = 0; column_itr < indexed_columns.size();
+         column_itr++) {
+      key->SetValue(column_itr,
+                    tile_group->GetValue(tuple_slot_id,
+                                         indexed_columns[column_itr]),
+                    index->GetPool());
+    }
+
+    if (is_primary == true && next_location.IsNull() == false) {
+      // A reader may have swapped the entry to a newer version already
+      std::vector<ItemPointer *> entry_locations;
+      index->ScanKey(key.get(), entry_locations);
+      for (auto entry_location : entry_locations) {
+        if (AtomicCompareAndSwapItemPointer(entry_location, location,
+                                            next_location) == true) {
+          break;
+        }
+      }
+      continue;
+    }
+
+    index->DeleteEntry(key.get(), location);
+  }
+
+  // The next version becomes the oldest one
+  if (next_location.IsNull() == false) {
+    auto &manager = catalog::Manager::GetInstance();
+    auto next_tile_group = manager.GetTileGroup(next_location.block);
+    if (next_tile_group != nullptr) {
+      next_tile_group->GetHeader()->SetPrevItemPointer(next_location.offset,
+                                                       INVALID_ITEMPOINTER);
+    }
+  }
+}
+
+/**
+ * @brief Cut the rollback segments of a transaction off the delta chains.
+ *
+ * A chain is ordered from the newest segment to the oldest one, so once a
+ * segment holds a version that ended before the oldest running transaction
+ * started, it and every older segment are never applied again.
+ */
+void GCManager::UnlinkRollbackSegments(const RollbackSegmentMetadata &metadata,
+                                       const cid_t &max_cid) {
+  auto &manager = catalog::Manager::GetInstance();
+  for (auto &location : metadata.locations) {
+    auto tile_group = manager.GetTileGroup(location.block);
+    if (tile_group == nullptr) {
+      continue;
+    }
+
+    auto tile_group_header = tile_group->GetHeader();
+    concurrency::TsOrderTxnManager::LockDeltaChain(tile_group_header,
+                                                   location.offset);
+
+    char *prev_seg = nullptr;
+    char *rb_seg = concurrency::TsOrderTxnManager::GetDeltaChainHead(
+        tile_group_header, location.offset);
+    while (rb_seg != nullptr &&
+           storage::RollbackSegmentPool::GetTimeStamp(rb_seg) > max_cid) {
+      prev_seg = rb_seg;
+      rb_seg = storage::RollbackSegmentPool::GetNextPtr(rb_seg);
+    }
+
+    if (rb_seg != nullptr) {
+      if (prev_seg == nullptr) {
+        concurrency::TsOrderTxnManager::SetDeltaChainHead(
+            tile_group_header, location.offset, nullptr);
+      } else {
+        storage::RollbackSegmentPool::SetNextPtr(prev_seg, nullptr);
+      }
+    }
+
+    COMPILER_MEMORY_FENCE;
+    concurrency::TsOrderTxnManager::UnlockDeltaChain(tile_group_header,
+                                                     location.offset);
+  }
+}
+
+/**
+ * @brief Trim the delta chains and free the rollback segments in two phases.
+ *
+ * The segments of a transaction are unlinked once its versions are garbage.
+ * Readers walk the chains without the latch, so a pool is only freed after
+ * every transaction that started before the unlink is done. Returns the
+ * number of freed pools.
+ */
+size_t GCManager::ReclaimRollbackSegments(
+    std::vector<RollbackSegmentMetadata> &local_rb_seg_queue,
+    const cid_t &max_cid, const bool is_running) {
+  auto &txn_manager = concurrency::TransactionManagerFactory::GetInstance();
+
+  size_t freed_count = 0;
+  size_t kept_count = 0;
+  for (size_t itr = 0; itr < local_rb_seg_queue.size(); itr++) {
+    auto &metadata = local_rb_seg_queue[itr];
+
+    if (metadata.unlink_cid == INVALID_CID &&
+        (is_running == false || metadata.end_cid <= max_cid)) {
+      UnlinkRollbackSegments(metadata, is_running ? max_cid : MAX_CID - 1);
+      metadata.unlink_cid = txn_manager.GetCurrentCommitId();
+    }
+
+    if (metadata.unlink_cid != INVALID_CID &&
+        (is_running == false || metadata.unlink_cid <= max_cid)) {
+      rb_seg_backlog_count_--;
+      freed_count++;
+      continue;
+    }
+
+    if (kept_count != itr) {
+      local_rb_seg_queue[kept_count] = std::move(metadata);
+    }
+    kept_count++;
+  }
+  local_rb_seg_queue.resize(kept_count);
+
+  return freed_count;
+}
+
 void GCManager::AddToRecycleMap(TupleMetadata tuple_metadata) {
+  backlog_count_--;
+
   // If the tuple being reset no longer exists, just skip it
   if (ResetTuple(tuple_metadata) == false) return;
+  reclaimed_count_++;
 
   // Add to the recycle map
-  std::shared_ptr<Queue<TupleMetadata>> recycle_queue;
-  // if the entry for table_id exists.
-  if (recycle_queue_map_.find(tuple_metadata.table_id, recycle_queue) == true) {
-    // if the entry for tuple_metadata.table_id exists.
-    recycle_queue->Dequeue(tuple_metadata);
-  } else {
-    // if the entry for tuple_metadata.table_id does not exist.
-    recycle_queue.reset(new Queue<TupleMetadata>(MAX_QUEUE_LENGTH));
-    bool ret =
-        recycle_queue_map_.insert(tuple_metadata.table_id, recycle_queue);
-    if (ret == true) {
-      recycle_queue->Dequeue(tuple_metadata);
-    } else {
+  std::shared_ptr<RecycleQueue> recycle_queue;
+  // if the entry for table_id does not exist.
+  if (recycle_queue_map_.find(tuple_metadata.table_id, recycle_queue) ==
+      false) {
+    recycle_queue.reset(new RecycleQueue());
+    if (recycle_queue_map_.insert(tuple_metadata.table_id, recycle_queue) ==
+        false) {
       recycle_queue_map_.find(tuple_metadata.table_id, recycle_queue);
-      recycle_queue->Dequeue(tuple_metadata);
     }
   }
-}
 
-void GCManager::Running() {
-  // Check if we can move anything from the possibly free list to the free list.
+  // A full queue drops the slot, it stays reset and is never reused
+  if (recycle_queue->size.fetch_add(1) >= MAX_QUEUE_LENGTH) {
+    recycle_queue->size--;
+    LOG_TRACE("Recycle queue of table %u is full", tuple_metadata.table_id);
+    return;
+  }
 
-  // We use a local buffer to store all possible garbage handled by this gc
-  // worker
-  std::list<TupleMetadata> local_reclaim_queue;
+  recycle_backlog_count_++;
+  recycle_queue->queue.Enqueue(tuple_metadata);
+}
 
-  while (true) {
-    std::this_thread::sleep_for(
-        std::chrono::milliseconds(GC_PERIOD_MILLISECONDS));
+void GCManager::Running(const size_t thread_id) {
+  auto &reclaim_queue = *reclaim_queues_[thread_id];
+  auto &txn_manager = concurrency::TransactionManagerFactory::GetInstance();
 
-    LOG_TRACE("reclaim tuple thread...");
+  // Tuples taken from the queue that are still visible to some transaction
+  std::vector<TupleMetadata> local_reclaim_queue;
 
-    // First load every possible garbage into the list
-    // This step move all garbage from the global reclaim queue to the worker's
-    // local queue
-    for (size_t i = 0; i < MAX_ATTEMPT_COUNT; ++i) {
+  // Rollback segments taken from the shared queue that are not freed yet
+  std::vector<RollbackSegmentMetadata> local_rb_seg_queue;
+
+  while (true) {
+    // Take the next batch of possible garbage from the worker's queue
+    size_t batch_size = 0;
+    for (; batch_size < GC_MAX_BATCH_SIZE; ++batch_size) {
       TupleMetadata tuple_metadata;
-      if (reclaim_queue_.Dequeue(tuple_metadata) == false) {
+      if (reclaim_queue.Dequeue(tuple_metadata) == false) {
         break;
       }
       LOG_TRACE("Collect tuple (%u, %u) of table %u into local list",
@@ -148,49 +329,54 @@ void GCManager::Running() {
       local_reclaim_queue.push_back(tuple_metadata);
     }
 
-    // Then we go through to recycle garbage
-    auto &txn_manager = concurrency::TransactionManagerFactory::GetInstance();
-    auto max_cid = txn_manager.GetMaxCommittedCid();
+    size_t rb_seg_batch_size = 0;
+    for (; rb_seg_batch_size < GC_MAX_BATCH_SIZE; ++rb_seg_batch_size) {
+      RollbackSegmentMetadata rb_seg_metadata;
+      if (rb_seg_queue_.Dequeue(rb_seg_metadata) == false) {
+        break;
+      }
+      local_rb_seg_queue.push_back(std::move(rb_seg_metadata));
+    }
 
-    assert(max_cid != MAX_CID);
+    // Every version that ended before the oldest running transaction started
+    // is garbage, as long as the worker is running. Once it is stopped, no
+    // transaction is running and every possible garbage is actually garbage.
+    bool is_running = is_running_;
+    auto max_cid = txn_manager.GetMaxCommittedCid();
 
-    int tuple_counter = 0;
-    int attempt = 0;
-    auto queue_itr = local_reclaim_queue.begin();
+    PL_ASSERT(max_cid != MAX_CID);
 
-    while (queue_itr != local_reclaim_queue.end() &&
-           attempt < MAX_ATTEMPT_COUNT) {
-      if (queue_itr->tuple_end_cid <= max_cid) {
-        // add the tuple to recycle map
+    size_t tuple_counter = 0;
+    size_t kept_count = 0;
+    for (auto &tuple_metadata : local_reclaim_queue) {
+      if (is_running == false || tuple_metadata.tuple_end_cid <= max_cid) {
         LOG_TRACE("Add tuple(%u, %u) in table %u to recycle map",
-                  queue_itr->tile_group_id, queue_itr->tuple_slot_id,
-                  queue_itr->table_id);
-        AddToRecycleMap(*queue_itr);
-        queue_itr = local_reclaim_queue.erase(queue_itr);
+                  tuple_metadata.tile_group_id, tuple_metadata.tuple_slot_id,
+                  tuple_metadata.table_id);
+        AddToRecycleMap(tuple_metadata);
         tuple_counter++;
       } else {
-        queue_itr++;
+        local_reclaim_queue[kept_count++] = tuple_metadata;
       }
-      attempt++;
     }
+    local_reclaim_queue.resize(kept_count);
 
-    LOG_TRACE("Marked %d tuples as garbage", tuple_counter);
-    if (is_running_ == false) {
-      // Clear all pending garbage
-      tuple_counter = 0;
-      queue_itr = local_reclaim_queue.begin();
-
-      while (queue_itr != local_reclaim_queue.end()) {
-        // In this case, we assume that no transaction is running
-        // so every possible garbage is actually garbage
-        AddToRecycleMap(*queue_itr);
-        queue_itr = local_reclaim_queue.erase(queue_itr);
-        tuple_counter++;
-      }
+    size_t rb_seg_pool_counter = 0;
+    rb_seg_pool_counter +=
+        ReclaimRollbackSegments(local_rb_seg_queue, max_cid, is_running);
 
-      LOG_TRACE("GCThread recycle last %d tuples before exits", tuple_counter);
+    LOG_TRACE("GC thread %lu recycled %lu tuples and %lu rollback segment pools",
+              thread_id, tuple_counter, rb_seg_pool_counter);
+    if (is_running == false) {
       return;
     }
+
+    // Keep going while a queue is full, otherwise wait for more garbage
+    if (batch_size < GC_MAX_BATCH_SIZE &&
+        rb_seg_batch_size < GC_MAX_BATCH_SIZE) {
+      std::this_thread::sleep_for(
+          std::chrono::milliseconds(GC_PERIOD_MILLISECONDS));
+    }
   }
 }
 
@@ -209,13 +395,41 @@ void GCManager::RecycleTupleSlot(const oid_t &table_id,
   tuple_metadata.tuple_slot_id = tuple_id;
   tuple_metadata.tuple_end_cid = tuple_end_cid;
 
-  reclaim_queue_.Enqueue(tuple_metadata);
+  backlog_count_++;
+  reclaim_queues_[table_id % thread_count_]->Enqueue(tuple_metadata);
 
   LOG_TRACE("Marked tuple(%u, %u) in table %u as possible garbage",
             tuple_metadata.tile_group_id, tuple_metadata.tuple_slot_id,
             tuple_metadata.table_id);
 }
 
+// called by transaction manager.
+void GCManager::RecycleRollbackSegments(
+    const std::shared_ptr<storage::RollbackSegmentPool> &rb_seg_pool,
+    const std::vector<ItemPointer> &locations, const cid_t &end_cid) {
+  // Without GC, old versions are never reclaimed and neither are their
+  // rollback segments
+  if (this->gc_type_ == GC_TYPE_OFF) {
+    std::lock_guard<std::mutex> lock(retained_rb_seg_pools_mutex_);
+    retained_rb_seg_pools_.push_back(rb_seg_pool);
+    return;
+  }
+
+  RollbackSegmentMetadata rb_seg_metadata;
+  rb_seg_metadata.rb_seg_pool = rb_seg_pool;
+  rb_seg_metadata.locations = locations;
+  rb_seg_metadata.end_cid = end_cid;
+
+  // Segments of an aborted transaction are already unlinked
+  if (locations.empty() == true) {
+    auto &txn_manager = concurrency::TransactionManagerFactory::GetInstance();
+    rb_seg_metadata.unlink_cid = txn_manager.GetCurrentCommitId();
+  }
+
+  rb_seg_backlog_count_++;
+  rb_seg_queue_.Enqueue(rb_seg_metadata);
+}
+
 // this function returns a free tuple slot, if one exists
 // called by data_table.
 ItemPointer GCManager::ReturnFreeSlot(const oid_t &table_id) {
@@ -223,11 +437,13 @@ ItemPointer GCManager::ReturnFreeSlot(const oid_t &table_id) {
     return INVALID_ITEMPOINTER;
   }
 
-  std::shared_ptr<Queue<TupleMetadata>> recycle_queue;
+  std::shared_ptr<RecycleQueue> recycle_queue;
   // if there exists recycle_queue
   if (recycle_queue_map_.find(table_id, recycle_queue) == true) {
     TupleMetadata tuple_metadata;
-    if (recycle_queue->Dequeue(tuple_metadata) == true) {
+    if (recycle_queue->queue.Dequeue(tuple_metadata) == true) {
+      recycle_queue->size--;
+      recycle_backlog_count_--;
       LOG_TRACE("Reuse tuple(%u, %u) in table %u", tuple_metadata.tile_group_id,
                 tuple_metadata.tuple_slot_id, table_id);
       return ItemPointer(tuple_metadata.tile_group_id,
@@ -237,6 +453,34 @@ ItemPointer GCManager::ReturnFreeSlot(const oid_t &table_id) {
   return ItemPointer();
 }
 
+// this function returns a batch of free tuple slots, if any exist
+// called by data_table.
+void GCManager::ReturnFreeSlots(const oid_t &table_id,
+                                std::vector<ItemPointer> &free_slots,
+                                const size_t max_count) {
+  if (this->gc_type_ == GC_TYPE_OFF) {
+    return;
+  }
+
+  std::shared_ptr<RecycleQueue> recycle_queue;
+  if (recycle_queue_map_.find(table_id, recycle_queue) == false) {
+    return;
+  }
+
+  TupleMetadata tuple_metadata;
+  size_t slot_count = 0;
+  for (; slot_count < max_count; slot_count++) {
+    if (recycle_queue->queue.Dequeue(tuple_metadata) == false) {
+      break;
+    }
+    free_slots.emplace_back(tuple_metadata.tile_group_id,
+                            tuple_metadata.tuple_slot_id);
+  }
+  recycle_queue->size -= slot_count;
+  recycle_backlog_count_ -= slot_count;
+  LOG_TRACE("Reuse %lu tuple slots in table %u", free_slots.size(), table_id);
+}
+
 // this function can only be called after:
 //    1) All txns have exited
 //    2) The background gc thread has exited
@@ -245,12 +489,22 @@ void GCManager::ClearGarbage() {
   // world now.
   TupleMetadata tuple_metadata;
   int counter = 0;
-  while (reclaim_queue_.Dequeue(tuple_metadata) == true) {
-    // In such case, we assume it's the end of the world and every possible
-    // garbage is actually garbage
-    AddToRecycleMap(tuple_metadata);
-    counter++;
+  for (auto &reclaim_queue : reclaim_queues_) {
+    while (reclaim_queue->Dequeue(tuple_metadata) == true) {
+      // In such case, we assume it's the end of the world and every possible
+      // garbage is actually garbage
+      AddToRecycleMap(tuple_metadata);
+      counter++;
+    }
+  }
+
+  // Every rollback segment is garbage as well
+  std::vector<RollbackSegmentMetadata> local_rb_seg_queue;
+  RollbackSegmentMetadata rb_seg_metadata;
+  while (rb_seg_queue_.Dequeue(rb_seg_metadata) == true) {
+    local_rb_seg_queue.push_back(std::move(rb_seg_metadata));
   }
+  ReclaimRollbackSegments(local_rb_seg_queue, MAX_CID, false);
 
   LOG_TRACE("GCManager finally recyle %d tuples", counter);
 }
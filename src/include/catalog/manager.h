@@ -41,11 +41,19 @@ namespace catalog {
 // Manager
 //===--------------------------------------------------------------------===//
 
-typedef std::unordered_map<oid_t, std::shared_ptr<storage::TileGroup>> lookup_dir;
+// The tile group locator is a two-level directly-indexed array keyed by
+// tile group oid. Segments are allocated on first use.
+#define LOCATOR_SEGMENT_BITS 16
+#define LOCATOR_SEGMENT_SIZE (1 << LOCATOR_SEGMENT_BITS)
+#define LOCATOR_SEGMENT_COUNT (1 << (32 - LOCATOR_SEGMENT_BITS))
+
+typedef std::atomic<std::shared_ptr<storage::TileGroup> *> locator_slot;
 
 class Manager {
  public:
-  Manager() {}
+  Manager();
+
+  ~Manager();
 
   // Singleton
   static Manager &GetInstance();
@@ -101,14 +109,24 @@ class Manager {
   Manager(Manager const &) = delete;
 
  private:
+  // Get the locator slot of the tile group, allocating its segment if asked
+  locator_slot *GetLocatorSlot(const oid_t oid, bool allocate);
+
+  // Hand an unlinked locator entry over to epoch-based reclamation
+  void RetireLocation(std::shared_ptr<storage::TileGroup> *location);
+
   //===--------------------------------------------------------------------===//
   // Data members
   //===--------------------------------------------------------------------===//
 
   std::atomic<oid_t> oid = ATOMIC_VAR_INIT(START_OID);
 
-  lookup_dir locator;
+  // TILE GROUP LOCATOR
+
+  // Readers only touch these atomics within a ThreadEpochGuard
+  std::atomic<locator_slot *> *locator;
 
+  // Serializes writers
   std::mutex locator_mutex;
 
   // DATABASES
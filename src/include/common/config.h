@@ -35,6 +35,18 @@ class PelotonConfiguration {
 
   void SetSocketFamily(const std::string& socket_family);
 
+  std::string GetServerMode() const;
+
+  void SetServerMode(const std::string& server_mode);
+
+  int GetIOThreadCount() const;
+
+  void SetIOThreadCount(const int io_thread_count);
+
+  int GetWorkerThreadCount() const;
+
+  void SetWorkerThreadCount(const int worker_thread_count);
+
  protected:
 
   // Peloton port
@@ -46,6 +58,18 @@ class PelotonConfiguration {
   // Socket family (AF_UNIX, AF_INET)
   std::string socket_family = "AF_INET";
 
+  // Server mode (THREAD_PER_CONNECTION, EVENT_DRIVEN). In EVENT_DRIVEN mode,
+  // results a client does not read yet are kept in memory, up to
+  // SOCKET_WRITE_BACKLOG_LIMIT bytes per connection. Beyond that, the worker
+  // running the statement waits for the client.
+  std::string server_mode = "THREAD_PER_CONNECTION";
+
+  // Number of threads polling the client sockets (EVENT_DRIVEN only)
+  int io_thread_count = 2;
+
+  // Number of threads processing client packets (EVENT_DRIVEN only)
+  int worker_thread_count = 8;
+
 };
 
 }  // End peloton namespace
@@ -47,6 +47,12 @@ namespace peloton {
 #define PL_MEMSET memset
 #endif
 
+//===--------------------------------------------------------------------===//
+// prefetching
+//===--------------------------------------------------------------------===//
+
+#define PL_PREFETCH(addr) __builtin_prefetch(addr)
+
 //===--------------------------------------------------------------------===//
 // packed
 //===--------------------------------------------------------------------===//
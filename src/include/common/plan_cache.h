@@ -0,0 +1,93 @@
+//===----------------------------------------------------------------------===//
+//
+//                         Peloton
+//
+// plan_cache.h
+//
+// Identification: src/include/common/plan_cache.h
+//
+// Copyright (c) 2015-16, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+
+#pragma once
+
+#include <atomic>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+#include "common/cache.h"
+#include "common/statement.h"
+
+// Number of distinct statements kept by the plan cache
+#define PLAN_CACHE_SIZE 1000
+
+namespace peloton {
+
+//===--------------------------------------------------------------------===//
+// Plan Cache
+//===--------------------------------------------------------------------===//
+
+/** @brief Process-wide cache of planned statements
+ *
+ *  Statements are keyed by their normalized query string and parameter
+ *  types, so that a statement prepared by any connection can reuse the plan
+ *  built for another one. A statement is only cached once it has been
+ *  prepared a few times (see the insert threshold of Cache).
+ *
+ *  Cached plan trees are shared, so parameters are bound per execution and
+ *  never into the plan itself.
+ *
+ *  Note that TrafficCop::PrepareStatement does not parse or plan queries
+ *  yet, so for now nothing is ever inserted into this cache.
+ *
+ *  Every DDL operation, including index creation and removal, invalidates
+ *  the whole cache. To
+ *  avoid caching a plan built against the old catalog, callers read the
+ *  version of the cache before planning and pass it back on insertion.
+ * */
+class PlanCache {
+ public:
+  PlanCache(const PlanCache &) = delete;
+  PlanCache &operator=(const PlanCache &) = delete;
+
+  // global singleton
+  static PlanCache &GetInstance(void);
+
+  // Collapses whitespace, drops a trailing semicolon and lowercases
+  // everything outside of quotes
+  static std::string NormalizeQuery(const std::string &query_string);
+
+  static std::string GetKey(const std::string &query_string,
+                            const std::vector<int32_t> &param_types);
+
+  // Returns the cached statement, or nullptr if there is none
+  std::shared_ptr<Statement> Find(const std::string &key);
+
+  // Caches a statement planned when the cache was at the given version.
+  // The statement is dropped if the catalog changed in the meantime.
+  void Insert(const std::string &key,
+              const std::shared_ptr<Statement> &statement, size_t version);
+
+  // Drops every cached statement, called on DDL
+  void Invalidate(void);
+
+  size_t GetVersion(void) const { return version.load(); }
+
+  size_t GetSize(void);
+
+ private:
+  PlanCache();
+
+  std::mutex cache_mutex;
+
+  // incremented on every invalidation
+  std::atomic<size_t> version;
+
+  Cache<std::string, Statement> statements;
+};
+
+}  // End peloton namespace
@@ -39,6 +39,8 @@ class Portal {
 
   std::shared_ptr<Statement> GetStatement() const;
 
+  const std::vector<std::pair<int, std::string>>& GetBindParameters() const;
+
  private:
 
   // Portal name
@@ -0,0 +1,325 @@
+//===----------------------------------------------------------------------===//
+//
+//                         Peloton
+//
+// thread_epoch.h
+//
+// Identification: src/include/common/thread_epoch.h
+//
+// Copyright (c) 2015-16, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+#include <cstdlib>
+#include <functional>
+#include <mutex>
+#include <new>
+#include <utility>
+#include <vector>
+
+#include "common/macros.h"
+#include "common/platform.h"
+
+namespace peloton {
+
+//===--------------------------------------------------------------------===//
+// Thread Slot List
+//===--------------------------------------------------------------------===//
+
+// Number of slots allocated at once when every existing slot is taken
+#define THREAD_SLOT_SEGMENT_SIZE 64
+
+/**
+ * Cache-line sized per-thread slots for the epoch managers.
+ *
+ * A thread claims a free slot the first time it needs one and releases it
+ * when it exits, so slots are reused by later threads. When every slot is
+ * taken a new segment is appended to a latch-free list. Segments are only
+ * freed with the list, which lets scans walk them without a latch.
+ *
+ * SlotType must have a std::atomic<bool> in_use member, and its other
+ * members must hold neutral values whenever the slot is not in use.
+ */
+template <typename SlotType>
+class ThreadSlotList {
+ public:
+  ThreadSlotList() : head_(AllocateSegment(0)) {}
+
+  ~ThreadSlotList() {
+    auto segment = head_;
+    while (segment != nullptr) {
+      auto next = segment->next.load();
+      FreeSegment(segment);
+      segment = next;
+    }
+  }
+
+  ThreadSlotList(const ThreadSlotList &) = delete;
+  ThreadSlotList &operator=(const ThreadSlotList &) = delete;
+
+  // Claim a free slot and return its id
+  size_t Claim() {
+    auto segment = head_;
+
+    while (true) {
+      for (size_t slot_itr = 0; slot_itr < THREAD_SLOT_SEGMENT_SIZE;
+           slot_itr++) {
+        bool expected = false;
+        if (segment->slots[slot_itr].in_use.compare_exchange_strong(expected,
+                                                                    true)) {
+          return segment->base_id + slot_itr;
+        }
+      }
+
+      auto next = segment->next.load();
+      if (next == nullptr) {
+        auto new_segment =
+            AllocateSegment(segment->base_id + THREAD_SLOT_SEGMENT_SIZE);
+
+        // someone else might have appended a segment first
+        if (segment->next.compare_exchange_strong(next, new_segment)) {
+          next = new_segment;
+        } else {
+          FreeSegment(new_segment);
+        }
+      }
+
+      segment = next;
+    }
+  }
+
+  // The caller resets the other members of the slot first
+  void Release(size_t slot_id) { Get(slot_id).in_use.store(false); }
+
+  SlotType &Get(size_t slot_id) {
+    auto segment = head_;
+    while (slot_id >= segment->base_id + THREAD_SLOT_SEGMENT_SIZE) {
+      segment = segment->next.load();
+      PL_ASSERT(segment != nullptr);
+    }
+
+    return segment->slots[slot_id - segment->base_id];
+  }
+
+  // Call the function on every slot, whether it is in use or not
+  template <typename Function>
+  void ForEach(Function function) const {
+    auto segment = head_;
+    while (segment != nullptr) {
+      for (size_t slot_itr = 0; slot_itr < THREAD_SLOT_SEGMENT_SIZE;
+           slot_itr++) {
+        function(segment->slots[slot_itr]);
+      }
+      segment = segment->next.load();
+    }
+  }
+
+ private:
+  struct Segment {
+    explicit Segment(size_t base_id) : next(nullptr), base_id(base_id) {}
+
+    SlotType slots[THREAD_SLOT_SEGMENT_SIZE];
+    std::atomic<Segment *> next;
+    const size_t base_id;
+  };
+
+  // operator new does not honor the cache line alignment of the slots
+  static Segment *AllocateSegment(size_t base_id) {
+    void *memory = nullptr;
+    if (posix_memalign(&memory, CACHELINE_SIZE, sizeof(Segment)) != 0) {
+      throw std::bad_alloc();
+    }
+    return new (memory) Segment(base_id);
+  }
+
+  static void FreeSegment(Segment *segment) {
+    segment->~Segment();
+    free(segment);
+  }
+
+  Segment *const head_;
+};
+
+//===--------------------------------------------------------------------===//
+// Thread Epoch Manager
+//===--------------------------------------------------------------------===//
+
+/**
+ * Epoch-based memory reclamation for latch-free data structures.
+ *
+ * Every thread publishes the global epoch it observed when it started an
+ * operation in its own cache-line sized slot, so entering and leaving an
+ * epoch never writes to a shared cache line. Objects unlinked from a
+ * structure are tagged with the global epoch at retirement and can be
+ * freed once no active thread has published an epoch that is not newer
+ * than the tag.
+ *
+ * Objects handed to Retire() are freed by whichever thread leaves the last
+ * epoch that can still see them, so they do not wait for the next
+ * retirement.
+ */
+class ThreadEpochManager {
+ public:
+  static const uint64_t INACTIVE_EPOCH = UINT64_MAX;
+
+  static ThreadEpochManager &GetInstance() {
+    static ThreadEpochManager epoch_manager;
+    return epoch_manager;
+  }
+
+  ~ThreadEpochManager() {
+    for (auto &retired_object : retired_objects_) {
+      retired_object.second();
+    }
+  }
+
+  // Enter an epoch on behalf of the calling thread (re-entrant)
+  void EnterEpoch() {
+    auto &local_state = GetLocalState();
+    if (local_state.nesting_level++ == 0) {
+      local_state.slot->epoch.store(global_epoch_.load());
+    }
+  }
+
+  // Leave the epoch entered by the matching EnterEpoch call
+  void ExitEpoch() {
+    auto &local_state = GetLocalState();
+    PL_ASSERT(local_state.nesting_level > 0);
+    if (--local_state.nesting_level == 0) {
+      local_state.slot->epoch.store(INACTIVE_EPOCH);
+
+      if (retired_count_.load() > 0) {
+        ReclaimRetired();
+      }
+    }
+  }
+
+  uint64_t GetCurrentEpoch() const { return global_epoch_.load(); }
+
+  uint64_t AdvanceEpoch() { return ++global_epoch_; }
+
+  // Get the oldest epoch that an active thread may still be reading in
+  uint64_t GetMinActiveEpoch() const {
+    uint64_t min_epoch = global_epoch_.load();
+
+    slots_.ForEach([&min_epoch](const EpochSlot &slot) {
+      auto epoch = slot.epoch.load();
+      if (epoch < min_epoch) {
+        min_epoch = epoch;
+      }
+    });
+
+    return min_epoch;
+  }
+
+  // Call the deleter once no thread can still be reading the object, which
+  // must already be unreachable for threads entering an epoch from now on
+  void Retire(std::function<void()> deleter) {
+    {
+      std::lock_guard<std::mutex> lock(retired_mutex_);
+      retired_objects_.emplace_back(global_epoch_.load(), std::move(deleter));
+      retired_count_++;
+    }
+
+    AdvanceEpoch();
+    ReclaimRetired();
+  }
+
+  // Free the retired objects that no active thread can see anymore
+  void ReclaimRetired() {
+    // one reclaimer at a time
+    if (reclaiming_.exchange(true) == true) {
+      return;
+    }
+
+    auto min_active_epoch = GetMinActiveEpoch();
+    std::vector<std::function<void()>> deleters;
+
+    {
+      std::lock_guard<std::mutex> lock(retired_mutex_);
+      auto retired_itr = retired_objects_.begin();
+      while (retired_itr != retired_objects_.end()) {
+        if (retired_itr->first < min_active_epoch) {
+          deleters.push_back(std::move(retired_itr->second));
+          retired_itr = retired_objects_.erase(retired_itr);
+        } else {
+          retired_itr++;
+        }
+      }
+      retired_count_ -= deleters.size();
+    }
+
+    reclaiming_.store(false);
+
+    // deleters may enter epochs or retire objects themselves
+    for (auto &deleter : deleters) {
+      deleter();
+    }
+  }
+
+  // Number of retired objects that are not freed yet
+  size_t GetRetiredCount() const { return retired_count_.load(); }
+
+ private:
+  struct EpochSlot {
+    std::atomic<uint64_t> epoch{INACTIVE_EPOCH};
+    std::atomic<bool> in_use{false};
+  } CACHE_ALIGNED;
+
+  // Slot ownership of the calling thread
+  struct LocalState {
+    LocalState()
+        : slot_id(GetInstance().slots_.Claim()),
+          slot(&GetInstance().slots_.Get(slot_id)),
+          nesting_level(0) {}
+
+    ~LocalState() {
+      slot->epoch.store(INACTIVE_EPOCH);
+      GetInstance().slots_.Release(slot_id);
+    }
+
+    size_t slot_id;
+    EpochSlot *slot;
+    size_t nesting_level;
+  };
+
+  ThreadEpochManager()
+      : global_epoch_(1), retired_count_(0), reclaiming_(false) {}
+
+  static LocalState &GetLocalState() {
+    static thread_local LocalState local_state;
+    return local_state;
+  }
+
+  std::atomic<uint64_t> global_epoch_;
+
+  ThreadSlotList<EpochSlot> slots_;
+
+  // Objects waiting for the active threads to leave their epoch, along
+  // with the epoch in which they were retired
+  std::vector<std::pair<uint64_t, std::function<void()>>> retired_objects_;
+
+  std::mutex retired_mutex_;
+
+  std::atomic<size_t> retired_count_;
+
+  std::atomic<bool> reclaiming_;
+};
+
+// Scoped epoch protection for a latch-free operation
+class ThreadEpochGuard {
+ public:
+  ThreadEpochGuard() { ThreadEpochManager::GetInstance().EnterEpoch(); }
+
+  ~ThreadEpochGuard() { ThreadEpochManager::GetInstance().ExitEpoch(); }
+
+  ThreadEpochGuard(const ThreadEpochGuard &) = delete;
+  ThreadEpochGuard &operator=(const ThreadEpochGuard &) = delete;
+};
+
+}  // End peloton namespace
@@ -65,6 +65,7 @@ enum LoggerMappingStrategyType {
 enum CheckpointType {
   CHECKPOINT_TYPE_INVALID = 0,
   CHECKPOINT_TYPE_NORMAL = 1,
+  CHECKPOINT_TYPE_STREAMING = 2,
 };
 
 enum GCType {
@@ -405,6 +406,17 @@ enum IsolationLevelType {
   ISOLATION_LEVEL_TYPE_REPEATABLE_READ = 3  // repeatable read
 };
 
+//===--------------------------------------------------------------------===//
+// Version Storage Types
+//===--------------------------------------------------------------------===//
+
+enum VersionStorageType {
+  VERSION_STORAGE_TYPE_INVALID = 0,
+
+  VERSION_STORAGE_TYPE_FULL = 1,   // updates copy the whole tuple
+  VERSION_STORAGE_TYPE_DELTA = 2   // updates in place, old columns in deltas
+};
+
 //===--------------------------------------------------------------------===//
 // Garbage Collection Types
 //===--------------------------------------------------------------------===//
@@ -416,6 +428,17 @@ enum GCType {
   GC_TYPE_COOPERATIVE = 2         // cooperative GC
 };
 
+//===--------------------------------------------------------------------===//
+// Epoch Types
+//===--------------------------------------------------------------------===//
+
+enum EpochType {
+  EPOCH_TYPE_INVALID = 0,
+
+  EPOCH_TYPE_CENTRALIZED = 1,     // shared epoch queue
+  EPOCH_TYPE_DECENTRALIZED = 2    // per-thread epochs
+};
+
 enum BackendType {
   BACKEND_TYPE_INVALID = 0,  // invalid backend type
   BACKEND_TYPE_MM = 1,       // on volatile memory
@@ -438,6 +461,13 @@ enum IndexType {
 
 };
 
+enum IndexStorageType {
+  INDEX_STORAGE_TYPE_INVALID = 0,  // invalid index storage type
+
+  INDEX_STORAGE_TYPE_INDIRECT = 1,  // locations allocated out of the index
+  INDEX_STORAGE_TYPE_INLINE = 2     // locations stored in the index nodes
+};
+
 enum IndexConstraintType {
   INDEX_CONSTRAINT_TYPE_INVALID = 0,  // invalid index constraint type
   INDEX_CONSTRAINT_TYPE_DEFAULT =
@@ -518,6 +548,9 @@ enum PlanNodeType {
   PLAN_NODE_TYPE_DROP = 33,
   PLAN_NODE_TYPE_CREATE = 34,
 
+  // Bulk Load Nodes
+  PLAN_NODE_TYPE_IMPORT = 35,
+
   // Communication Nodes
   PLAN_NODE_TYPE_SEND = 40,
   PLAN_NODE_TYPE_RECEIVE = 41,
@@ -900,6 +933,12 @@ struct ItemPointerHasher {
   }
 };
 
+struct ItemPointerComparator {
+  bool operator()(const ItemPointer &lhs, const ItemPointer &rhs) const {
+    return lhs.block == rhs.block && lhs.offset == rhs.offset;
+  }
+};
+
 //===--------------------------------------------------------------------===//
 // File Handle
 //===--------------------------------------------------------------------===//
@@ -945,6 +984,11 @@ BackendType GetBackendType(const LoggingType &logging_type);
 
 void AtomicUpdateItemPointer(ItemPointer *src_ptr, const ItemPointer &value);
 
+// Swap in the value only if the pointer still holds the expected location
+bool AtomicCompareAndSwapItemPointer(ItemPointer *src_ptr,
+                                     const ItemPointer &expected,
+                                     const ItemPointer &value);
+
 //===--------------------------------------------------------------------===//
 // Transformers
 //===--------------------------------------------------------------------===//
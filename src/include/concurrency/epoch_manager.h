@@ -13,12 +13,14 @@
 
 #pragma once
 
+#include <atomic>
 #include <thread>
 #include <vector>
 
 #include "common/macros.h"
 #include "common/types.h"
 #include "common/platform.h"
+#include "common/thread_epoch.h"
 
 namespace peloton {
 namespace concurrency {
@@ -37,9 +39,36 @@ struct Epoch {
   }
 };
 
+/**
+ * Tracks the running transactions so that the GC knows which versions no
+ * transaction can see anymore.
+ *
+ * A worker calls PrepareEnterEpoch before it takes the begin cid of a
+ * transaction, EnterEpoch with that cid and ExitEpoch with the returned id
+ * once the transaction ends.
+ */
 class EpochManager {
  public:
-  EpochManager()
+  virtual ~EpochManager() {}
+
+  virtual void Reset() = 0;
+
+  virtual void PrepareEnterEpoch() {}
+
+  virtual size_t EnterEpoch(cid_t begin_cid) = 0;
+
+  virtual void ExitEpoch(size_t epoch) = 0;
+
+  // Every transaction that began at or before the returned cid has ended,
+  // and every transaction that begins later gets a larger begin cid
+  virtual cid_t GetMaxDeadTxnCid() = 0;
+};
+
+// Epochs advanced by a dedicated thread, with the running transactions
+// counted per epoch
+class CentralizedEpochManager : public EpochManager {
+ public:
+  CentralizedEpochManager()
       : epoch_queue_(epoch_queue_size_),
         queue_tail_(0),
         current_epoch_(0),
@@ -48,7 +77,7 @@ class EpochManager {
         finish_(false) {
     // ts_thread_.reset(new std::thread(&EpochManager::Start, this));
     // ts_thread_->detach();
-    ts_thread_ = std::thread(&EpochManager::Start, this);
+    ts_thread_ = std::thread(&CentralizedEpochManager::Start, this);
   }
 
   void Reset() {
@@ -62,10 +91,10 @@ class EpochManager {
     max_cid = 0;
 
     finish_ = false;
-    ts_thread_ = std::thread(&EpochManager::Start, this);
+    ts_thread_ = std::thread(&CentralizedEpochManager::Start, this);
   }
 
-  ~EpochManager() {
+  ~CentralizedEpochManager() {
     finish_ = true;
     ts_thread_.join();
   }
@@ -226,12 +255,145 @@ class EpochManager {
   std::thread ts_thread_;
 };
 
-class EpochManagerFactory {
+/**
+ * Every worker publishes the begin cid of its running transaction in its
+ * own cache-line sized slot, so beginning and ending a transaction never
+ * writes to a shared cache line. GetMaxDeadTxnCid computes the minimum over
+ * the slots lazily.
+ *
+ * The slots live in a ThreadSlotList, so a worker releases its slot when
+ * it exits and any number of workers can run at the same time.
+ *
+ * PrepareEnterEpoch reserves the slot with the begin cid of the previous
+ * transaction of the slot, which is not larger than the one the worker is
+ * about to take. A transaction whose begin cid is taken but not yet
+ * published therefore still holds back GetMaxDeadTxnCid.
+ */
+class DecentralizedEpochManager : public EpochManager {
  public:
-  static EpochManager& GetInstance() {
-    static EpochManager epoch_manager;
+  DecentralizedEpochManager() : max_dead_cid_(0) {}
+
+  // Must not be called while transactions are running
+  void Reset() {
+    slots_.ForEach([](WorkerSlot &slot) { slot.last_begin_cid.store(0); });
+    max_dead_cid_ = 0;
+  }
+
+  void PrepareEnterEpoch() {
+    auto &slot = *GetLocalState().slot;
+    slot.begin_cid.store(slot.last_begin_cid.load());
+  }
+
+  // Returns the slot of the calling thread as the epoch id
+  size_t EnterEpoch(cid_t begin_cid) {
+    auto &local_state = GetLocalState();
+    local_state.slot->begin_cid.store(begin_cid);
+    return local_state.slot_id;
+  }
+
+  void ExitEpoch(size_t epoch) {
+    auto &slot = slots_.Get(epoch);
+    PL_ASSERT(slot.begin_cid != MAX_CID);
+
+    slot.last_begin_cid.store(slot.begin_cid.load());
+    slot.begin_cid.store(MAX_CID);
+  }
+
+  cid_t GetMaxDeadTxnCid() {
+    // the ended transactions must be read before the running ones. A
+    // transaction missed by the second loop takes its begin cid after the
+    // first loop, so it is larger than every cid seen there.
+    // Slots appended in between start out with neither.
+    cid_t max_ended_cid = 0;
+    slots_.ForEach([&max_ended_cid](const WorkerSlot &slot) {
+      auto last_begin_cid = slot.last_begin_cid.load();
+      if (last_begin_cid > max_ended_cid) {
+        max_ended_cid = last_begin_cid;
+      }
+    });
+
+    cid_t min_running_cid = MAX_CID;
+    slots_.ForEach([&min_running_cid](const WorkerSlot &slot) {
+      auto begin_cid = slot.begin_cid.load();
+      if (begin_cid < min_running_cid) {
+        min_running_cid = begin_cid;
+      }
+    });
+
+    auto dead_cid = max_ended_cid;
+    if (min_running_cid <= dead_cid) {
+      dead_cid = (min_running_cid == 0) ? 0 : min_running_cid - 1;
+    }
+
+    auto max_dead_cid = max_dead_cid_.load();
+    while (max_dead_cid < dead_cid &&
+           !max_dead_cid_.compare_exchange_weak(max_dead_cid, dead_cid))
+      ;
+
+    return max_dead_cid_.load();
+  }
+
+ private:
+  struct WorkerSlot {
+    // begin cid of the running transaction, MAX_CID if there is none
+    std::atomic<cid_t> begin_cid{MAX_CID};
+    // begin cid of the last transaction that ended, kept for the next owner
+    std::atomic<cid_t> last_begin_cid{0};
+    std::atomic<bool> in_use{false};
+  } CACHE_ALIGNED;
+
+  // Slot ownership of the calling thread
+  struct LocalState {
+    LocalState()
+        : slot_id(GetInstance().slots_.Claim()),
+          slot(&GetInstance().slots_.Get(slot_id)) {}
+
+    ~LocalState() {
+      slot->begin_cid.store(MAX_CID);
+      GetInstance().slots_.Release(slot_id);
+    }
+
+    size_t slot_id;
+    WorkerSlot *slot;
+  };
+
+  static DecentralizedEpochManager &GetInstance() {
+    static DecentralizedEpochManager epoch_manager;
     return epoch_manager;
   }
+
+  static LocalState &GetLocalState() {
+    static thread_local LocalState local_state;
+    return local_state;
+  }
+
+  friend class EpochManagerFactory;
+
+  std::atomic<cid_t> max_dead_cid_;
+
+  ThreadSlotList<WorkerSlot> slots_;
+};
+
+class EpochManagerFactory {
+ public:
+  static EpochManager &GetInstance() {
+    switch (epoch_type_) {
+      case EPOCH_TYPE_CENTRALIZED: {
+        static CentralizedEpochManager epoch_manager;
+        return epoch_manager;
+      }
+
+      default:
+        return DecentralizedEpochManager::GetInstance();
+    }
+  }
+
+  static void Configure(EpochType epoch_type) { epoch_type_ = epoch_type; }
+
+  static EpochType GetEpochType() { return epoch_type_; }
+
+ private:
+  static EpochType epoch_type_;
 };
 }
 }
@@ -50,6 +50,11 @@ class OptimisticTxnManager : public TransactionManager {
 
   virtual bool PerformRead(const ItemPointer &location);
 
+  virtual bool PerformReads(const oid_t tile_group_id,
+                            const storage::TileGroupHeader *const
+                                tile_group_header,
+                            const std::vector<oid_t> &tuple_ids);
+
   virtual void PerformUpdate(const ItemPointer &old_location,
                              const ItemPointer &new_location);
 
@@ -65,11 +70,15 @@ class OptimisticTxnManager : public TransactionManager {
   virtual Result AbortTransaction();
 
   virtual Transaction *BeginTransaction() {
+    auto &epoch_manager = EpochManagerFactory::GetInstance();
+    // the begin cid must be taken after the epoch is prepared
+    epoch_manager.PrepareEnterEpoch();
+
     txn_id_t txn_id = GetNextTransactionId();
     cid_t begin_cid = GetNextCommitId();
     Transaction *txn = new Transaction(txn_id, begin_cid);
 
-    auto eid = EpochManagerFactory::GetInstance().EnterEpoch(begin_cid);
+    auto eid = epoch_manager.EnterEpoch(begin_cid);
     txn->SetEpochId(eid);
 
     current_txn = txn;
@@ -17,6 +17,7 @@
 #include <atomic>
 #include <vector>
 #include <map>
+#include <memory>
 #include <unordered_map>
 #include <unordered_set>
 
@@ -24,7 +25,19 @@
 #include "common/types.h"
 #include "common/exception.h"
 
+// Number of entries reserved for the read/write set of a new transaction
+#define TXN_RW_SET_INITIAL_CAPACITY 16
+
+// Read/write sets up to this size are searched linearly, larger ones are
+// indexed by a hash table
+#define TXN_RW_SET_LINEAR_SEARCH_LIMIT 16
+
 namespace peloton {
+
+namespace storage {
+class RollbackSegmentPool;
+}
+
 namespace concurrency {
 
 //===--------------------------------------------------------------------===//
@@ -39,6 +52,17 @@ enum RWType {
   RW_TYPE_INS_DEL  // delete after insert.
 };
 
+struct RWSetEntry {
+  ItemPointer location;
+  RWType type;
+
+  RWSetEntry(const ItemPointer &location, const RWType type)
+      : location(location), type(type) {}
+};
+
+// Tuples accessed by a transaction, in the order of their first access
+typedef std::vector<RWSetEntry> ReadWriteSet;
+
 class Transaction : public Printable {
   Transaction(Transaction const &) = delete;
 
@@ -48,21 +72,27 @@ class Transaction : public Printable {
         begin_cid_(INVALID_CID),
         end_cid_(MAX_CID),
         is_written_(false),
-        insert_count_(0) {}
+        insert_count_(0) {
+    rw_set_.reserve(TXN_RW_SET_INITIAL_CAPACITY);
+  }
 
   Transaction(const txn_id_t &txn_id)
       : txn_id_(txn_id),
         begin_cid_(INVALID_CID),
         end_cid_(MAX_CID),
         is_written_(false),
-        insert_count_(0) {}
+        insert_count_(0) {
+    rw_set_.reserve(TXN_RW_SET_INITIAL_CAPACITY);
+  }
 
   Transaction(const txn_id_t &txn_id, const cid_t &begin_cid)
       : txn_id_(txn_id),
         begin_cid_(begin_cid),
         end_cid_(MAX_CID),
         is_written_(false),
-        insert_count_(0) {}
+        insert_count_(0) {
+    rw_set_.reserve(TXN_RW_SET_INITIAL_CAPACITY);
+  }
 
   ~Transaction() {}
 
@@ -91,7 +121,16 @@ class Transaction : public Printable {
   // Return true if we detect INS_DEL
   bool RecordDelete(const ItemPointer &);
 
-  const std::map<oid_t, std::map<oid_t, RWType>> &GetRWSet();
+  const ReadWriteSet &GetRWSet();
+
+  // Pool of the rollback segments created by the in-place updates of the
+  // transaction, allocated on the first one
+  storage::RollbackSegmentPool *GetRollbackSegmentPool();
+
+  inline const std::shared_ptr<storage::RollbackSegmentPool> &
+  GetRollbackSegmentPoolRef() const {
+    return rb_seg_pool_;
+  }
 
   // Get a string representation for debugging
   const std::string GetInfo() const;
@@ -107,6 +146,11 @@ class Transaction : public Printable {
   }
 
  private:
+  // Returns the type of the entry of the tuple, or nullptr if there is none
+  RWType *FindRWType(const ItemPointer &location);
+
+  void AddRWEntry(const ItemPointer &location, const RWType type);
+
   //===--------------------------------------------------------------------===//
   // Data members
   //===--------------------------------------------------------------------===//
@@ -123,7 +167,16 @@ class Transaction : public Printable {
   // epoch id
   size_t epoch_id_;
 
-  std::map<oid_t, std::map<oid_t, RWType>> rw_set_;
+  // tuples read or written by the transaction
+  ReadWriteSet rw_set_;
+
+  // position of every entry in the read/write set, built only once the set
+  // outgrows the linear search
+  std::unordered_map<ItemPointer, size_t, ItemPointerHasher,
+                     ItemPointerComparator> rw_set_index_;
+
+  // rollback segments of the in-place updates, handed to the GC at the end
+  std::shared_ptr<storage::RollbackSegmentPool> rb_seg_pool_;
 
   // result of the transaction
   Result result_ = peloton::RESULT_SUCCESS;
@@ -29,9 +29,12 @@
 namespace peloton {
 
 class ItemPointer;
+class VarlenPool;
 
 namespace storage {
 class DataTable;
+class TileGroup;
+class Tuple;
 }
 
 namespace concurrency {
@@ -85,6 +88,21 @@ class TransactionManager {
 
   virtual bool PerformRead(const ItemPointer &location) = 0;
 
+  // Collect the ids of the tuples among the first tuple_count slots of the
+  // tile group that are visible to the current transaction. Uses (and
+  // maintains) the frozen summary of the tile group header so that full,
+  // quiescent tile groups skip the per-tuple checks.
+  void GetVisibleTuples(const storage::TileGroupHeader *const tile_group_header,
+                        const oid_t tuple_count,
+                        std::vector<oid_t> &visible_tuples);
+
+  // Perform the read of a batch of visible tuples of one tile group.
+  // Returns false as soon as one of the reads fails.
+  virtual bool PerformReads(const oid_t tile_group_id,
+                            const storage::TileGroupHeader *const
+                                tile_group_header,
+                            const std::vector<oid_t> &tuple_ids);
+
   virtual void PerformUpdate(const ItemPointer &old_location,
                              const ItemPointer &new_location) = 0;
 
@@ -95,6 +113,29 @@ class TransactionManager {
 
   virtual void PerformDelete(const ItemPointer &location) = 0;
 
+  // Delta version storage: save the columns of the target list in a rollback
+  // segment before the owned tuple is updated in place
+  virtual void PerformInPlaceUpdate(
+      const ItemPointer &location UNUSED_ATTRIBUTE,
+      const TargetList &target_list UNUSED_ATTRIBUTE) {
+    throw NotImplementedException(
+        "Delta version storage is not supported by this protocol");
+  }
+
+  // Delta version storage: copy into the tuple the version visible to the
+  // current transaction, rebuilt from the delta chain if needed. The caller
+  // must have pinned the tile group (see ExecutorContext::PinTileGroup).
+  // Returns false if the slot holds the visible version and can be read in
+  // place: the tuple is owned by the transaction, or by no transaction and
+  // not overwritten after the snapshot.
+  virtual bool ReconstructVersion(
+      storage::TileGroup *tile_group UNUSED_ATTRIBUTE,
+      const oid_t &tuple_id UNUSED_ATTRIBUTE,
+      storage::Tuple *tuple UNUSED_ATTRIBUTE,
+      VarlenPool *data_pool UNUSED_ATTRIBUTE) {
+    return false;
+  }
+
   // Txn manager may store related information in TileGroupHeader, so when
   // TileGroup is dropped, txn manager might need to be notified
   virtual void DroppingTileGroup(const oid_t &tile_group_id UNUSED_ATTRIBUTE) {
@@ -138,6 +179,11 @@ class TransactionManager {
   inline bool CidIsInDirtyRange(cid_t cid) {
     return ((cid > dirty_range_.first) & (cid <= dirty_range_.second));
   }
+
+  inline bool HasDirtyRange() {
+    return (dirty_range_.first != dirty_range_.second);
+  }
+
   // invisible range after failure and recovery;
   // first value is exclusive, last value is inclusive
   std::pair<cid_t, cid_t> dirty_range_ =
@@ -30,19 +30,29 @@ class TransactionManagerFactory {
     }
   }
 
-  static void Configure(ConcurrencyType protocol,
-                        IsolationLevelType level = ISOLATION_LEVEL_TYPE_FULL) {
+  static void Configure(
+      ConcurrencyType protocol,
+      IsolationLevelType level = ISOLATION_LEVEL_TYPE_FULL,
+      VersionStorageType version_storage = VERSION_STORAGE_TYPE_FULL) {
     protocol_ = protocol;
     isolation_level_ = level;
+    // only the timestamp ordering protocol keeps delta chains. hybrid scans
+    // are not delta-aware and refuse to run in delta storage
+    version_storage_ = (protocol == CONCURRENCY_TYPE_TO)
+                           ? version_storage
+                           : VERSION_STORAGE_TYPE_FULL;
   }
 
   static ConcurrencyType GetProtocol() { return protocol_; }
 
   static IsolationLevelType GetIsolationLevel() { return isolation_level_; }
 
+  static VersionStorageType GetVersionStorage() { return version_storage_; }
+
  private:
   static ConcurrencyType protocol_;
   static IsolationLevelType isolation_level_;
+  static VersionStorageType version_storage_;
 };
 }
 }
\ No newline at end of file
@@ -14,6 +14,7 @@
 #pragma once
 
 #include "concurrency/transaction_manager.h"
+#include "storage/rollback_segment.h"
 #include "storage/tile_group.h"
 
 namespace peloton {
@@ -50,6 +51,11 @@ class TsOrderTxnManager : public TransactionManager {
 
   virtual bool PerformRead(const ItemPointer &location);
 
+  virtual bool PerformReads(const oid_t tile_group_id,
+                            const storage::TileGroupHeader *const
+                                tile_group_header,
+                            const std::vector<oid_t> &tuple_ids);
+
   virtual void PerformUpdate(const ItemPointer &old_location,
                              const ItemPointer &new_location);
 
@@ -60,17 +66,28 @@ class TsOrderTxnManager : public TransactionManager {
 
   virtual void PerformDelete(const ItemPointer &location);
 
+  virtual void PerformInPlaceUpdate(const ItemPointer &location,
+                                    const TargetList &target_list);
+
+  virtual bool ReconstructVersion(storage::TileGroup *tile_group,
+                                  const oid_t &tuple_id, storage::Tuple *tuple,
+                                  VarlenPool *data_pool);
+
   virtual Result CommitTransaction();
 
   virtual Result AbortTransaction();
 
   virtual Transaction *BeginTransaction() {
+    auto &epoch_manager = EpochManagerFactory::GetInstance();
+    // the begin cid must be taken after the epoch is prepared
+    epoch_manager.PrepareEnterEpoch();
+
     txn_id_t txn_id = GetNextTransactionId();
     cid_t begin_cid = GetNextCommitId();
     Transaction *txn = new Transaction(txn_id, begin_cid);
     current_txn = txn;
 
-    auto eid = EpochManagerFactory::GetInstance().EnterEpoch(begin_cid);
+    auto eid = epoch_manager.EnterEpoch(begin_cid);
     txn->SetEpochId(eid);
 
     return txn;
@@ -83,20 +100,73 @@ class TsOrderTxnManager : public TransactionManager {
     current_txn = nullptr;
   }
 
+  //===--------------------------------------------------------------------===//
+  // Delta chain
+  //===--------------------------------------------------------------------===//
+
+  // The reserved field of a tuple holds its last reader cid, the head of its
+  // delta chain, newest rollback segment first, and a latch that serializes
+  // the changes of the chain. Readers walk the chain without the latch.
+  inline static char *GetDeltaChainHead(
+      const storage::TileGroupHeader *const tile_group_header,
+      const oid_t &tuple_id) {
+    char *reserved_field = tile_group_header->GetReservedFieldRef(tuple_id);
+    return *(reinterpret_cast<char **>(reserved_field + delta_chain_offset_));
+  }
+
+  inline static void SetDeltaChainHead(
+      const storage::TileGroupHeader *const tile_group_header,
+      const oid_t &tuple_id, char *rb_seg) {
+    char *reserved_field = tile_group_header->GetReservedFieldRef(tuple_id);
+    *(reinterpret_cast<char **>(reserved_field + delta_chain_offset_)) = rb_seg;
+  }
+
+  inline static void LockDeltaChain(
+      const storage::TileGroupHeader *const tile_group_header,
+      const oid_t &tuple_id) {
+    char *reserved_field = tile_group_header->GetReservedFieldRef(tuple_id);
+    auto latch = reinterpret_cast<int64_t *>(reserved_field + delta_latch_offset_);
+    while (__sync_bool_compare_and_swap(latch, 0, 1) == false)
+      ;
+  }
+
+  inline static void UnlockDeltaChain(
+      const storage::TileGroupHeader *const tile_group_header,
+      const oid_t &tuple_id) {
+    char *reserved_field = tile_group_header->GetReservedFieldRef(tuple_id);
+    auto latch = reinterpret_cast<int64_t *>(reserved_field + delta_latch_offset_);
+    __sync_lock_release(latch);
+  }
+
  private:
+  static const size_t last_reader_offset_ = 0;
+  static const size_t delta_chain_offset_ = last_reader_offset_ + sizeof(cid_t);
+  static const size_t delta_latch_offset_ =
+      delta_chain_offset_ + sizeof(char *);
+
+  bool IsVisibleInDeltaChain(
+      const storage::TileGroupHeader *const tile_group_header,
+      const oid_t &tuple_id);
+
+  bool CommitDeltaChain(const storage::TileGroupHeader *const tile_group_header,
+                        const oid_t &tuple_id, const cid_t &end_commit_id);
+
+  void AbortDeltaChain(storage::TileGroup *tile_group, const oid_t &tuple_id);
+
   inline cid_t GetLastReaderCid(
       const storage::TileGroupHeader *const tile_group_header,
       const oid_t &tuple_id) {
     char *reserved_field = tile_group_header->GetReservedFieldRef(tuple_id);
     cid_t read_ts = 0;
-    PL_MEMCPY(&read_ts, reserved_field, sizeof(cid_t));
+    PL_MEMCPY(&read_ts, reserved_field + last_reader_offset_, sizeof(cid_t));
     return read_ts;
   }
 
   inline void SetLastReaderCid(
       const storage::TileGroupHeader *const tile_group_header,
       const oid_t &tuple_id, const cid_t &last_read_ts) {
-    char *reserved_field = tile_group_header->GetReservedFieldRef(tuple_id);
+    char *reserved_field =
+        tile_group_header->GetReservedFieldRef(tuple_id) + last_reader_offset_;
     cid_t read_ts = 0;
     PL_MEMCPY(&read_ts, reserved_field, sizeof(cid_t));
     if (last_read_ts > read_ts) {
@@ -19,6 +19,9 @@
 
 #include <vector>
 
+// Minimum number of input tuples for a hash aggregation to run in parallel
+#define PARALLEL_AGGREGATE_MIN_TUPLE_COUNT 100000
+
 namespace peloton {
 namespace executor {
 
@@ -32,7 +35,8 @@ namespace executor {
  *
  * If it is instantiated using PLAN_NODE_TYPE_HASHAGGREGATE,
  * then the input does not need to be sorted and it will hash the group by key
- * to aggregate the tuples.
+ * to aggregate the tuples. Large hash aggregations whose aggregates are all
+ * over fixed-width columns are run in parallel.
  */
 class AggregateExecutor : public AbstractExecutor {
  public:
@@ -51,6 +55,9 @@ class AggregateExecutor : public AbstractExecutor {
 
   bool DExecute();
 
+  // Wrap the output table into the result tiles and return the first one
+  bool ReturnResult();
+
   //===--------------------------------------------------------------------===//
   // Executor State
   //===--------------------------------------------------------------------===//
@@ -13,6 +13,8 @@
 
 #pragma once
 
+#include <atomic>
+#include <memory>
 #include <unordered_map>
 #include <unordered_set>
 
@@ -235,6 +237,56 @@ class MinAgg : public Agg {
 /** brief Create an instance of an aggregator for the specified aggregate */
 Agg *GetAggInstance(ExpressionType agg_type);
 
+/*
+ * Aggregate over a fixed-width numeric column (or COUNT(*)) that keeps its
+ * state in native types instead of Values. Unlike Agg, two partial
+ * aggregates of the same group can be merged.
+ */
+class TypedAgg {
+ public:
+  TypedAgg(ExpressionType agg_type, ValueType value_type)
+      : agg_type(agg_type), value_type(value_type) {}
+
+  // Whether an aggregate term can be computed with a typed aggregate
+  static bool IsSupported(const planner::AggregatePlan::AggTerm &agg_term);
+
+  void Advance(const Value &val);
+
+  // Fold the partial aggregate of another thread into this one
+  void Merge(const TypedAgg &other);
+
+  Value Finalize() const;
+
+ private:
+  bool IsDouble() const { return value_type == VALUE_TYPE_DOUBLE; }
+
+  void AddInteger(int64_t val);
+
+  ExpressionType agg_type;
+
+  ValueType value_type;
+
+  /** @brief count of non-null values aggregated */
+  int64_t count = 0;
+
+  int64_t int_aggregate = 0;
+
+  double double_aggregate = 0;
+};
+
+/** Hash function of the aggregate hash tables */
+struct ValueVectorHasher
+    : std::unary_function<std::vector<Value>, std::size_t> {
+  // Generate a 64-bit number for the a vector of value
+  size_t operator()(const std::vector<Value> &values) const {
+    size_t seed = 0;
+    for (auto &v : values) {
+      v.HashCombine(seed);
+    }
+    return seed;
+  }
+};
+
 /*
  * Interface for an aggregator (not an an individual aggregate)
  *
@@ -293,19 +345,6 @@ class HashAggregator : public AbstractAggregator {
     Agg **aggregates;
   };
 
-  /** Hash function of internal hash table */
-  struct ValueVectorHasher
-      : std::unary_function<std::vector<Value>, std::size_t> {
-    // Generate a 64-bit number for the a vector of value
-    size_t operator()(const std::vector<Value> &values) const {
-      size_t seed = 0;
-      for (auto &v : values) {
-        v.HashCombine(seed);
-      }
-      return seed;
-    }
-  };
-
   // Default equal_to should works well
   typedef std::unordered_map<std::vector<Value>, AggregateList *,
                              ValueVectorHasher> HashAggregateMapType;
@@ -359,6 +398,64 @@ class PlainAggregator : public AbstractAggregator {
  private:
   Agg **aggregates;
 };
+
+/**
+ * @brief Morsel-driven parallel version of the HashAggregator.
+ *
+ * Every worker repeatedly claims the next input tile (a morsel) and
+ * pre-aggregates it into its own hash table, which is split into
+ * partitions by the hash of the group-by key. The partitions are then
+ * merged in parallel, one worker per partition, so no table is ever shared
+ * between threads.
+ *
+ * Only used when all aggregates can be computed with typed aggregates.
+ */
+class ParallelHashAggregator {
+ public:
+  ParallelHashAggregator(const planner::AggregatePlan *node,
+                         storage::DataTable *output_table,
+                         executor::ExecutorContext *econtext,
+                         size_t num_input_columns);
+
+  // Whether the aggregation of the plan can run in parallel
+  static bool IsSupported(const planner::AggregatePlan *node);
+
+  // Aggregate all the tiles and insert the groups into the output table
+  bool Execute(const std::vector<std::unique_ptr<LogicalTile>> &tiles);
+
+ private:
+  /** Aggregates of one group */
+  struct GroupEntry {
+    // Keep a deep copy of the first tuple we met of this group
+    std::vector<Value> first_tuple_values;
+
+    std::vector<TypedAgg> aggregates;
+  };
+
+  typedef std::unordered_map<std::vector<Value>, std::unique_ptr<GroupEntry>,
+                             ValueVectorHasher> GroupMapType;
+
+  /** Hash table of a worker, one map per partition */
+  typedef std::vector<GroupMapType> PartitionedTable;
+
+  void AggregateMorsels(const std::vector<std::unique_ptr<LogicalTile>> &tiles,
+                        std::atomic<size_t> &next_morsel,
+                        PartitionedTable &table);
+
+  void MergePartition(std::vector<PartitionedTable> &tables,
+                      size_t partition);
+
+  const planner::AggregatePlan *node;
+
+  storage::DataTable *output_table;
+
+  executor::ExecutorContext *executor_context;
+
+  const size_t num_input_columns;
+
+  /** @brief Input column of every aggregate, INVALID_OID for COUNT(*) */
+  std::vector<oid_t> aggregate_column_ids;
+};
 }
 // namespace executor
 }  // namespace peloton
@@ -13,11 +13,19 @@
 
 #pragma once
 
+#include <memory>
+#include <unordered_map>
+
 #include "concurrency/transaction.h"
 #include "common/pool.h"
 #include "common/value.h"
 
 namespace peloton {
+
+namespace storage {
+class TileGroup;
+}
+
 namespace executor {
 
 //===--------------------------------------------------------------------===//
@@ -45,6 +53,10 @@ class ExecutorContext {
 
   ~ExecutorContext();
 
+  // Prepare the context for another execution of the same executor tree
+  void Reset(concurrency::Transaction *transaction,
+             const std::vector<Value> &params);
+
   concurrency::Transaction *GetTransaction() const { return transaction_; }
 
   const std::vector<Value> &GetParams() const { return params_; }
@@ -57,10 +69,21 @@ class ExecutorContext {
   // Get a varlen pool (will construct the pool only if needed)
   VarlenPool *GetExecutorContextPool();
 
+  // Pin the tile group until the context is reset or destroyed, so that
+  // the tuples the results read in place are not overwritten by other
+  // transactions meanwhile (see TileGroupHeader::Pin)
+  void PinTileGroup(const std::shared_ptr<storage::TileGroup> &tile_group);
+
+  bool IsTileGroupPinned(const oid_t tile_group_id) const {
+    return pinned_tile_groups_.count(tile_group_id) != 0;
+  }
+
   // num of tuple processed
   uint32_t num_processed = 0;
 
  private:
+  void UnpinTileGroups();
+
   //===--------------------------------------------------------------------===//
   // MEMBERS
   //===--------------------------------------------------------------------===//
@@ -76,6 +99,10 @@ class ExecutorContext {
 
   // PARAMS_EXEC_Flag
   ParamsExecFlag params_exec_flag_;
+
+  // tile groups pinned by the context, kept alive until they are unpinned
+  std::unordered_map<oid_t, std::shared_ptr<storage::TileGroup>>
+      pinned_tile_groups_;
 };
 
 }  // namespace executor
@@ -30,6 +30,7 @@
 #include "executor/hash_join_executor.h"
 #include "executor/hash_executor.h"
 #include "executor/order_by_executor.h"
+#include "executor/import_executor.h"
 #include "executor/hash_set_op_executor.h"
 #include "executor/append_executor.h"
 #include "executor/projection_executor.h"
@@ -20,6 +20,9 @@
 #include "planner/hash_join_plan.h"
 #include "executor/hash_executor.h"
 
+// Number of tuples of the probe side hashed ahead of probing
+#define HASH_JOIN_PROBE_BATCH_SIZE 32
+
 namespace peloton {
 namespace executor {
 
@@ -0,0 +1,122 @@
+//===----------------------------------------------------------------------===//
+//
+//                         Peloton
+//
+// import_executor.h
+//
+// Identification: src/include/executor/import_executor.h
+//
+// Copyright (c) 2015-16, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+
+#pragma once
+
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "executor/abstract_executor.h"
+#include "planner/import_plan.h"
+
+// Bytes of the input file loaded, indexed and logged as one batch
+#define IMPORT_BATCH_SIZE (64 * 1024 * 1024)
+
+namespace peloton {
+
+namespace storage {
+class DataTable;
+class TileGroup;
+class Tuple;
+}
+
+namespace executor {
+
+/**
+ * Bulk loads a CSV or TSV file into a table, bypassing the tuple at a time
+ * insert path.
+ *
+ * The file is read in batches that are split at line boundaries into one
+ * chunk per worker. Workers parse their chunk in parallel straight into
+ * tile groups that are not yet part of the table, and collect the index
+ * keys of every row. Once a batch is parsed, the tile groups are added to
+ * the table with tuples owned by the transaction, every index is bulk
+ * loaded from its keys sorted at once, and the batch is logged as a single
+ * transaction with one commit record. Only then do all its tuples get the
+ * same commit id.
+ *
+ * Primary and unique indexes are loaded first. A batch that repeats one of
+ * their keys, or holds a key they already have, is rejected as a whole.
+ *
+ * Records cannot contain line breaks. An empty unquoted field is NULL.
+ * Batches loaded before a malformed record stay loaded.
+ */
+class ImportExecutor : public AbstractExecutor {
+ public:
+  ImportExecutor(const ImportExecutor &) = delete;
+  ImportExecutor &operator=(const ImportExecutor &) = delete;
+  ImportExecutor(ImportExecutor &&) = delete;
+  ImportExecutor &operator=(ImportExecutor &&) = delete;
+
+  ImportExecutor(const planner::AbstractPlan *node,
+                 ExecutorContext *executor_context);
+
+  ~ImportExecutor() {}
+
+  // Set the number of parsing workers, zero uses one per hardware thread
+  static void Configure(size_t worker_count) { worker_count_ = worker_count; }
+
+  static size_t GetWorkerCount();
+
+  // Number of tuples loaded by the last execution
+  size_t GetLoadedTupleCount() const { return loaded_tuple_count_; }
+
+ protected:
+  bool DInit();
+
+  bool DExecute();
+
+ private:
+  /** Output of a worker parsing one chunk of a batch */
+  struct import_chunk_t {
+    std::vector<std::shared_ptr<storage::TileGroup>> tile_groups;
+
+    // Keys of every parsed tuple and their locations, one list per index
+    std::vector<std::vector<std::unique_ptr<storage::Tuple>>> keys;
+    std::vector<std::vector<ItemPointer>> locations;
+
+    size_t tuple_count = 0;
+
+    // Set when the chunk holds a malformed record
+    std::string error;
+  };
+
+  void ParseChunk(const char *begin, const char *end,
+                  import_chunk_t &chunk) const;
+
+  void LoadBatch(const std::vector<char> &buffer, size_t length);
+
+  // Insert the keys of the batch into the indexes at the offsets in
+  // parallel. Returns false, with none of the keys inserted, if one of the
+  // indexes rejects a duplicate key.
+  bool BuildIndexes(const std::vector<import_chunk_t> &chunks,
+                    const std::vector<oid_t> &index_offsets, bool unique);
+
+  // Keys of the batch for the index at the offset, and their locations
+  static void GetIndexEntries(const std::vector<import_chunk_t> &chunks,
+                              oid_t index_offset,
+                              std::vector<const storage::Tuple *> &keys,
+                              std::vector<ItemPointer> &locations);
+
+  storage::DataTable *target_table_ = nullptr;
+
+  char delimiter_ = ',';
+
+  size_t loaded_tuple_count_ = 0;
+
+  static size_t worker_count_;
+};
+
+}  // namespace executor
+}  // namespace peloton
@@ -13,6 +13,8 @@
 
 #pragma once
 
+#include <map>
+#include <memory>
 #include <vector>
 
 #include "executor/abstract_scan_executor.h"
@@ -22,6 +24,8 @@ namespace peloton {
 
 namespace storage {
 class AbstractTable;
+class TileGroup;
+class Tuple;
 }
 
 namespace executor {
@@ -48,6 +52,12 @@ class IndexScanExecutor : public AbstractScanExecutor {
   bool ExecPrimaryIndexLookup();
   bool ExecSecondaryIndexLookup();
 
+  bool AddVisibleTuple(
+      const std::shared_ptr<storage::TileGroup> &tile_group,
+      const ItemPointer &location,
+      std::map<oid_t, std::vector<oid_t>> &visible_tuples,
+      std::vector<std::unique_ptr<storage::Tuple>> &delta_tuples);
+
   //===--------------------------------------------------------------------===//
   // Executor State
   //===--------------------------------------------------------------------===//
@@ -0,0 +1,137 @@
+//===----------------------------------------------------------------------===//
+//
+//                         Peloton
+//
+// join_hash_table.h
+//
+// Identification: src/include/executor/join_hash_table.h
+//
+// Copyright (c) 2015-16, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+
+#pragma once
+
+#include <memory>
+#include <utility>
+#include <vector>
+
+#include "common/macros.h"
+#include "common/types.h"
+#include "executor/logical_tile.h"
+#include "expression/container_tuple.h"
+
+// Minimum number of slots of a join hash table
+#define JOIN_HASH_TABLE_MIN_SLOTS 16
+
+// Maximum number of key columns whose values are kept inline in the slots
+#define JOIN_HASH_TABLE_INLINE_KEY_COLUMNS 2
+
+namespace peloton {
+namespace executor {
+
+/**
+ * @brief Open addressing hash table built by the hash executor and probed
+ * by the hash join executor.
+ *
+ * Every distinct key owns one slot, which keeps the hash of the key inline
+ * along with the range of the locations of the tuples with that key. The
+ * locations of all tuples are stored contiguously, grouped by key, so
+ * probing a key touches one slot and one run of locations.
+ *
+ * Keys made of up to JOIN_HASH_TABLE_INLINE_KEY_COLUMNS integer columns are
+ * also kept inline in their slot, widened to 64 bits, so that probes compare
+ * them without going back to the tiles. Other keys, as well as keys with
+ * NULLs, are compared through the tuple of the first location of the slot.
+ *
+ * The table is built once, after all the input tiles are known, and is read
+ * only afterwards. It does not own the tiles, which must outlive it.
+ */
+class JoinHashTable {
+ public:
+  JoinHashTable(const JoinHashTable &) = delete;
+  JoinHashTable &operator=(const JoinHashTable &) = delete;
+
+  JoinHashTable() {}
+
+  /** @brief Location of a tuple : < tile offset, tuple offset > */
+  typedef std::pair<oid_t, oid_t> Location;
+
+  /** @brief Range of the locations of the tuples with some key */
+  typedef std::pair<const Location *, const Location *> LocationRange;
+
+  typedef expression::ContainerTuple<LogicalTile> KeyType;
+
+  // Build the table over the key columns of all tuples of the tiles
+  void Build(const std::vector<std::unique_ptr<LogicalTile>> &tiles,
+             const std::vector<oid_t> *column_ids);
+
+  static size_t HashKey(const KeyType &key) { return key.HashCode(); }
+
+  // Issue a prefetch of the slot a key with the given hash starts at
+  inline void Prefetch(size_t hash) const {
+    if (slots_.empty() == false) {
+      PL_PREFETCH(&slots_[hash & slot_mask_]);
+    }
+  }
+
+  // Find the tuples whose key equals the given key, the range is empty if
+  // there are none
+  LocationRange Find(const KeyType &key, size_t hash) const;
+
+  // Number of distinct keys
+  size_t GetKeyCount() const { return key_count_; }
+
+  // Number of tuples
+  size_t GetSize() const { return locations_.size(); }
+
+  bool IsEmpty() const { return locations_.empty(); }
+
+ private:
+  struct Slot {
+    // hash of the key
+    size_t hash;
+
+    // values of the key, only valid if the keys of the table are inline
+    int64_t key[JOIN_HASH_TABLE_INLINE_KEY_COLUMNS];
+
+    // offset of the first location of the key in the location array
+    oid_t begin;
+
+    // number of tuples with the key, 0 if the slot is free
+    oid_t count;
+  };
+
+  // Key of the tuple at the given location
+  KeyType GetKey(const Location &location) const {
+    return KeyType(tiles_[location.first], location.second, column_ids_);
+  }
+
+  // Widen the values of the key into the given array, returns false if the
+  // key cannot be kept inline
+  bool PackKey(const KeyType &key, int64_t *packed_key) const;
+
+  // Whether the slot holds the key with the given hash and packed values.
+  // The packed values are nullptr if the key could not be packed.
+  bool SlotMatches(const Slot &slot, const KeyType &key, size_t hash,
+                   const int64_t *packed_key) const;
+
+  std::vector<LogicalTile *> tiles_;
+
+  const std::vector<oid_t> *column_ids_ = nullptr;
+
+  // Whether every slot holds its key inline
+  bool inline_keys_ = false;
+
+  std::vector<Slot> slots_;
+
+  size_t slot_mask_ = 0;
+
+  std::vector<Location> locations_;
+
+  size_t key_count_ = 0;
+};
+
+} /* namespace executor */
+} /* namespace peloton */
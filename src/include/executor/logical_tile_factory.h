@@ -20,8 +20,13 @@
 
 namespace peloton {
 
+namespace catalog {
+class Schema;
+}
+
 namespace storage {
 class Tile;
+class Tuple;
 class TileGroup;
 class AbstractTable;
 }
@@ -42,6 +47,10 @@ class LogicalTileFactory {
 
   static LogicalTile *WrapTileGroup(
       const std::shared_ptr<storage::TileGroup> &tile_group);
+
+  static LogicalTile *WrapTuples(
+      const std::vector<std::unique_ptr<storage::Tuple>> &tuples,
+      const catalog::Schema *schema);
 };
 
 }  // namespace executor
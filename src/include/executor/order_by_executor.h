@@ -13,9 +13,21 @@
 
 #pragma once
 
+#include <cstdio>
+
+#include "catalog/schema.h"
+#include "common/serializer.h"
 #include "common/types.h"
 #include "executor/abstract_executor.h"
-#include "storage/tuple.h"
+
+// Bytes of sort records kept in memory before a sorted run is spilled to disk
+#define ORDER_BY_MEMORY_BUDGET (64 * 1024 * 1024)
+
+// Maximum number of runs merged at once
+#define ORDER_BY_MERGE_FAN_IN 64
+
+// Size of the stdio buffer of every run file
+#define ORDER_BY_RUN_BUFFER_SIZE (64 * 1024)
 
 namespace peloton {
 
@@ -26,10 +38,14 @@ namespace executor {
 /**
  * @warning This is a pipeline breaker and a materialization point.
  *
- * TODO Currently, we store all input tiles and sort result in memory
- * until this executor is destroyed, which is sometimes necessary.
- * But can we let it release the RAM earlier as long as the executor
- * is not needed any more (e.g., with a LIMIT sitting on top)?
+ * Every input tuple is turned into a sort record made of a normalized
+ * binary sort key, which orders correctly under memcmp, followed by the
+ * serialized tuple. Records are sorted in memory; once they exceed the
+ * memory budget, the sorted batch is spilled to a temporary file as a run
+ * and the runs are merged while the output is produced.
+ *
+ * When a LIMIT sits on top, only the first limit + offset tuples are kept
+ * in a bounded heap instead of sorting the entire input.
  */
 class OrderByExecutor : public AbstractExecutor {
  public:
@@ -43,6 +59,19 @@ class OrderByExecutor : public AbstractExecutor {
 
   ~OrderByExecutor();
 
+  // Only the first limit tuples of the sorted output are needed
+  void SetLimit(size_t limit) {
+    has_limit_ = true;
+    limit_ = limit;
+  }
+
+  // Set the memory budget of the sort buffer, in bytes
+  static void Configure(size_t memory_budget) {
+    memory_budget_ = memory_budget;
+  }
+
+  static size_t GetMemoryBudget() { return memory_budget_; }
+
  protected:
   bool DInit();
 
@@ -51,50 +80,90 @@ class OrderByExecutor : public AbstractExecutor {
  private:
   bool DoSort();
 
-  bool sort_done_ = false;
+  /** Location of a sort record in the sort buffer */
+  struct sort_entry_t {
+    size_t offset;
+    uint32_t key_length;
+    uint32_t row_length;
+  };
 
-  /**
-   * IMPORTANT This type must be move-constructible and move-assignable
-   * in order to be correctly sorted by STL sort
-   */
-  struct sort_buffer_entry_t {
-    ItemPointer item_pointer;
-    std::unique_ptr<storage::Tuple> tuple;
-
-    sort_buffer_entry_t(ItemPointer ipt, std::unique_ptr<storage::Tuple> &&tp)
-        : item_pointer(ipt), tuple(std::move(tp)) {}
-
-    sort_buffer_entry_t(sort_buffer_entry_t &&rhs) {
-      item_pointer = rhs.item_pointer;
-      tuple = std::move(rhs.tuple);
-    }
-
-    sort_buffer_entry_t &operator=(sort_buffer_entry_t &&rhs) {
-      item_pointer = rhs.item_pointer;
-      tuple = std::move(rhs.tuple);
-      return *this;
-    }
-
-    sort_buffer_entry_t(const sort_buffer_entry_t &) = delete;
-    sort_buffer_entry_t &operator=(const sort_buffer_entry_t &) = delete;
+  /** Current record of a run being merged */
+  struct run_reader_t {
+    FILE *file;
+    std::vector<char> record;
+    uint32_t key_length;
+    uint32_t row_length;
   };
 
-  /** All tiles returned by child. */
-  std::vector<std::unique_ptr<LogicalTile>> input_tiles_;
+  void AddSortRecord(LogicalTile *tile, oid_t tuple_id);
+
+  bool SortEntryLess(const sort_entry_t &lhs, const sort_entry_t &rhs) const;
+
+  bool MergeReaderGreater(size_t lhs, size_t rhs) const;
+
+  void CompactSortBuffer();
+
+  void SpillRun();
+
+  FILE *MergeRuns(size_t run_begin, size_t run_end);
+
+  void StartMerge(size_t run_begin, size_t run_end);
+
+  run_reader_t *NextMergedRecord();
+
+  bool NextSortRecord(const char *&row, uint32_t &row_length);
+
+  void CloseRuns();
+
+  bool sort_done_ = false;
 
   /** Physical (not logical) schema of input tiles */
   std::unique_ptr<catalog::Schema> input_schema_;
 
-  /** All valid tuples in sorted order */
-  std::vector<sort_buffer_entry_t> sort_buffer_;
-
-  /** Tuples in sort_buffer only contains the sort keys */
-  std::unique_ptr<catalog::Schema> sort_key_tuple_schema_;
+  std::vector<oid_t> sort_keys_;
 
   std::vector<bool> descend_flags_;
 
+  /** Sort records, each a sort key followed by a serialized tuple */
+  std::vector<char> sort_buffer_;
+
+  /** Records in the sort buffer, a max heap in top-N mode */
+  std::vector<sort_entry_t> sort_entries_;
+
+  /** Bytes of the sort buffer still referenced by sort entries */
+  size_t live_bytes_ = 0;
+
+  /** Scratch buffer for serializing tuples */
+  CopySerializeOutput row_output_;
+
+  /** Sorted runs spilled to temporary files */
+  std::vector<FILE *> runs_;
+
+  std::vector<run_reader_t> merge_readers_;
+
+  /** Indexes into merge_readers_, a min heap on the current sort keys */
+  std::vector<size_t> merge_heap_;
+
+  /** Reader whose record was handed out last and has to advance */
+  bool merge_pending_ = false;
+  size_t merge_current_ = 0;
+
+  /** Holds the variable length values of the tile being built */
+  std::unique_ptr<VarlenPool> output_pool_;
+
+  bool has_limit_ = false;
+  size_t limit_ = 0;
+
+  /** Keep a bounded heap instead of sorting everything */
+  bool top_n_ = false;
+
+  /** Number of tuples the sort produces */
+  size_t num_tuples_ = 0;
+
   /** How many tuples have been returned to parent */
   size_t num_tuples_returned_ = 0;
+
+  static size_t memory_budget_;
 };
 
 } /* namespace executor */
@@ -13,9 +13,15 @@
 
 #pragma once
 
+#include <functional>
+#include <memory>
+
 #include "common/types.h"
 #include "executor/abstract_executor.h"
 
+// Number of executor trees of cached plans kept by every thread
+#define EXECUTOR_TREE_CACHE_SIZE 64
+
 namespace peloton {
 namespace bridge {
 
@@ -44,6 +50,10 @@ typedef struct peloton_status {
 
 } peloton_status;
 
+// Receives every result tile as soon as the executor tree produces it. The
+// tile is only valid during the call. Returning false stops the execution.
+typedef std::function<bool(executor::LogicalTile *)> ResultTileCallback;
+
 class PlanExecutor {
  public:
   PlanExecutor(const PlanExecutor &) = delete;
@@ -69,8 +79,19 @@ class PlanExecutor {
    * pass
    *        value list directly rather than passing Postgres's ParamListInfo
    */
-  static peloton_status ExecutePlan(const planner::AbstractPlan *plan,
-                                    const std::vector<Value> &params);
+  static peloton_status ExecutePlan(
+      const planner::AbstractPlan *plan, const std::vector<Value> &params,
+      const ResultTileCallback &callback = nullptr);
+
+  /*
+   * @brief Execute a plan shared by cached statements. The calling thread
+   * builds the executor tree of the plan once and re-initializes it with
+   * the params and transaction of the later executions.
+   */
+  static peloton_status ExecutePlan(
+      const std::shared_ptr<planner::AbstractPlan> &plan,
+      const std::vector<Value> &params,
+      const ResultTileCallback &callback = nullptr);
 
   /*
    * @brief When a peloton node recvs a query plan, this function is invoked
@@ -13,8 +13,11 @@
 
 #pragma once
 
+#include <memory>
+
 #include "planner/seq_scan_plan.h"
 #include "executor/abstract_scan_executor.h"
+#include "executor/logical_tile.h"
 
 namespace peloton {
 namespace executor {
@@ -35,6 +38,10 @@ class SeqScanExecutor : public AbstractScanExecutor {
   bool DExecute();
 
  private:
+  bool ReconstructVersions(
+      const std::shared_ptr<storage::TileGroup> &tile_group,
+      std::vector<oid_t> &position_list);
+
   //===--------------------------------------------------------------------===//
   // Executor State
   //===--------------------------------------------------------------------===//
@@ -45,6 +52,9 @@ class SeqScanExecutor : public AbstractScanExecutor {
   /** @brief Keeps track of the number of tile groups to scan. */
   oid_t table_tile_group_count_ = INVALID_OID;
 
+  /** @brief Versions of the last tile group copied in delta storage. */
+  std::unique_ptr<LogicalTile> delta_tile_;
+
   //===--------------------------------------------------------------------===//
   // Plan Info
   //===--------------------------------------------------------------------===//
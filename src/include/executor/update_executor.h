@@ -36,8 +36,17 @@ class UpdateExecutor : public AbstractExecutor {
   bool DExecute();
 
  private:
+  void PerformInPlaceUpdate(storage::TileGroup *tile_group,
+                            const oid_t physical_tuple_id);
+
   storage::DataTable *target_table_ = nullptr;
   const planner::ProjectInfo *project_info_ = nullptr;
+
+  /** @brief Columns modified by the update, without their expressions. */
+  TargetList delta_columns_;
+
+  /** @brief Whether tuples are updated in place with a delta record. */
+  bool delta_update_ = false;
 };
 
 }  // namespace executor
@@ -26,6 +26,10 @@ namespace executor {
 class ExecutorContext;
 }
 
+namespace storage {
+class TileGroup;
+}
+
 namespace expression {
 
 //===----------------------------------------------------------------------===//
@@ -51,6 +55,14 @@ class AbstractExpression : public Printable {
                          const AbstractTuple *tuple2,
                          executor::ExecutorContext *context) const = 0;
 
+  // Evaluate the expression as a predicate over a batch of tuples in a tile
+  // group. The selection vector holds the ids of the tuples to check, in
+  // ascending order; the ones for which the predicate is not true are
+  // removed from it. The default evaluates the tuples one at a time.
+  virtual void EvaluateBatch(storage::TileGroup *tile_group,
+                             std::vector<oid_t> &selection_vector,
+                             executor::ExecutorContext *context) const;
+
   /** return true if self or descendent should be substitute()'d */
   virtual bool HasParameter() const;
 
@@ -40,6 +40,9 @@ namespace expression {
 //
 // "includes_equality" returns true if the comparison is true for (rows of)
 // equal values.
+//
+// "compare_raw" applies the comparison to two non-null native values; it is
+// used by the batch evaluation kernels.
 //===----------------------------------------------------------------------===//
 
 class CmpEq {
@@ -48,6 +51,10 @@ class CmpEq {
   inline static Value compare_withoutNull(const Value &l, const Value &r) {
     return l.OpEqualsWithoutNull(r);
   }
+  template <typename T>
+  inline static bool compare_raw(const T l, const T r) {
+    return l == r;
+  }
   inline static bool implies_true_for_row(UNUSED_ATTRIBUTE const Value &l,
                                           UNUSED_ATTRIBUTE const Value &r) {
     return false;
@@ -66,6 +73,10 @@ class CmpNe {
   inline static Value compare_withoutNull(const Value &l, const Value &r) {
     return l.OpNotEqualsWithoutNull(r);
   }
+  template <typename T>
+  inline static bool compare_raw(const T l, const T r) {
+    return l != r;
+  }
   inline static bool implies_true_for_row(UNUSED_ATTRIBUTE const Value &l,
                                           UNUSED_ATTRIBUTE const Value &r) {
     return true;
@@ -84,6 +95,10 @@ class CmpLt {
   inline static Value compare_withoutNull(const Value &l, const Value &r) {
     return l.OpLessThanWithoutNull(r);
   }
+  template <typename T>
+  inline static bool compare_raw(const T l, const T r) {
+    return l < r;
+  }
   inline static bool implies_true_for_row(UNUSED_ATTRIBUTE const Value &l,
                                           UNUSED_ATTRIBUTE const Value &r) {
     return true;
@@ -101,6 +116,10 @@ class CmpGt {
   inline static Value compare_withoutNull(const Value &l, const Value &r) {
     return l.OpGreaterThanWithoutNull(r);
   }
+  template <typename T>
+  inline static bool compare_raw(const T l, const T r) {
+    return l > r;
+  }
   inline static bool implies_true_for_row(UNUSED_ATTRIBUTE const Value &l,
                                           UNUSED_ATTRIBUTE const Value &r) {
     return true;
@@ -118,6 +137,10 @@ class CmpLte {
   inline static Value compare_withoutNull(const Value &l, const Value &r) {
     return l.OpLessThanOrEqualWithoutNull(r);
   }
+  template <typename T>
+  inline static bool compare_raw(const T l, const T r) {
+    return l <= r;
+  }
   inline static bool implies_true_for_row(const Value &l, const Value &r) {
     return l.OpNotEqualsWithoutNull(r).IsTrue();
   }
@@ -135,6 +158,10 @@ class CmpGte {
   inline static Value compare_withoutNull(const Value &l, const Value &r) {
     return l.OpGreaterThanOrEqualWithoutNull(r);
   }
+  template <typename T>
+  inline static bool compare_raw(const T l, const T r) {
+    return l >= r;
+  }
   inline static bool implies_true_for_row(const Value &l, const Value &r) {
     return l.OpNotEqualsWithoutNull(r).IsTrue();
   }
@@ -213,6 +240,12 @@ class ComparisonExpression : public AbstractExpression {
     return OP::compare_withoutNull(lnv, rnv);
   }
 
+  void EvaluateBatch(storage::TileGroup *tile_group,
+                     std::vector<oid_t> &selection_vector,
+                     executor::ExecutorContext *context) const override {
+    AbstractExpression::EvaluateBatch(tile_group, selection_vector, context);
+  }
+
   inline const char *traceEval(const AbstractTuple *tuple1,
                                const AbstractTuple *tuple2,
                                executor::ExecutorContext *context) const {
@@ -239,6 +272,33 @@ class ComparisonExpression : public AbstractExpression {
   }
 };
 
+// Comparisons between a fixed-width column and a constant or parameter have
+// tight batch kernels; everything else falls back to the tuple at a time path.
+template <>
+void ComparisonExpression<CmpEq>::EvaluateBatch(
+    storage::TileGroup *tile_group, std::vector<oid_t> &selection_vector,
+    executor::ExecutorContext *context) const;
+template <>
+void ComparisonExpression<CmpNe>::EvaluateBatch(
+    storage::TileGroup *tile_group, std::vector<oid_t> &selection_vector,
+    executor::ExecutorContext *context) const;
+template <>
+void ComparisonExpression<CmpLt>::EvaluateBatch(
+    storage::TileGroup *tile_group, std::vector<oid_t> &selection_vector,
+    executor::ExecutorContext *context) const;
+template <>
+void ComparisonExpression<CmpGt>::EvaluateBatch(
+    storage::TileGroup *tile_group, std::vector<oid_t> &selection_vector,
+    executor::ExecutorContext *context) const;
+template <>
+void ComparisonExpression<CmpLte>::EvaluateBatch(
+    storage::TileGroup *tile_group, std::vector<oid_t> &selection_vector,
+    executor::ExecutorContext *context) const;
+template <>
+void ComparisonExpression<CmpGte>::EvaluateBatch(
+    storage::TileGroup *tile_group, std::vector<oid_t> &selection_vector,
+    executor::ExecutorContext *context) const;
+
 template <typename C, typename L, typename R>
 class InlinedComparisonExpression : public ComparisonExpression<C> {
  public:
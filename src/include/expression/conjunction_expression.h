@@ -17,7 +17,10 @@
 
 #include "expression/abstract_expression.h"
 
+#include <algorithm>
+#include <iterator>
 #include <string>
+#include <vector>
 
 namespace peloton {
 namespace expression {
@@ -35,6 +38,10 @@ class ConjunctionExpression : public AbstractExpression {
   Value Evaluate(const AbstractTuple *tuple1, const AbstractTuple *tuple2,
                  executor::ExecutorContext *context) const override;
 
+  void EvaluateBatch(storage::TileGroup *tile_group,
+                     std::vector<oid_t> &selection_vector,
+                     executor::ExecutorContext *context) const override;
+
   std::string DebugInfo(const std::string &spacer) const override {
     return (spacer + "ConjunctionExpression\n");
   }
@@ -93,5 +100,38 @@ inline Value ConjunctionExpression<ConjunctionOr>::Evaluate(
   return Value::GetNullValue(VALUE_TYPE_BOOLEAN);
 }
 
+template <>
+inline void ConjunctionExpression<ConjunctionAnd>::EvaluateBatch(
+    storage::TileGroup *tile_group, std::vector<oid_t> &selection_vector,
+    executor::ExecutorContext *context) const {
+  // Only tuples for which the left side is true can pass
+  m_left->EvaluateBatch(tile_group, selection_vector, context);
+  if (selection_vector.empty() == false) {
+    m_right->EvaluateBatch(tile_group, selection_vector, context);
+  }
+}
+
+template <>
+inline void ConjunctionExpression<ConjunctionOr>::EvaluateBatch(
+    storage::TileGroup *tile_group, std::vector<oid_t> &selection_vector,
+    executor::ExecutorContext *context) const {
+  std::vector<oid_t> left_selection(selection_vector);
+  m_left->EvaluateBatch(tile_group, left_selection, context);
+
+  // Only check the right side for tuples the left side did not select
+  std::vector<oid_t> right_selection;
+  std::set_difference(selection_vector.begin(), selection_vector.end(),
+                      left_selection.begin(), left_selection.end(),
+                      std::back_inserter(right_selection));
+  if (right_selection.empty() == false) {
+    m_right->EvaluateBatch(tile_group, right_selection, context);
+  }
+
+  selection_vector.clear();
+  std::merge(left_selection.begin(), left_selection.end(),
+             right_selection.begin(), right_selection.end(),
+             std::back_inserter(selection_vector));
+}
+
 }  // namespace expression
 }  // namespace peloton
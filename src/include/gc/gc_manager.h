@@ -13,17 +13,27 @@
 
 #pragma once
 
+#include <atomic>
+#include <memory>
 #include <thread>
 #include <unordered_map>
 #include <map>
+#include <mutex>
 #include <vector>
 
 #include "common/types.h"
 #include "common/logger.h"
+#include "common/macros.h"
 #include "container/queue.h"
 #include "libcuckoo/cuckoohash_map.hh"
 
 namespace peloton {
+
+namespace storage {
+class RollbackSegmentPool;
+class TileGroup;
+}
+
 namespace gc {
 
 //===--------------------------------------------------------------------===//
@@ -34,6 +44,13 @@ namespace gc {
 #define MAX_QUEUE_LENGTH 100000
 
 #define GC_PERIOD_MILLISECONDS 100
+
+// Number of GC worker threads, each table is assigned to one of them
+#define GC_DEFAULT_THREAD_COUNT 2
+
+// Maximum number of tuples a worker takes from its queue in one round
+#define GC_MAX_BATCH_SIZE 4096
+
 class GCBuffer {
  public:
   GCBuffer(oid_t tid) : table_id(tid), garbage_tuples() {}
@@ -47,6 +64,29 @@ class GCBuffer {
   std::vector<ItemPointer> garbage_tuples;
 };
 
+// Rollback segments of a transaction, with the tuples whose delta chain they
+// were pushed on
+struct RollbackSegmentMetadata {
+  std::shared_ptr<storage::RollbackSegmentPool> rb_seg_pool;
+  std::vector<ItemPointer> locations;
+
+  // commit id of the transaction, the segments are garbage once every
+  // transaction that may read them is done
+  cid_t end_cid = INVALID_CID;
+
+  // next commit id when the segments were unlinked from the chains, the pool
+  // is freed once every transaction that may still walk them is done
+  cid_t unlink_cid = INVALID_CID;
+};
+
+// Reclaimed slots of a table waiting to be reused, with their number
+struct RecycleQueue {
+  RecycleQueue() : queue(MAX_QUEUE_LENGTH), size(0) {}
+
+  Queue<TupleMetadata> queue;
+  std::atomic<size_t> size;
+};
+
 class GCManager {
  public:
   GCManager(const GCManager &) = delete;
@@ -54,8 +94,21 @@ class GCManager {
   GCManager(GCManager &&) = delete;
   GCManager &operator=(GCManager &&) = delete;
 
-  GCManager(const GCType type)
-      : is_running_(true), gc_type_(type), reclaim_queue_(MAX_QUEUE_LENGTH) {
+  GCManager(const GCType type,
+            const size_t thread_count = GC_DEFAULT_THREAD_COUNT)
+      : is_running_(true),
+        gc_type_(type),
+        thread_count_(thread_count),
+        rb_seg_queue_(MAX_QUEUE_LENGTH),
+        reclaimed_count_(0),
+        backlog_count_(0),
+        recycle_backlog_count_(0),
+        rb_seg_backlog_count_(0) {
+    PL_ASSERT(thread_count_ > 0);
+    for (size_t thread_itr = 0; thread_itr < thread_count_; thread_itr++) {
+      reclaim_queues_.emplace_back(
+          new Queue<TupleMetadata>(MAX_QUEUE_LENGTH));
+    }
     StartGC();
   }
 
@@ -73,11 +126,51 @@ class GCManager {
 
   ItemPointer ReturnFreeSlot(const oid_t &table_id);
 
+  // Move up to max_count free tuple slots of the table to free_slots
+  void ReturnFreeSlots(const oid_t &table_id,
+                       std::vector<ItemPointer> &free_slots,
+                       const size_t max_count);
+
+  // called by transaction manager for the rollback segments of a finished
+  // transaction, with no location if the segments are already unlinked
+  void RecycleRollbackSegments(
+      const std::shared_ptr<storage::RollbackSegmentPool> &rb_seg_pool,
+      const std::vector<ItemPointer> &locations, const cid_t &end_cid);
+
+  size_t GetThreadCount() const { return thread_count_; }
+
+  // Number of versions reclaimed so far
+  size_t GetReclaimedCount() const { return reclaimed_count_.load(); }
+
+  // Number of versions handed to the GC and not reclaimed yet
+  size_t GetQueueBacklog() const { return backlog_count_.load(); }
+
+  // Number of reclaimed slots waiting to be reused, at most MAX_QUEUE_LENGTH
+  // per table
+  size_t GetRecycleQueueBacklog() const {
+    return recycle_backlog_count_.load();
+  }
+
+  // Number of rollback segment pools not freed yet
+  size_t GetRollbackSegmentBacklog() const {
+    return rb_seg_backlog_count_.load();
+  }
+
  private:
-  void Running();
+  void Running(const size_t thread_id);
 
   bool ResetTuple(const TupleMetadata &);
 
+  void UnlinkIndexEntries(storage::TileGroup *tile_group,
+                          const oid_t &tuple_slot_id);
+
+  void UnlinkRollbackSegments(const RollbackSegmentMetadata &metadata,
+                              const cid_t &max_cid);
+
+  size_t ReclaimRollbackSegments(
+      std::vector<RollbackSegmentMetadata> &local_rb_seg_queue,
+      const cid_t &max_cid, const bool is_running);
+
  private:
   //===--------------------------------------------------------------------===//
   // Private methods
@@ -92,14 +185,32 @@ class GCManager {
   volatile bool is_running_;
   GCType gc_type_;
 
-  std::unique_ptr<std::thread> gc_thread_;
+  size_t thread_count_;
 
+  std::vector<std::unique_ptr<std::thread>> gc_threads_;
+
+  // one reclaim queue per worker, a table always goes to the same worker
   // TODO: use shared pointer to reduce memory copy
-  Queue<TupleMetadata> reclaim_queue_;
+  std::vector<std::unique_ptr<Queue<TupleMetadata>>> reclaim_queues_;
 
   // TODO: use shared pointer to reduce memory copy
-  cuckoohash_map<oid_t, std::shared_ptr<Queue<TupleMetadata>>>
-      recycle_queue_map_;
+  cuckoohash_map<oid_t, std::shared_ptr<RecycleQueue>> recycle_queue_map_;
+
+  // rollback segments of the finished transactions, shared by the workers
+  Queue<RollbackSegmentMetadata> rb_seg_queue_;
+
+  // rollback segments kept alive while GC is off
+  std::mutex retained_rb_seg_pools_mutex_;
+  std::vector<std::shared_ptr<storage::RollbackSegmentPool>>
+      retained_rb_seg_pools_;
+
+  std::atomic<size_t> reclaimed_count_;
+
+  std::atomic<size_t> backlog_count_;
+
+  std::atomic<size_t> recycle_backlog_count_;
+
+  std::atomic<size_t> rb_seg_backlog_count_;
 };
 
 }  // namespace gc
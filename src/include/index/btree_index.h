@@ -52,6 +52,12 @@ class BTreeIndex : public Index {
   bool CondInsertEntry(const storage::Tuple *key, const ItemPointer &location,
                        std::function<bool(const ItemPointer &)> predicate);
 
+  void InsertEntries(const std::vector<const storage::Tuple *> &keys,
+                     const std::vector<ItemPointer> &locations);
+
+  bool CondInsertEntries(const std::vector<const storage::Tuple *> &keys,
+                         const std::vector<ItemPointer> &locations);
+
   void Scan(const std::vector<Value> &values,
             const std::vector<oid_t> &key_column_ids,
             const std::vector<ExpressionType> &expr_types,
@@ -101,6 +107,15 @@ class BTreeIndex : public Index {
   }
 
  protected:
+  // Sorted entries of the keys and their locations, equal keys keep their
+  // order
+  std::vector<std::pair<KeyType, ValueType>> SortEntries(
+      const std::vector<const storage::Tuple *> &keys,
+      const std::vector<ItemPointer> &locations);
+
+  // Insert sorted entries, the caller holds the index lock
+  void LoadEntries(std::vector<std::pair<KeyType, ValueType>> &entries);
+
   MapType container;
 
   // equality checker and comparator
@@ -0,0 +1,1061 @@
+//===----------------------------------------------------------------------===//
+//
+//                         Peloton
+//
+// bwtree.h
+//
+// Identification: src/include/index/bwtree.h
+//
+// Copyright (c) 2015-16, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <cstdint>
+#include <utility>
+#include <vector>
+
+#include "common/exception.h"
+#include "common/logger.h"
+#include "common/macros.h"
+#include "common/platform.h"
+#include "common/thread_epoch.h"
+
+namespace peloton {
+namespace index {
+
+//===--------------------------------------------------------------------===//
+// Bw-Tree
+//===--------------------------------------------------------------------===//
+
+// BWTREE_TEMPLATE_ARGUMENTS
+#define BWTREE_TEMPLATE_ARGUMENTS                                    \
+  template <typename KeyType, typename ValueType, class KeyComparator, \
+            class ValueEqualityChecker, class ValueDeleter>
+
+// BWTREE_TYPE
+#define BWTREE_TYPE \
+  BwTree<KeyType, ValueType, KeyComparator, ValueEqualityChecker, ValueDeleter>
+
+/**
+ * Latch-free B+tree (Levandoski et al., "The Bw-Tree: A B-tree for New
+ * Hardware Platforms", ICDE 2013).
+ *
+ * Nodes are addressed through a mapping table of logical node ids, so a
+ * node is modified by prepending a delta record to its chain and swapping
+ * the mapping table entry with a single CAS. Long delta chains are
+ * consolidated into a new base page; an overflowing page is split while
+ * it is consolidated, and the index term for the new right sibling is
+ * posted to the parent by whichever thread first walks across the split
+ * (B-link style right-sibling pointers keep the tree searchable until
+ * then). Unlinked nodes are reclaimed through the ThreadEpochManager.
+ *
+ * The tree is a multimap: the same key may be stored with several values.
+ * Values are owned by the tree and handed to ValueDeleter once they are
+ * no longer reachable. Pages never merge; deleted entries are dropped on
+ * consolidation.
+ */
+BWTREE_TEMPLATE_ARGUMENTS
+class BwTree {
+ public:
+  typedef uint64_t NodeID;
+
+  typedef std::pair<KeyType, ValueType> KeyValuePair;
+
+  typedef std::pair<KeyType, NodeID> KeyNodeIDPair;
+
+  BwTree();
+
+  ~BwTree();
+
+  // Insert a <key, value> pair
+  bool Insert(const KeyType &key, const ValueType &value);
+
+  // Insert a <key, value> pair unless the predicate holds for a value that
+  // is already stored under the key
+  template <typename Predicate>
+  bool ConditionalInsert(const KeyType &key, const ValueType &value,
+                         Predicate predicate);
+
+  // Remove every value equal to the given one from the key. Ownership of
+  // the value passes to the tree only if true is returned.
+  bool Delete(const KeyType &key, const ValueType &value);
+
+  // Collect all the values stored under the key
+  void GetValue(const KeyType &key, std::vector<ValueType> &result);
+
+  // Visit the <key, value> pairs with low_key <= key <= high_key in key
+  // order. A null bound leaves that side of the range open.
+  template <typename Visitor>
+  void Scan(const KeyType *low_key, const KeyType *high_key, Visitor visitor);
+
+  // Free retired nodes that no active thread can reach anymore
+  void PerformGarbageCollection();
+
+  // Number of nodes ever allocated in the mapping table
+  size_t GetNodeCount() const { return next_node_id_.load(); }
+
+  // Bytes held by the mapping table and the live and retired nodes
+  size_t GetMemoryFootprint() const { return memory_footprint_.load(); }
+
+ private:
+  //===--------------------------------------------------------------------===//
+  // Nodes
+  //===--------------------------------------------------------------------===//
+
+  enum class NodeType : uint8_t {
+    LEAF,          // consolidated leaf page
+    INNER,         // consolidated inner page
+    LEAF_INSERT,   // <key, value> insert delta
+    LEAF_DELETE,   // <key, value> delete delta
+    INNER_INSERT   // index term for a split child
+  };
+
+  struct BaseNode {
+    // base page
+    BaseNode(NodeType type)
+        : type(type),
+          depth(0),
+          has_high_key(false),
+          high_key(),
+          right_sibling(INVALID_NODE_ID),
+          next(nullptr) {}
+
+    // delta record on top of the chain head "below"
+    BaseNode(NodeType type, BaseNode *below)
+        : type(type),
+          depth(below->depth + 1),
+          has_high_key(below->has_high_key),
+          high_key(below->high_key),
+          right_sibling(below->right_sibling),
+          next(below) {}
+
+    NodeType type;
+
+    // number of delta records above the base page
+    size_t depth;
+
+    // keys >= high_key belong to the right sibling
+    bool has_high_key;
+    KeyType high_key;
+    NodeID right_sibling;
+
+    // next record in the delta chain, nullptr for base pages
+    BaseNode *next;
+  };
+
+  struct LeafNode : public BaseNode {
+    LeafNode() : BaseNode(NodeType::LEAF) {}
+
+    // sorted by key
+    std::vector<KeyValuePair> items;
+  };
+
+  struct InnerNode : public BaseNode {
+    InnerNode() : BaseNode(NodeType::INNER) {}
+
+    // sorted by key; the key of the first (leftmost) child is never used
+    std::vector<KeyNodeIDPair> items;
+  };
+
+  struct LeafDeltaNode : public BaseNode {
+    LeafDeltaNode(NodeType type, BaseNode *below, const KeyType &key,
+                  const ValueType &value)
+        : BaseNode(type, below), key(key), value(value) {}
+
+    KeyType key;
+    ValueType value;
+  };
+
+  // Keys in [separator, next_key) are routed to child
+  struct InnerInsertNode : public BaseNode {
+    InnerInsertNode(BaseNode *below, const KeyType &separator, NodeID child,
+                    const BaseNode *child_head)
+        : BaseNode(NodeType::INNER_INSERT, below),
+          separator(separator),
+          child(child),
+          has_next_key(child_head->has_high_key),
+          next_key(child_head->high_key) {}
+
+    KeyType separator;
+    NodeID child;
+    bool has_next_key;
+    KeyType next_key;
+  };
+
+  // Retired delta chain along with the values it stopped referencing
+  struct GarbageNode {
+    uint64_t epoch;
+    BaseNode *chain;
+    std::vector<ValueType> values;
+    GarbageNode *next;
+  };
+
+  //===--------------------------------------------------------------------===//
+  // Mapping table
+  //===--------------------------------------------------------------------===//
+
+  std::atomic<BaseNode *> &GetMappingEntry(NodeID node_id);
+
+  BaseNode *GetNode(NodeID node_id) {
+    return GetMappingEntry(node_id).load();
+  }
+
+  bool InstallNode(NodeID node_id, BaseNode *expected, BaseNode *node) {
+    return GetMappingEntry(node_id).compare_exchange_strong(expected, node);
+  }
+
+  NodeID AllocateNodeID(BaseNode *node);
+
+  //===--------------------------------------------------------------------===//
+  // Traversal
+  //===--------------------------------------------------------------------===//
+
+  inline bool KeyLess(const KeyType &lhs, const KeyType &rhs) const {
+    return key_comparator_(lhs, rhs);
+  }
+
+  inline bool KeyEqual(const KeyType &lhs, const KeyType &rhs) const {
+    return !key_comparator_(lhs, rhs) && !key_comparator_(rhs, lhs);
+  }
+
+  inline bool InRange(const BaseNode *node, const KeyType &key) const {
+    return !node->has_high_key || KeyLess(key, node->high_key);
+  }
+
+  static inline bool IsLeaf(const BaseNode *node) {
+    return node->type == NodeType::LEAF ||
+           node->type == NodeType::LEAF_INSERT ||
+           node->type == NodeType::LEAF_DELETE;
+  }
+
+  NodeID FindLeaf(const KeyType *key, BaseNode *&leaf_head);
+
+  NodeID RouteInner(const BaseNode *head, const KeyType &key) const;
+
+  NodeID RouteLeftmost(const BaseNode *head) const;
+
+  void PostIndexTerm(NodeID parent_id, NodeID child_id,
+                     const BaseNode *child_head);
+
+  void CollectValues(const BaseNode *head, const KeyType &key,
+                     std::vector<ValueType> &result) const;
+
+  void CollectLeafItems(const BaseNode *head, std::vector<KeyValuePair> &items,
+                        std::vector<ValueType> *dropped_values) const;
+
+  void CollectInnerItems(const BaseNode *head,
+                         std::vector<KeyNodeIDPair> &items) const;
+
+  //===--------------------------------------------------------------------===//
+  // Structure modifications
+  //===--------------------------------------------------------------------===//
+
+  void ConsolidateNode(NodeID node_id, BaseNode *head);
+
+  template <typename PageType>
+  void InstallPage(NodeID node_id, BaseNode *head, PageType *page,
+                   std::vector<ValueType> &dropped_values, size_t max_size);
+
+  template <typename ItemType>
+  size_t FindSplitPoint(const std::vector<ItemType> &items) const;
+
+  //===--------------------------------------------------------------------===//
+  // Memory reclamation
+  //===--------------------------------------------------------------------===//
+
+  void RetireChain(BaseNode *head, std::vector<ValueType> &dropped_values);
+
+  void FreeChain(BaseNode *head, bool free_values);
+
+  void FreeNode(BaseNode *node);
+
+  // Count a node in the memory footprint once it is completely built
+  void TrackNode(const BaseNode *node) {
+    memory_footprint_ += NodeSize(node);
+  }
+
+  static size_t NodeSize(const BaseNode *node);
+
+  //===--------------------------------------------------------------------===//
+  // Data members
+  //===--------------------------------------------------------------------===//
+
+  static const NodeID INVALID_NODE_ID = UINT64_MAX;
+
+  // the root keeps its id across root splits
+  static const NodeID ROOT_NODE_ID = 0;
+
+  // pages are split when they grow beyond these sizes on consolidation
+  static const size_t LEAF_PAGE_MAX_SIZE = 128;
+  static const size_t INNER_PAGE_MAX_SIZE = 128;
+
+  // delta chains at least this long get consolidated
+  static const size_t DELTA_CHAIN_LENGTH_THRESHOLD = 8;
+
+  // retired chains that trigger a reclamation pass
+  static const size_t GC_THRESHOLD = 64;
+
+  // the mapping table grows in segments on demand
+  static const size_t MAPPING_TABLE_SEGMENT_SIZE = 1 << 12;
+  static const size_t MAPPING_TABLE_SEGMENT_COUNT = 1 << 12;
+
+  std::atomic<std::atomic<BaseNode *> *>
+      mapping_table_[MAPPING_TABLE_SEGMENT_COUNT];
+
+  std::atomic<NodeID> next_node_id_;
+
+  std::atomic<size_t> memory_footprint_;
+
+  // lock-free stack of retired chains
+  std::atomic<GarbageNode *> garbage_list_;
+  std::atomic<size_t> garbage_count_;
+  std::atomic<bool> gc_running_;
+
+  KeyComparator key_comparator_;
+  ValueEqualityChecker value_equals_;
+  ValueDeleter value_deleter_;
+};
+
+//===--------------------------------------------------------------------===//
+// Implementation
+//===--------------------------------------------------------------------===//
+
+BWTREE_TEMPLATE_ARGUMENTS
+BWTREE_TYPE::BwTree()
+    : next_node_id_(0),
+      memory_footprint_(0),
+      garbage_list_(nullptr),
+      garbage_count_(0),
+      gc_running_(false),
+      key_comparator_(),
+      value_equals_(),
+      value_deleter_() {
+  for (size_t segment_itr = 0; segment_itr < MAPPING_TABLE_SEGMENT_COUNT;
+       segment_itr++) {
+    mapping_table_[segment_itr].store(nullptr);
+  }
+
+  // the tree starts out as a single empty leaf
+  auto root = new LeafNode();
+  TrackNode(root);
+  auto root_id = AllocateNodeID(root);
+  PL_ASSERT(root_id == ROOT_NODE_ID);
+  (void)root_id;
+}
+
+BWTREE_TEMPLATE_ARGUMENTS
+BWTREE_TYPE::~BwTree() {
+  // live chains own every value they reference
+  auto node_count = next_node_id_.load();
+  for (NodeID node_id = 0; node_id < node_count; node_id++) {
+    auto segment =
+        mapping_table_[node_id / MAPPING_TABLE_SEGMENT_SIZE].load();
+    if (segment == nullptr) {
+      continue;
+    }
+
+    auto head = segment[node_id % MAPPING_TABLE_SEGMENT_SIZE].load();
+    if (head != nullptr) {
+      FreeChain(head, true);
+    }
+  }
+
+  // nobody can reach retired chains anymore
+  auto garbage = garbage_list_.exchange(nullptr);
+  while (garbage != nullptr) {
+    auto next = garbage->next;
+    FreeChain(garbage->chain, false);
+    for (auto value : garbage->values) {
+      value_deleter_(value);
+    }
+    delete garbage;
+    garbage = next;
+  }
+
+  for (size_t segment_itr = 0; segment_itr < MAPPING_TABLE_SEGMENT_COUNT;
+       segment_itr++) {
+    delete[] mapping_table_[segment_itr].load();
+  }
+}
+
+BWTREE_TEMPLATE_ARGUMENTS
+std::atomic<typename BWTREE_TYPE::BaseNode *> &BWTREE_TYPE::GetMappingEntry(
+    NodeID node_id) {
+  auto &segment_ptr = mapping_table_[node_id / MAPPING_TABLE_SEGMENT_SIZE];
+  auto segment = segment_ptr.load();
+
+  if (segment == nullptr) {
+    auto new_segment = new std::atomic<BaseNode *>[MAPPING_TABLE_SEGMENT_SIZE];
+    for (size_t entry_itr = 0; entry_itr < MAPPING_TABLE_SEGMENT_SIZE;
+         entry_itr++) {
+      new_segment[entry_itr].store(nullptr);
+    }
+
+    // somebody else might have installed the segment concurrently
+    if (segment_ptr.compare_exchange_strong(segment, new_segment)) {
+      segment = new_segment;
+      memory_footprint_ +=
+          sizeof(std::atomic<BaseNode *>) * MAPPING_TABLE_SEGMENT_SIZE;
+    } else {
+      delete[] new_segment;
+    }
+  }
+
+  return segment[node_id % MAPPING_TABLE_SEGMENT_SIZE];
+}
+
+BWTREE_TEMPLATE_ARGUMENTS
+typename BWTREE_TYPE::NodeID BWTREE_TYPE::AllocateNodeID(BaseNode *node) {
+  auto node_id = next_node_id_++;
+  if (node_id >= MAPPING_TABLE_SEGMENT_SIZE * MAPPING_TABLE_SEGMENT_COUNT) {
+    throw IndexException("Bw-Tree mapping table is full");
+  }
+
+  GetMappingEntry(node_id).store(node);
+  return node_id;
+}
+
+//===--------------------------------------------------------------------===//
+// Operations
+//===--------------------------------------------------------------------===//
+
+BWTREE_TEMPLATE_ARGUMENTS
+bool BWTREE_TYPE::Insert(const KeyType &key, const ValueType &value) {
+  ThreadEpochGuard epoch_guard;
+
+  while (true) {
+    BaseNode *head = nullptr;
+    auto leaf_id = FindLeaf(&key, head);
+
+    auto delta = new LeafDeltaNode(NodeType::LEAF_INSERT, head, key, value);
+    TrackNode(delta);
+    if (InstallNode(leaf_id, head, delta)) {
+      if (delta->depth >= DELTA_CHAIN_LENGTH_THRESHOLD) {
+        ConsolidateNode(leaf_id, delta);
+      }
+      return true;
+    }
+
+    // lost the race against another update, start over
+    FreeNode(delta);
+  }
+}
+
+BWTREE_TEMPLATE_ARGUMENTS
+template <typename Predicate>
+bool BWTREE_TYPE::ConditionalInsert(const KeyType &key, const ValueType &value,
+                                    Predicate predicate) {
+  ThreadEpochGuard epoch_guard;
+  std::vector<ValueType> existing_values;
+
+  while (true) {
+    BaseNode *head = nullptr;
+    auto leaf_id = FindLeaf(&key, head);
+
+    // the CAS below fails if the chain changed after this check
+    existing_values.clear();
+    CollectValues(head, key, existing_values);
+    for (auto &existing_value : existing_values) {
+      if (predicate(existing_value)) {
+        return false;
+      }
+    }
+
+    auto delta = new LeafDeltaNode(NodeType::LEAF_INSERT, head, key, value);
+    TrackNode(delta);
+    if (InstallNode(leaf_id, head, delta)) {
+      if (delta->depth >= DELTA_CHAIN_LENGTH_THRESHOLD) {
+        ConsolidateNode(leaf_id, delta);
+      }
+      return true;
+    }
+
+    FreeNode(delta);
+  }
+}
+
+BWTREE_TEMPLATE_ARGUMENTS
+bool BWTREE_TYPE::Delete(const KeyType &key, const ValueType &value) {
+  ThreadEpochGuard epoch_guard;
+  std::vector<ValueType> existing_values;
+
+  while (true) {
+    BaseNode *head = nullptr;
+    auto leaf_id = FindLeaf(&key, head);
+
+    existing_values.clear();
+    CollectValues(head, key, existing_values);
+    bool found = false;
+    for (auto &existing_value : existing_values) {
+      if (value_equals_(existing_value, value)) {
+        found = true;
+        break;
+      }
+    }
+
+    if (found == false) {
+      return false;
+    }
+
+    auto delta = new LeafDeltaNode(NodeType::LEAF_DELETE, head, key, value);
+    TrackNode(delta);
+    if (InstallNode(leaf_id, head, delta)) {
+      if (delta->depth >= DELTA_CHAIN_LENGTH_THRESHOLD) {
+        ConsolidateNode(leaf_id, delta);
+      }
+      return true;
+    }
+
+    FreeNode(delta);
+  }
+}
+
+BWTREE_TEMPLATE_ARGUMENTS
+void BWTREE_TYPE::GetValue(const KeyType &key,
+                           std::vector<ValueType> &result) {
+  ThreadEpochGuard epoch_guard;
+
+  BaseNode *head = nullptr;
+  FindLeaf(&key, head);
+  CollectValues(head, key, result);
+}
+
+BWTREE_TEMPLATE_ARGUMENTS
+template <typename Visitor>
+void BWTREE_TYPE::Scan(const KeyType *low_key, const KeyType *high_key,
+                       Visitor visitor) {
+  ThreadEpochGuard epoch_guard;
+  std::vector<KeyValuePair> items;
+
+  BaseNode *head = nullptr;
+  FindLeaf(low_key, head);
+
+  // walk the leaf level along the right sibling pointers
+  while (true) {
+    items.clear();
+    CollectLeafItems(head, items, nullptr);
+
+    for (auto &item : items) {
+      if (low_key != nullptr && KeyLess(item.first, *low_key)) {
+        continue;
+      }
+      if (high_key != nullptr && KeyLess(*high_key, item.first)) {
+        return;
+      }
+      visitor(item.first, item.second);
+    }
+
+    if (head->has_high_key == false) {
+      return;
+    }
+    if (high_key != nullptr && KeyLess(*high_key, head->high_key)) {
+      return;
+    }
+
+    head = GetNode(head->right_sibling);
+  }
+}
+
+//===--------------------------------------------------------------------===//
+// Traversal
+//===--------------------------------------------------------------------===//
+
+/**
+ * @brief Descend from the root to the leaf covering the key, or to the
+ * leftmost leaf if key is null. Long delta chains met on the way are
+ * consolidated and splits not yet reflected in the parent are posted.
+ */
+BWTREE_TEMPLATE_ARGUMENTS
+typename BWTREE_TYPE::NodeID BWTREE_TYPE::FindLeaf(const KeyType *key,
+                                                   BaseNode *&leaf_head) {
+  NodeID parent_id = INVALID_NODE_ID;
+  NodeID node_id = ROOT_NODE_ID;
+
+  while (true) {
+    auto head = GetNode(node_id);
+
+    if (head->depth >= DELTA_CHAIN_LENGTH_THRESHOLD) {
+      ConsolidateNode(node_id, head);
+      continue;
+    }
+
+    // the node split, keep looking in the right sibling
+    if (key != nullptr && InRange(head, *key) == false) {
+      if (parent_id != INVALID_NODE_ID) {
+        PostIndexTerm(parent_id, node_id, head);
+      }
+      node_id = head->right_sibling;
+      continue;
+    }
+
+    if (IsLeaf(head)) {
+      leaf_head = head;
+      return node_id;
+    }
+
+    parent_id = node_id;
+    node_id = (key != nullptr) ? RouteInner(head, *key) : RouteLeftmost(head);
+  }
+}
+
+BWTREE_TEMPLATE_ARGUMENTS
+typename BWTREE_TYPE::NodeID BWTREE_TYPE::RouteInner(
+    const BaseNode *head, const KeyType &key) const {
+  auto node = head;
+
+  // newer index terms take precedence
+  while (node->type == NodeType::INNER_INSERT) {
+    auto delta = static_cast<const InnerInsertNode *>(node);
+    if (KeyLess(key, delta->separator) == false &&
+        (delta->has_next_key == false || KeyLess(key, delta->next_key))) {
+      return delta->child;
+    }
+    node = node->next;
+  }
+
+  PL_ASSERT(node->type == NodeType::INNER);
+  auto &items = static_cast<const InnerNode *>(node)->items;
+
+  // last child whose separator is not greater than the key
+  auto itr = std::upper_bound(
+      items.begin() + 1, items.end(), key,
+      [this](const KeyType &lhs, const KeyNodeIDPair &rhs) {
+        return KeyLess(lhs, rhs.first);
+      });
+
+  return (itr - 1)->second;
+}
+
+BWTREE_TEMPLATE_ARGUMENTS
+typename BWTREE_TYPE::NodeID BWTREE_TYPE::RouteLeftmost(
+    const BaseNode *head) const {
+  // index terms never cover the leftmost child
+  auto node = head;
+  while (node->type != NodeType::INNER) {
+    node = node->next;
+  }
+
+  return static_cast<const InnerNode *>(node)->items.front().second;
+}
+
+/**
+ * @brief Post the index term for the right sibling of a split child to
+ * the parent, unless the parent no longer routes the split key to the
+ * child (the term is already there, or the parent itself changed).
+ */
+BWTREE_TEMPLATE_ARGUMENTS
+void BWTREE_TYPE::PostIndexTerm(NodeID parent_id, NodeID child_id,
+                                const BaseNode *child_head) {
+  const KeyType &separator = child_head->high_key;
+  auto sibling_id = child_head->right_sibling;
+  auto sibling_head = GetNode(sibling_id);
+
+  while (true) {
+    auto parent_head = GetNode(parent_id);
+
+    if (InRange(parent_head, separator) == false ||
+        RouteInner(parent_head, separator) != child_id) {
+      return;
+    }
+
+    auto delta =
+        new InnerInsertNode(parent_head, separator, sibling_id, sibling_head);
+    TrackNode(delta);
+    if (InstallNode(parent_id, parent_head, delta)) {
+      return;
+    }
+
+    FreeNode(delta);
+  }
+}
+
+BWTREE_TEMPLATE_ARGUMENTS
+void BWTREE_TYPE::CollectValues(const BaseNode *head, const KeyType &key,
+                                std::vector<ValueType> &result) const {
+  std::vector<ValueType> deleted_values;
+
+  auto is_deleted = [this, &deleted_values](const ValueType &value) {
+    for (auto &deleted_value : deleted_values) {
+      if (value_equals_(deleted_value, value)) {
+        return true;
+      }
+    }
+    return false;
+  };
+
+  // a delete record hides the older inserts of the same value
+  auto node = head;
+  for (; node->type != NodeType::LEAF; node = node->next) {
+    auto delta = static_cast<const LeafDeltaNode *>(node);
+    if (KeyEqual(delta->key, key) == false) {
+      continue;
+    }
+
+    if (delta->type == NodeType::LEAF_DELETE) {
+      deleted_values.push_back(delta->value);
+    } else if (is_deleted(delta->value) == false) {
+      result.push_back(delta->value);
+    }
+  }
+
+  auto &items = static_cast<const LeafNode *>(node)->items;
+  auto itr = std::lower_bound(
+      items.begin(), items.end(), key,
+      [this](const KeyValuePair &lhs, const KeyType &rhs) {
+        return KeyLess(lhs.first, rhs);
+      });
+
+  for (; itr != items.end() && KeyLess(key, itr->first) == false; ++itr) {
+    if (is_deleted(itr->second) == false) {
+      result.push_back(itr->second);
+    }
+  }
+}
+
+/**
+ * @brief Materialize the logical content of a leaf chain. Values that the
+ * chain no longer references are appended to dropped_values if given.
+ */
+BWTREE_TEMPLATE_ARGUMENTS
+void BWTREE_TYPE::CollectLeafItems(
+    const BaseNode *head, std::vector<KeyValuePair> &items,
+    std::vector<ValueType> *dropped_values) const {
+  std::vector<const LeafDeltaNode *> deltas;
+
+  auto node = head;
+  for (; node->type != NodeType::LEAF; node = node->next) {
+    deltas.push_back(static_cast<const LeafDeltaNode *>(node));
+  }
+
+  items = static_cast<const LeafNode *>(node)->items;
+
+  // replay the delta records from the oldest to the newest
+  for (auto delta_itr = deltas.rbegin(); delta_itr != deltas.rend();
+       ++delta_itr) {
+    auto delta = *delta_itr;
+
+    auto upper = std::upper_bound(
+        items.begin(), items.end(), delta->key,
+        [this](const KeyType &lhs, const KeyValuePair &rhs) {
+          return KeyLess(lhs, rhs.first);
+        });
+
+    if (delta->type == NodeType::LEAF_INSERT) {
+      items.insert(upper, KeyValuePair(delta->key, delta->value));
+      continue;
+    }
+
+    auto lower = std::lower_bound(
+        items.begin(), upper, delta->key,
+        [this](const KeyValuePair &lhs, const KeyType &rhs) {
+          return KeyLess(lhs.first, rhs);
+        });
+
+    auto keep = lower;
+    for (auto itr = lower; itr != upper; ++itr) {
+      if (value_equals_(itr->second, delta->value)) {
+        if (dropped_values != nullptr) {
+          dropped_values->push_back(itr->second);
+        }
+      } else {
+        *keep++ = *itr;
+      }
+    }
+    items.erase(keep, upper);
+
+    if (dropped_values != nullptr) {
+      dropped_values->push_back(delta->value);
+    }
+  }
+}
+
+BWTREE_TEMPLATE_ARGUMENTS
+void BWTREE_TYPE::CollectInnerItems(const BaseNode *head,
+                                    std::vector<KeyNodeIDPair> &items) const {
+  std::vector<const InnerInsertNode *> deltas;
+
+  auto node = head;
+  for (; node->type != NodeType::INNER; node = node->next) {
+    deltas.push_back(static_cast<const InnerInsertNode *>(node));
+  }
+
+  items = static_cast<const InnerNode *>(node)->items;
+
+  for (auto delta_itr = deltas.rbegin(); delta_itr != deltas.rend();
+       ++delta_itr) {
+    auto delta = *delta_itr;
+    auto upper = std::upper_bound(
+        items.begin() + 1, items.end(), delta->separator,
+        [this](const KeyType &lhs, const KeyNodeIDPair &rhs) {
+          return KeyLess(lhs, rhs.first);
+        });
+    items.insert(upper, KeyNodeIDPair(delta->separator, delta->child));
+  }
+}
+
+//===--------------------------------------------------------------------===//
+// Structure modifications
+//===--------------------------------------------------------------------===//
+
+BWTREE_TEMPLATE_ARGUMENTS
+void BWTREE_TYPE::ConsolidateNode(NodeID node_id, BaseNode *head) {
+  std::vector<ValueType> dropped_values;
+
+  if (IsLeaf(head)) {
+    auto page = new LeafNode();
+    CollectLeafItems(head, page->items, &dropped_values);
+    InstallPage(node_id, head, page, dropped_values, LEAF_PAGE_MAX_SIZE);
+  } else {
+    auto page = new InnerNode();
+    CollectInnerItems(head, page->items);
+    InstallPage(node_id, head, page, dropped_values, INNER_PAGE_MAX_SIZE);
+  }
+}
+
+/**
+ * @brief Replace the chain starting at head with the consolidated page,
+ * splitting the page first if it grew too large. The split is installed
+ * by the same CAS, so it is atomic with the consolidation.
+ */
+BWTREE_TEMPLATE_ARGUMENTS
+template <typename PageType>
+void BWTREE_TYPE::InstallPage(NodeID node_id, BaseNode *head, PageType *page,
+                              std::vector<ValueType> &dropped_values,
+                              size_t max_size) {
+  page->has_high_key = head->has_high_key;
+  page->high_key = head->high_key;
+  page->right_sibling = head->right_sibling;
+
+  size_t split_point = 0;
+  if (page->items.size() > max_size) {
+    split_point = FindSplitPoint(page->items);
+  }
+
+  // Plain consolidation
+  if (split_point == 0) {
+    TrackNode(page);
+    if (InstallNode(node_id, head, page)) {
+      RetireChain(head, dropped_values);
+    } else {
+      FreeNode(page);
+    }
+    return;
+  }
+
+  auto sibling = new PageType();
+  sibling->items.assign(page->items.begin() + split_point, page->items.end());
+  sibling->has_high_key = page->has_high_key;
+  sibling->high_key = page->high_key;
+  sibling->right_sibling = page->right_sibling;
+  page->items.resize(split_point);
+  TrackNode(sibling);
+  TrackNode(page);
+
+  auto sibling_id = AllocateNodeID(sibling);
+  page->has_high_key = true;
+  page->high_key = sibling->items.front().first;
+  page->right_sibling = sibling_id;
+
+  // Non-root split : the left half keeps the node id
+  if (node_id != ROOT_NODE_ID) {
+    if (InstallNode(node_id, head, page)) {
+      RetireChain(head, dropped_values);
+    } else {
+      GetMappingEntry(sibling_id).store(nullptr);
+      FreeNode(sibling);
+      FreeNode(page);
+    }
+    return;
+  }
+
+  // Root split : both halves move to new nodes under a new root page
+  auto page_id = AllocateNodeID(page);
+  auto root = new InnerNode();
+  root->items.emplace_back(page->high_key, page_id);
+  root->items.emplace_back(page->high_key, sibling_id);
+  TrackNode(root);
+
+  if (InstallNode(ROOT_NODE_ID, head, root)) {
+    RetireChain(head, dropped_values);
+  } else {
+    GetMappingEntry(page_id).store(nullptr);
+    GetMappingEntry(sibling_id).store(nullptr);
+    FreeNode(sibling);
+    FreeNode(page);
+    FreeNode(root);
+  }
+}
+
+/**
+ * @brief Pick a split point near the middle that does not separate equal
+ * keys. Returns zero if the page cannot be split.
+ */
+BWTREE_TEMPLATE_ARGUMENTS
+template <typename ItemType>
+size_t BWTREE_TYPE::FindSplitPoint(const std::vector<ItemType> &items) const {
+  auto item_count = items.size();
+  auto split_point = item_count / 2;
+
+  while (split_point < item_count &&
+         KeyEqual(items[split_point - 1].first, items[split_point].first)) {
+    split_point++;
+  }
+
+  if (split_point < item_count) {
+    return split_point;
+  }
+
+  split_point = item_count / 2;
+  while (split_point > 0 &&
+         KeyEqual(items[split_point - 1].first, items[split_point].first)) {
+    split_point--;
+  }
+
+  return split_point;
+}
+
+//===--------------------------------------------------------------------===//
+// Memory reclamation
+//===--------------------------------------------------------------------===//
+
+BWTREE_TEMPLATE_ARGUMENTS
+void BWTREE_TYPE::RetireChain(BaseNode *head,
+                              std::vector<ValueType> &dropped_values) {
+  auto &epoch_manager = ThreadEpochManager::GetInstance();
+
+  auto garbage = new GarbageNode();
+  garbage->epoch = epoch_manager.GetCurrentEpoch();
+  garbage->chain = head;
+  garbage->values.swap(dropped_values);
+  garbage->next = garbage_list_.load();
+
+  while (garbage_list_.compare_exchange_weak(garbage->next, garbage) == false)
+    ;
+
+  if (++garbage_count_ >= GC_THRESHOLD) {
+    PerformGarbageCollection();
+  }
+}
+
+BWTREE_TEMPLATE_ARGUMENTS
+void BWTREE_TYPE::PerformGarbageCollection() {
+  // one reclaimer at a time
+  if (gc_running_.exchange(true) == true) {
+    return;
+  }
+
+  auto &epoch_manager = ThreadEpochManager::GetInstance();
+  epoch_manager.AdvanceEpoch();
+  auto min_active_epoch = epoch_manager.GetMinActiveEpoch();
+
+  GarbageNode *survivors = nullptr;
+  GarbageNode *survivors_tail = nullptr;
+  size_t freed_count = 0;
+
+  auto garbage = garbage_list_.exchange(nullptr);
+  while (garbage != nullptr) {
+    auto next = garbage->next;
+
+    if (garbage->epoch < min_active_epoch) {
+      FreeChain(garbage->chain, false);
+      for (auto value : garbage->values) {
+        value_deleter_(value);
+      }
+      delete garbage;
+      freed_count++;
+    } else {
+      garbage->next = survivors;
+      survivors = garbage;
+      if (survivors_tail == nullptr) {
+        survivors_tail = garbage;
+      }
+    }
+
+    garbage = next;
+  }
+
+  // put back whatever is still reachable
+  if (survivors != nullptr) {
+    survivors_tail->next = garbage_list_.load();
+    while (garbage_list_.compare_exchange_weak(survivors_tail->next,
+                                               survivors) == false)
+      ;
+  }
+
+  garbage_count_ -= freed_count;
+  LOG_TRACE("Bw-Tree reclaimed %lu chains", freed_count);
+
+  gc_running_.store(false);
+}
+
+BWTREE_TEMPLATE_ARGUMENTS
+void BWTREE_TYPE::FreeChain(BaseNode *head, bool free_values) {
+  auto node = head;
+
+  while (node != nullptr) {
+    auto next = node->next;
+
+    if (free_values == true) {
+      if (node->type == NodeType::LEAF) {
+        for (auto &item : static_cast<LeafNode *>(node)->items) {
+          value_deleter_(item.second);
+        }
+      } else if (node->type == NodeType::LEAF_INSERT ||
+                 node->type == NodeType::LEAF_DELETE) {
+        value_deleter_(static_cast<LeafDeltaNode *>(node)->value);
+      }
+    }
+
+    FreeNode(node);
+    node = next;
+  }
+}
+
+BWTREE_TEMPLATE_ARGUMENTS
+size_t BWTREE_TYPE::NodeSize(const BaseNode *node) {
+  switch (node->type) {
+    case NodeType::LEAF:
+      return sizeof(LeafNode) +
+             static_cast<const LeafNode *>(node)->items.capacity() *
+                 sizeof(KeyValuePair);
+    case NodeType::INNER:
+      return sizeof(InnerNode) +
+             static_cast<const InnerNode *>(node)->items.capacity() *
+                 sizeof(KeyNodeIDPair);
+    case NodeType::LEAF_INSERT:
+    case NodeType::LEAF_DELETE:
+      return sizeof(LeafDeltaNode);
+    case NodeType::INNER_INSERT:
+      return sizeof(InnerInsertNode);
+  }
+  return 0;
+}
+
+BWTREE_TEMPLATE_ARGUMENTS
+void BWTREE_TYPE::FreeNode(BaseNode *node) {
+  memory_footprint_ -= NodeSize(node);
+
+  switch (node->type) {
+    case NodeType::LEAF:
+      delete static_cast<LeafNode *>(node);
+      break;
+    case NodeType::INNER:
+      delete static_cast<InnerNode *>(node);
+      break;
+    case NodeType::LEAF_INSERT:
+    case NodeType::LEAF_DELETE:
+      delete static_cast<LeafDeltaNode *>(node);
+      break;
+    case NodeType::INNER_INSERT:
+      delete static_cast<InnerInsertNode *>(node);
+      break;
+  }
+}
+
+}  // End index namespace
+}  // End peloton namespace
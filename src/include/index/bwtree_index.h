@@ -0,0 +1,140 @@
+//===----------------------------------------------------------------------===//
+//
+//                         Peloton
+//
+// bwtree_index.h
+//
+// Identification: src/include/index/bwtree_index.h
+//
+// Copyright (c) 2015-16, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+
+#pragma once
+
+#include <vector>
+#include <map>
+#include <string>
+
+#include "catalog/manager.h"
+#include "common/types.h"
+#include "index/index.h"
+
+#include "index/bwtree.h"
+
+namespace peloton {
+namespace index {
+
+// Index values compare by the location they point to
+struct ItemPointerEqualityChecker {
+  inline bool operator()(const ItemPointer *lhs, const ItemPointer *rhs) const {
+    return (lhs->block == rhs->block) && (lhs->offset == rhs->offset);
+  }
+};
+
+// Index values are heap-allocated and owned by the index
+struct ItemPointerDeleter {
+  inline void operator()(ItemPointer *item_pointer) const {
+    delete item_pointer;
+  }
+};
+
+/**
+ * Latch-free Bw-Tree based index
+ *
+ * @see Index
+ * @see BwTree
+ */
+template <typename KeyType, typename ValueType, class KeyComparator,
+          class KeyEqualityChecker>
+class BWTreeIndex : public Index {
+  friend class IndexFactory;
+
+  // Define the container type
+  typedef BwTree<KeyType, ValueType, KeyComparator, ItemPointerEqualityChecker,
+                 ItemPointerDeleter> MapType;
+
+ public:
+  BWTreeIndex(IndexMetadata *metadata);
+
+  ~BWTreeIndex();
+
+  bool InsertEntry(const storage::Tuple *key, const ItemPointer &location);
+
+  bool DeleteEntry(const storage::Tuple *key, const ItemPointer &location);
+
+  bool CondInsertEntry(const storage::Tuple *key, const ItemPointer &location,
+                       std::function<bool(const ItemPointer &)> predicate);
+
+  void Scan(const std::vector<Value> &values,
+            const std::vector<oid_t> &key_column_ids,
+            const std::vector<ExpressionType> &expr_types,
+            const ScanDirectionType &scan_direction,
+            std::vector<ItemPointer> &);
+
+  void ScanAllKeys(std::vector<ItemPointer> &);
+
+  void ScanKey(const storage::Tuple *key, std::vector<ItemPointer> &);
+
+  void Scan(const std::vector<Value> &values,
+            const std::vector<oid_t> &key_column_ids,
+            const std::vector<ExpressionType> &exprs,
+            const ScanDirectionType &scan_direction,
+            std::vector<ItemPointer *> &result);
+
+  void ScanAllKeys(std::vector<ItemPointer *> &result);
+
+  void ScanKey(const storage::Tuple *key, std::vector<ItemPointer *> &result);
+
+  std::string GetTypeName() const;
+
+  bool Cleanup() {
+    container.PerformGarbageCollection();
+    return true;
+  }
+
+  size_t GetMemoryFootprint() { return container.GetMemoryFootprint(); }
+
+  void ConstructIntervals(oid_t leading_column_id,
+                          const std::vector<Value> &values,
+                          const std::vector<oid_t> &key_column_ids,
+                          const std::vector<ExpressionType> &expr_types,
+                          std::vector<std::pair<Value, Value>> &intervals);
+
+  void FindMaxMinInColumns(
+      oid_t leading_column_id, const std::vector<Value> &values,
+      const std::vector<oid_t> &key_column_ids,
+      const std::vector<ExpressionType> &expr_types,
+      std::map<oid_t, std::pair<Value, Value>> &non_leading_columns);
+
+  // Get the indexed tile group offset
+  virtual int GetIndexedTileGroupOff() {
+    return indexed_tile_group_offset_.load();
+  }
+
+  virtual void IncrementIndexedTileGroupOffset() {
+    indexed_tile_group_offset_++;
+    return;
+  }
+
+ protected:
+  // Shared by both Scan flavors, result_adder appends one matching entry
+  template <typename ResultAdder>
+  void ScanHelper(const std::vector<Value> &values,
+                  const std::vector<oid_t> &key_column_ids,
+                  const std::vector<ExpressionType> &expr_types,
+                  const ScanDirectionType &scan_direction,
+                  ResultAdder result_adder);
+
+  MapType container;
+
+  // equality checker and comparator
+  KeyEqualityChecker equals;
+  KeyComparator comparator;
+
+  std::atomic<int> indexed_tile_group_offset_;
+};
+
+}  // End index namespace
+}  // End peloton namespace
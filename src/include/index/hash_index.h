@@ -0,0 +1,120 @@
+//===----------------------------------------------------------------------===//
+//
+//                         Peloton
+//
+// hash_index.h
+//
+// Identification: src/include/index/hash_index.h
+//
+// Copyright (c) 2015-16, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+
+#pragma once
+
+#include <vector>
+#include <string>
+
+#include "catalog/manager.h"
+#include "common/types.h"
+#include "index/index.h"
+
+#include "libcuckoo/cuckoohash_map.hh"
+
+namespace peloton {
+namespace index {
+
+/**
+ * Concurrent hash index (libcuckoo)
+ *
+ * Only supports point lookups on the full key. Every key maps to the list
+ * of locations stored under it, so non-unique keys are supported as well.
+ * Scans that are not an equality match on all key columns walk every entry
+ * and filter the keys, SupportsScan() reports them so the caller can pick
+ * another index.
+ *
+ * @see Index
+ */
+template <typename KeyType, typename ValueType, class KeyHasher,
+          class KeyEqualityChecker>
+class HashIndex : public Index {
+  friend class IndexFactory;
+
+  // Define the container type
+  typedef std::vector<ValueType> ValueList;
+  typedef cuckoohash_map<KeyType, ValueList, KeyHasher, KeyEqualityChecker>
+      MapType;
+
+ public:
+  HashIndex(IndexMetadata *metadata);
+
+  ~HashIndex();
+
+  bool InsertEntry(const storage::Tuple *key, const ItemPointer &location);
+
+  bool DeleteEntry(const storage::Tuple *key, const ItemPointer &location);
+
+  bool CondInsertEntry(const storage::Tuple *key, const ItemPointer &location,
+                       std::function<bool(const ItemPointer &)> predicate);
+
+  void Scan(const std::vector<Value> &values,
+            const std::vector<oid_t> &key_column_ids,
+            const std::vector<ExpressionType> &expr_types,
+            const ScanDirectionType &scan_direction,
+            std::vector<ItemPointer> &);
+
+  void ScanAllKeys(std::vector<ItemPointer> &);
+
+  void ScanKey(const storage::Tuple *key, std::vector<ItemPointer> &);
+
+  bool SupportsScan(const std::vector<oid_t> &key_column_ids,
+                    const std::vector<ExpressionType> &expr_types) const;
+
+  void Scan(const std::vector<Value> &values,
+            const std::vector<oid_t> &key_column_ids,
+            const std::vector<ExpressionType> &exprs,
+            const ScanDirectionType &scan_direction,
+            std::vector<ItemPointer *> &result);
+
+  void ScanAllKeys(std::vector<ItemPointer *> &result);
+
+  void ScanKey(const storage::Tuple *key, std::vector<ItemPointer *> &result);
+
+  std::string GetTypeName() const;
+
+  bool Cleanup() { return true; }
+
+  size_t GetMemoryFootprint();
+
+  // Get the indexed tile group offset
+  virtual int GetIndexedTileGroupOff() {
+    return indexed_tile_group_offset_.load();
+  }
+
+  virtual void IncrementIndexedTileGroupOffset() {
+    indexed_tile_group_offset_++;
+    return;
+  }
+
+ protected:
+  // Build the lookup key for an equality scan on every key column
+  std::unique_ptr<storage::Tuple> GetScanKey(
+      const std::vector<Value> &values,
+      const std::vector<oid_t> &key_column_ids,
+      const std::vector<ExpressionType> &expr_types);
+
+  // Walk every entry and pass the locations of the keys matching the
+  // predicates to the callback, for scans that are not a lookup
+  void ScanMatchingKeys(const std::vector<Value> &values,
+                        const std::vector<oid_t> &key_column_ids,
+                        const std::vector<ExpressionType> &expr_types,
+                        std::function<void(const ValueList &)> callback);
+
+  MapType container;
+
+  std::atomic<int> indexed_tile_group_offset_;
+};
+
+}  // End index namespace
+}  // End peloton namespace
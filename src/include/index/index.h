@@ -18,6 +18,7 @@
 #include <functional>
 #include <memory>
 
+#include "common/macros.h"
 #include "common/printable.h"
 #include "common/types.h"
 
@@ -93,6 +94,54 @@ class IndexMetadata {
   bool unique_keys;
 };
 
+//===--------------------------------------------------------------------===//
+// IndexValue
+//===--------------------------------------------------------------------===//
+
+/**
+ * Access to the location stored as the value of an index entry.
+ *
+ * An indirect value is a separately allocated ItemPointer. Its address does
+ * not change when the container moves entries around, so MVCC can use it as
+ * the head of the version chain and swap it in place.
+ * An inline value is the ItemPointer itself, which saves an allocation and a
+ * dereference per entry but gives no stable address.
+ */
+template <typename ValueType>
+struct IndexValue;
+
+template <>
+struct IndexValue<ItemPointer *> {
+  static const bool is_inline = false;
+
+  static ItemPointer *Create(const ItemPointer &location) {
+    return new ItemPointer(location);
+  }
+
+  static const ItemPointer &Get(const ItemPointer *value) { return *value; }
+
+  static ItemPointer *GetPointer(ItemPointer *value) { return value; }
+
+  static void Release(ItemPointer *&value) {
+    delete value;
+    value = nullptr;
+  }
+};
+
+template <>
+struct IndexValue<ItemPointer> {
+  static const bool is_inline = true;
+
+  static ItemPointer Create(const ItemPointer &location) { return location; }
+
+  static const ItemPointer &Get(const ItemPointer &value) { return value; }
+
+  // only valid as long as the container does not move the entry
+  static ItemPointer *GetPointer(ItemPointer &value) { return &value; }
+
+  static void Release(ItemPointer &) {}
+};
+
 //===--------------------------------------------------------------------===//
 // Index
 //===--------------------------------------------------------------------===//
@@ -133,6 +182,19 @@ class Index : public Printable {
       const storage::Tuple *key, const ItemPointer &location,
       std::function<bool(const ItemPointer &)> predicate) = 0;
 
+  // insert the index entries linked to the given tuples, used to build an
+  // index from scratch. Indexes that can load sorted entries in bulk
+  // override it, the default inserts the entries one at a time.
+  virtual void InsertEntries(const std::vector<const storage::Tuple *> &keys,
+                             const std::vector<ItemPointer> &locations);
+
+  // insert the index entries like InsertEntries, unless a key is repeated
+  // among them or already in the index. In that case nothing is inserted and
+  // false is returned. Used to load primary/unique indexes in bulk.
+  virtual bool CondInsertEntries(
+      const std::vector<const storage::Tuple *> &keys,
+      const std::vector<ItemPointer> &locations);
+
   //===--------------------------------------------------------------------===//
   // Accessors
   //===--------------------------------------------------------------------===//
@@ -148,6 +210,14 @@ class Index : public Printable {
   // scan the entire index, working like a sort
   virtual void ScanAllKeys(std::vector<ItemPointer> &) = 0;
 
+  // whether a scan with these predicates is served by a lookup instead of
+  // a walk over every entry, so the plan can prefer another index
+  virtual bool SupportsScan(
+      UNUSED_ATTRIBUTE const std::vector<oid_t> &key_column_ids,
+      UNUSED_ATTRIBUTE const std::vector<ExpressionType> &expr_types) const {
+    return true;
+  }
+
   virtual void ScanKey(const storage::Tuple *key,
                        std::vector<ItemPointer> &) = 0;
 
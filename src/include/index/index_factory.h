@@ -26,6 +26,16 @@ class IndexFactory {
  public:
   // Get an index with required attributes
   static Index *GetInstance(IndexMetadata *metadata);
+
+  static void Configure(IndexStorageType index_storage_type) {
+    index_storage_type_ = index_storage_type;
+  }
+
+  static IndexStorageType GetIndexStorageType() { return index_storage_type_; }
+
+ private:
+  // storage of the locations in B+tree and skip list indexes
+  static IndexStorageType index_storage_type_;
 };
 
 }  // End index namespace
@@ -0,0 +1,127 @@
+//===----------------------------------------------------------------------===//
+//
+//                         Peloton
+//
+// streaming_checkpoint.h
+//
+// Identification: src/include/logging/checkpoint/streaming_checkpoint.h
+//
+// Copyright (c) 2015-16, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+
+#pragma once
+
+#include <atomic>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+#include "common/serializer.h"
+#include "logging/checkpoint.h"
+
+// Maximum number of data files of a checkpoint, which is also the number of
+// threads writing and recovering it
+#define STREAMING_CHECKPOINT_MAX_FILE_COUNT 8
+
+namespace peloton {
+
+namespace storage {
+class TileGroup;
+}
+
+namespace logging {
+
+//===--------------------------------------------------------------------===//
+// Streaming Checkpoint
+//===--------------------------------------------------------------------===//
+
+/**
+ * @brief Checkpoint that streams tile groups in their in-memory layout.
+ *
+ * Every visible tile group is written as one block holding its column map,
+ * the slots of the tuples visible to the checkpoint, the raw inlined bytes
+ * of those tuples for every tile and finally the uninlined values. The
+ * blocks are spread over several data files, each written by its own
+ * thread, so a thread only ever buffers the tile group it is writing.
+ *
+ * The manifest, which records the checkpoint cid and the number of data
+ * files, is written once all data files are synced. A checkpoint without a
+ * manifest is incomplete and is never recovered from.
+ */
+class StreamingCheckpoint : public Checkpoint {
+ public:
+  StreamingCheckpoint(const StreamingCheckpoint &) = delete;
+  StreamingCheckpoint &operator=(const StreamingCheckpoint &) = delete;
+  StreamingCheckpoint(StreamingCheckpoint &&) = delete;
+  StreamingCheckpoint &operator=(StreamingCheckpoint &&) = delete;
+  StreamingCheckpoint(bool disable_file_access);
+  ~StreamingCheckpoint();
+
+  // Inherited functions
+  void DoCheckpoint();
+
+  cid_t DoRecovery();
+
+  // Internal functions
+  // Serialize the tuples of the tile group visible to the checkpoint, returns
+  // the number of serialized tuples
+  size_t SerializeTileGroup(storage::TileGroup *tile_group,
+                            oid_t database_oid, oid_t table_oid,
+                            CopySerializeOutput &output);
+
+  // Recover the tile group serialized in the input, returns the number of
+  // recovered tuples
+  size_t RecoverTileGroup(SerializeInputBE &input, cid_t commit_id);
+
+  // Getters and Setters
+  inline void SetStartCommitId(cid_t start_commit_id) {
+    start_commit_id_ = start_commit_id;
+  }
+
+  inline void SetFileCount(size_t file_count) { file_count_ = file_count; }
+
+  inline size_t GetFileCount() const { return file_count_; }
+
+ private:
+  struct TileGroupItem {
+    oid_t database_oid;
+    oid_t table_oid;
+    std::shared_ptr<storage::TileGroup> tile_group;
+  };
+
+  bool WriteDataFile(size_t file_itr, const std::vector<TileGroupItem> &items,
+                     std::atomic<size_t> &next_item);
+
+  void RecoverDataFile(size_t file_itr, cid_t commit_id);
+
+  bool WriteManifest(size_t file_count);
+
+  bool ReadManifest(cid_t &commit_id, size_t &file_count);
+
+  std::string GetDataFileName(int version, size_t file_itr);
+
+  void RemovePreviousVersions();
+
+  void InitVersionNumber();
+
+  // number of data files of the next checkpoint
+  size_t file_count_;
+
+  // commit id of current checkpoint
+  cid_t start_commit_id_ = 0;
+
+  // Keep tracking max oid for setting next_oid in manager
+  // For active processing after recovery
+  std::atomic<oid_t> max_oid_;
+
+  // protects the tuple counts of the recovered tables
+  std::mutex recovery_mutex_;
+
+  // suffix for data file name
+  const std::string DATA_FILE_SUFFIX = ".data";
+};
+
+}  // namespace logging
+}  // namespace peloton
@@ -19,6 +19,7 @@
 #include <vector>
 #include <unistd.h>
 #include <map>
+#include <mutex>
 #include <thread>
 
 #include "common/types.h"
@@ -28,6 +29,15 @@
 #include "logging/backend_logger.h"
 #include "logging/checkpoint.h"
 
+// Maximum number of commits gathered into one group commit
+#define GROUP_COMMIT_DEFAULT_BATCH_SIZE 64
+
+// Maximum time (in microseconds) a group commit waits for more commits
+#define GROUP_COMMIT_DEFAULT_MAX_DELAY 1000
+
+// Time (in microseconds) an idle frontend logger waits for the first commit
+#define GROUP_COMMIT_IDLE_TIMEOUT 10000
+
 namespace peloton {
 namespace logging {
 //===--------------------------------------------------------------------===//
@@ -79,8 +89,31 @@ class FrontendLogger : public Logger {
 
   void SetIsDistinguishedLogger(bool flag) { is_distinguished_logger = flag; }
 
+  // Advance the flushed commit id of an idle log stream on its own instead
+  // of following the global max flushed commit id
+  void SetIndependentEpoch(bool flag) { independent_epoch_ = flag; }
+
   void UpdateGlobalMaxFlushId();
 
+  //===--------------------------------------------------------------------===//
+  // Group Commit
+  //===--------------------------------------------------------------------===//
+
+  // Called by a backend logger once it has buffered a commit record
+  void NotifyCommit();
+
+  void SetGroupCommit(bool group_commit) { group_commit_ = group_commit; }
+
+  bool IsGroupCommit() const { return group_commit_; }
+
+  void SetGroupCommitBatchSize(size_t batch_size) {
+    group_commit_batch_size_ = batch_size;
+  }
+
+  void SetGroupCommitMaxDelay(int64_t max_delay) {
+    group_commit_max_delay_ = max_delay;
+  }
+
   // reset the frontend logger to its original state (for testing
   void Reset() {
     backend_loggers_lock.Lock();
@@ -91,6 +124,7 @@ class FrontendLogger : public Logger {
     }
 
     fsync_count = 0;
+    pending_commits_ = 0;
     max_flushed_commit_id = 0;
     max_collected_commit_id = 0;
     max_seen_commit_id = 0;
@@ -110,6 +144,9 @@ class FrontendLogger : public Logger {
   }
 
  protected:
+  // Wait until a group of commits is ready to be flushed
+  void WaitForGroupCommit();
+
   // Associated backend loggers
   std::vector<BackendLogger *> backend_loggers;
 
@@ -124,7 +161,7 @@ class FrontendLogger : public Logger {
   int64_t wait_timeout;
 
   // stats
-  size_t fsync_count = 0;
+  std::atomic<size_t> fsync_count{0};
 
   cid_t max_flushed_commit_id = 0;
 
@@ -137,6 +174,31 @@ class FrontendLogger : public Logger {
   bool test_mode_ = false;
 
   bool is_distinguished_logger = false;
+
+  // whether the log stream tracks its durable epoch on its own
+  bool independent_epoch_ = false;
+
+  // wait for commits and flush them together instead of polling
+  bool group_commit_ = false;
+
+  // flush once this many commits are pending
+  size_t group_commit_batch_size_ = GROUP_COMMIT_DEFAULT_BATCH_SIZE;
+
+  // upper bound on the time spent gathering a group (in microseconds)
+  int64_t group_commit_max_delay_ = GROUP_COMMIT_DEFAULT_MAX_DELAY;
+
+  // duration of the last fsync (in microseconds), which is how long a group
+  // keeps gathering commits
+  int64_t last_fsync_duration_ = 0;
+
+  // commits buffered by the backend loggers since the last collection
+  std::atomic<size_t> pending_commits_{0};
+
+  // whether the frontend logger is waiting for commits
+  std::atomic<bool> waiting_for_commits_{false};
+
+  std::mutex group_commit_mutex_;
+  std::condition_variable group_commit_cv_;
 };
 
 }  // namespace logging
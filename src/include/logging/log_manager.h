@@ -13,8 +13,13 @@
 
 #pragma once
 
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
 #include <mutex>
 #include <map>
+#include <thread>
 #include <vector>
 
 #include "logging/logger.h"
@@ -25,6 +30,9 @@
 
 #define DEFAULT_NUM_FRONTEND_LOGGERS 1
 
+// Number of power of two buckets of the commit latency histogram
+#define COMMIT_LATENCY_BUCKET_COUNT 32
+
 //===--------------------------------------------------------------------===//
 // GUC Variables
 //===--------------------------------------------------------------------===//
@@ -65,6 +73,19 @@ class LogManager {
     test_mode_ = test_mode;
     num_frontend_loggers_ = num_frontend_loggers;
     logger_mapping_strategy_ = logger_mapping_strategy;
+    log_streams_ = false;
+  }
+
+  // configure one log stream, with its own frontend logger and log files,
+  // per core, all cores are used if the number of streams is 0
+  void ConfigureLogStreams(LoggingType logging_type, bool test_mode = false,
+                           unsigned int num_log_streams = 0) {
+    if (num_log_streams == 0) {
+      num_log_streams = std::max(1U, std::thread::hardware_concurrency());
+    }
+    Configure(logging_type, test_mode, num_log_streams,
+              LOGGER_MAPPING_TYPE_AFFINITY);
+    log_streams_ = true;
   }
 
   // reset all frontend loggers, for testing
@@ -116,6 +137,17 @@ class LogManager {
   // called by frontends when recovery is complete.(for a particular frontend)
   void NotifyRecoveryDone();
 
+  // replay the transactions added by the frontends of all log streams in
+  // commit id order, through the given frontend
+  void ReplayRecoveredTransactions(WriteAheadFrontendLogger *frontend_logger);
+
+  // called by frontends during recovery of log streams, the transactions of
+  // all streams are replayed together in commit id order
+  void AddRecoveredTransaction(cid_t commit_id,
+                               std::vector<TupleRecord *> &tuple_records);
+
+  bool HasLogStreams() const { return log_streams_; }
+
   //===--------------------------------------------------------------------===//
   // Accessors
   //===--------------------------------------------------------------------===//
@@ -131,6 +163,33 @@ class LogManager {
   // get the status of sychronus commit
   bool GetSyncCommit(void) const { return syncronization_commit; }
 
+  // Whether the frontend loggers flush commits in groups
+  void SetGroupCommit(bool group_commit);
+
+  bool GetGroupCommit(void) const { return group_commit_; }
+
+  // Whether the write ahead frontend loggers write the log as preallocated
+  // segments with asynchronous direct I/O, must be set before they start
+  void SetSegmentedLogIO(bool segmented_log_io);
+
+  bool GetSegmentedLogIO(void) const { return segmented_log_io_; }
+
+  //===--------------------------------------------------------------------===//
+  // Metrics
+  //===--------------------------------------------------------------------===//
+
+  // record the latency (in microseconds) of a synchronous commit
+  void RecordCommitLatency(uint64_t latency);
+
+  // latency (in microseconds) within which the given percentage of the
+  // synchronous commits completed, rounded up to a power of two
+  uint64_t GetCommitLatencyPercentile(double percentile);
+
+  // fsyncs per second issued by the frontend loggers since the last reset
+  double GetFsyncRate();
+
+  void ResetCommitMetrics();
+
   // returns true if a frontend logger is active
   bool ContainsFrontendLogger(void);
 
@@ -217,6 +276,10 @@ class LogManager {
   // set the maximum commit id which has been persisted to disk
   cid_t GetGlobalMaxFlushedCommitId();
 
+  // raise the maximum commit id which has been persisted to disk, it never
+  // goes back when log streams race to update it
+  void AdvanceGlobalMaxFlushedCommitId(cid_t new_max);
+
   // get the list of frontend loggers
   std::vector<std::unique_ptr<FrontendLogger>> &GetFrontendLoggersList() {
     return frontend_loggers;
@@ -259,6 +322,14 @@ class LogManager {
   // set the strategy for mapping frontend loggers to worker threads
   LoggerMappingStrategyType logger_mapping_strategy_ = LOGGER_MAPPING_TYPE_INVALID;
 
+  // every frontend logger is an independent log stream of a core
+  bool log_streams_ = false;
+
+  // committed transactions read from the log streams during recovery
+  std::vector<RecoveredTransaction> recovered_transactions_;
+
+  std::mutex recovered_transactions_mutex_;
+
   // default log file size
   size_t log_file_size_limit_ = LOG_FILE_LEN;
 
@@ -277,9 +348,29 @@ class LogManager {
   std::mutex logging_status_mutex;
   std::condition_variable logging_status_cv;
 
-  // To wait for flush
+  // A worker thread waiting for its commit to be flushed
+  struct FlushWaiter {
+    std::condition_variable cv;
+    bool flushed = false;
+  };
+
+  // To wait for flush, the waiters are ordered by the cid they wait for
   std::mutex flush_notify_mutex;
-  std::condition_variable flush_notify_cv;
+  std::multimap<cid_t, FlushWaiter *> flush_waiters_;
+
+  // whether the frontend loggers flush commits in groups
+  bool group_commit_ = false;
+
+  // whether the write ahead log is written as segments
+  bool segmented_log_io_ = false;
+
+  // histogram of the synchronous commit latencies, bucket i holds the
+  // latencies below 2^i microseconds
+  std::atomic<uint64_t> commit_latency_buckets_[COMMIT_LATENCY_BUCKET_COUNT];
+
+  // when the metrics were reset and the fsync count at that time
+  std::chrono::steady_clock::time_point metrics_begin_;
+  size_t metrics_begin_fsync_count_ = 0;
 
   // To update catalog and txn managers
   std::mutex update_managers_mutex;
@@ -303,7 +394,7 @@ class LogManager {
 
   cid_t global_max_flushed_id_for_recovery = UINT64_MAX;
 
-  cid_t global_max_flushed_commit_id = 0;
+  std::atomic<cid_t> global_max_flushed_commit_id{0};
 
   // number the fronted loggers who have updated the manager of their max oid
   // and cid
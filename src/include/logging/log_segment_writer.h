@@ -0,0 +1,141 @@
+//===----------------------------------------------------------------------===//
+//
+//                         Peloton
+//
+// log_segment_writer.h
+//
+// Identification: src/include/logging/log_segment_writer.h
+//
+// Copyright (c) 2015-16, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+
+#pragma once
+
+#include <condition_variable>
+#include <functional>
+#include <mutex>
+#include <string>
+#include <thread>
+
+#include "common/types.h"
+
+// Alignment of the buffers, offsets and lengths of direct I/O
+#define LOG_SEGMENT_BLOCK_SIZE 4096
+
+// Size of the header at the start of a segment : max log id, max delimiter
+#define LOG_SEGMENT_HEADER_SIZE (2 * sizeof(cid_t))
+
+namespace peloton {
+namespace logging {
+
+//===--------------------------------------------------------------------===//
+// Log Segment Writer
+//===--------------------------------------------------------------------===//
+
+/**
+ * @brief Writes a log file as a preallocated segment with direct I/O.
+ *
+ * The frontend logger appends the log records of a batch to the active
+ * buffer and submits it. A dedicated I/O thread writes and syncs the batch
+ * while the frontend logger already fills the other buffer with the next
+ * one, so at most one batch is in flight. The flush callback is invoked on
+ * the I/O thread once a batch is durable, or failed to be.
+ *
+ * Writes always start at a block boundary, the partial block at the end of
+ * a batch is carried over and rewritten by the next batch. Every write ends
+ * with at least one zero byte, which marks the end of the log in a recycled
+ * segment that still holds stale records further on.
+ */
+class LogSegmentWriter {
+ public:
+  LogSegmentWriter(const LogSegmentWriter &) = delete;
+  LogSegmentWriter &operator=(const LogSegmentWriter &) = delete;
+
+  // Invoked with the commit id and the duration (in microseconds) of the
+  // write and sync of every batch, along with RESULT_SUCCESS once it is
+  // durable or RESULT_FAILURE if it could not be written or synced
+  typedef std::function<void(cid_t, int64_t, Result)> FlushCallback;
+
+  LogSegmentWriter(FlushCallback flush_callback);
+
+  ~LogSegmentWriter();
+
+  // Open a new segment, reusing the recycled segment file if one is given
+  bool Open(const std::string &file_name, const std::string &recycled_file_name,
+            size_t segment_size);
+
+  // Append data to the active buffer
+  void Append(const char *data, size_t size);
+
+  // Hand the active buffer to the I/O thread, waits for the previous batch
+  void Submit(cid_t commit_id);
+
+  // Wait until all the submitted batches are durable
+  void Drain();
+
+  // Write the header of the segment, sync and close it
+  void Close(cid_t max_log_id, cid_t max_delimiter);
+
+  bool IsOpen() const { return fd_ != -1; }
+
+  // Whether the segment is opened with O_DIRECT
+  bool IsDirect() const { return direct_; }
+
+  // Number of bytes written to the segment, including its header
+  size_t GetSize() const { return file_offset_; }
+
+ private:
+  struct AlignedBuffer {
+    char *data = nullptr;
+    size_t capacity = 0;
+    size_t size = 0;
+
+    ~AlignedBuffer();
+
+    void Reserve(size_t new_capacity);
+  };
+
+  struct Batch {
+    AlignedBuffer *buffer;
+    size_t offset;
+    size_t length;
+    cid_t commit_id;
+  };
+
+  void IOLoop();
+
+  void WriteBatch(const Batch &batch);
+
+  FlushCallback flush_callback_;
+
+  int fd_ = -1;
+
+  bool direct_ = false;
+
+  // logical end of the segment
+  size_t file_offset_ = 0;
+
+  // the active buffer holds the segment from this block aligned offset on
+  size_t buffer_offset_ = 0;
+
+  // whether data was appended after the last batch
+  bool unsubmitted_data_ = false;
+
+  AlignedBuffer buffers_[2];
+
+  AlignedBuffer *active_buffer_ = &buffers_[0];
+
+  // state shared with the I/O thread
+  std::mutex io_mutex_;
+  std::condition_variable io_cv_;
+  Batch pending_batch_;
+  bool batch_in_flight_ = false;
+  bool shutdown_ = false;
+
+  std::thread io_thread_;
+};
+
+}  // namespace logging
+}  // namespace peloton
@@ -16,15 +16,26 @@
 #include "logging/frontend_logger.h"
 #include "logging/records/tuple_record.h"
 #include "logging/log_file.h"
+#include "logging/log_segment_writer.h"
 #include "executor/executors.h"
 
 #include <dirent.h>
+#include <memory>
 #include <vector>
 #include <set>
 #include <chrono>
 
 extern int peloton_flush_frequency_micros;
 
+// Maximum number of threads replaying the log and rebuilding the indexes
+#define WAL_RECOVERY_MAX_THREAD_COUNT 8
+
+// Number of committed tuple records buffered before they are replayed
+#define WAL_RECOVERY_BATCH_SIZE 65536
+
+// Maximum number of truncated log segments kept around for reuse
+#define WAL_MAX_RECYCLED_SEGMENTS 4
+
 namespace peloton {
 
 class VarlenPool;
@@ -33,6 +44,10 @@ namespace concurrency {
 class Transaction;
 }
 
+namespace index {
+class Index;
+}
+
 namespace logging {
 
 typedef std::chrono::high_resolution_clock Clock;
@@ -40,6 +55,9 @@ typedef std::chrono::high_resolution_clock Clock;
 typedef std::chrono::microseconds Micros;
 
 typedef std::chrono::time_point<Clock> TimePoint;
+
+// A committed transaction read from a log stream : < commit id, records >
+typedef std::pair<cid_t, std::vector<TupleRecord *>> RecoveredTransaction;
 //===--------------------------------------------------------------------===//
 // Write Ahead Frontend Logger
 //===--------------------------------------------------------------------===//
@@ -68,12 +86,36 @@ class WriteAheadFrontendLogger : public FrontendLogger {
 
   void CommitTransactionRecovery(cid_t commit_id);
 
+  // Add a tuple record to the transaction it belongs to
+  void AddTupleRecordRecovery(TupleRecord *tuple_record);
+
   void InsertTuple(TupleRecord *recovery_txn);
 
   void DeleteTuple(TupleRecord *recovery_txn);
 
   void UpdateTuple(TupleRecord *recovery_txn);
 
+  void ApplyRecoveryBatch();
+
+  // Replay the committed transactions of all log streams in commit id order,
+  // takes the ownership of their records
+  void ReplayRecoveredTransactions(
+      std::vector<RecoveredTransaction> &transactions);
+
+  // Hand the committed transactions to the log manager, which replays the
+  // transactions of all log streams once they are all read
+  void SetMergedRecovery(bool merged_recovery) {
+    merged_recovery_ = merged_recovery;
+  }
+
+  oid_t GetMaxRecoveredOid() const { return max_oid; }
+
+  void SetRecoveryThreadCount(size_t thread_count) {
+    recovery_thread_count_ = thread_count;
+  }
+
+  size_t GetRecoveryThreadCount() const { return recovery_thread_count_; }
+
   void AbortActiveTransactions();
 
   void InitLogFilesList();
@@ -104,16 +146,50 @@ class WriteAheadFrontendLogger : public FrontendLogger {
 
   void InitSelf();
 
+  // Write the log as preallocated segments with asynchronous direct I/O,
+  // must be set before logging starts
+  void SetSegmentedIO(bool segmented_io) { segmented_io_ = segmented_io; }
+
+  bool IsSegmentedIO() const { return segmented_io_; }
+
   static constexpr auto wal_directory_path = "wal_log";
 
  private:
   std::string GetLogFileName(void);
 
-  bool RecoverTableIndexHelper(storage::DataTable *target_table,
-                               cid_t start_cid);
+  // Hand the collected log records to the segment writer
+  void FlushLogRecordsToSegment();
+
+  void OpenLogSegment();
+
+  void CloseLogSegment();
 
-  void InsertIndexEntry(storage::Tuple *tuple, storage::DataTable *table,
-                        ItemPointer target_location);
+  // Invoked by the segment writer once a batch is durable, or failed to be
+  void LogSegmentFlushed(cid_t commit_id, int64_t duration, Result status);
+
+  // Keep a truncated log file for reuse, returns false if it is not needed
+  bool RecycleLogSegment(const std::string &file_name);
+
+  // Replay the log records of the committed transactions
+  void ReplayLogRecords(cid_t start_commit_id,
+                       cid_t global_max_flushed_id_for_recovery);
+
+  // Replay the records of a committed transaction
+  void ReplayTransaction(cid_t commit_id,
+                         std::vector<TupleRecord *> &tuple_records);
+
+  // Buffer the operations of a committed tuple record for parallel replay
+  void AddRecoveryOperations(TupleRecord *tuple_record);
+
+  void RecoverTableIndexHelper(storage::DataTable *target_table,
+                               index::Index *index, cid_t start_cid);
+
+  // An operation of a tuple record on a single tile group. An update record
+  // has two : inserting the new version and updating the old one.
+  struct RecoveryOperation {
+    TupleRecord *record;
+    bool insert_version;
+  };
 
   //===--------------------------------------------------------------------===//
   // Member Variables
@@ -125,6 +201,18 @@ class WriteAheadFrontendLogger : public FrontendLogger {
   // Txn table during recovery
   std::map<txn_id_t, std::vector<TupleRecord *>> recovery_txn_table;
 
+  // number of threads replaying the log, the log is replayed serially if 1
+  size_t recovery_thread_count_;
+
+  // committed operations waiting for replay, partitioned by tile group
+  std::vector<std::vector<RecoveryOperation>> recovery_partitions_;
+
+  // committed records waiting for replay
+  std::vector<TupleRecord *> recovery_batch_records_;
+
+  // whether the log streams are merged by the log manager during recovery
+  bool merged_recovery_ = false;
+
   // Keep tracking max oid for setting next_oid in manager
   // For active processing after recovery
   oid_t max_oid = 0;
@@ -163,6 +251,21 @@ class WriteAheadFrontendLogger : public FrontendLogger {
   TimePoint last_flush = Clock::now();
 
   Micros flush_frequency{peloton_flush_frequency_micros};
+
+  // whether the log is written through the segment writer
+  bool segmented_io_ = false;
+
+  std::unique_ptr<LogSegmentWriter> segment_writer_;
+
+  // max commit id handed to the segment writer
+  cid_t max_submitted_commit_id_ = 0;
+
+  // truncated segments waiting for reuse
+  std::vector<std::string> recycled_segments_;
+
+  int recycled_segment_counter_ = 0;
+
+  std::string RECYCLED_SEGMENT_PREFIX = "peloton_free_segment_";
 };
 
 }  // namespace logging
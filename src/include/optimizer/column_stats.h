@@ -0,0 +1,102 @@
+//===----------------------------------------------------------------------===//
+//
+//                         Peloton
+//
+// column_stats.h
+//
+// Identification: src/include/optimizer/column_stats.h
+//
+// Copyright (c) 2015-16, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+
+#pragma once
+
+#include "common/types.h"
+#include "common/value.h"
+
+#include <random>
+#include <vector>
+
+namespace peloton {
+namespace optimizer {
+
+// Number of registers of the distinct count sketch is 2^HLL_PRECISION
+#define HLL_PRECISION 10
+
+// Number of values kept to build the histogram of a numeric column
+#define HISTOGRAM_SAMPLE_SIZE 10000
+
+// Number of equi-depth buckets of a histogram
+#define HISTOGRAM_BUCKET_COUNT 64
+
+// Selectivity of a predicate we know nothing about
+#define DEFAULT_SELECTIVITY 0.1
+
+// Selectivity of a range predicate on a column without histogram
+#define DEFAULT_RANGE_SELECTIVITY 0.33
+
+//===--------------------------------------------------------------------===//
+// Column Stats
+//===--------------------------------------------------------------------===//
+
+// Statistics of one column of a table: null fraction, a HyperLogLog sketch
+// of the number of distinct values, and an equi-depth histogram built from a
+// reservoir sample of the values (numeric columns only).
+class ColumnStats {
+ public:
+  ColumnStats(ValueType type);
+
+  // Add one value of the column
+  void AddValue(const Value &value);
+
+  // Build the histogram once all values have been added
+  void Finalize();
+
+  ValueType GetType() const { return type; }
+
+  size_t GetValueCount() const { return value_count; }
+
+  double GetNullFraction() const;
+
+  double GetDistinctCount() const;
+
+  bool HasHistogram() const { return histogram_bounds.empty() == false; }
+
+  // Fraction of the non-null values that are less than (or equal to) value
+  double GetLessThanFraction(double value, bool inclusive) const;
+
+  // Estimated fraction of the rows that satisfy "column <expr_type> constant"
+  double EstimateSelectivity(ExpressionType expr_type,
+                             const Value &constant) const;
+
+ private:
+  void AddToSketch(const Value &value);
+
+  void AddToSample(const Value &value);
+
+  ValueType type;
+
+  size_t value_count = 0;
+
+  size_t null_count = 0;
+
+  // HyperLogLog registers
+  std::vector<uint8_t> registers;
+
+  // reservoir sample of the non-null values (numeric columns only)
+  std::vector<double> sample;
+
+  size_t sampled_value_count = 0;
+
+  std::mt19937_64 generator;
+
+  // upper bounds of the equi-depth buckets, in ascending order
+  std::vector<double> histogram_bounds;
+
+  double min_value = 0;
+};
+
+} /* namespace optimizer */
+} /* namespace peloton */
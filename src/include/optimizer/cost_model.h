@@ -0,0 +1,57 @@
+//===----------------------------------------------------------------------===//
+//
+//                         Peloton
+//
+// cost_model.h
+//
+// Identification: src/include/optimizer/cost_model.h
+//
+// Copyright (c) 2015-16, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+
+#pragma once
+
+#include "optimizer/operator_node.h"
+#include "optimizer/stats.h"
+
+#include <memory>
+#include <vector>
+
+//===--------------------------------------------------------------------===//
+// Cost constants, relative to reading one tuple during a scan
+//===--------------------------------------------------------------------===//
+
+// Assumed cardinality of a table without stats
+#define DEFAULT_TABLE_CARDINALITY 1000
+
+#define SCAN_TUPLE_COST 1.0
+
+// Evaluating a predicate on one tuple (or pair of tuples)
+#define PREDICATE_TUPLE_COST 0.25
+
+// Computing the projection of one tuple
+#define PROJECT_TUPLE_COST 0.1
+
+// Materializing one output tuple of a join
+#define OUTPUT_TUPLE_COST 0.1
+
+// Inserting one tuple into the hash table of a hash join
+#define HASH_BUILD_TUPLE_COST 1.5
+
+// Probing the hash table of a hash join with one tuple
+#define HASH_PROBE_TUPLE_COST 0.5
+
+namespace peloton {
+namespace optimizer {
+
+// Derive the stats of the output of an operator and the cost of evaluating
+// it from the stats and costs of its children
+void DeriveOperatorStatsAndCost(
+    const Operator &op, const std::vector<std::shared_ptr<Stats>> &child_stats,
+    const std::vector<double> &child_costs,
+    std::shared_ptr<Stats> &output_stats, double &output_cost);
+
+} /* namespace optimizer */
+} /* namespace peloton */
@@ -13,7 +13,10 @@
 
 #pragma once
 
-#include "optimizer/tuple_sample.h"
+#include "optimizer/table_stats.h"
+#include "common/value.h"
+
+#include <memory>
 
 namespace peloton {
 namespace optimizer {
@@ -21,12 +24,53 @@ namespace optimizer {
 //===--------------------------------------------------------------------===//
 // Stats
 //===--------------------------------------------------------------------===//
+
+// Statistics derived for a group expression. Relational operators estimate
+// their output cardinality; expressions carry what their parent needs to
+// estimate a selectivity (the column or constant they stand for, or the
+// selectivity of a predicate).
 class Stats {
  public:
-  Stats(TupleSample *sample);
+  Stats(double cardinality) : cardinality(cardinality) {}
+
+  double GetCardinality() const { return cardinality; }
+
+  // Fraction of its input rows a predicate lets through
+  double GetSelectivity() const { return selectivity; }
+
+  void SetSelectivity(double selectivity_) { selectivity = selectivity_; }
+
+  // Stats of the base table column a variable refers to (nullptr if unknown)
+  const ColumnStats *GetColumnStats() const { return column_stats; }
+
+  void SetColumnStats(std::shared_ptr<TableStats> table_stats_,
+                      const ColumnStats *column_stats_) {
+    table_stats = table_stats_;
+    column_stats = column_stats_;
+  }
+
+  bool HasConstant() const { return has_constant; }
+
+  const Value &GetConstant() const { return constant; }
+
+  void SetConstant(const Value &constant_) {
+    constant = constant_;
+    has_constant = true;
+  }
 
  private:
-  TupleSample *sample;
+  double cardinality;
+
+  double selectivity = 1;
+
+  // keeps the column stats alive
+  std::shared_ptr<TableStats> table_stats;
+
+  const ColumnStats *column_stats = nullptr;
+
+  bool has_constant = false;
+
+  Value constant;
 };
 
 } /* namespace optimizer */
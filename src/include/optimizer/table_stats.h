@@ -0,0 +1,110 @@
+//===----------------------------------------------------------------------===//
+//
+//                         Peloton
+//
+// table_stats.h
+//
+// Identification: src/include/optimizer/table_stats.h
+//
+// Copyright (c) 2015-16, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+
+#pragma once
+
+#include "optimizer/column_stats.h"
+
+#include <future>
+#include <memory>
+#include <mutex>
+#include <unordered_map>
+#include <vector>
+
+// Re-analyze a table once its tuple count drifted by this fraction
+#define STATS_STALENESS_THRESHOLD 0.2
+
+namespace peloton {
+
+namespace storage {
+class DataTable;
+}
+
+namespace optimizer {
+
+//===--------------------------------------------------------------------===//
+// Table Stats
+//===--------------------------------------------------------------------===//
+class TableStats {
+ public:
+  TableStats(oid_t table_oid) : table_oid(table_oid) {}
+
+  // Build the stats of a table by scanning the latest committed version of
+  // every tuple (the equivalent of ANALYZE)
+  static std::shared_ptr<TableStats> Analyze(storage::DataTable *table);
+
+  oid_t GetTableOid() const { return table_oid; }
+
+  double GetRowCount() const { return row_count; }
+
+  // Tuple count maintained by the table at the time it was analyzed
+  double GetAnalyzedTupleCount() const { return analyzed_tuple_count; }
+
+  // Returns nullptr if there are no stats for the column
+  const ColumnStats *GetColumnStats(oid_t column_id) const;
+
+ private:
+  oid_t table_oid;
+
+  double row_count = 0;
+
+  double analyzed_tuple_count = 0;
+
+  std::vector<ColumnStats> column_stats;
+};
+
+//===--------------------------------------------------------------------===//
+// Stats Manager
+//===--------------------------------------------------------------------===//
+
+// Cache of the table stats used by the optimizer.
+//
+// A table is analyzed by at most one thread at a time. While its stats are
+// refreshed, other planners keep using the stale ones, and only planners of
+// a table that has no stats at all wait for the running analyze.
+class StatsManager {
+ public:
+  static StatsManager &GetInstance();
+
+  // Get the stats of the table, analyzing it first if there are none yet or
+  // if they are stale and no other thread is analyzing it
+  std::shared_ptr<TableStats> GetTableStats(storage::DataTable *table);
+
+  // Get the stats of the table if it has been analyzed already
+  std::shared_ptr<TableStats> GetTableStats(oid_t table_oid);
+
+  // Analyze the table and replace its stats
+  std::shared_ptr<TableStats> AnalyzeTable(storage::DataTable *table);
+
+  void DropTableStats(oid_t table_oid);
+
+  void Clear();
+
+ private:
+  StatsManager() {}
+
+  struct TableStatsEntry {
+    std::shared_ptr<TableStats> stats;
+
+    // Outcome of the analyze that is running, if any
+    std::shared_future<std::shared_ptr<TableStats>> analysis;
+    bool analyzing = false;
+  };
+
+  std::mutex stats_mutex;
+
+  std::unordered_map<oid_t, TableStatsEntry> table_stats;
+};
+
+} /* namespace optimizer */
+} /* namespace peloton */
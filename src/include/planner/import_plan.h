@@ -0,0 +1,85 @@
+//===----------------------------------------------------------------------===//
+//
+//                         Peloton
+//
+// import_plan.h
+//
+// Identification: src/include/planner/import_plan.h
+//
+// Copyright (c) 2015-16, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+
+#pragma once
+
+#include "planner/abstract_plan.h"
+
+namespace peloton {
+namespace storage {
+class DataTable;
+}
+namespace parser {
+struct ImportStatement;
+}
+
+namespace planner {
+
+/**
+ * @brief Bulk load of a delimited file into a table
+ */
+class ImportPlan : public AbstractPlan {
+ public:
+  ImportPlan() = delete;
+  ImportPlan(const ImportPlan &) = delete;
+  ImportPlan &operator=(const ImportPlan &) = delete;
+  ImportPlan(ImportPlan &&) = delete;
+  ImportPlan &operator=(ImportPlan &&) = delete;
+
+  ImportPlan(storage::DataTable *table, std::string file_path, char delimiter);
+
+  explicit ImportPlan(parser::ImportStatement *parse_tree);
+
+  inline PlanNodeType GetPlanNodeType() const { return PLAN_NODE_TYPE_IMPORT; }
+
+  const std::string GetInfo() const {
+    std::string returned_string = "ImportPlan:\n";
+    returned_string += "\tTable name: " + table_name_ + "\n";
+    returned_string += "\tFile path: " + file_path_ + "\n";
+    return returned_string;
+  }
+
+  std::unique_ptr<AbstractPlan> Copy() const {
+    return std::unique_ptr<AbstractPlan>(
+        new ImportPlan(target_table_, table_name_, file_path_, delimiter_));
+  }
+
+  // The target table, nullptr if it is looked up by name
+  storage::DataTable *GetTable() const { return target_table_; }
+
+  std::string GetTableName() const { return table_name_; }
+
+  std::string GetFilePath() const { return file_path_; }
+
+  char GetDelimiter() const { return delimiter_; }
+
+ private:
+  ImportPlan(storage::DataTable *table, std::string table_name,
+             std::string file_path, char delimiter)
+      : target_table_(table),
+        table_name_(table_name),
+        file_path_(file_path),
+        delimiter_(delimiter) {}
+
+  // Target Table
+  storage::DataTable *target_table_ = nullptr;
+  std::string table_name_;
+
+  std::string file_path_;
+
+  // ',' for CSV files and '\t' for TSV files
+  char delimiter_;
+};
+
+}  // namespace planner
+}  // namespace peloton
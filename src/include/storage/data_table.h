@@ -17,9 +17,19 @@
 #include <queue>
 #include <map>
 #include <mutex>
+#include <vector>
 
+#include "common/platform.h"
 #include "storage/abstract_table.h"
 
+// Number of insert buffers of a table, the inserting threads are spread over
+// them
+#define DATA_TABLE_INSERT_BUFFER_COUNT 16
+
+// Maximum number of recycled tuple slots an insert buffer takes from the GC
+// at once
+#define DATA_TABLE_FREE_SLOT_BATCH_SIZE 64
+
 //===--------------------------------------------------------------------===//
 // GUC Variables
 //===--------------------------------------------------------------------===//
@@ -133,6 +143,10 @@ class DataTable : public AbstractTable {
   // Get a tile group with given layout
   TileGroup *GetTileGroupWithLayout(const column_map_type &partitioning);
 
+  // Get a tile group with the default layout that is not yet part of the
+  // table. Bulk loads fill it before adding it with AddTileGroup.
+  TileGroup *GetDefaultTileGroup();
+
   //===--------------------------------------------------------------------===//
   // INDEX
   //===--------------------------------------------------------------------===//
@@ -231,6 +245,12 @@ class DataTable : public AbstractTable {
   // add a default unpartitioned tile group to table
   oid_t AddDefaultTileGroup();
 
+  // take a tile group no insert buffer fills, creating one if needed
+  std::shared_ptr<storage::TileGroup> ClaimTileGroup();
+
+  // make sure a tile group is ready for the next insert buffer that needs one
+  void PrepareTileGroup();
+
   // get a partitioning with given layout type
   column_map_type GetTileGroupLayout(LayoutType layout_type);
 
@@ -268,6 +288,35 @@ class DataTable : public AbstractTable {
   // TODO: don't know why need this mutex --Yingjun
   std::mutex tile_group_mutex_;
 
+  // INSERT BUFFERS
+  // Each inserting thread claims slots from its own partially filled tile
+  // group and from the recycled slots it took from the GC, so that concurrent
+  // inserts do not contend on the tail tile group
+  struct InsertBuffer {
+    Spinlock lock;
+
+    std::shared_ptr<storage::TileGroup> tile_group;
+
+    std::vector<ItemPointer> free_slots;
+
+    // number of inserts before the GC is asked for recycled slots again
+    size_t free_slot_backoff = 0;
+
+    // keeps the locks of neighbouring buffers on different cache lines
+    char padding[CACHELINE_SIZE];
+  };
+
+  ItemPointer GetRecycledTupleSlot(InsertBuffer &insert_buffer,
+                                   const storage::Tuple *tuple);
+
+  InsertBuffer insert_buffers_[DATA_TABLE_INSERT_BUFFER_COUNT];
+
+  // protects the claiming of tile groups by the insert buffers
+  std::mutex claim_mutex_;
+
+  // tile groups from this offset on are not claimed by any insert buffer
+  oid_t next_unclaimed_offset_ = 0;
+
   // INDEXES
   std::vector<index::Index *> indexes_;
 
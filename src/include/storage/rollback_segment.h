@@ -55,7 +55,8 @@ class RollbackSegmentPool {
  public:
   /**
     * Data layout:
-    * | next_seg_ptr (8 bytes) | timestamp (8 bytes) | column_count (8 bytes)
+    * | next_seg_ptr (8 bytes) | timestamp (8 bytes)
+    * | begin_timestamp (8 bytes) | column_count (8 bytes)
     * | id_offset_pairs (column_count * 16 bytes) | segment data
     *
     * Rollback segment is variable length byte buffer
@@ -67,6 +68,9 @@ class RollbackSegmentPool {
     *  of a rollback segment is JUST the end timestamp of next rollback segment
     *  on the rollback segment chain. Everytime the timestamp of a rollback
     *  segment is copied from the coressponding tuple
+    * - The next 8 byte field is the begin timestamp of the version the
+    *  rollback segment restores, so that a reader can tell whether that
+    *  version is visible without looking at the rest of the chain
     * - The next 8 byte field is the number of columns in the rollback segment
     * - The next column_count * 16 bytes is a serious of pairs, the pairs map
     *  column id of the original tuple to the offset of value in the data area
@@ -75,7 +79,10 @@ class RollbackSegmentPool {
     */
   static const size_t next_ptr_offset_ = 0;
   static const size_t timestamp_offset_ = next_ptr_offset_ + sizeof(void *);
-  static const size_t col_count_offset_ = timestamp_offset_ + sizeof(cid_t);
+  static const size_t begin_timestamp_offset_ =
+      timestamp_offset_ + sizeof(cid_t);
+  static const size_t col_count_offset_ =
+      begin_timestamp_offset_ + sizeof(cid_t);
   static const size_t pairs_start_offset = col_count_offset_ + sizeof(size_t);
 
   RollbackSegmentPool(BackendType backend_type)
@@ -105,6 +112,10 @@ class RollbackSegmentPool {
     return *(reinterpret_cast<cid_t *>(rb_seg + timestamp_offset_));
   }
 
+  inline static cid_t GetBeginTimeStamp(char *rb_seg) {
+    return *(reinterpret_cast<cid_t *>(rb_seg + begin_timestamp_offset_));
+  }
+
   inline static size_t GetColCount(const char *rb_seg) {
     return *(reinterpret_cast<const size_t *>(rb_seg + col_count_offset_));
   }
@@ -133,6 +144,11 @@ class RollbackSegmentPool {
   // within this rollback segment
   static Value GetValue(char *rb_seg, const catalog::Schema *schema, int idx);
 
+  // Overwrite the columns of the tuple with the values on the rollback
+  // segment
+  static void ApplyToTuple(char *rb_seg, const catalog::Schema *schema,
+                           Tuple *tuple, VarlenPool *data_pool);
+
   /////////////////////
   // Public setters
   /////////////////////
@@ -144,6 +160,10 @@ class RollbackSegmentPool {
     *(reinterpret_cast<cid_t *>(rb_seg + timestamp_offset_)) = ts;
   }
 
+  inline static void SetBeginTimeStamp(char *rb_seg, cid_t ts) {
+    *(reinterpret_cast<cid_t *>(rb_seg + begin_timestamp_offset_)) = ts;
+  }
+
   inline void SetPoolTimestamp(const cid_t ts) { timestamp_ = ts; }
 
   // FIXME: should set timestamp_ as the next commit id here
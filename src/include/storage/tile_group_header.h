@@ -68,6 +68,8 @@ class TileGroupHeader : public Printable {
     oid_t val = other.next_tuple_slot;
     next_tuple_slot = val;
 
+    frozen_commit_id = INVALID_CID;
+
     return *this;
   }
 
@@ -173,16 +175,19 @@ class TileGroupHeader : public Printable {
   inline void SetTransactionId(const oid_t &tuple_slot_id,
                                const txn_id_t &transaction_id) {
     *((txn_id_t *)(TUPLE_HEADER_LOCATION)) = transaction_id;
+    Thaw();
   }
 
   inline void SetBeginCommitId(const oid_t &tuple_slot_id,
                                const cid_t &begin_cid) {
     *((cid_t *)(TUPLE_HEADER_LOCATION + begin_cid_offset)) = begin_cid;
+    Thaw();
   }
 
   inline void SetEndCommitId(const oid_t &tuple_slot_id,
                              const cid_t &end_cid) const {
     *((cid_t *)(TUPLE_HEADER_LOCATION + end_cid_offset)) = end_cid;
+    Thaw();
   }
 
   inline void SetNextItemPointer(const oid_t &tuple_slot_id,
@@ -214,16 +219,70 @@ class TileGroupHeader : public Printable {
                                          const txn_id_t &old_txn_id,
                                          const txn_id_t &new_txn_id) const {
     txn_id_t *txn_id_ptr = (txn_id_t *)(TUPLE_HEADER_LOCATION);
-    return __sync_val_compare_and_swap(txn_id_ptr, old_txn_id, new_txn_id);
+    auto txn_id = __sync_val_compare_and_swap(txn_id_ptr, old_txn_id, new_txn_id);
+    Thaw();
+    return txn_id;
   }
 
   inline bool SetAtomicTransactionId(const oid_t &tuple_slot_id,
                                      const txn_id_t &transaction_id) const {
     txn_id_t *txn_id_ptr = (txn_id_t *)(TUPLE_HEADER_LOCATION);
-    return __sync_bool_compare_and_swap(txn_id_ptr, INITIAL_TXN_ID,
-                                        transaction_id);
+    auto status = __sync_bool_compare_and_swap(txn_id_ptr, INITIAL_TXN_ID,
+                                               transaction_id);
+    Thaw();
+    return status;
+  }
+
+  //===--------------------------------------------------------------------===//
+  // Frozen tile groups
+  //===--------------------------------------------------------------------===//
+
+  // A full tile group whose tuples are all committed, unowned and not yet
+  // invalidated is "frozen" at the largest begin commit id among them: a
+  // transaction that began at or after that id sees every tuple in it.
+  // Any change to the MVCC fields of a tuple thaws the tile group again.
+
+  // Get the frozen commit id, or INVALID_CID if the tile group is not frozen
+  inline cid_t GetFrozenCommitId() const {
+    cid_t frozen_cid = frozen_commit_id.load();
+    return (frozen_cid == FREEZING_CID) ? INVALID_CID : frozen_cid;
+  }
+
+  // Claim the right to check whether the tile group can be frozen.
+  // The caller must read the tuple headers only after this returns true.
+  inline bool BeginFreeze() {
+    if (GetCurrentNextTupleSlot() != num_tuple_slots) {
+      return false;
+    }
+    cid_t expected = INVALID_CID;
+    return frozen_commit_id.compare_exchange_strong(expected, FREEZING_CID);
+  }
+
+  // Publish the outcome of the check. Fails silently if a writer has
+  // touched the tile group in the meantime.
+  inline void EndFreeze(const cid_t frozen_cid) {
+    PL_ASSERT(frozen_cid != FREEZING_CID);
+    cid_t expected = FREEZING_CID;
+    frozen_commit_id.compare_exchange_strong(expected, frozen_cid);
   }
 
+  //===--------------------------------------------------------------------===//
+  // Pinned tile groups
+  //===--------------------------------------------------------------------===//
+
+  // Executor contexts pin the tile groups whose tuples their results read in
+  // place. In delta version storage, a tuple of a tile group pinned by
+  // another context is not overwritten in place.
+
+  inline void Pin() const { pin_count++; }
+
+  inline void Unpin() const {
+    PL_ASSERT(pin_count > 0);
+    pin_count--;
+  }
+
+  inline size_t GetPinCount() const { return pin_count.load(); }
+
   void PrintVisibility(txn_id_t txn_id, cid_t at_cid);
 
   // Getter for spin lock
@@ -270,6 +329,23 @@ class TileGroupHeader : public Printable {
       insert_commit_offset + sizeof(bool);
 
  private:
+  // frozen_commit_id value while a reader checks whether to freeze
+  static const cid_t FREEZING_CID = MAX_CID;
+
+  // Called after every change to the MVCC fields of a tuple. Only tuples
+  // that are committed and unowned can be frozen, so any change to them
+  // starts with the compare-and-swap of the transaction id, which is a
+  // full barrier: either a concurrent BeginFreeze/EndFreeze sees the new
+  // owner or we see its claim and void it. The plain setters only write to
+  // tuples that are owned or not yet committed, which never look frozen.
+  // So the common case is a single acquire load, and only an actual thaw
+  // pays for a sequentially consistent store.
+  inline void Thaw() const {
+    if (frozen_commit_id.load(std::memory_order_acquire) != INVALID_CID) {
+      frozen_commit_id.store(INVALID_CID);
+    }
+  }
+
   //===--------------------------------------------------------------------===//
   // Data members
   //===--------------------------------------------------------------------===//
@@ -294,6 +370,12 @@ class TileGroupHeader : public Printable {
   std::atomic<oid_t> next_tuple_slot;
 
   Spinlock tile_header_lock;
+
+  // see GetFrozenCommitId
+  mutable std::atomic<cid_t> frozen_commit_id;
+
+  // see Pin
+  mutable std::atomic<size_t> pin_count;
 };
 
 }  // End storage namespace
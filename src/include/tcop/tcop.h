@@ -21,6 +21,7 @@
 #include "common/portal.h"
 #include "common/statement.h"
 #include "common/types.h"
+#include "executor/plan_executor.h"
 
 namespace peloton {
 namespace tcop {
@@ -55,14 +56,27 @@ class TrafficCop {
                           int &rows_change,
                           std::string &error_message);
 
-  // InitBindPrepStmt - Prepare and bind a query from a query string
+  // Execute a statement and hand every result tile to the callback as soon
+  // as it is produced, instead of collecting the whole result. The bound
+  // parameters only live in this execution, the plan tree is left untouched
+  // since it may be shared through the plan cache.
+  Result ExecuteStatement(const std::shared_ptr<Statement>& statement,
+                          const std::vector<Value> &params,
+                          const bridge::ResultTileCallback &callback,
+                          int &rows_changed,
+                          std::string &error_message);
+
+  // InitBindPrepStmt - Prepare and bind a query from a query string,
+  // reusing the plan cached for the same query and parameter types
   std::shared_ptr<Statement> PrepareStatement(const std::string& statement_name,
                                               const std::string& query_string,
-                                              std::string &error_message);
+                                              std::string &error_message,
+                                              const std::vector<int32_t>& param_types = {});
 
-  int BindParameters(std::vector<std::pair<int, std::string>> &parameters,
-                     Statement **stmt,
-                     std::string &error_message);
+  // Turn the (value type, string) pairs of a bind message into values.
+  // An empty integer parameter is NULL.
+  static std::vector<Value> BindParameters(
+      const std::vector<std::pair<int, std::string>> &parameters);
 
 };
 
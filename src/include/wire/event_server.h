@@ -0,0 +1,212 @@
+//===----------------------------------------------------------------------===//
+//
+//                         Peloton
+//
+// event_server.h
+//
+// Identification: src/include/wire/event_server.h
+//
+// Copyright (c) 2015-16, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+
+#pragma once
+
+#include <atomic>
+#include <memory>
+#include <thread>
+#include <vector>
+#include <sys/epoll.h>
+
+#include "common/macros.h"
+#include "common/thread_pool.h"
+#include "wire/socket_base.h"
+
+#define EVENT_SERVER_MAX_EVENTS 64
+
+namespace peloton {
+namespace wire {
+
+/*
+ * EventServer - Event-driven alternative to HandleConnections.
+ *    Client sockets are registered with one of a few epoll instances, each
+ *    polled by its own I/O thread. When a socket becomes readable, the
+ *    connection is handed to a worker pool that processes the packets that
+ *    have fully arrived and then re-arms the socket. Workers never wait
+ *    for a client to send the rest of a packet. Idle connections thus cost
+ *    only their buffers, not a thread. Takes the protocol's PacketManager (P)
+ *    and STL container type for the protocol's buffer (B).
+ *
+ *    Responses the client does not read yet are kept in the write backlog of
+ *    its socket. The connection is then paused: it is re-armed for
+ *    writability instead of new packets until the backlog is written. A
+ *    statement still runs to completion on its worker, so a result larger
+ *    than SOCKET_WRITE_BACKLOG_LIMIT holds the worker until the client has
+ *    read all but that much of it.
+ */
+template <typename P, typename B>
+class EventServer {
+  // State of one client connection
+  struct Connection {
+    SocketManager<B> sock;
+    P packet_manager;
+
+    inline Connection(int fd) : sock(fd), packet_manager(&sock) {
+      sock.SetNonBlockingWrites(true);
+    }
+  };
+
+ public:
+  EventServer(Server *server, const int io_thread_count,
+              const int worker_thread_count);
+
+  // Server's "accept loop"
+  void HandleConnections();
+
+ private:
+  // I/O thread function: waits for readable sockets and dispatches them
+  void PollConnections(int epoll_fd);
+
+  // Worker task: writes the backlog of one writable connection or processes
+  // the packets of one readable connection
+  void ProcessConnection(int epoll_fd, Connection *connection);
+
+  // (Re-)register the connection for exactly one readiness notification,
+  // for writability while the connection has a backlog
+  bool ArmConnection(int epoll_fd, Connection *connection, int op);
+
+  Server *server;
+
+  std::vector<int> epoll_fds;
+
+  std::vector<std::thread> io_threads;
+
+  ThreadPool worker_pool;
+
+  // round-robin assignment of new connections to epoll instances
+  std::atomic<size_t> next_epoll_fd;
+};
+
+/*
+ * Functions defined here for template visibility
+ *
+ */
+
+template <typename P, typename B>
+EventServer<P, B>::EventServer(Server *server, const int io_thread_count,
+                               const int worker_thread_count)
+    : server(server), worker_pool(worker_thread_count), next_epoll_fd(0) {
+  PL_ASSERT(io_thread_count > 0 && worker_thread_count > 0);
+
+  for (int thread_itr = 0; thread_itr < io_thread_count; thread_itr++) {
+    int epoll_fd = epoll_create1(0);
+    if (epoll_fd < 0) {
+      LOG_ERROR("Server error: could not create epoll instance");
+      exit(EXIT_FAILURE);
+    }
+    epoll_fds.push_back(epoll_fd);
+    io_threads.emplace_back(&EventServer::PollConnections, this, epoll_fd);
+  }
+}
+
+template <typename P, typename B>
+void EventServer<P, B>::HandleConnections() {
+  int connfd, clilen;
+  struct sockaddr_in cli_addr;
+  clilen = sizeof(cli_addr);
+
+  for (;;) {
+    // block and wait for incoming connection
+    connfd = accept(server->server_fd, (struct sockaddr *)&cli_addr,
+                    (socklen_t *)&clilen);
+    if (connfd < 0) {
+      if (errno == EINTR) {
+        continue;
+      }
+      LOG_ERROR("Server error: Connection not established");
+      exit(EXIT_FAILURE);
+    }
+
+    LOG_TRACE("Client fd: %d", connfd);
+    auto epoll_fd = epoll_fds[next_epoll_fd++ % epoll_fds.size()];
+    auto connection = new Connection(connfd);
+    if (!ArmConnection(epoll_fd, connection, EPOLL_CTL_ADD)) {
+      LOG_ERROR("Server error: could not register client fd %d", connfd);
+      connection->sock.CloseSocket();
+      delete connection;
+    }
+  }
+}
+
+template <typename P, typename B>
+void EventServer<P, B>::PollConnections(int epoll_fd) {
+  struct epoll_event events[EVENT_SERVER_MAX_EVENTS];
+
+  for (;;) {
+    int event_count =
+        epoll_wait(epoll_fd, events, EVENT_SERVER_MAX_EVENTS, -1);
+    if (event_count < 0) {
+      if (errno == EINTR) {
+        continue;
+      }
+      LOG_ERROR("Server error: epoll_wait failed");
+      exit(EXIT_FAILURE);
+    }
+
+    // the sockets are registered one-shot, so a connection is dispatched
+    // to at most one worker at a time
+    for (int event_itr = 0; event_itr < event_count; event_itr++) {
+      auto connection =
+          reinterpret_cast<Connection *>(events[event_itr].data.ptr);
+      worker_pool.Enqueue([this, epoll_fd, connection] {
+        ProcessConnection(epoll_fd, connection);
+      });
+    }
+  }
+}
+
+template <typename P, typename B>
+void EventServer<P, B>::ProcessConnection(int epoll_fd,
+                                          Connection *connection) {
+  // a paused connection resumes only once its backlog is written
+  if (connection->sock.HasPendingWrites() &&
+      connection->sock.TryFlushWriteBacklog() < 0) {
+    connection->sock.CloseSocket();
+    delete connection;
+    return;
+  }
+
+  if (connection->sock.HasPendingWrites() == false) {
+    // process what has arrived, a partial packet waits in the packet
+    // manager for the next notification instead of blocking the worker
+    bool status = connection->packet_manager.ManageAvailablePackets();
+
+    if (status == false) {
+      // the packet manager has closed the socket, which also removed it
+      // from the epoll instance
+      delete connection;
+      return;
+    }
+  }
+
+  if (!ArmConnection(epoll_fd, connection, EPOLL_CTL_MOD)) {
+    LOG_ERROR("Server error: could not re-arm client fd %d",
+              connection->sock.GetSocketFd());
+    connection->sock.CloseSocket();
+    delete connection;
+  }
+}
+
+template <typename P, typename B>
+bool EventServer<P, B>::ArmConnection(int epoll_fd, Connection *connection,
+                                      int op) {
+  struct epoll_event event;
+  event.events = (connection->sock.HasPendingWrites() ? EPOLLOUT : EPOLLIN) |
+                 EPOLLRDHUP | EPOLLONESHOT;
+  event.data.ptr = connection;
+  return (epoll_ctl(epoll_fd, op, connection->sock.GetSocketFd(), &event) == 0);
+}
+
+}  // End wire namespace
+}  // End peloton namespace
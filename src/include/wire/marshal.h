@@ -19,6 +19,7 @@
 #include "wire/socket_base.h"
 #include "wire/wire.h"
 #include "common/logger.h"
+#include "common/value.h"
 
 namespace peloton {
 namespace wire {
@@ -47,6 +48,10 @@ extern void PacketPutCbytes(std::unique_ptr<Packet> &pkt, const uchar *b,
 extern void PacketPutBytes(std::unique_ptr<Packet> &pkt,
                            const std::vector<uchar> &data);
 
+/* packet_put_value - used to write a value in text format, preceded by its
+ * length (-1 for NULL) as in a DataRow message */
+extern void PacketPutValue(std::unique_ptr<Packet> &pkt, const Value &value);
+
 /*
  * Unmarshallers
  */
@@ -81,6 +86,11 @@ extern void GetStringToken(Packet *pkt, std::string &result);
 extern bool WritePackets(std::vector<std::unique_ptr<Packet>> &packets,
                          Client *client);
 
+/* Copy a batch of packets into the socket write buffer, which is only
+ * flushed once it is full */
+extern bool BufferPackets(std::vector<std::unique_ptr<Packet>> &packets,
+                          Client *client);
+
 /* Read a single packet from the socket read buffer */
 extern bool ReadPacket(Packet *pkt, bool has_type_field, Client *client);
 
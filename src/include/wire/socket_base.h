@@ -31,6 +31,9 @@
 #include "common/config.h"
 
 #define SOCKET_BUFFER_SIZE 8192
+// bytes a connection with non-blocking writes keeps for a slow client
+// before a flush waits for the socket
+#define SOCKET_WRITE_BACKLOG_LIMIT (16 * 1024 * 1024)
 #define MAX_CONNECTIONS 64
 #define DEFAULT_PORT 5432
 
@@ -80,24 +83,68 @@ class SocketManager {
   Buffer rbuf;  // socket's read buffer
   Buffer wbuf;  // socket's write buffer
 
+  bool nonblocking_writes;   // flushes never wait while the backlog fits
+  B write_backlog;           // flushed bytes the socket did not accept yet
+  size_t write_backlog_ptr;  // first byte of the backlog not yet written
+
  private:
   /* refill_read_buffer - Used to repopulate read buffer with a fresh
    * batch of data from the socket
    */
   bool RefillReadBuffer();
 
+  /* try_refill_read_buffer - Repopulates the read buffer with whatever the
+   * socket has available, without blocking. Returns 1 if data was read, 0 if
+   * none is available yet and -1 if the client is gone
+   */
+  int TryRefillReadBuffer();
+
+  /* flush_write_buffer_non_blocking - Writes what the socket accepts right
+   * away and appends the rest to the write backlog. Waits for the socket
+   * only while the backlog exceeds SOCKET_WRITE_BACKLOG_LIMIT
+   */
+  bool FlushWriteBufferNonBlocking();
+
+  /* try_write - Writes what the socket accepts of "len" bytes without
+   * blocking. Returns the number of bytes written, or -1 on errors
+   */
+  ssize_t TryWrite(const uchar *data, size_t len);
+
  public:
-  inline SocketManager(int sock_fd) : sock_fd(sock_fd) {}
+  inline SocketManager(int sock_fd)
+      : sock_fd(sock_fd), nonblocking_writes(false), write_backlog_ptr(0) {}
 
   // Reads a packet of length "bytes" from the head of the buffer
   bool ReadBytes(B &pkt_buf, size_t bytes);
 
+  // Reads up to "bytes" bytes of a packet into pkt_buf from what is buffered
+  // or already readable, without blocking. Returns the number of bytes
+  // read, or -1 if the client is gone.
+  ssize_t TryReadBytes(B &pkt_buf, size_t bytes);
+
   // Writes a packet into the write buffer
   bool BufferWriteBytes(B &pkt_buf, size_t len, uchar type);
 
   // Used to invoke a write into the Socket, once the write buffer is ready
   bool FlushWriteBuffer();
 
+  // Used by event-driven servers, so that a client that does not read its
+  // results holds a worker only once its backlog is full
+  inline void SetNonBlockingWrites(bool enabled) {
+    nonblocking_writes = enabled;
+  }
+
+  inline bool HasPendingWrites() const {
+    return write_backlog_ptr < write_backlog.size();
+  }
+
+  // Writes as much of the backlog as the socket accepts without blocking.
+  // Returns 1 if the backlog is empty, 0 if the rest has to wait until the
+  // socket is writable again and -1 if the client is gone.
+  int TryFlushWriteBacklog();
+
+  inline int GetSocketFd() const { return sock_fd; }
+
   void CloseSocket();
 };
 
@@ -32,6 +32,11 @@
 #define TXN_FAIL 'E'
 
 namespace peloton {
+
+namespace executor {
+class LogicalTile;
+}
+
 namespace wire {
 
 typedef std::vector<uchar> PktBuf;
@@ -74,6 +79,22 @@ class PacketManager {
   // Manage standalone queries
   std::shared_ptr<Statement> unnamed_statement;
 
+  // Named prepared statements of this session. Their plans are shared with
+  // other sessions through the plan cache.
+  Cache<std::string, Statement> statement_cache_;
+
+  // Portals of this session, created by BIND and run by EXECUTE
+  std::unordered_map<std::string, std::shared_ptr<Portal>> portals_;
+
+  // whether the startup packet has been processed
+  bool started_ = false;
+
+  // Header and contents of a packet that has only partly arrived, kept
+  // across calls to ManageAvailablePackets
+  PktBuf partial_header_;
+  std::unique_ptr<Packet> partial_packet_;
+  size_t partial_packet_size_ = 0;
+
   // gloabl txn state
   uchar txn_state;
 
@@ -82,6 +103,9 @@ class PacketManager {
   std::string skipped_query_string_;
   std::string skipped_query_type_;
 
+  // reused for every DataRow message of a streamed result
+  std::unique_ptr<Packet> row_packet_;
+
   static const std::unordered_map<std::string, std::string>
       parameter_status_map;
 
@@ -100,9 +124,17 @@ class PacketManager {
   void PutTupleDescriptor(const std::vector<FieldInfoType>& tuple_descriptor,
                           ResponseBuffer& responses);
 
-  // Send each row, one packet at a time, used by SELECT queries
-  void SendDataRows(std::vector<ResultType>& results, int colcount,
-                    int& rows_affected, ResponseBuffer& responses);
+  // Send each row of a result tile as a DataRow message, written straight
+  // into the socket write buffer. Returns false if the client is gone.
+  bool SendDataTile(executor::LogicalTile* tile, int& rows_sent);
+
+  // Execute a statement and stream its result rows to the socket, behind
+  // the responses batched so far
+  Result ExecuteStreamingStatement(const std::shared_ptr<Statement>& statement,
+                                   const std::vector<Value>& params,
+                                   ResponseBuffer& responses,
+                                   int& rows_affected,
+                                   std::string& error_message);
 
   // Used to send a packet that indicates the completion of a query. Also has
   // txn state mgmt
@@ -143,9 +175,18 @@ class PacketManager {
   /* closes the socket connection with the client */
   void CloseClient();
 
+  /* Reads what the socket has available of the next packet into
+   * partial_packet_ without blocking. Sets complete once the packet has
+   * fully arrived. Returns false if the client is gone */
+  bool TryReadPacket(bool has_type_field, bool& complete);
+
  public:
   inline PacketManager(SocketManager<PktBuf>* sock)
-      : client(sock), txn_state(TXN_IDLE) {}
+      : client(sock),
+        statement_cache_(DEFAULT_CACHE_SIZE, 1),
+        partial_packet_(new Packet()),
+        txn_state(TXN_IDLE),
+        row_packet_(new Packet()) {}
 
   /* Startup packet processing logic */
   bool ProcessStartupPacket(Packet* pkt, ResponseBuffer& responses);
@@ -154,6 +195,20 @@ class PacketManager {
    * packet */
   bool ProcessPacket(Packet* pkt, ResponseBuffer& responses);
 
+  /* Reads, processes and answers the startup packet. Returns false if the
+   * client has been closed */
+  bool ManageStartupPacket();
+
+  /* Reads, processes and answers one packet. Returns false if the client
+   * has been closed */
+  bool ManagePacket();
+
+  /* Processes the packets that have fully arrived, starting with the
+   * startup packet, and returns once the socket has no complete packet left
+   * or responses wait in its write backlog. Never waits for the client to
+   * send. Returns false if the client has been closed */
+  bool ManageAvailablePackets();
+
   /* Protocol manager */
   void ManagePackets();
 
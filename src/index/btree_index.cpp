@@ -11,6 +11,8 @@
 //===----------------------------------------------------------------------===//
 
 
+#include <algorithm>
+
 #include "index/btree_index.h"
 #include "index/index_key.h"
 #include "common/logger.h"
@@ -39,8 +41,7 @@ BTreeIndex<KeyType, ValueType, KeyComparator,
   // as the underlying index is unaware of shared_ptr,
   // memory allocated should be managed carefully by programmers.
   for (auto entry = container.begin(); entry != container.end(); ++entry) {
-    delete entry->second;
-    entry->second = nullptr;
+    IndexValue<ValueType>::Release(entry->second);
   }
 }
 
@@ -52,7 +53,8 @@ bool BTreeIndex<KeyType, ValueType, KeyComparator,
   KeyType index_key;
 
   index_key.SetFromKey(key);
-  std::pair<KeyType, ValueType> entry(index_key, new ItemPointer(location));
+  std::pair<KeyType, ValueType> entry(index_key,
+                                      IndexValue<ValueType>::Create(location));
 
   {
     index_lock.WriteLock();
@@ -87,12 +89,11 @@ bool BTreeIndex<KeyType, ValueType, KeyComparator,
       auto entries = container.equal_range(index_key);
       for (auto iterator = entries.first; iterator != entries.second;
            iterator++) {
-        ItemPointer value = *(iterator->second);
+        ItemPointer value = IndexValue<ValueType>::Get(iterator->second);
 
         if ((value.block == location.block) &&
             (value.offset == location.offset)) {
-          delete iterator->second;
-          iterator->second = nullptr;
+          IndexValue<ValueType>::Release(iterator->second);
           container.erase(iterator);
           // Set try again
           try_again = true;
@@ -121,7 +122,7 @@ bool BTreeIndex<KeyType, ValueType, KeyComparator, KeyEqualityChecker>::
     // find the <key, location> pair
     auto entries = container.equal_range(index_key);
     for (auto entry = entries.first; entry != entries.second; ++entry) {
-      ItemPointer item_pointer = *(entry->second);
+      ItemPointer item_pointer = IndexValue<ValueType>::Get(entry->second);
 
       if (predicate(item_pointer)) {
         // this key is already visible or dirty in the index
@@ -131,8 +132,8 @@ bool BTreeIndex<KeyType, ValueType, KeyComparator, KeyEqualityChecker>::
     }
 
     // Insert the key, val pair
-    container.insert(
-        std::pair<KeyType, ValueType>(index_key, new ItemPointer(location)));
+    container.insert(std::pair<KeyType, ValueType>(
+        index_key, IndexValue<ValueType>::Create(location)));
 
     index_lock.Unlock();
   }
@@ -140,6 +141,105 @@ bool BTreeIndex<KeyType, ValueType, KeyComparator, KeyEqualityChecker>::
   return true;
 }
 
+template <typename KeyType, typename ValueType, class KeyComparator,
+          class KeyEqualityChecker>
+void BTreeIndex<KeyType, ValueType, KeyComparator, KeyEqualityChecker>::
+    InsertEntries(const std::vector<const storage::Tuple *> &keys,
+                  const std::vector<ItemPointer> &locations) {
+  // Sort the entries outside the lock
+  auto entries = SortEntries(keys, locations);
+
+  {
+    index_lock.WriteLock();
+
+    LoadEntries(entries);
+
+    index_lock.Unlock();
+  }
+}
+
+template <typename KeyType, typename ValueType, class KeyComparator,
+          class KeyEqualityChecker>
+bool BTreeIndex<KeyType, ValueType, KeyComparator, KeyEqualityChecker>::
+    CondInsertEntries(const std::vector<const storage::Tuple *> &keys,
+                      const std::vector<ItemPointer> &locations) {
+  auto entries = SortEntries(keys, locations);
+
+  // equal keys of the batch are next to each other once sorted
+  bool duplicate = false;
+  for (size_t entry_itr = 1; entry_itr < entries.size(); entry_itr++) {
+    if (equals(entries[entry_itr - 1].first, entries[entry_itr].first)) {
+      duplicate = true;
+      break;
+    }
+  }
+
+  if (duplicate == false) {
+    index_lock.WriteLock();
+
+    if (container.empty() == false) {
+      for (auto &entry : entries) {
+        if (container.find(entry.first) != container.end()) {
+          duplicate = true;
+          break;
+        }
+      }
+    }
+
+    if (duplicate == false) LoadEntries(entries);
+
+    index_lock.Unlock();
+  }
+
+  if (duplicate == true) {
+    for (auto &entry : entries) {
+      IndexValue<ValueType>::Release(entry.second);
+    }
+    return false;
+  }
+
+  return true;
+}
+
+template <typename KeyType, typename ValueType, class KeyComparator,
+          class KeyEqualityChecker>
+std::vector<std::pair<KeyType, ValueType>>
+BTreeIndex<KeyType, ValueType, KeyComparator, KeyEqualityChecker>::SortEntries(
+    const std::vector<const storage::Tuple *> &keys,
+    const std::vector<ItemPointer> &locations) {
+  PL_ASSERT(keys.size() == locations.size());
+
+  std::vector<std::pair<KeyType, ValueType>> entries;
+  entries.reserve(keys.size());
+  for (size_t entry_itr = 0; entry_itr < keys.size(); entry_itr++) {
+    KeyType index_key;
+    index_key.SetFromKey(keys[entry_itr]);
+    entries.emplace_back(index_key,
+                         IndexValue<ValueType>::Create(locations[entry_itr]));
+  }
+
+  std::stable_sort(entries.begin(), entries.end(),
+                   [this](const std::pair<KeyType, ValueType> &lhs,
+                          const std::pair<KeyType, ValueType> &rhs) {
+                     return comparator(lhs.first, rhs.first);
+                   });
+  return entries;
+}
+
+template <typename KeyType, typename ValueType, class KeyComparator,
+          class KeyEqualityChecker>
+void BTreeIndex<KeyType, ValueType, KeyComparator, KeyEqualityChecker>::
+    LoadEntries(std::vector<std::pair<KeyType, ValueType>> &entries) {
+  // An empty tree is built bottom up from the sorted entries
+  if (container.empty()) {
+    container.bulk_load(entries.begin(), entries.end());
+  } else {
+    for (auto &entry : entries) {
+      container.insert(entry);
+    }
+  }
+}
+
 template <typename KeyType, typename ValueType, class KeyComparator,
           class KeyEqualityChecker>
 void BTreeIndex<KeyType, ValueType, KeyComparator, KeyEqualityChecker>::Scan(
@@ -261,7 +361,8 @@ void BTreeIndex<KeyType, ValueType, KeyComparator, KeyEqualityChecker>::Scan(
               // "expression types"
               // For instance, "5" EXPR_GREATER_THAN "2" is true
               if (Compare(tuple, key_column_ids, expr_types, values) == true) {
-                ItemPointer location_header = *(scan_itr->second);
+                ItemPointer location_header =
+                    IndexValue<ValueType>::Get(scan_itr->second);
                 result.push_back(location_header);
               }
             }
@@ -291,7 +392,8 @@ void BTreeIndex<KeyType, ValueType, KeyComparator, KeyEqualityChecker>::Scan(
             // "expression types"
             // For instance, "5" EXPR_GREATER_THAN "2" is true
             if (Compare(tuple, key_column_ids, expr_types, values) == true) {
-              ItemPointer location_header = *(scan_itr->second);
+              ItemPointer location_header =
+                    IndexValue<ValueType>::Get(scan_itr->second);
               result.push_back(location_header);
             }
           }
@@ -320,7 +422,7 @@ void BTreeIndex<KeyType, ValueType, KeyComparator,
 
     // scan all entries
     while (itr != container.end()) {
-      ItemPointer item_pointer = *(itr->second);
+      ItemPointer item_pointer = IndexValue<ValueType>::Get(itr->second);
 
       result.push_back(std::move(item_pointer));
       itr++;
@@ -343,7 +445,7 @@ void BTreeIndex<KeyType, ValueType, KeyComparator, KeyEqualityChecker>::ScanKey(
     // find the <key, location> pair
     auto entries = container.equal_range(index_key);
     for (auto entry = entries.first; entry != entries.second; ++entry) {
-      ItemPointer item_pointer = *(entry->second);
+      ItemPointer item_pointer = IndexValue<ValueType>::Get(entry->second);
 
       result.push_back(item_pointer);
     }
@@ -502,6 +604,13 @@ void BTreeIndex<KeyType, ValueType, KeyComparator, KeyEqualityChecker>::Scan(
     const std::vector<ExpressionType> &expr_types,
     const ScanDirectionType &scan_direction,
     std::vector<ItemPointer *> &result) {
+  // leaf nodes move entries around on splits and merges, so inline values
+  // have no stable address to hand out
+  if (IndexValue<ValueType>::is_inline == true) {
+    throw IndexException(
+        "B+tree index with inline values has no stable item pointers");
+  }
+
   // Check if we have leading (leftmost) column equality
   // refer : http://www.postgresql.org/docs/8.2/static/indexes-multicolumn.html
   //  oid_t leading_column_id = 0;
@@ -618,7 +727,8 @@ void BTreeIndex<KeyType, ValueType, KeyComparator, KeyEqualityChecker>::Scan(
               // "expression types"
               // For instance, "5" EXPR_GREATER_THAN "2" is true
               if (Compare(tuple, key_column_ids, expr_types, values) == true) {
-                ItemPointer *location_header = scan_itr->second;
+                ItemPointer *location_header =
+                    IndexValue<ValueType>::GetPointer(scan_itr->second);
                 result.push_back(location_header);
               }
             }
@@ -648,7 +758,8 @@ void BTreeIndex<KeyType, ValueType, KeyComparator, KeyEqualityChecker>::Scan(
             // "expression types"
             // For instance, "5" EXPR_GREATER_THAN "2" is true
             if (Compare(tuple, key_column_ids, expr_types, values) == true) {
-              ItemPointer *location_header = scan_itr->second;
+              ItemPointer *location_header =
+                    IndexValue<ValueType>::GetPointer(scan_itr->second);
               result.push_back(location_header);
             }
           }
@@ -670,6 +781,13 @@ template <typename KeyType, typename ValueType, class KeyComparator,
 void BTreeIndex<KeyType, ValueType, KeyComparator,
                 KeyEqualityChecker>::ScanAllKeys(std::vector<ItemPointer *> &
                                                      result) {
+  // leaf nodes move entries around on splits and merges, so inline values
+  // have no stable address to hand out
+  if (IndexValue<ValueType>::is_inline == true) {
+    throw IndexException(
+        "B+tree index with inline values has no stable item pointers");
+  }
+
   {
     index_lock.ReadLock();
 
@@ -677,7 +795,7 @@ void BTreeIndex<KeyType, ValueType, KeyComparator,
 
     // scan all entries
     while (itr != container.end()) {
-      ItemPointer *location = itr->second;
+      ItemPointer *location = IndexValue<ValueType>::GetPointer(itr->second);
       result.push_back(location);
       itr++;
     }
@@ -693,6 +811,13 @@ template <typename KeyType, typename ValueType, class KeyComparator,
           class KeyEqualityChecker>
 void BTreeIndex<KeyType, ValueType, KeyComparator, KeyEqualityChecker>::ScanKey(
     const storage::Tuple *key, std::vector<ItemPointer *> &result) {
+  // leaf nodes move entries around on splits and merges, so inline values
+  // have no stable address to hand out
+  if (IndexValue<ValueType>::is_inline == true) {
+    throw IndexException(
+        "B+tree index with inline values has no stable item pointers");
+  }
+
   KeyType index_key;
   index_key.SetFromKey(key);
 
@@ -702,7 +827,7 @@ void BTreeIndex<KeyType, ValueType, KeyComparator, KeyEqualityChecker>::ScanKey(
     // find the <key, location> pair
     auto entries = container.equal_range(index_key);
     for (auto entry = entries.first; entry != entries.second; ++entry) {
-      result.push_back(entry->second);
+      result.push_back(IndexValue<ValueType>::GetPointer(entry->second));
     }
 
     index_lock.Unlock();
@@ -734,5 +859,19 @@ template class BTreeIndex<GenericKey<256>, ItemPointer *,
 template class BTreeIndex<TupleKey, ItemPointer *, TupleKeyComparator,
                           TupleKeyEqualityChecker>;
 
+template class BTreeIndex<GenericKey<4>, ItemPointer, GenericComparator<4>,
+                          GenericEqualityChecker<4>>;
+template class BTreeIndex<GenericKey<8>, ItemPointer, GenericComparator<8>,
+                          GenericEqualityChecker<8>>;
+template class BTreeIndex<GenericKey<16>, ItemPointer, GenericComparator<16>,
+                          GenericEqualityChecker<16>>;
+template class BTreeIndex<GenericKey<64>, ItemPointer, GenericComparator<64>,
+                          GenericEqualityChecker<64>>;
+template class BTreeIndex<GenericKey<256>, ItemPointer,
+                          GenericComparator<256>, GenericEqualityChecker<256>>;
+
+template class BTreeIndex<TupleKey, ItemPointer, TupleKeyComparator,
+                          TupleKeyEqualityChecker>;
+
 }  // End index namespace
 }  // End peloton namespace
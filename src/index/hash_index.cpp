@@ -0,0 +1,329 @@
+//===----------------------------------------------------------------------===//
+//
+//                         Peloton
+//
+// hash_index.cpp
+//
+// Identification: src/index/hash_index.cpp
+//
+// Copyright (c) 2015-16, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+
+#include <algorithm>
+
+#include "index/hash_index.h"
+#include "index/index_key.h"
+#include "common/exception.h"
+#include "common/logger.h"
+#include "storage/tuple.h"
+
+namespace peloton {
+namespace index {
+
+template <typename KeyType, typename ValueType, class KeyHasher,
+          class KeyEqualityChecker>
+HashIndex<KeyType, ValueType, KeyHasher, KeyEqualityChecker>::HashIndex(
+    IndexMetadata *metadata)
+    : Index(metadata), container(), indexed_tile_group_offset_(-1) {}
+
+template <typename KeyType, typename ValueType, class KeyHasher,
+          class KeyEqualityChecker>
+HashIndex<KeyType, ValueType, KeyHasher, KeyEqualityChecker>::~HashIndex() {
+  // the values are heap-allocated item pointers owned by the index
+  auto locked_container = container.lock_table();
+  for (auto &entry : locked_container) {
+    for (auto value : entry.second) {
+      delete value;
+    }
+  }
+}
+
+template <typename KeyType, typename ValueType, class KeyHasher,
+          class KeyEqualityChecker>
+bool HashIndex<KeyType, ValueType, KeyHasher, KeyEqualityChecker>::InsertEntry(
+    const storage::Tuple *key, const ItemPointer &location) {
+  KeyType index_key;
+  index_key.SetFromKey(key);
+
+  ValueType value = new ItemPointer(location);
+
+  // Append to the list of an existing key, or insert a new list
+  container.upsert(index_key,
+                   [value](ValueList &values) { values.push_back(value); },
+                   ValueList(1, value));
+
+  return true;
+}
+
+template <typename KeyType, typename ValueType, class KeyHasher,
+          class KeyEqualityChecker>
+bool HashIndex<KeyType, ValueType, KeyHasher, KeyEqualityChecker>::DeleteEntry(
+    const storage::Tuple *key, const ItemPointer &location) {
+  KeyType index_key;
+  index_key.SetFromKey(key);
+
+  // Delete the < key, location > pairs. The key goes away together with
+  // its last location, under the same bucket lock a concurrent insert of
+  // the key would take.
+  container.erase_fn(index_key, [&location](ValueList &values) {
+    auto values_itr = values.begin();
+    while (values_itr != values.end()) {
+      ItemPointer *value = *values_itr;
+      if ((value->block == location.block) &&
+          (value->offset == location.offset)) {
+        delete value;
+        values_itr = values.erase(values_itr);
+      } else {
+        values_itr++;
+      }
+    }
+    return values.empty();
+  });
+
+  return true;
+}
+
+template <typename KeyType, typename ValueType, class KeyHasher,
+          class KeyEqualityChecker>
+bool HashIndex<KeyType, ValueType, KeyHasher, KeyEqualityChecker>::
+    CondInsertEntry(const storage::Tuple *key, const ItemPointer &location,
+                    std::function<bool(const ItemPointer &)> predicate) {
+  KeyType index_key;
+  index_key.SetFromKey(key);
+
+  ValueType value = new ItemPointer(location);
+  bool inserted = true;
+
+  // The predicate is evaluated while holding the bucket lock
+  container.upsert(index_key, [&](ValueList &values) {
+    for (auto existing_value : values) {
+      if (predicate(*existing_value)) {
+        // this key is already visible or dirty in the index
+        inserted = false;
+        return;
+      }
+    }
+    values.push_back(value);
+  }, ValueList(1, value));
+
+  if (inserted == false) {
+    delete value;
+  }
+
+  return inserted;
+}
+
+template <typename KeyType, typename ValueType, class KeyHasher,
+          class KeyEqualityChecker>
+std::unique_ptr<storage::Tuple>
+HashIndex<KeyType, ValueType, KeyHasher, KeyEqualityChecker>::GetScanKey(
+    const std::vector<Value> &values, const std::vector<oid_t> &key_column_ids,
+    const std::vector<ExpressionType> &expr_types) {
+  auto key_schema = metadata->GetKeySchema();
+  std::vector<bool> bound_columns(key_schema->GetColumnCount(), false);
+
+  std::unique_ptr<storage::Tuple> scan_key(new storage::Tuple(key_schema, true));
+
+  for (size_t column_itr = 0; column_itr < key_column_ids.size();
+       column_itr++) {
+    if (expr_types[column_itr] != EXPRESSION_TYPE_COMPARE_EQUAL) {
+      continue;
+    }
+
+    auto key_column_id = key_column_ids[column_itr];
+    scan_key->SetValue(key_column_id, values[column_itr], GetPool());
+    bound_columns[key_column_id] = true;
+  }
+
+  PL_ASSERT(std::find(bound_columns.begin(), bound_columns.end(), false) ==
+            bound_columns.end());
+
+  return scan_key;
+}
+
+template <typename KeyType, typename ValueType, class KeyHasher,
+          class KeyEqualityChecker>
+bool HashIndex<KeyType, ValueType, KeyHasher, KeyEqualityChecker>::
+    SupportsScan(const std::vector<oid_t> &key_column_ids,
+                 const std::vector<ExpressionType> &expr_types) const {
+  std::vector<bool> bound_columns(metadata->GetKeySchema()->GetColumnCount(),
+                                  false);
+
+  for (size_t column_itr = 0; column_itr < key_column_ids.size();
+       column_itr++) {
+    if (expr_types[column_itr] == EXPRESSION_TYPE_COMPARE_EQUAL) {
+      bound_columns[key_column_ids[column_itr]] = true;
+    }
+  }
+
+  return std::find(bound_columns.begin(), bound_columns.end(), false) ==
+         bound_columns.end();
+}
+
+template <typename KeyType, typename ValueType, class KeyHasher,
+          class KeyEqualityChecker>
+void HashIndex<KeyType, ValueType, KeyHasher, KeyEqualityChecker>::
+    ScanMatchingKeys(const std::vector<Value> &values,
+                     const std::vector<oid_t> &key_column_ids,
+                     const std::vector<ExpressionType> &expr_types,
+                     std::function<void(const ValueList &)> callback) {
+  auto key_schema = metadata->GetKeySchema();
+  auto locked_container = container.lock_table();
+
+  for (auto &entry : locked_container) {
+    auto scan_current_key = entry.first;
+    auto tuple = scan_current_key.GetTupleForComparison(key_schema);
+
+    if (Compare(tuple, key_column_ids, expr_types, values) == true) {
+      callback(entry.second);
+    }
+  }
+}
+
+template <typename KeyType, typename ValueType, class KeyHasher,
+          class KeyEqualityChecker>
+void HashIndex<KeyType, ValueType, KeyHasher, KeyEqualityChecker>::Scan(
+    const std::vector<Value> &values, const std::vector<oid_t> &key_column_ids,
+    const std::vector<ExpressionType> &expr_types,
+    UNUSED_ATTRIBUTE const ScanDirectionType &scan_direction,
+    std::vector<ItemPointer> &result) {
+  if (SupportsScan(key_column_ids, expr_types) == false) {
+    ScanMatchingKeys(values, key_column_ids, expr_types,
+                     [&result](const ValueList &entry_values) {
+      for (auto value : entry_values) {
+        result.push_back(*value);
+      }
+    });
+    return;
+  }
+
+  auto scan_key = GetScanKey(values, key_column_ids, expr_types);
+
+  // Any remaining predicates only depend on the key itself
+  if (Compare(*scan_key, key_column_ids, expr_types, values) == false) {
+    return;
+  }
+
+  ScanKey(scan_key.get(), result);
+}
+
+template <typename KeyType, typename ValueType, class KeyHasher,
+          class KeyEqualityChecker>
+void HashIndex<KeyType, ValueType, KeyHasher, KeyEqualityChecker>::ScanAllKeys(
+    std::vector<ItemPointer> &result) {
+  auto locked_container = container.lock_table();
+
+  // scan all entries
+  for (auto &entry : locked_container) {
+    for (auto value : entry.second) {
+      result.push_back(*value);
+    }
+  }
+}
+
+template <typename KeyType, typename ValueType, class KeyHasher,
+          class KeyEqualityChecker>
+void HashIndex<KeyType, ValueType, KeyHasher, KeyEqualityChecker>::ScanKey(
+    const storage::Tuple *key, std::vector<ItemPointer> &result) {
+  KeyType index_key;
+  index_key.SetFromKey(key);
+
+  // update_fn keeps the bucket locked while we copy out the locations
+  container.update_fn(index_key, [&result](ValueList &values) {
+    for (auto value : values) {
+      result.push_back(*value);
+    }
+  });
+}
+
+template <typename KeyType, typename ValueType, class KeyHasher,
+          class KeyEqualityChecker>
+void HashIndex<KeyType, ValueType, KeyHasher, KeyEqualityChecker>::Scan(
+    const std::vector<Value> &values, const std::vector<oid_t> &key_column_ids,
+    const std::vector<ExpressionType> &expr_types,
+    UNUSED_ATTRIBUTE const ScanDirectionType &scan_direction,
+    std::vector<ItemPointer *> &result) {
+  if (SupportsScan(key_column_ids, expr_types) == false) {
+    ScanMatchingKeys(values, key_column_ids, expr_types,
+                     [&result](const ValueList &entry_values) {
+      result.insert(result.end(), entry_values.begin(), entry_values.end());
+    });
+    return;
+  }
+
+  auto scan_key = GetScanKey(values, key_column_ids, expr_types);
+
+  // Any remaining predicates only depend on the key itself
+  if (Compare(*scan_key, key_column_ids, expr_types, values) == false) {
+    return;
+  }
+
+  ScanKey(scan_key.get(), result);
+}
+
+template <typename KeyType, typename ValueType, class KeyHasher,
+          class KeyEqualityChecker>
+void HashIndex<KeyType, ValueType, KeyHasher, KeyEqualityChecker>::ScanAllKeys(
+    std::vector<ItemPointer *> &result) {
+  auto locked_container = container.lock_table();
+
+  // scan all entries
+  for (auto &entry : locked_container) {
+    result.insert(result.end(), entry.second.begin(), entry.second.end());
+  }
+}
+
+template <typename KeyType, typename ValueType, class KeyHasher,
+          class KeyEqualityChecker>
+void HashIndex<KeyType, ValueType, KeyHasher, KeyEqualityChecker>::ScanKey(
+    const storage::Tuple *key, std::vector<ItemPointer *> &result) {
+  KeyType index_key;
+  index_key.SetFromKey(key);
+
+  container.update_fn(index_key, [&result](ValueList &values) {
+    result.insert(result.end(), values.begin(), values.end());
+  });
+}
+
+template <typename KeyType, typename ValueType, class KeyHasher,
+          class KeyEqualityChecker>
+size_t HashIndex<KeyType, ValueType, KeyHasher,
+                 KeyEqualityChecker>::GetMemoryFootprint() {
+  auto locked_container = container.lock_table();
+
+  size_t memory_footprint = 0;
+  for (auto &entry : locked_container) {
+    memory_footprint += sizeof(KeyType) + sizeof(ValueList) +
+                        entry.second.capacity() * sizeof(ValueType) +
+                        entry.second.size() * sizeof(ItemPointer);
+  }
+
+  return memory_footprint;
+}
+
+template <typename KeyType, typename ValueType, class KeyHasher,
+          class KeyEqualityChecker>
+std::string HashIndex<KeyType, ValueType, KeyHasher,
+                      KeyEqualityChecker>::GetTypeName() const {
+  return "Hash";
+}
+
+// Explicit template instantiation
+template class HashIndex<GenericKey<4>, ItemPointer *, GenericHasher<4>,
+                         GenericEqualityChecker<4>>;
+template class HashIndex<GenericKey<8>, ItemPointer *, GenericHasher<8>,
+                         GenericEqualityChecker<8>>;
+template class HashIndex<GenericKey<16>, ItemPointer *, GenericHasher<16>,
+                         GenericEqualityChecker<16>>;
+template class HashIndex<GenericKey<64>, ItemPointer *, GenericHasher<64>,
+                         GenericEqualityChecker<64>>;
+template class HashIndex<GenericKey<256>, ItemPointer *, GenericHasher<256>,
+                         GenericEqualityChecker<256>>;
+
+template class HashIndex<TupleKey, ItemPointer *, TupleKeyHasher,
+                         TupleKeyEqualityChecker>;
+
+}  // End index namespace
+}  // End peloton namespace
@@ -249,6 +249,36 @@ const std::string Index::GetInfo() const {
   return os.str();
 }
 
+void Index::InsertEntries(const std::vector<const storage::Tuple *> &keys,
+                          const std::vector<ItemPointer> &locations) {
+  PL_ASSERT(keys.size() == locations.size());
+  for (size_t entry_itr = 0; entry_itr < keys.size(); entry_itr++) {
+    InsertEntry(keys[entry_itr], locations[entry_itr]);
+  }
+}
+
+bool Index::CondInsertEntries(const std::vector<const storage::Tuple *> &keys,
+                              const std::vector<ItemPointer> &locations) {
+  PL_ASSERT(keys.size() == locations.size());
+  std::vector<ItemPointer> existing_locations;
+  size_t entry_itr = 0;
+  for (; entry_itr < keys.size(); entry_itr++) {
+    existing_locations.clear();
+    ScanKey(keys[entry_itr], existing_locations);
+    if (existing_locations.empty() == false) break;
+
+    InsertEntry(keys[entry_itr], locations[entry_itr]);
+  }
+
+  if (entry_itr == keys.size()) return true;
+
+  // take back the entries inserted before the duplicate
+  while (entry_itr-- > 0) {
+    DeleteEntry(keys[entry_itr], locations[entry_itr]);
+  }
+  return false;
+}
+
 /**
  * @brief Increase the number of tuples in this table
  * @param amount amount to increase
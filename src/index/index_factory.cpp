@@ -19,11 +19,71 @@
 #include "index/index_factory.h"
 #include "index/index_key.h"
 #include "index/btree_index.h"
+#include "index/bwtree_index.h"
+#include "index/hash_index.h"
 #include "index/skip_list_index.h"
 
 namespace peloton {
 namespace index {
 
+IndexStorageType IndexFactory::index_storage_type_ = INDEX_STORAGE_TYPE_INLINE;
+
+// The primary index keeps its locations out of line even in inline mode,
+// index scans use their stable addresses to shortcut the version chains.
+static bool UseInlineValues(IndexMetadata *metadata) {
+  return IndexFactory::GetIndexStorageType() == INDEX_STORAGE_TYPE_INLINE &&
+         metadata->GetIndexType() != INDEX_CONSTRAINT_TYPE_PRIMARY_KEY;
+}
+
+template <typename ValueType>
+static Index *CreateBTreeIndex(IndexMetadata *metadata, oid_t key_size) {
+  if (key_size <= 4) {
+    return new BTreeIndex<GenericKey<4>, ValueType, GenericComparator<4>,
+                          GenericEqualityChecker<4>>(metadata);
+  } else if (key_size <= 8) {
+    return new BTreeIndex<GenericKey<8>, ValueType, GenericComparator<8>,
+                          GenericEqualityChecker<8>>(metadata);
+  } else if (key_size <= 16) {
+    return new BTreeIndex<GenericKey<16>, ValueType, GenericComparator<16>,
+                          GenericEqualityChecker<16>>(metadata);
+  } else if (key_size <= 64) {
+    return new BTreeIndex<GenericKey<64>, ValueType, GenericComparator<64>,
+                          GenericEqualityChecker<64>>(metadata);
+  } else if (key_size <= 256) {
+    return new BTreeIndex<GenericKey<256>, ValueType, GenericComparator<256>,
+                          GenericEqualityChecker<256>>(metadata);
+  } else {
+    return new BTreeIndex<TupleKey, ValueType, TupleKeyComparator,
+                          TupleKeyEqualityChecker>(metadata);
+  }
+}
+
+template <typename ValueType>
+static Index *CreateSkipListIndex(IndexMetadata *metadata, oid_t key_size) {
+  if (key_size <= 4) {
+    return new SkipListIndex<GenericKey<4>, ValueType, GenericComparatorRaw<4>,
+                             GenericEqualityChecker<4>>(metadata);
+  } else if (key_size <= 8) {
+    return new SkipListIndex<GenericKey<8>, ValueType, GenericComparatorRaw<8>,
+                             GenericEqualityChecker<8>>(metadata);
+  } else if (key_size <= 16) {
+    return new SkipListIndex<GenericKey<16>, ValueType,
+                             GenericComparatorRaw<16>,
+                             GenericEqualityChecker<16>>(metadata);
+  } else if (key_size <= 64) {
+    return new SkipListIndex<GenericKey<64>, ValueType,
+                             GenericComparatorRaw<64>,
+                             GenericEqualityChecker<64>>(metadata);
+  } else if (key_size <= 256) {
+    return new SkipListIndex<GenericKey<256>, ValueType,
+                             GenericComparatorRaw<256>,
+                             GenericEqualityChecker<256>>(metadata);
+  } else {
+    return new SkipListIndex<TupleKey, ValueType, TupleKeyComparatorRaw,
+                             TupleKeyEqualityChecker>(metadata);
+  }
+}
+
 Index *IndexFactory::GetInstance(IndexMetadata *metadata) {
 
   LOG_TRACE("Creating index %s", metadata->GetName().c_str());
@@ -34,58 +94,68 @@ Index *IndexFactory::GetInstance(IndexMetadata *metadata) {
   LOG_TRACE("Index type : %d", index_type);
 
   if (index_type == INDEX_TYPE_BTREE) {
+    if (UseInlineValues(metadata)) {
+      return CreateBTreeIndex<ItemPointer>(metadata, key_size);
+    }
+    return CreateBTreeIndex<ItemPointer *>(metadata, key_size);
+  }
+
+  if (index_type == INDEX_TYPE_BWTREE) {
 
     if (key_size <= 4) {
-      return new BTreeIndex<GenericKey<4>, ItemPointer *, GenericComparator<4>,
-                            GenericEqualityChecker<4>>(metadata);
+      return new BWTreeIndex<GenericKey<4>, ItemPointer *, GenericComparator<4>,
+                             GenericEqualityChecker<4>>(metadata);
     } else if (key_size <= 8) {
-      return new BTreeIndex<GenericKey<8>, ItemPointer *, GenericComparator<8>,
-                            GenericEqualityChecker<8>>(metadata);
+      return new BWTreeIndex<GenericKey<8>, ItemPointer *, GenericComparator<8>,
+                             GenericEqualityChecker<8>>(metadata);
     } else if (key_size <= 16) {
-      return new BTreeIndex<GenericKey<16>, ItemPointer *,
-                            GenericComparator<16>, GenericEqualityChecker<16>>(
+      return new BWTreeIndex<GenericKey<16>, ItemPointer *,
+                             GenericComparator<16>, GenericEqualityChecker<16>>(
           metadata);
     } else if (key_size <= 64) {
-      return new BTreeIndex<GenericKey<64>, ItemPointer *,
-                            GenericComparator<64>, GenericEqualityChecker<64>>(
+      return new BWTreeIndex<GenericKey<64>, ItemPointer *,
+                             GenericComparator<64>, GenericEqualityChecker<64>>(
           metadata);
     } else if (key_size <= 256) {
-      return new BTreeIndex<GenericKey<256>, ItemPointer *,
-                            GenericComparator<256>,
-                            GenericEqualityChecker<256>>(metadata);
+      return new BWTreeIndex<GenericKey<256>, ItemPointer *,
+                             GenericComparator<256>,
+                             GenericEqualityChecker<256>>(metadata);
     } else {
-      return new BTreeIndex<TupleKey, ItemPointer *, TupleKeyComparator,
-                            TupleKeyEqualityChecker>(metadata);
+      return new BWTreeIndex<TupleKey, ItemPointer *, TupleKeyComparator,
+                             TupleKeyEqualityChecker>(metadata);
     }
   }
 
   if (index_type == INDEX_TYPE_SKIPLIST) {
+    if (UseInlineValues(metadata)) {
+      return CreateSkipListIndex<ItemPointer>(metadata, key_size);
+    }
+    return CreateSkipListIndex<ItemPointer *>(metadata, key_size);
+  }
+
+  if (index_type == INDEX_TYPE_HASH) {
 
     if (key_size <= 4) {
-      return new SkipListIndex<GenericKey<4>, ItemPointer *, GenericComparatorRaw<4>,
-                            GenericEqualityChecker<4>>(metadata);
+      return new HashIndex<GenericKey<4>, ItemPointer *, GenericHasher<4>,
+                           GenericEqualityChecker<4>>(metadata);
     } else if (key_size <= 8) {
-      return new SkipListIndex<GenericKey<8>, ItemPointer *, GenericComparatorRaw<8>,
-                            GenericEqualityChecker<8>>(metadata);
+      return new HashIndex<GenericKey<8>, ItemPointer *, GenericHasher<8>,
+                           GenericEqualityChecker<8>>(metadata);
     } else if (key_size <= 16) {
-      return new SkipListIndex<GenericKey<16>, ItemPointer *,
-                            GenericComparatorRaw<16>, GenericEqualityChecker<16>>(
-          metadata);
+      return new HashIndex<GenericKey<16>, ItemPointer *, GenericHasher<16>,
+                           GenericEqualityChecker<16>>(metadata);
     } else if (key_size <= 64) {
-      return new SkipListIndex<GenericKey<64>, ItemPointer *,
-                            GenericComparatorRaw<64>, GenericEqualityChecker<64>>(
-          metadata);
+      return new HashIndex<GenericKey<64>, ItemPointer *, GenericHasher<64>,
+                           GenericEqualityChecker<64>>(metadata);
     } else if (key_size <= 256) {
-      return new SkipListIndex<GenericKey<256>, ItemPointer *,
-                            GenericComparatorRaw<256>,
-                            GenericEqualityChecker<256>>(metadata);
+      return new HashIndex<GenericKey<256>, ItemPointer *, GenericHasher<256>,
+                           GenericEqualityChecker<256>>(metadata);
     } else {
-      return new SkipListIndex<TupleKey, ItemPointer *, TupleKeyComparatorRaw,
-                            TupleKeyEqualityChecker>(metadata);
+      return new HashIndex<TupleKey, ItemPointer *, TupleKeyHasher,
+                           TupleKeyEqualityChecker>(metadata);
     }
   }
 
-
   throw IndexException("Unsupported index scheme.");
   return NULL;
 }
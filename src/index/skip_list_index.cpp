@@ -42,8 +42,7 @@ KeyEqualityChecker>::~SkipListIndex() {
   // memory allocated should be managed carefully by programmers.
   auto iterator = container.begin();
   for (; iterator != container.end(); ++iterator) {
-    delete iterator->second;
-    iterator->second = nullptr;
+    IndexValue<ValueType>::Release(iterator->second);
   }
 
 }
@@ -57,7 +56,8 @@ KeyEqualityChecker>::InsertEntry(const storage::Tuple *key,
   index_key.SetFromKey(key);
 
   // Insert the key, val pair
-  auto status = container.Insert(index_key, new ItemPointer(location));
+  auto status = container.Insert(index_key,
+                                 IndexValue<ValueType>::Create(location));
 
   return status;
 }
@@ -81,7 +81,8 @@ CondInsertEntry(const storage::Tuple *key, const ItemPointer &location,
 
   // Insert the key if it does not exist
   const bool bInsert = false;
-  auto status = container.Update(index_key, new ItemPointer(location), bInsert);
+  auto status = container.Update(
+      index_key, IndexValue<ValueType>::Create(location), bInsert);
 
   return status;
 }
@@ -204,7 +205,8 @@ void SkipListIndex<KeyType, ValueType, KeyComparator, KeyEqualityChecker>::Scan(
             // "expression types"
             // For instance, "5" EXPR_GREATER_THAN "2" is true
             if (Compare(tuple, key_column_ids, expr_types, values) == true) {
-              ItemPointer location_header = *(scan_itr->second);
+              ItemPointer location_header =
+                  IndexValue<ValueType>::Get(scan_itr->second);
               result.push_back(location_header);
             }
           }
@@ -235,7 +237,8 @@ void SkipListIndex<KeyType, ValueType, KeyComparator, KeyEqualityChecker>::Scan(
           // "expression types"
           // For instance, "5" EXPR_GREATER_THAN "2" is true
           if (Compare(tuple, key_column_ids, expr_types, values) == true) {
-            ItemPointer location_header = *(scan_itr->second);
+            ItemPointer location_header =
+                  IndexValue<ValueType>::Get(scan_itr->second);
             result.push_back(location_header);
           }
         }
@@ -259,7 +262,7 @@ KeyEqualityChecker>::ScanAllKeys(std::vector<ItemPointer> &
   // scan all entries
   auto iterator = container.begin();
   for (; iterator != container.end(); ++iterator) {
-    ItemPointer item_pointer = *(iterator->second);
+    ItemPointer item_pointer = IndexValue<ValueType>::Get(iterator->second);
     result.push_back(std::move(item_pointer));
   }
 
@@ -275,7 +278,7 @@ void SkipListIndex<KeyType, ValueType, KeyComparator, KeyEqualityChecker>::ScanK
   // find the <key, location> pair
   auto iterator = container.Contains(index_key);
   if(iterator != container.end()) {
-    ItemPointer item_pointer = *(iterator->second);
+    ItemPointer item_pointer = IndexValue<ValueType>::Get(iterator->second);
     result.push_back(item_pointer);
   }
 
@@ -577,7 +580,8 @@ void SkipListIndex<KeyType, ValueType, KeyComparator, KeyEqualityChecker>::Scan(
             // "expression types"
             // For instance, "5" EXPR_GREATER_THAN "2" is true
             if (Compare(tuple, key_column_ids, expr_types, values) == true) {
-              ItemPointer *location_header = scan_itr->second;
+              ItemPointer *location_header =
+                  IndexValue<ValueType>::GetPointer(scan_itr->second);
               result.push_back(location_header);
             }
           }
@@ -610,7 +614,8 @@ void SkipListIndex<KeyType, ValueType, KeyComparator, KeyEqualityChecker>::Scan(
           // "expression types"
           // For instance, "5" EXPR_GREATER_THAN "2" is true
           if (Compare(tuple, key_column_ids, expr_types, values) == true) {
-            ItemPointer *location_header = scan_itr->second;
+            ItemPointer *location_header =
+                  IndexValue<ValueType>::GetPointer(scan_itr->second);
             result.push_back(location_header);
           }
         }
@@ -636,7 +641,7 @@ KeyEqualityChecker>::ScanAllKeys(std::vector<ItemPointer *> &
   // scan all entries
   auto iterator = container.begin();
   for (; iterator != container.end(); ++iterator) {
-    ItemPointer *location = iterator->second;
+    ItemPointer *location = IndexValue<ValueType>::GetPointer(iterator->second);
     result.push_back(location);
   }
 
@@ -655,7 +660,7 @@ void SkipListIndex<KeyType, ValueType, KeyComparator, KeyEqualityChecker>::ScanK
   // find the <key, location> pair
   auto iterator = container.Contains(index_key);
   if(iterator != container.end()) {
-    result.push_back(iterator->second);
+    result.push_back(IndexValue<ValueType>::GetPointer(iterator->second));
   }
 
 }
@@ -685,6 +690,20 @@ GenericComparatorRaw<256>, GenericEqualityChecker<256>>;
 template class SkipListIndex<TupleKey, ItemPointer *, TupleKeyComparatorRaw,
 TupleKeyEqualityChecker>;
 
+template class SkipListIndex<GenericKey<4>, ItemPointer, GenericComparatorRaw<4>,
+GenericEqualityChecker<4>>;
+template class SkipListIndex<GenericKey<8>, ItemPointer, GenericComparatorRaw<8>,
+GenericEqualityChecker<8>>;
+template class SkipListIndex<GenericKey<16>, ItemPointer, GenericComparatorRaw<16>,
+GenericEqualityChecker<16>>;
+template class SkipListIndex<GenericKey<64>, ItemPointer, GenericComparatorRaw<64>,
+GenericEqualityChecker<64>>;
+template class SkipListIndex<GenericKey<256>, ItemPointer,
+GenericComparatorRaw<256>, GenericEqualityChecker<256>>;
+
+template class SkipListIndex<TupleKey, ItemPointer, TupleKeyComparatorRaw,
+TupleKeyEqualityChecker>;
+
 
 }  // End index namespace
 }  // End peloton namespace
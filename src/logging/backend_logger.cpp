@@ -118,6 +118,14 @@ void BackendLogger::Log(LogRecord *record) {
   }
 
   this->log_buffer_lock.Unlock();
+
+  // let the frontend logger know that a commit is ready to be flushed
+  if (record->GetType() == LOGRECORD_TYPE_TRANSACTION_COMMIT &&
+      frontend_logger_id != -1) {
+    LogManager::GetInstance()
+        .GetFrontendLoggersList()[frontend_logger_id]
+        ->NotifyCommit();
+  }
 }
 
 // used by the frontend logger to collect data on the current state of the
@@ -15,6 +15,7 @@
 #include "logging/checkpoint.h"
 #include "logging/logging_util.h"
 #include "logging/checkpoint/simple_checkpoint.h"
+#include "logging/checkpoint/streaming_checkpoint.h"
 #include "logging/log_manager.h"
 #include "logging/checkpoint_manager.h"
 #include "logging/backend_logger.h"
@@ -102,9 +103,13 @@ std::unique_ptr<Checkpoint> Checkpoint::GetCheckpoint(
   if (checkpoint_type == CHECKPOINT_TYPE_NORMAL) {
     std::unique_ptr<Checkpoint> checkpoint(
         new SimpleCheckpoint(disable_file_access));
-    return std::move(checkpoint);
+    return checkpoint;
+  } else if (checkpoint_type == CHECKPOINT_TYPE_STREAMING) {
+    std::unique_ptr<Checkpoint> checkpoint(
+        new StreamingCheckpoint(disable_file_access));
+    return checkpoint;
   }
-  return std::move(std::unique_ptr<Checkpoint>(nullptr));
+  return std::unique_ptr<Checkpoint>(nullptr);
 }
 
 void Checkpoint::RecoverTuple(storage::Tuple *tuple, storage::DataTable *table,
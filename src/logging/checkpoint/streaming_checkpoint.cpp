@@ -0,0 +1,579 @@
+//===----------------------------------------------------------------------===//
+//
+//                         Peloton
+//
+// streaming_checkpoint.cpp
+//
+// Identification: src/logging/checkpoint/streaming_checkpoint.cpp
+//
+// Copyright (c) 2015-16, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+
+#include <dirent.h>
+#include <stdio.h>
+
+#include <algorithm>
+#include <thread>
+
+#include "logging/checkpoint/streaming_checkpoint.h"
+#include "logging/checkpoint_tile_scanner.h"
+#include "logging/checkpoint_manager.h"
+#include "logging/log_manager.h"
+#include "logging/logging_util.h"
+
+#include "catalog/manager.h"
+#include "concurrency/transaction_manager_factory.h"
+#include "storage/database.h"
+#include "storage/data_table.h"
+#include "storage/tile.h"
+#include "storage/tile_group.h"
+#include "storage/tile_group_header.h"
+#include "storage/tuple.h"
+
+#include "common/logger.h"
+
+namespace peloton {
+namespace logging {
+
+//===--------------------------------------------------------------------===//
+// Streaming Checkpoint
+//===--------------------------------------------------------------------===//
+
+StreamingCheckpoint::StreamingCheckpoint(bool disable_file_access)
+    : Checkpoint(disable_file_access), max_oid_(0) {
+  file_count_ = std::max<size_t>(
+      1, std::min<size_t>(std::thread::hardware_concurrency(),
+                          STREAMING_CHECKPOINT_MAX_FILE_COUNT));
+  InitDirectory();
+  InitVersionNumber();
+}
+
+StreamingCheckpoint::~StreamingCheckpoint() {}
+
+void StreamingCheckpoint::DoCheckpoint() {
+  auto &log_manager = LogManager::GetInstance();
+  start_commit_id_ = log_manager.GetGlobalMaxFlushedCommitId();
+  if (start_commit_id_ == INVALID_CID) {
+    auto &txn_manager = concurrency::TransactionManagerFactory::GetInstance();
+    start_commit_id_ = txn_manager.GetMaxCommittedCid();
+  }
+
+  LOG_TRACE("DoCheckpoint cid = %lu", start_commit_id_);
+
+  // Collect the tile groups of all tables
+  std::vector<TileGroupItem> items;
+  auto &catalog_manager = catalog::Manager::GetInstance();
+  auto database_count = catalog_manager.GetDatabaseCount();
+  for (oid_t database_idx = 0; database_idx < database_count; database_idx++) {
+    auto database = catalog_manager.GetDatabase(database_idx);
+    auto table_count = database->GetTableCount();
+
+    for (oid_t table_idx = 0; table_idx < table_count; table_idx++) {
+      storage::DataTable *target_table = database->GetTable(table_idx);
+      PL_ASSERT(target_table);
+      auto tile_group_count = target_table->GetTileGroupCount();
+      for (oid_t tile_group_offset = START_OID;
+           tile_group_offset < tile_group_count; tile_group_offset++) {
+        auto tile_group = target_table->GetTileGroup(tile_group_offset);
+        if (tile_group == nullptr) {
+          continue;
+        }
+        items.push_back(TileGroupItem{database->GetOid(),
+                                      target_table->GetOid(), tile_group});
+      }
+    }
+  }
+
+  // Stream the tile groups into the data files, one thread per file
+  checkpoint_version++;
+  size_t file_count = std::max<size_t>(1, std::min(file_count_, items.size()));
+  std::atomic<size_t> next_item(0);
+  std::vector<char> file_status(file_count, false);
+  std::vector<std::thread> writers;
+  for (size_t file_itr = 0; file_itr < file_count; file_itr++) {
+    writers.emplace_back([this, file_itr, &items, &next_item, &file_status] {
+      file_status[file_itr] = WriteDataFile(file_itr, items, next_item);
+    });
+  }
+  for (auto &writer : writers) {
+    writer.join();
+  }
+
+  if (!disable_file_access) {
+    // The checkpoint only exists once its manifest is written
+    bool success = std::all_of(file_status.begin(), file_status.end(),
+                               [](char status) { return status != 0; });
+    if (success == false || WriteManifest(file_count) == false) {
+      LOG_ERROR("Failed to write checkpoint version %d", checkpoint_version);
+      return;
+    }
+    RemovePreviousVersions();
+  }
+
+  LOG_TRACE("Wrote checkpoint version %d : %lu tile groups, %lu files",
+            checkpoint_version, items.size(), file_count);
+
+  // Truncate logs
+  log_manager.TruncateLogs(start_commit_id_);
+  most_recent_checkpoint_cid = start_commit_id_;
+}
+
+cid_t StreamingCheckpoint::DoRecovery() {
+  // No checkpoint to recover from
+  if (checkpoint_version < 0 || disable_file_access) {
+    return 0;
+  }
+
+  cid_t commit_id = 0;
+  size_t file_count = 0;
+  if (ReadManifest(commit_id, file_count) == false) {
+    return 0;
+  }
+
+  // Replay the data files in parallel
+  max_oid_ = 0;
+  std::vector<std::thread> readers;
+  for (size_t file_itr = 0; file_itr < file_count; file_itr++) {
+    readers.emplace_back(&StreamingCheckpoint::RecoverDataFile, this,
+                         file_itr, commit_id);
+  }
+  for (auto &reader : readers) {
+    reader.join();
+  }
+
+  // After finishing recovery, set the next oid with maximum oid
+  // observed during the recovery
+  auto &manager = catalog::Manager::GetInstance();
+  if (max_oid_ > manager.GetNextOid()) {
+    manager.SetNextOid(max_oid_);
+  }
+
+  concurrency::TransactionManagerFactory::GetInstance().SetNextCid(commit_id);
+  CheckpointManager::GetInstance().SetRecoveredCid(commit_id);
+  return commit_id;
+}
+
+size_t StreamingCheckpoint::SerializeTileGroup(storage::TileGroup *tile_group,
+                                               oid_t database_oid,
+                                               oid_t table_oid,
+                                               CopySerializeOutput &output) {
+  // Find the tuples visible to the checkpoint
+  auto tile_group_header = tile_group->GetHeader();
+  auto active_tuple_count = tile_group_header->GetCurrentNextTupleSlot();
+  CheckpointTileScanner scanner;
+  std::vector<oid_t> tuple_slots;
+  for (oid_t tuple_id = 0; tuple_id < active_tuple_count; tuple_id++) {
+    if (scanner.IsVisible(tile_group_header, tuple_id, start_commit_id_)) {
+      tuple_slots.push_back(tuple_id);
+    }
+  }
+
+  output.Reset();
+  if (tuple_slots.empty()) {
+    return 0;
+  }
+
+  // Block header
+  size_t start = output.ReserveBytes(sizeof(int32_t));
+  output.WriteInt(database_oid);
+  output.WriteInt(table_oid);
+  output.WriteInt(tile_group->GetTileGroupId());
+
+  // Column map : the table columns stored in every tile
+  auto tile_count = tile_group->GetTileCount();
+  std::vector<std::vector<oid_t>> tile_columns(tile_count);
+  for (auto &column_entry : tile_group->GetColumnMap()) {
+    auto &columns = tile_columns[column_entry.second.first];
+    if (columns.size() <= column_entry.second.second) {
+      columns.resize(column_entry.second.second + 1);
+    }
+    columns[column_entry.second.second] = column_entry.first;
+  }
+  output.WriteInt(tile_count);
+  for (auto &columns : tile_columns) {
+    output.WriteInt(columns.size());
+    for (auto column_id : columns) {
+      output.WriteInt(column_id);
+    }
+  }
+
+  output.WriteInt(tuple_slots.size());
+  for (auto tuple_slot : tuple_slots) {
+    output.WriteInt(tuple_slot);
+  }
+
+  // Raw inlined tuples of every tile
+  for (oid_t tile_itr = 0; tile_itr < tile_count; tile_itr++) {
+    auto tile = tile_group->GetTile(tile_itr);
+    auto tuple_length = tile->GetSchema()->GetLength();
+    for (auto tuple_slot : tuple_slots) {
+      output.WriteBytes(tile->GetTupleLocation(tuple_slot), tuple_length);
+    }
+  }
+
+  // Uninlined values, whose pointers in the raw tuples are meaningless
+  for (oid_t tile_itr = 0; tile_itr < tile_count; tile_itr++) {
+    auto tile = tile_group->GetTile(tile_itr);
+    auto schema = tile->GetSchema();
+    auto uninlined_column_count = schema->GetUninlinedColumnCount();
+    if (uninlined_column_count == 0) {
+      continue;
+    }
+    for (auto tuple_slot : tuple_slots) {
+      storage::Tuple tile_tuple(schema, tile->GetTupleLocation(tuple_slot));
+      for (oid_t column_itr = 0; column_itr < uninlined_column_count;
+           column_itr++) {
+        tile_tuple.GetValue(schema->GetUninlinedColumn(column_itr))
+            .SerializeTo(output);
+      }
+    }
+  }
+
+  output.WriteIntAt(start, static_cast<int32_t>(output.Position() - start -
+                                                sizeof(int32_t)));
+  return tuple_slots.size();
+}
+
+size_t StreamingCheckpoint::RecoverTileGroup(SerializeInputBE &input,
+                                             cid_t commit_id) {
+  oid_t database_oid = input.ReadInt();
+  oid_t table_oid = input.ReadInt();
+  oid_t tile_group_id = input.ReadInt();
+
+  oid_t tile_count = input.ReadInt();
+  std::vector<std::vector<oid_t>> tile_columns(tile_count);
+  for (auto &columns : tile_columns) {
+    columns.resize(input.ReadInt());
+    for (auto &column_id : columns) {
+      column_id = input.ReadInt();
+    }
+  }
+
+  std::vector<oid_t> tuple_slots(input.ReadInt());
+  for (auto &tuple_slot : tuple_slots) {
+    tuple_slot = input.ReadInt();
+  }
+
+  auto &manager = catalog::Manager::GetInstance();
+  auto table = manager.GetTableWithOid(database_oid, table_oid);
+  if (table == nullptr) {
+    // the table was dropped
+    return 0;
+  }
+
+  auto tile_group = manager.GetTileGroup(tile_group_id);
+  if (tile_group == nullptr) {
+    table->AddTileGroupWithOidForRecovery(tile_group_id);
+    tile_group = manager.GetTileGroup(tile_group_id);
+  }
+  auto tile_group_header = tile_group->GetHeader();
+
+  // The raw tuples can be copied into the tiles if the tile group has the
+  // layout it was checkpointed with
+  auto table_schema = table->GetSchema();
+  bool same_layout = (tile_group->GetTileCount() == tile_count);
+  for (oid_t tile_itr = 0; same_layout && tile_itr < tile_count; tile_itr++) {
+    auto &columns = tile_columns[tile_itr];
+    same_layout = (columns.size() ==
+                   tile_group->GetTile(tile_itr)->GetSchema()->GetColumnCount());
+    for (oid_t column_itr = 0; same_layout && column_itr < columns.size();
+         column_itr++) {
+      oid_t tile_offset, tile_column_offset;
+      tile_group->LocateTileAndColumn(columns[column_itr], tile_offset,
+                                      tile_column_offset);
+      same_layout = (tile_offset == tile_itr && tile_column_offset == column_itr);
+    }
+  }
+
+  // Otherwise the tuples are rebuilt from their values
+  std::unique_ptr<VarlenPool> scratch_pool;
+  std::vector<std::unique_ptr<catalog::Schema>> scratch_schemas;
+  std::vector<std::vector<char>> scratch_tuples(tile_count);
+  if (same_layout == false) {
+    LOG_TRACE("Tile group %u changed layout since the checkpoint",
+              tile_group_id);
+    scratch_pool.reset(new VarlenPool(BACKEND_TYPE_MM));
+    for (oid_t tile_itr = 0; tile_itr < tile_count; tile_itr++) {
+      scratch_schemas.emplace_back(
+          catalog::Schema::CopySchema(table_schema, tile_columns[tile_itr]));
+      scratch_tuples[tile_itr].resize(tuple_slots.size() *
+                                      scratch_schemas.back()->GetLength());
+    }
+  } else {
+    for (auto tuple_slot : tuple_slots) {
+      if (tile_group_header->GetEmptyTupleSlot(tuple_slot) == false) {
+        LOG_ERROR("Invalid slot %u in checkpoint of tile group %u", tuple_slot,
+                  tile_group_id);
+        return 0;
+      }
+    }
+  }
+
+  auto get_tile_schema = [&](oid_t tile_itr) {
+    return same_layout ? tile_group->GetTile(tile_itr)->GetSchema()
+                       : scratch_schemas[tile_itr].get();
+  };
+  auto get_tuple_location = [&](oid_t tile_itr, size_t tuple_itr) {
+    if (same_layout) {
+      return tile_group->GetTile(tile_itr)
+          ->GetTupleLocation(tuple_slots[tuple_itr]);
+    }
+    return scratch_tuples[tile_itr].data() +
+           tuple_itr * scratch_schemas[tile_itr]->GetLength();
+  };
+
+  // Raw inlined tuples of every tile
+  for (oid_t tile_itr = 0; tile_itr < tile_count; tile_itr++) {
+    auto tuple_length = get_tile_schema(tile_itr)->GetLength();
+    for (size_t tuple_itr = 0; tuple_itr < tuple_slots.size(); tuple_itr++) {
+      PL_MEMCPY(get_tuple_location(tile_itr, tuple_itr),
+                input.GetRawPointer(tuple_length), tuple_length);
+    }
+  }
+
+  // Uninlined values
+  for (oid_t tile_itr = 0; tile_itr < tile_count; tile_itr++) {
+    auto schema = get_tile_schema(tile_itr);
+    auto pool = same_layout ? tile_group->GetTile(tile_itr)->GetPool()
+                            : scratch_pool.get();
+    auto uninlined_column_count = schema->GetUninlinedColumnCount();
+    for (size_t tuple_itr = 0; tuple_itr < tuple_slots.size(); tuple_itr++) {
+      auto tuple_location = get_tuple_location(tile_itr, tuple_itr);
+      for (oid_t column_itr = 0; column_itr < uninlined_column_count;
+           column_itr++) {
+        auto column_id = schema->GetUninlinedColumn(column_itr);
+        Value::DeserializeFrom(input, pool,
+                               tuple_location + schema->GetOffset(column_id),
+                               schema->GetType(column_id), false,
+                               schema->GetVariableLength(column_id), false);
+      }
+    }
+  }
+
+  if (same_layout) {
+    // Set MVCC info
+    for (auto tuple_slot : tuple_slots) {
+      tile_group_header->SetTransactionId(tuple_slot, INITIAL_TXN_ID);
+      tile_group_header->SetBeginCommitId(tuple_slot, commit_id);
+      tile_group_header->SetEndCommitId(tuple_slot, MAX_CID);
+      tile_group_header->SetInsertCommit(tuple_slot, false);
+      tile_group_header->SetDeleteCommit(tuple_slot, false);
+      tile_group_header->SetNextItemPointer(tuple_slot, INVALID_ITEMPOINTER);
+    }
+  } else {
+    storage::Tuple tuple(table_schema, true);
+    for (size_t tuple_itr = 0; tuple_itr < tuple_slots.size(); tuple_itr++) {
+      for (oid_t tile_itr = 0; tile_itr < tile_count; tile_itr++) {
+        storage::Tuple tile_tuple(scratch_schemas[tile_itr].get(),
+                                  get_tuple_location(tile_itr, tuple_itr));
+        auto &columns = tile_columns[tile_itr];
+        for (oid_t column_itr = 0; column_itr < columns.size(); column_itr++) {
+          tuple.SetValue(columns[column_itr], tile_tuple.GetValue(column_itr),
+                         scratch_pool.get());
+        }
+      }
+      if (tile_group->InsertTupleFromCheckpoint(tuple_slots[tuple_itr], &tuple,
+                                                commit_id) == INVALID_OID) {
+        LOG_ERROR("Invalid slot %u in checkpoint of tile group %u",
+                  tuple_slots[tuple_itr], tile_group_id);
+        return 0;
+      }
+    }
+  }
+
+  {
+    std::lock_guard<std::mutex> lock(recovery_mutex_);
+    table->IncreaseNumberOfTuplesBy(tuple_slots.size());
+  }
+
+  oid_t max_oid = max_oid_;
+  while (max_oid < tile_group_id &&
+         max_oid_.compare_exchange_weak(max_oid, tile_group_id) == false) {
+  }
+
+  LOG_TRACE("Recovered %lu tuples of tile group %u", tuple_slots.size(),
+            tile_group_id);
+  return tuple_slots.size();
+}
+
+// Private Functions
+bool StreamingCheckpoint::WriteDataFile(size_t file_itr,
+                                        const std::vector<TileGroupItem> &items,
+                                        std::atomic<size_t> &next_item) {
+  FileHandle file_handle;
+  if (!disable_file_access) {
+    auto file_name = GetDataFileName(checkpoint_version, file_itr);
+    if (LoggingUtil::InitFileHandle(file_name.c_str(), file_handle, "wb") ==
+        false) {
+      return false;
+    }
+  }
+
+  // Only the tile group being written is buffered
+  CopySerializeOutput output;
+  bool success = true;
+  for (size_t item_itr = next_item++; item_itr < items.size();
+       item_itr = next_item++) {
+    auto &item = items[item_itr];
+    if (SerializeTileGroup(item.tile_group.get(), item.database_oid,
+                           item.table_oid, output) == 0) {
+      continue;
+    }
+    if (file_handle.file != nullptr && success) {
+      success = (fwrite(output.Data(), sizeof(char), output.Size(),
+                        file_handle.file) == output.Size());
+    }
+  }
+
+  if (file_handle.file != nullptr) {
+    LoggingUtil::FFlushFsync(file_handle);
+    fclose(file_handle.file);
+  }
+  return success;
+}
+
+void StreamingCheckpoint::RecoverDataFile(size_t file_itr, cid_t commit_id) {
+  FileHandle file_handle;
+  auto file_name = GetDataFileName(checkpoint_version, file_itr);
+  if (LoggingUtil::InitFileHandle(file_name.c_str(), file_handle, "rb") ==
+      false) {
+    return;
+  }
+
+  std::vector<char> block;
+  char block_size_buffer[sizeof(int32_t)];
+  while (fread(block_size_buffer, sizeof(char), sizeof(block_size_buffer),
+               file_handle.file) == sizeof(block_size_buffer)) {
+    CopySerializeInputBE block_size_input(block_size_buffer,
+                                          sizeof(block_size_buffer));
+    size_t block_size = block_size_input.ReadInt();
+    block.resize(block_size);
+    if (fread(block.data(), sizeof(char), block_size, file_handle.file) !=
+        block_size) {
+      LOG_ERROR("Torn checkpoint block in %s", file_name.c_str());
+      break;
+    }
+
+    ReferenceSerializeInputBE block_input(block.data(), block_size);
+    RecoverTileGroup(block_input, commit_id);
+  }
+
+  fclose(file_handle.file);
+}
+
+bool StreamingCheckpoint::WriteManifest(size_t file_count) {
+  CopySerializeOutput output;
+  output.WriteInt(checkpoint_version);
+  output.WriteLong(start_commit_id_);
+  output.WriteInt(file_count);
+
+  // Write to a temporary file and rename it, so that a manifest is either
+  // complete or missing
+  auto file_name = ConcatFileName(checkpoint_dir, checkpoint_version);
+  auto temp_file_name = file_name + ".tmp";
+  FileHandle file_handle;
+  if (LoggingUtil::InitFileHandle(temp_file_name.c_str(), file_handle, "wb") ==
+      false) {
+    return false;
+  }
+  bool success = (fwrite(output.Data(), sizeof(char), output.Size(),
+                         file_handle.file) == output.Size());
+  LoggingUtil::FFlushFsync(file_handle);
+  fclose(file_handle.file);
+
+  if (success == false ||
+      rename(temp_file_name.c_str(), file_name.c_str()) != 0) {
+    LOG_ERROR("Failed to write checkpoint manifest %s", file_name.c_str());
+    return false;
+  }
+  return true;
+}
+
+bool StreamingCheckpoint::ReadManifest(cid_t &commit_id, size_t &file_count) {
+  auto file_name = ConcatFileName(checkpoint_dir, checkpoint_version);
+  FileHandle file_handle;
+  if (LoggingUtil::InitFileHandle(file_name.c_str(), file_handle, "rb") ==
+      false) {
+    return false;
+  }
+
+  char manifest[sizeof(int32_t) + sizeof(int64_t) + sizeof(int32_t)];
+  bool success = (fread(manifest, sizeof(char), sizeof(manifest),
+                        file_handle.file) == sizeof(manifest));
+  fclose(file_handle.file);
+  if (success == false) {
+    LOG_ERROR("Torn checkpoint manifest %s", file_name.c_str());
+    return false;
+  }
+
+  CopySerializeInputBE input(manifest, sizeof(manifest));
+  if (input.ReadInt() != checkpoint_version) {
+    LOG_ERROR("Checkpoint manifest %s has a wrong version", file_name.c_str());
+    return false;
+  }
+  commit_id = input.ReadLong();
+  file_count = input.ReadInt();
+  return true;
+}
+
+std::string StreamingCheckpoint::GetDataFileName(int version,
+                                                 size_t file_itr) {
+  return checkpoint_dir + "/" + FILE_PREFIX + std::to_string(version) + "_" +
+         std::to_string(file_itr) + DATA_FILE_SUFFIX;
+}
+
+void StreamingCheckpoint::RemovePreviousVersions() {
+  auto dirp = opendir(checkpoint_dir.c_str());
+  if (dirp == nullptr) {
+    return;
+  }
+
+  struct dirent *file;
+  while ((file = readdir(dirp)) != NULL) {
+    if (strncmp(file->d_name, FILE_PREFIX.c_str(), FILE_PREFIX.length()) != 0) {
+      continue;
+    }
+    int version = LoggingUtil::ExtractNumberFromFileName(file->d_name);
+    if (version < checkpoint_version) {
+      auto file_name = checkpoint_dir + "/" + file->d_name;
+      if (remove(file_name.c_str()) != 0) {
+        LOG_TRACE("Failed to remove file %s", file_name.c_str());
+      }
+    }
+  }
+  closedir(dirp);
+}
+
+void StreamingCheckpoint::InitVersionNumber() {
+  // Get checkpoint version
+  LOG_TRACE("Trying to read checkpoint directory");
+  struct dirent *file;
+  auto dirp = opendir(checkpoint_dir.c_str());
+  if (dirp == nullptr) {
+    LOG_TRACE("Opendir failed: Errno: %d, error: %s", errno, strerror(errno));
+    return;
+  }
+
+  // Only checkpoints with a manifest are complete
+  while ((file = readdir(dirp)) != NULL) {
+    std::string file_name(file->d_name);
+    if (file_name.compare(0, FILE_PREFIX.length(), FILE_PREFIX) != 0 ||
+        file_name.length() < FILE_SUFFIX.length() ||
+        file_name.compare(file_name.length() - FILE_SUFFIX.length(),
+                          FILE_SUFFIX.length(), FILE_SUFFIX) != 0) {
+      continue;
+    }
+    LOG_TRACE("Found a checkpoint manifest with name %s", file->d_name);
+    int version = LoggingUtil::ExtractNumberFromFileName(file->d_name);
+    if (version > checkpoint_version) {
+      checkpoint_version = version;
+    }
+  }
+  closedir(dirp);
+  LOG_TRACE("set checkpoint version to: %d", checkpoint_version);
+}
+
+}  // namespace logging
+}  // namespace peloton
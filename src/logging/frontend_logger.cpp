@@ -11,9 +11,11 @@
 //===----------------------------------------------------------------------===//
 
 
+#include <algorithm>
 #include <thread>
 
 #include "common/logger.h"
+#include "concurrency/transaction_manager_factory.h"
 #include "logging/log_manager.h"
 #include "logging/checkpoint_manager.h"
 #include "logging/frontend_logger.h"
@@ -64,8 +66,25 @@ FrontendLogger *FrontendLogger::GetFrontendLogger(LoggingType logging_type,
   return frontend_logger;
 }
 
-// only the distinguished logger does this
+// only the distinguished logger or a log stream does this
 void FrontendLogger::UpdateGlobalMaxFlushId() {
+  // A commit is durable once every log stream is flushed past it, so the
+  // global max is the minimum over the streams. Every stream raises it after
+  // its own flush, as there is no distinguished logger.
+  if (independent_epoch_) {
+    auto &log_manager = LogManager::GetInstance();
+    cid_t global_max_flushed_commit_id = MAX_CID;
+    for (auto &frontend_logger : log_manager.GetFrontendLoggersList()) {
+      global_max_flushed_commit_id = std::min(
+          global_max_flushed_commit_id, frontend_logger->GetMaxFlushedCommitId());
+    }
+
+    if (global_max_flushed_commit_id != MAX_CID) {
+      log_manager.AdvanceGlobalMaxFlushedCommitId(global_max_flushed_commit_id);
+    }
+    return;
+  }
+
   if (is_distinguished_logger) {
     cid_t global_max_flushed_commit_id = INVALID_CID;
 
@@ -85,6 +104,51 @@ void FrontendLogger::UpdateGlobalMaxFlushId() {
   }
 }
 
+/**
+ * @brief Wake up the frontend logger if it is waiting for this commit
+ */
+void FrontendLogger::NotifyCommit() {
+  auto pending_commits = ++pending_commits_;
+
+  // Only the first commit of a group and the one filling it wake up the
+  // frontend logger, the others are picked up by the same collection
+  if (waiting_for_commits_ &&
+      (pending_commits == 1 || pending_commits >= group_commit_batch_size_)) {
+    std::lock_guard<std::mutex> lock(group_commit_mutex_);
+    group_commit_cv_.notify_one();
+  }
+}
+
+/**
+ * @brief Wait until a group of commits is ready to be flushed
+ *
+ * An idle frontend logger sleeps until the first commit is buffered. The
+ * group then gathers commits for as long as the last fsync took, since
+ * waiting longer than an fsync does not pay off, bounded by the maximum
+ * delay, or until the group is full.
+ */
+void FrontendLogger::WaitForGroupCommit() {
+  std::unique_lock<std::mutex> lock(group_commit_mutex_);
+  waiting_for_commits_ = true;
+
+  // Wake up regularly to notice a change of the logging status
+  group_commit_cv_.wait_for(lock,
+                            std::chrono::microseconds(GROUP_COMMIT_IDLE_TIMEOUT),
+                            [this] { return pending_commits_ > 0; });
+
+  if (pending_commits_ > 0) {
+    auto delay = std::min(last_fsync_duration_, group_commit_max_delay_);
+    group_commit_cv_.wait_for(lock, std::chrono::microseconds(delay), [this] {
+      return pending_commits_ >= group_commit_batch_size_;
+    });
+  }
+
+  waiting_for_commits_ = false;
+
+  // Commits buffered from now on start the next group
+  pending_commits_ = 0;
+}
+
 /**
  * @brief MainLoop
  */
@@ -173,12 +237,24 @@ void FrontendLogger::MainLoop(void) {
  * @brief Collect the log records from BackendLoggers
  */
 void FrontendLogger::CollectLogRecordsFromBackendLoggers() {
-  auto sleep_period = std::chrono::microseconds(wait_timeout);
-  std::this_thread::sleep_for(sleep_period);
+  if (group_commit_) {
+    WaitForGroupCommit();
+  } else {
+    auto sleep_period = std::chrono::microseconds(wait_timeout);
+    std::this_thread::sleep_for(sleep_period);
+  }
   int debug_flag = 0;
 
   auto &log_manager = LogManager::GetInstance();
 
+  // A transaction gets its commit id after its backend logger has set its
+  // lower bound, so an idle stream holds no commit below the current one
+  cid_t idle_epoch = INVALID_CID;
+  if (independent_epoch_) {
+    auto &txn_manager = concurrency::TransactionManagerFactory::GetInstance();
+    idle_epoch = txn_manager.GetCurrentCommitId() - 1;
+  }
+
   {
     cid_t max_committed_cid = 0;
     cid_t lower_bound = MAX_CID;
@@ -223,7 +299,9 @@ void FrontendLogger::CollectLogRecordsFromBackendLoggers() {
     cid_t max_possible_commit_id;
     if (max_committed_cid == 0 && lower_bound == MAX_CID) {
       // nothing collected
-      cid_t global_max = log_manager.GetGlobalMaxFlushedCommitId();
+      cid_t global_max = independent_epoch_
+                             ? idle_epoch
+                             : log_manager.GetGlobalMaxFlushedCommitId();
 
       if (global_max > max_collected_commit_id)
         max_collected_commit_id = global_max;
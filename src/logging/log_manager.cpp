@@ -11,8 +11,12 @@
 //===----------------------------------------------------------------------===//
 
 
+#include <algorithm>
+#include <chrono>
+#include <cmath>
 #include <condition_variable>
 #include <memory>
+#include <sched.h>
 
 #include "concurrency/transaction_manager_factory.h"
 #include "logging/log_manager.h"
@@ -35,6 +39,7 @@ thread_local static BackendLogger *backend_logger = nullptr;
 LogManager::LogManager() {
   Configure(peloton_logging_mode, false, DEFAULT_NUM_FRONTEND_LOGGERS,
             LOGGER_MAPPING_TYPE_ROUND_ROBIN);
+  ResetCommitMetrics();
 }
 
 LogManager::~LogManager() {}
@@ -63,8 +68,9 @@ void LogManager::StartStandbyMode() {
     return;
   }
 
-  // assign a distinguished logger thread only if we have more than 1 loggers
-  if (num_frontend_loggers_ > 1)
+  // assign a distinguished logger thread only if we have more than 1 loggers,
+  // log streams track their epochs on their own
+  if (num_frontend_loggers_ > 1 && log_streams_ == false)
     frontend_loggers[0].get()->SetIsDistinguishedLogger(true);
 
   // Toggle status in log manager map
@@ -257,9 +263,13 @@ void LogManager::LogCommitTransaction(cid_t commit_id) {
   if (this->IsInLoggingMode()) {
     auto logger = this->GetBackendLogger();
     TransactionRecord record(LOGRECORD_TYPE_TRANSACTION_COMMIT, commit_id);
+    auto commit_begin = std::chrono::steady_clock::now();
     logger->Log(&record);
     if (syncronization_commit) {
       WaitForFlush(commit_id);
+      RecordCommitLatency(std::chrono::duration_cast<std::chrono::microseconds>(
+                              std::chrono::steady_clock::now() - commit_begin)
+                              .count());
     }
     logger->GetVarlenPool()->Purge();
   }
@@ -287,6 +297,15 @@ BackendLogger *LogManager::GetBackendLogger(unsigned int hint_idx) {
           backend_logger);
       backend_logger->SetFrontendLoggerID(i % num_frontend_loggers_);
 
+    } else if (logger_mapping_strategy_ == LOGGER_MAPPING_TYPE_AFFINITY) {
+      // the stream of the core the worker first logs on
+      int cpu = sched_getcpu();
+      unsigned int logger_idx =
+          ((cpu >= 0) ? (unsigned int)cpu : (unsigned int)i) %
+          num_frontend_loggers_;
+      frontend_loggers[logger_idx].get()->AddBackendLogger(backend_logger);
+      backend_logger->SetFrontendLoggerID(logger_idx);
+
     } else if (logger_mapping_strategy_ == LOGGER_MAPPING_TYPE_MANUAL) {
       // manual mapping with hint
       PL_ASSERT(hint_idx < frontend_loggers.size());
@@ -309,6 +328,14 @@ void LogManager::InitFrontendLoggers() {
           FrontendLogger::GetFrontendLogger(logging_type_, test_mode_));
 
       if (frontend_logger.get() != nullptr) {
+        frontend_logger->SetGroupCommit(group_commit_);
+        frontend_logger->SetIndependentEpoch(log_streams_);
+        if (IsBasedOnWriteAheadLogging(logging_type_)) {
+          auto wal_frontend_logger =
+              static_cast<WriteAheadFrontendLogger *>(frontend_logger.get());
+          wal_frontend_logger->SetSegmentedIO(segmented_log_io_);
+          wal_frontend_logger->SetMergedRecovery(num_frontend_loggers_ > 1);
+        }
         frontend_loggers.push_back(std::move(frontend_logger));
       }
     }
@@ -435,6 +462,14 @@ void LogManager::SetGlobalMaxFlushedCommitId(cid_t new_max) {
   global_max_flushed_commit_id = new_max;
 }
 
+void LogManager::AdvanceGlobalMaxFlushedCommitId(cid_t new_max) {
+  cid_t current_max = global_max_flushed_commit_id.load();
+  while (current_max < new_max &&
+         global_max_flushed_commit_id.compare_exchange_weak(current_max,
+                                                            new_max) == false) {
+  }
+}
+
 cid_t LogManager::GetPersistentFlushedCommitId() {
   int num_loggers;
   num_loggers = this->frontend_loggers.size();
@@ -461,7 +496,15 @@ cid_t LogManager::GetPersistentFlushedCommitId() {
 void LogManager::FrontendLoggerFlushed() {
   {
     std::unique_lock<std::mutex> wait_lock(flush_notify_mutex);
-    flush_notify_cv.notify_all();
+
+    // Wake up exactly the waiters whose commits are now durable
+    auto flushed_commit_id = this->GetPersistentFlushedCommitId();
+    auto flushed_end = flush_waiters_.upper_bound(flushed_commit_id);
+    for (auto itr = flush_waiters_.begin(); itr != flushed_end; itr++) {
+      itr->second->flushed = true;
+      itr->second->cv.notify_one();
+    }
+    flush_waiters_.erase(flush_waiters_.begin(), flushed_end);
   }
 }
 
@@ -470,18 +513,111 @@ void LogManager::WaitForFlush(cid_t cid) {
   {
     std::unique_lock<std::mutex> wait_lock(flush_notify_mutex);
 
-    while (this->GetPersistentFlushedCommitId() < cid) {
-      LOG_TRACE(
-          "Logs up to %lu cid is flushed. %lu cid is not flushed yet. Wait...",
-          this->GetPersistentFlushedCommitId(), cid);
-      flush_notify_cv.wait(wait_lock);
+    if (this->GetPersistentFlushedCommitId() >= cid) {
+      return;
     }
+
+    LOG_TRACE(
+        "Logs up to %lu cid is flushed. %lu cid is not flushed yet. Wait...",
+        this->GetPersistentFlushedCommitId(), cid);
+
+    // The waiter is removed by the flush that makes the cid durable
+    FlushWaiter waiter;
+    flush_waiters_.emplace(cid, &waiter);
+    while (waiter.flushed == false) {
+      waiter.cv.wait(wait_lock);
+    }
+
     LOG_TRACE(
         "Flushes done! Can return! Got persistent flushed commit id as %d",
         (int)this->GetPersistentFlushedCommitId());
   }
 }
 
+void LogManager::SetGroupCommit(bool group_commit) {
+  group_commit_ = group_commit;
+  for (auto &frontend_logger : frontend_loggers) {
+    frontend_logger->SetGroupCommit(group_commit);
+  }
+}
+
+void LogManager::SetSegmentedLogIO(bool segmented_log_io) {
+  segmented_log_io_ = segmented_log_io;
+  if (IsBasedOnWriteAheadLogging(logging_type_)) {
+    for (auto &frontend_logger : frontend_loggers) {
+      static_cast<WriteAheadFrontendLogger *>(frontend_logger.get())
+          ->SetSegmentedIO(segmented_log_io);
+    }
+  }
+}
+
+void LogManager::RecordCommitLatency(uint64_t latency) {
+  size_t bucket = 0;
+  while (latency > 0 && bucket < COMMIT_LATENCY_BUCKET_COUNT - 1) {
+    latency >>= 1;
+    bucket++;
+  }
+  commit_latency_buckets_[bucket]++;
+}
+
+uint64_t LogManager::GetCommitLatencyPercentile(double percentile) {
+  uint64_t counts[COMMIT_LATENCY_BUCKET_COUNT];
+  uint64_t total = 0;
+  for (size_t bucket = 0; bucket < COMMIT_LATENCY_BUCKET_COUNT; bucket++) {
+    counts[bucket] = commit_latency_buckets_[bucket];
+    total += counts[bucket];
+  }
+
+  if (total == 0) {
+    return 0;
+  }
+
+  // the rank of the commit at the given percentile
+  auto rank = static_cast<uint64_t>(std::ceil(total * percentile / 100.0));
+  rank = std::max<uint64_t>(1, std::min(rank, total));
+
+  uint64_t seen = 0;
+  size_t bucket = 0;
+  for (; bucket < COMMIT_LATENCY_BUCKET_COUNT - 1; bucket++) {
+    seen += counts[bucket];
+    if (seen >= rank) break;
+  }
+
+  return (bucket == 0) ? 0 : (UINT64_C(1) << bucket);
+}
+
+double LogManager::GetFsyncRate() {
+  size_t fsync_count = 0;
+  for (auto &frontend_logger : frontend_loggers) {
+    fsync_count += frontend_logger->GetFsyncCount();
+  }
+
+  // the frontend loggers were reset since
+  if (fsync_count < metrics_begin_fsync_count_) {
+    metrics_begin_fsync_count_ = 0;
+  }
+
+  std::chrono::duration<double> elapsed =
+      std::chrono::steady_clock::now() - metrics_begin_;
+  if (elapsed.count() <= 0) {
+    return 0;
+  }
+
+  return (fsync_count - metrics_begin_fsync_count_) / elapsed.count();
+}
+
+void LogManager::ResetCommitMetrics() {
+  for (auto &bucket : commit_latency_buckets_) {
+    bucket = 0;
+  }
+
+  metrics_begin_fsync_count_ = 0;
+  for (auto &frontend_logger : frontend_loggers) {
+    metrics_begin_fsync_count_ += frontend_logger->GetFsyncCount();
+  }
+  metrics_begin_ = std::chrono::steady_clock::now();
+}
+
 void LogManager::NotifyRecoveryDone() {
   LOG_TRACE("One frontend logger has notified that it has completed recovery");
 
@@ -491,11 +627,36 @@ void LogManager::NotifyRecoveryDone() {
   if (i == num_frontend_loggers_) {
     LOG_TRACE(
         "This was the last one! Recover Index and change to LOGGING mode.");
+
+    // Replay the transactions of all log streams in commit id order
+    if (IsBasedOnWriteAheadLogging(logging_type_) &&
+        num_frontend_loggers_ > 1) {
+      ReplayRecoveredTransactions(
+          static_cast<WriteAheadFrontendLogger *>(frontend_loggers[0].get()));
+    }
     frontend_loggers[0].get()->RecoverIndex();
     SetLoggingStatus(LOGGING_STATUS_TYPE_LOGGING);
   }
 }
 
+void LogManager::ReplayRecoveredTransactions(
+    WriteAheadFrontendLogger *frontend_logger) {
+  {
+    std::lock_guard<std::mutex> lock(recovered_transactions_mutex_);
+    frontend_logger->ReplayRecoveredTransactions(recovered_transactions_);
+  }
+
+  std::unique_lock<std::mutex> wait_lock(update_managers_mutex);
+  max_oid = std::max(max_oid, frontend_logger->GetMaxRecoveredOid());
+  catalog::Manager::GetInstance().SetNextOid(max_oid);
+}
+
+void LogManager::AddRecoveredTransaction(
+    cid_t commit_id, std::vector<TupleRecord *> &tuple_records) {
+  std::lock_guard<std::mutex> lock(recovered_transactions_mutex_);
+  recovered_transactions_.emplace_back(commit_id, std::move(tuple_records));
+}
+
 void LogManager::UpdateCatalogAndTxnManagers(oid_t new_oid, cid_t new_cid) {
   {
     std::unique_lock<std::mutex> wait_lock(update_managers_mutex);
@@ -0,0 +1,270 @@
+//===----------------------------------------------------------------------===//
+//
+//                         Peloton
+//
+// log_segment_writer.cpp
+//
+// Identification: src/logging/log_segment_writer.cpp
+//
+// Copyright (c) 2015-16, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+
+#include <fcntl.h>
+#include <unistd.h>
+#include <algorithm>
+#include <cerrno>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <new>
+
+#include "common/logger.h"
+#include "common/macros.h"
+#include "logging/log_segment_writer.h"
+
+namespace peloton {
+namespace logging {
+
+LogSegmentWriter::AlignedBuffer::~AlignedBuffer() { free(data); }
+
+void LogSegmentWriter::AlignedBuffer::Reserve(size_t new_capacity) {
+  if (new_capacity <= capacity) {
+    return;
+  }
+
+  new_capacity = std::max(new_capacity, 2 * capacity);
+  new_capacity = (new_capacity + LOG_SEGMENT_BLOCK_SIZE - 1) /
+                 LOG_SEGMENT_BLOCK_SIZE * LOG_SEGMENT_BLOCK_SIZE;
+
+  void *new_data = nullptr;
+  if (posix_memalign(&new_data, LOG_SEGMENT_BLOCK_SIZE, new_capacity) != 0) {
+    throw std::bad_alloc();
+  }
+
+  if (size != 0) {
+    memcpy(new_data, data, size);
+  }
+  free(data);
+
+  data = static_cast<char *>(new_data);
+  capacity = new_capacity;
+}
+
+LogSegmentWriter::LogSegmentWriter(FlushCallback flush_callback)
+    : flush_callback_(flush_callback) {
+  io_thread_ = std::thread(&LogSegmentWriter::IOLoop, this);
+}
+
+LogSegmentWriter::~LogSegmentWriter() {
+  Drain();
+
+  {
+    std::lock_guard<std::mutex> lock(io_mutex_);
+    shutdown_ = true;
+  }
+  io_cv_.notify_all();
+  io_thread_.join();
+
+  if (fd_ != -1) {
+    close(fd_);
+  }
+}
+
+/**
+ * @brief Open a segment for writing
+ * @param file_name name of the new segment
+ * @param recycled_file_name segment to reuse, or empty to create one
+ * @param segment_size number of bytes preallocated for the segment
+ */
+bool LogSegmentWriter::Open(const std::string &file_name,
+                            const std::string &recycled_file_name,
+                            size_t segment_size) {
+  PL_ASSERT(fd_ == -1);
+
+  int flags = O_RDWR | O_CREAT;
+  if (recycled_file_name.empty() ||
+      rename(recycled_file_name.c_str(), file_name.c_str()) != 0) {
+    flags |= O_TRUNC;
+  }
+
+  // Not every file system supports direct I/O
+  direct_ = true;
+  fd_ = open(file_name.c_str(), flags | O_DIRECT, 0600);
+  if (fd_ == -1 && errno == EINVAL) {
+    direct_ = false;
+    fd_ = open(file_name.c_str(), flags, 0600);
+  }
+
+  if (fd_ == -1) {
+    LOG_ERROR("Could not open log segment %s: %s", file_name.c_str(),
+              strerror(errno));
+    return false;
+  }
+
+  int ret = posix_fallocate(fd_, 0, segment_size);
+  if (ret != 0) {
+    LOG_TRACE("Could not preallocate log segment %s: %s", file_name.c_str(),
+              strerror(ret));
+  }
+
+  // The header is filled in when the segment is closed
+  buffer_offset_ = 0;
+  file_offset_ = LOG_SEGMENT_HEADER_SIZE;
+  active_buffer_->Reserve(LOG_SEGMENT_BLOCK_SIZE);
+  memset(active_buffer_->data, 0, LOG_SEGMENT_BLOCK_SIZE);
+  active_buffer_->size = LOG_SEGMENT_HEADER_SIZE;
+  unsubmitted_data_ = false;
+
+  // Wipe the header and the first record of a recycled segment right away,
+  // so that its stale records are never taken for the new log
+  if ((flags & O_TRUNC) == 0) {
+    if (pwrite(fd_, active_buffer_->data, LOG_SEGMENT_BLOCK_SIZE, 0) !=
+            LOG_SEGMENT_BLOCK_SIZE ||
+        fdatasync(fd_) != 0) {
+      LOG_ERROR("Could not reset recycled log segment %s: %s",
+                file_name.c_str(), strerror(errno));
+    }
+  }
+
+  LOG_TRACE("Opened log segment %s, direct I/O : %d", file_name.c_str(),
+            direct_);
+  return true;
+}
+
+void LogSegmentWriter::Append(const char *data, size_t size) {
+  PL_ASSERT(fd_ != -1);
+  active_buffer_->Reserve(active_buffer_->size + size);
+  memcpy(active_buffer_->data + active_buffer_->size, data, size);
+  active_buffer_->size += size;
+  file_offset_ += size;
+  unsubmitted_data_ = true;
+}
+
+void LogSegmentWriter::Submit(cid_t commit_id) {
+  PL_ASSERT(fd_ != -1);
+
+  // Pad the batch with zeros to the next block, leaving at least one zero
+  // byte after the data
+  size_t data_length = active_buffer_->size;
+  size_t length = (data_length + LOG_SEGMENT_BLOCK_SIZE) /
+                  LOG_SEGMENT_BLOCK_SIZE * LOG_SEGMENT_BLOCK_SIZE;
+  active_buffer_->Reserve(length);
+  memset(active_buffer_->data + data_length, 0, length - data_length);
+
+  Batch batch{active_buffer_, buffer_offset_, length, commit_id};
+
+  // The other buffer is free once the previous batch is written
+  Drain();
+  AlignedBuffer *next_buffer =
+      (active_buffer_ == &buffers_[0]) ? &buffers_[1] : &buffers_[0];
+
+  // Carry the partial last block over to the next batch
+  size_t tail_offset =
+      file_offset_ / LOG_SEGMENT_BLOCK_SIZE * LOG_SEGMENT_BLOCK_SIZE;
+  size_t tail_size = file_offset_ - tail_offset;
+  next_buffer->Reserve(LOG_SEGMENT_BLOCK_SIZE);
+  memcpy(next_buffer->data,
+         active_buffer_->data + (tail_offset - buffer_offset_), tail_size);
+  next_buffer->size = tail_size;
+
+  {
+    std::lock_guard<std::mutex> lock(io_mutex_);
+    pending_batch_ = batch;
+    batch_in_flight_ = true;
+  }
+  io_cv_.notify_all();
+
+  active_buffer_ = next_buffer;
+  buffer_offset_ = tail_offset;
+  unsubmitted_data_ = false;
+}
+
+void LogSegmentWriter::Drain() {
+  std::unique_lock<std::mutex> lock(io_mutex_);
+  io_cv_.wait(lock, [this] { return batch_in_flight_ == false; });
+}
+
+void LogSegmentWriter::Close(cid_t max_log_id, cid_t max_delimiter) {
+  PL_ASSERT(fd_ != -1);
+
+  // Write out whatever was appended after the last batch
+  if (unsubmitted_data_) {
+    Submit(INVALID_CID);
+  }
+  Drain();
+
+  // Rewrite the first block with the header filled in
+  AlignedBuffer first_block;
+  first_block.Reserve(LOG_SEGMENT_BLOCK_SIZE);
+  memset(first_block.data, 0, LOG_SEGMENT_BLOCK_SIZE);
+  if (pread(fd_, first_block.data, LOG_SEGMENT_BLOCK_SIZE, 0) < 0) {
+    LOG_ERROR("Could not read log segment header: %s", strerror(errno));
+  }
+
+  memcpy(first_block.data, &max_log_id, sizeof(max_log_id));
+  memcpy(first_block.data + sizeof(max_log_id), &max_delimiter,
+         sizeof(max_delimiter));
+  if (pwrite(fd_, first_block.data, LOG_SEGMENT_BLOCK_SIZE, 0) !=
+      LOG_SEGMENT_BLOCK_SIZE) {
+    LOG_ERROR("Could not write log segment header: %s", strerror(errno));
+  }
+
+  if (fdatasync(fd_) != 0) {
+    LOG_ERROR("Error occured in fdatasync: %s", strerror(errno));
+  }
+
+  close(fd_);
+  fd_ = -1;
+}
+
+void LogSegmentWriter::IOLoop() {
+  std::unique_lock<std::mutex> lock(io_mutex_);
+  for (;;) {
+    io_cv_.wait(lock, [this] { return batch_in_flight_ || shutdown_; });
+    if (batch_in_flight_ == false) {
+      break;
+    }
+
+    auto batch = pending_batch_;
+    lock.unlock();
+    WriteBatch(batch);
+    lock.lock();
+
+    batch_in_flight_ = false;
+    io_cv_.notify_all();
+  }
+}
+
+void LogSegmentWriter::WriteBatch(const Batch &batch) {
+  auto begin = std::chrono::steady_clock::now();
+  auto status = Result::RESULT_SUCCESS;
+
+  size_t written = 0;
+  while (written < batch.length) {
+    auto ret = pwrite(fd_, batch.buffer->data + written,
+                      batch.length - written, batch.offset + written);
+    if (ret < 0) {
+      if (errno == EINTR) continue;
+      LOG_ERROR("Could not write log segment: %s", strerror(errno));
+      status = Result::RESULT_FAILURE;
+      break;
+    }
+    written += ret;
+  }
+
+  if (status == Result::RESULT_SUCCESS && fdatasync(fd_) != 0) {
+    LOG_ERROR("Error occured in fdatasync: %s", strerror(errno));
+    status = Result::RESULT_FAILURE;
+  }
+
+  // The callback always runs, so that nobody waits on a failed batch
+  auto duration = std::chrono::duration_cast<std::chrono::microseconds>(
+      std::chrono::steady_clock::now() - begin);
+  flush_callback_(batch.commit_id, duration.count(), status);
+}
+
+}  // namespace logging
+}  // namespace peloton
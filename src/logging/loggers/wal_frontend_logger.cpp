@@ -16,6 +16,7 @@
 #include <sys/mman.h>
 #include <algorithm>
 #include <dirent.h>
+#include <thread>
 
 #include "catalog/manager.h"
 #include "catalog/schema.h"
@@ -67,6 +68,9 @@ WriteAheadFrontendLogger::WriteAheadFrontendLogger(bool for_testing) {
 
   // allocate pool
   recovery_pool = new VarlenPool(BACKEND_TYPE_MM);
+  recovery_thread_count_ = std::max<size_t>(
+      1, std::min<size_t>(std::thread::hardware_concurrency(),
+                          WAL_RECOVERY_MAX_THREAD_COUNT));
   if (test_mode_) {
     cur_file_handle.file = nullptr;
   } else {
@@ -81,6 +85,9 @@ WriteAheadFrontendLogger::WriteAheadFrontendLogger(std::string log_dir)
 
   // allocate pool
   recovery_pool = new VarlenPool(BACKEND_TYPE_MM);
+  recovery_thread_count_ = std::max<size_t>(
+      1, std::min<size_t>(std::thread::hardware_concurrency(),
+                          WAL_RECOVERY_MAX_THREAD_COUNT));
 
   InitSelf();
 }
@@ -100,6 +107,11 @@ void WriteAheadFrontendLogger::InitSelf() {
  * @brief close logfile
  */
 WriteAheadFrontendLogger::~WriteAheadFrontendLogger() {
+  // close the log segment
+  if (segment_writer_ != nullptr && segment_writer_->IsOpen()) {
+    CloseLogSegment();
+  }
+
   // close the log file
   if (cur_file_handle.file != nullptr) {
     int ret = fclose(cur_file_handle.file);
@@ -117,6 +129,11 @@ WriteAheadFrontendLogger::~WriteAheadFrontendLogger() {
  * @brief flush all the log records to the file
  */
 void WriteAheadFrontendLogger::FlushLogRecords(void) {
+  if (segmented_io_ && !test_mode_) {
+    FlushLogRecordsToSegment();
+    return;
+  }
+
   size_t global_queue_size = global_queue.size();
 
   bool will_write_to_file;
@@ -175,10 +192,15 @@ void WriteAheadFrontendLogger::FlushLogRecords(void) {
 
         // by moving the fflush and sync here, we ensure that this file will
         // have at least 1 delimiter
-        if (Clock::now() > last_flush + flush_frequency) {
+        // a group commit is flushed right away, its waiting is already done
+        auto fsync_begin = Clock::now();
+        if (group_commit_ || fsync_begin > last_flush + flush_frequency) {
           LoggingUtil::FFlushFsync(cur_file_handle);
 
           last_flush = Clock::now();
+          last_fsync_duration_ =
+              std::chrono::duration_cast<Micros>(last_flush - fsync_begin)
+                  .count();
           if (this->max_collected_commit_id > max_flushed_commit_id) {
             max_flushed_commit_id = this->max_collected_commit_id;
           }
@@ -195,7 +217,7 @@ void WriteAheadFrontendLogger::FlushLogRecords(void) {
         if (FileSwitchCondIsTrue()) should_create_new_file = true;
       }
     } else {
-      if (Clock::now() > last_flush + flush_frequency) {
+      if (group_commit_ || Clock::now() > last_flush + flush_frequency) {
         last_flush = Clock::now();
         if (this->max_collected_commit_id > max_flushed_commit_id) {
           max_flushed_commit_id = this->max_collected_commit_id;
@@ -216,6 +238,88 @@ void WriteAheadFrontendLogger::FlushLogRecords(void) {
   }
 }
 
+/**
+ * @brief hand the collected log records to the segment writer
+ *
+ * The batch is written and synced by the I/O thread of the segment writer
+ * while the next batch is collected. The flushed commit id is advanced once
+ * the batch is durable.
+ */
+void WriteAheadFrontendLogger::FlushLogRecordsToSegment() {
+  bool has_new_commit = (max_collected_commit_id != max_submitted_commit_id_);
+  if (global_queue.empty() && has_new_commit == false) {
+    return;
+  }
+
+  if (segment_writer_ == nullptr || segment_writer_->IsOpen() == false) {
+    OpenLogSegment();
+  } else if (should_create_new_file) {
+    CloseLogSegment();
+    OpenLogSegment();
+    should_create_new_file = false;
+  }
+
+  bool is_open = segment_writer_->IsOpen();
+  for (auto &log_buffer : global_queue) {
+    if (is_open) {
+      segment_writer_->Append(log_buffer->GetData(), log_buffer->GetSize());
+    }
+
+    if (log_buffer->GetMaxLogId() > this->max_log_id_file) {
+      this->max_log_id_file = log_buffer->GetMaxLogId();
+    }
+
+    // return empty buffer
+    auto backend_logger = log_buffer->GetBackendLogger();
+    log_buffer->ResetData();
+    backend_logger->GrantEmptyBuffer(std::move(log_buffer));
+  }
+  global_queue.clear();
+
+  if (is_open == false) {
+    LOG_ERROR("No log segment to write to");
+    return;
+  }
+
+  if (has_new_commit) {
+    TransactionRecord delimiter_rec(LOGRECORD_TYPE_ITERATION_DELIMITER,
+                                    this->max_collected_commit_id);
+    delimiter_rec.Serialize(output_buffer);
+    segment_writer_->Append(delimiter_rec.GetMessage(),
+                            delimiter_rec.GetMessageLength());
+
+    if (this->max_collected_commit_id > max_delimiter_file) {
+      max_delimiter_file = this->max_collected_commit_id;
+    }
+  }
+
+  segment_writer_->Submit(this->max_collected_commit_id);
+  max_submitted_commit_id_ = this->max_collected_commit_id;
+
+  if (FileSwitchCondIsTrue()) should_create_new_file = true;
+}
+
+void WriteAheadFrontendLogger::LogSegmentFlushed(cid_t commit_id,
+                                                 int64_t duration,
+                                                 Result status) {
+  // The commits of a failed batch are not durable, the waiting workers are
+  // still woken up but keep seeing the old max flushed commit id
+  if (status != Result::RESULT_SUCCESS) {
+    LOG_ERROR("Failed to flush the log up to commit id %lu", commit_id);
+    LogManager::GetInstance().FrontendLoggerFlushed();
+    return;
+  }
+
+  if (commit_id > max_flushed_commit_id) {
+    max_flushed_commit_id = commit_id;
+  }
+  last_fsync_duration_ = duration;
+  fsync_count++;
+
+  // signal that we have flushed
+  LogManager::GetInstance().FrontendLoggerFlushed();
+}
+
 //===--------------------------------------------------------------------===//
 // Recovery
 //===--------------------------------------------------------------------===//
@@ -227,7 +331,6 @@ void WriteAheadFrontendLogger::DoRecovery() {
   // FIXME GetNextCommitId() increments next_cid!!!
   cid_t start_commit_id = CheckpointManager::GetInstance().GetRecoveredCid();
   auto &log_manager = logging::LogManager::GetInstance();
-  int num_inserts = 0;
   cid_t global_max_flushed_id_for_recovery;
   log_file_cursor_ = 0;
 
@@ -239,6 +342,25 @@ void WriteAheadFrontendLogger::DoRecovery() {
   // open first file
   OpenNextLogFile();
 
+  ReplayLogRecords(start_commit_id, global_max_flushed_id_for_recovery);
+
+  // Replay the committed transactions that are still buffered
+  ApplyRecoveryBatch();
+
+  // Finally, abort ACTIVE transactions in recovery_txn_table
+  AbortActiveTransactions();
+
+  // After finishing recovery, set the next oid with maximum oid
+  // observed during the recovery
+  log_manager.UpdateCatalogAndTxnManagers(max_oid, max_cid);
+
+  cur_file_handle = INVALID_FILE_HANDLE;
+}
+
+void WriteAheadFrontendLogger::ReplayLogRecords(
+    cid_t start_commit_id, cid_t global_max_flushed_id_for_recovery) {
+  int num_inserts = 0;
+
   // Go over the log file if needed
   bool reached_end_of_log = false;
 
@@ -351,8 +473,7 @@ void WriteAheadFrontendLogger::DoRecovery() {
         case LOGRECORD_TYPE_WAL_TUPLE_INSERT:
         case LOGRECORD_TYPE_WAL_TUPLE_DELETE:
         case LOGRECORD_TYPE_WAL_TUPLE_UPDATE:
-          recovery_txn_table[tuple_record->GetTransactionId()].push_back(
-              tuple_record);
+          AddTupleRecordRecovery(tuple_record);
           break;
         case LOGRECORD_TYPE_ITERATION_DELIMITER: {
           // Do nothing if we hit the delimiter, because the delimiters help
@@ -369,15 +490,7 @@ void WriteAheadFrontendLogger::DoRecovery() {
     }
   }
 
-  // Finally, abort ACTIVE transactions in recovery_txn_table
-  AbortActiveTransactions();
-
-  // After finishing recovery, set the next oid with maximum oid
-  // observed during the recovery
-  log_manager.UpdateCatalogAndTxnManagers(max_oid, max_cid);
-
   LOG_TRACE("This thread did %d inserts", (int)num_inserts);
-  cur_file_handle = INVALID_FILE_HANDLE;
 }
 
 void WriteAheadFrontendLogger::RecoverIndex() {
@@ -386,6 +499,8 @@ void WriteAheadFrontendLogger::RecoverIndex() {
   cid_t cid = txn_manager.GetNextCommitId();
   LOG_TRACE("Index Recovery got Next commit id as %d", (int)cid);
 
+  // Every index is rebuilt on its own
+  std::vector<std::pair<storage::DataTable *, index::Index *>> indexes;
   auto &catalog_manager = catalog::Manager::GetInstance();
   auto database_count = catalog_manager.GetDatabaseCount();
 
@@ -399,90 +514,75 @@ void WriteAheadFrontendLogger::RecoverIndex() {
       // Get the target table
       storage::DataTable *target_table = database->GetTable(table_idx);
       PL_ASSERT(target_table);
-      LOG_TRACE("SeqScan: database oid %u table oid %u: %s", database_idx,
-                table_idx, target_table->GetName().c_str());
-
-      if (!RecoverTableIndexHelper(target_table, cid)) {
-        break;
+      auto index_count = target_table->GetIndexCount();
+      for (oid_t index_itr = 0; index_itr < index_count; index_itr++) {
+        indexes.emplace_back(target_table, target_table->GetIndex(index_itr));
       }
     }
   }
+
+  std::atomic<size_t> next_index(0);
+  auto thread_count = std::min(recovery_thread_count_, indexes.size());
+  std::vector<std::thread> workers;
+  for (size_t thread_itr = 0; thread_itr < thread_count; thread_itr++) {
+    workers.emplace_back([this, &indexes, &next_index, cid] {
+      for (size_t index_itr = next_index++; index_itr < indexes.size();
+           index_itr = next_index++) {
+        RecoverTableIndexHelper(indexes[index_itr].first,
+                                indexes[index_itr].second, cid);
+      }
+    });
+  }
+  for (auto &worker : workers) {
+    worker.join();
+  }
 }
 
-bool WriteAheadFrontendLogger::RecoverTableIndexHelper(
-    storage::DataTable *target_table, cid_t start_cid) {
-  auto schema = target_table->GetSchema();
-  PL_ASSERT(schema);
-  std::vector<oid_t> column_ids;
-  column_ids.resize(schema->GetColumnCount());
-  std::iota(column_ids.begin(), column_ids.end(), 0);
+void WriteAheadFrontendLogger::RecoverTableIndexHelper(
+    storage::DataTable *target_table, index::Index *index, cid_t start_cid) {
+  auto index_schema = index->GetKeySchema();
+  auto indexed_columns = index_schema->GetIndexedColumns();
 
-  oid_t current_tile_group_offset = START_OID;
+  // Collect the keys of all visible tuples
+  std::vector<std::unique_ptr<storage::Tuple>> keys;
+  std::vector<ItemPointer> locations;
   auto table_tile_group_count = target_table->GetTileGroupCount();
   CheckpointTileScanner scanner;
 
-  while (current_tile_group_offset < table_tile_group_count) {
-    // Retrieve a tile group
-    auto tile_group = target_table->GetTileGroup(current_tile_group_offset);
+  for (oid_t tile_group_offset = START_OID;
+       tile_group_offset < table_tile_group_count; tile_group_offset++) {
+    auto tile_group = target_table->GetTileGroup(tile_group_offset);
+    auto tile_group_header = tile_group->GetHeader();
+    auto tile_group_id = tile_group->GetTileGroupId();
+    auto active_tuple_count = tile_group->GetNextTupleSlot();
 
-    // Retrieve a logical tile
-    std::unique_ptr<executor::LogicalTile> logical_tile(
-        scanner.Scan(tile_group, column_ids, start_cid));
-
-    // Empty result
-    if (!logical_tile) {
-      current_tile_group_offset++;
-      continue;
-    }
-
-    auto tile_group_id = logical_tile->GetColumnInfo(0)
-                             .base_tile->GetTileGroup()
-                             ->GetTileGroupId();
-    LOG_TRACE("Retrieved tile group %u", tile_group_id);
-
-    // Go over the logical tile
-    for (oid_t tuple_id : *logical_tile) {
-      expression::ContainerTuple<executor::LogicalTile> cur_tuple(
-          logical_tile.get(), tuple_id);
-
-      // Index update
-      {
-        // construct a physical tuple from the logical tuple
-        std::unique_ptr<storage::Tuple> tuple(new storage::Tuple(schema, true));
-        for (auto column_id : column_ids) {
-          tuple->SetValue(column_id, cur_tuple.GetValue(column_id),
-                          recovery_pool);
-        }
+    for (oid_t tuple_id = 0; tuple_id < active_tuple_count; tuple_id++) {
+      if (scanner.IsVisible(tile_group_header, tuple_id, start_cid) == false) {
+        continue;
+      }
 
-        ItemPointer location(tile_group_id, tuple_id);
-        InsertIndexEntry(tuple.get(), target_table, location);
+      std::unique_ptr<storage::Tuple> key(new storage::Tuple(index_schema, true));
+      for (oid_t column_itr = 0; column_itr < indexed_columns.size();
+           column_itr++) {
+        key->SetValue(column_itr,
+                      tile_group->GetValue(tuple_id, indexed_columns[column_itr]),
+                      index->GetPool());
       }
+      keys.push_back(std::move(key));
+      locations.emplace_back(tile_group_id, tuple_id);
     }
-    current_tile_group_offset++;
   }
-  return true;
-}
-
-void WriteAheadFrontendLogger::InsertIndexEntry(storage::Tuple *tuple,
-                                                storage::DataTable *table,
-                                                ItemPointer target_location) {
-  PL_ASSERT(tuple);
-  PL_ASSERT(table);
-  auto index_count = table->GetIndexCount();
-  LOG_TRACE("Insert tuple (%u, %u) into %u indexes", target_location.block,
-            target_location.offset, index_count);
 
-  for (int index_itr = index_count - 1; index_itr >= 0; --index_itr) {
-    auto index = table->GetIndex(index_itr);
-    auto index_schema = index->GetKeySchema();
-    auto indexed_columns = index_schema->GetIndexedColumns();
-    std::unique_ptr<storage::Tuple> key(new storage::Tuple(index_schema, true));
-    key->SetFromTuple(tuple, indexed_columns, index->GetPool());
+  LOG_TRACE("Insert %lu tuples into index %s", keys.size(),
+            index->GetName().c_str());
 
-    index->InsertEntry(key.get(), target_location);
-    // Increase the indexes' number of tuples by 1 as well
-    index->IncreaseNumberOfTuplesBy(1);
+  std::vector<const storage::Tuple *> key_pointers;
+  key_pointers.reserve(keys.size());
+  for (auto &key : keys) {
+    key_pointers.push_back(key.get());
   }
+  index->InsertEntries(key_pointers, locations);
+  index->IncreaseNumberOfTuplesBy(keys.size());
 }
 
 /**
@@ -514,8 +614,29 @@ void WriteAheadFrontendLogger::StartTransactionRecovery(cid_t commit_id) {
  */
 void WriteAheadFrontendLogger::CommitTransactionRecovery(cid_t commit_id) {
   std::vector<TupleRecord *> &tuple_records = recovery_txn_table[commit_id];
+  if (merged_recovery_) {
+    LogManager::GetInstance().AddRecoveredTransaction(commit_id,
+                                                      tuple_records);
+  } else {
+    ReplayTransaction(commit_id, tuple_records);
+  }
+  max_cid = commit_id + 1;
+  recovery_txn_table.erase(commit_id);
+}
+
+void WriteAheadFrontendLogger::AddTupleRecordRecovery(
+    TupleRecord *tuple_record) {
+  recovery_txn_table[tuple_record->GetTransactionId()].push_back(tuple_record);
+}
+
+void WriteAheadFrontendLogger::ReplayTransaction(
+    cid_t commit_id, std::vector<TupleRecord *> &tuple_records) {
   for (auto it = tuple_records.begin(); it != tuple_records.end(); it++) {
     TupleRecord *curr = *it;
+    if (recovery_thread_count_ > 1) {
+      AddRecoveryOperations(curr);
+      continue;
+    }
     switch (curr->GetType()) {
       case LOGRECORD_TYPE_WAL_TUPLE_INSERT:
         InsertTuple(curr);
@@ -527,12 +648,78 @@ void WriteAheadFrontendLogger::CommitTransactionRecovery(cid_t commit_id) {
         DeleteTuple(curr);
         break;
       default:
-        continue;
+        LOG_ERROR("Unexpected record type %d in a recovered transaction",
+                  curr->GetType());
+        break;
     }
     delete curr;
   }
-  max_cid = commit_id + 1;
-  recovery_txn_table.erase(commit_id);
+  max_cid = std::max(max_cid, commit_id + 1);
+
+  if (recovery_batch_records_.size() >= WAL_RECOVERY_BATCH_SIZE) {
+    ApplyRecoveryBatch();
+  }
+}
+
+/**
+ * @brief replay the committed transactions read from all log streams
+ *
+ * The streams are written independently, so the same tuple may be changed
+ * by transactions logged to different streams. Sorting the transactions by
+ * commit id replays them in the order they committed.
+ */
+void WriteAheadFrontendLogger::ReplayRecoveredTransactions(
+    std::vector<RecoveredTransaction> &transactions) {
+  std::sort(transactions.begin(), transactions.end(),
+            [](const RecoveredTransaction &left,
+               const RecoveredTransaction &right) {
+              return left.first < right.first;
+            });
+
+  LOG_TRACE("Replaying %lu transactions merged from the log streams",
+            transactions.size());
+  for (auto &transaction : transactions) {
+    ReplayTransaction(transaction.first, transaction.second);
+  }
+  transactions.clear();
+
+  ApplyRecoveryBatch();
+}
+
+void WriteAheadFrontendLogger::AddRecoveryOperations(TupleRecord *tuple_record) {
+  if (recovery_partitions_.size() != recovery_thread_count_) {
+    PL_ASSERT(recovery_batch_records_.empty());
+    recovery_partitions_.clear();
+    recovery_partitions_.resize(recovery_thread_count_);
+  }
+
+  // The operations on a tile group are replayed by a single thread, in
+  // commit order
+  auto add_operation = [this, tuple_record](oid_t tile_group_id,
+                                            bool insert_version) {
+    recovery_partitions_[tile_group_id % recovery_partitions_.size()]
+        .push_back(RecoveryOperation{tuple_record, insert_version});
+  };
+
+  switch (tuple_record->GetType()) {
+    case LOGRECORD_TYPE_WAL_TUPLE_INSERT:
+      add_operation(tuple_record->GetInsertLocation().block, true);
+      break;
+    case LOGRECORD_TYPE_WAL_TUPLE_UPDATE:
+      add_operation(tuple_record->GetInsertLocation().block, true);
+      add_operation(tuple_record->GetDeleteLocation().block, false);
+      break;
+    case LOGRECORD_TYPE_WAL_TUPLE_DELETE:
+      add_operation(tuple_record->GetDeleteLocation().block, false);
+      break;
+    default:
+      // Nothing to replay, the record is not queued so it is freed here
+      LOG_ERROR("Unexpected record type %d in a recovered transaction",
+                tuple_record->GetType());
+      delete tuple_record;
+      return;
+  }
+  recovery_batch_records_.push_back(tuple_record);
 }
 
 void InsertTupleHelper(oid_t &max_tg, cid_t commit_id, oid_t db_id,
@@ -597,8 +784,9 @@ void DeleteTupleHelper(oid_t &max_tg, cid_t commit_id, oid_t db_id,
     }
   }
   // FIXME we always decrease the number of tuples by one
+  table->GetTileGroupLock().WriteLock();
   table->DecreaseNumberOfTuplesBy(1);
-  // table->GetTileGroupLock().Unlock();
+  table->GetTileGroupLock().Unlock();
 
   tile_group->DeleteTupleFromRecovery(commit_id, delete_loc.offset);
 }
@@ -634,6 +822,31 @@ void UpdateTupleHelper(oid_t &max_tg, cid_t commit_id, oid_t db_id,
   tile_group->UpdateTupleFromRecovery(commit_id, remove_loc.offset, insert_loc);
 }
 
+// Only updates the old version, the new version is inserted separately
+void UpdateOldVersionHelper(oid_t &max_tg, cid_t commit_id, oid_t db_id,
+                            oid_t table_id, const ItemPointer &remove_loc,
+                            const ItemPointer &insert_loc) {
+  auto &manager = catalog::Manager::GetInstance();
+  storage::Database *db = manager.GetDatabaseWithOid(db_id);
+  PL_ASSERT(db);
+
+  auto table = db->GetTableWithOid(table_id);
+  if (!table) {
+    return;
+  }
+
+  auto tile_group = manager.GetTileGroup(remove_loc.block);
+  if (tile_group == nullptr) {
+    table->AddTileGroupWithOidForRecovery(remove_loc.block);
+    tile_group = manager.GetTileGroup(remove_loc.block);
+    if (max_tg < remove_loc.block) {
+      max_tg = remove_loc.block;
+    }
+  }
+
+  tile_group->UpdateTupleFromRecovery(commit_id, remove_loc.offset, insert_loc);
+}
+
 /**
  * @brief read tuple record from log file and add them tuples to recovery txn
  * @param recovery txn
@@ -666,6 +879,59 @@ void WriteAheadFrontendLogger::UpdateTuple(TupleRecord *record) {
                     record->GetTuple());
 }
 
+/**
+ * @brief replay the buffered operations of the committed transactions, every
+ * partition of tile groups on its own thread
+ */
+void WriteAheadFrontendLogger::ApplyRecoveryBatch() {
+  if (recovery_batch_records_.empty()) {
+    return;
+  }
+  LOG_TRACE("Replaying %lu tuple records", recovery_batch_records_.size());
+
+  std::vector<oid_t> max_tile_group_ids(recovery_partitions_.size(), max_oid);
+  std::vector<std::thread> workers;
+  for (size_t partition_itr = 0; partition_itr < recovery_partitions_.size();
+       partition_itr++) {
+    workers.emplace_back([this, partition_itr, &max_tile_group_ids] {
+      auto &max_tg = max_tile_group_ids[partition_itr];
+      for (auto &operation : recovery_partitions_[partition_itr]) {
+        auto record = operation.record;
+        if (operation.insert_version) {
+          InsertTupleHelper(
+              max_tg, record->GetTransactionId(), record->GetDatabaseOid(),
+              record->GetTableId(), record->GetInsertLocation(),
+              record->GetTuple(),
+              record->GetType() == LOGRECORD_TYPE_WAL_TUPLE_INSERT);
+        } else if (record->GetType() == LOGRECORD_TYPE_WAL_TUPLE_UPDATE) {
+          UpdateOldVersionHelper(max_tg, record->GetTransactionId(),
+                                 record->GetDatabaseOid(), record->GetTableId(),
+                                 record->GetDeleteLocation(),
+                                 record->GetInsertLocation());
+        } else {
+          DeleteTupleHelper(max_tg, record->GetTransactionId(),
+                            record->GetDatabaseOid(), record->GetTableId(),
+                            record->GetDeleteLocation());
+        }
+      }
+    });
+  }
+  for (auto &worker : workers) {
+    worker.join();
+  }
+
+  for (auto max_tile_group_id : max_tile_group_ids) {
+    max_oid = std::max(max_oid, max_tile_group_id);
+  }
+  for (auto &partition : recovery_partitions_) {
+    partition.clear();
+  }
+  for (auto record : recovery_batch_records_) {
+    delete record;
+  }
+  recovery_batch_records_.clear();
+}
+
 //===--------------------------------------------------------------------===//
 // Utility functions
 //===--------------------------------------------------------------------===//
@@ -721,6 +987,13 @@ LogRecordType WriteAheadFrontendLogger::GetNextLogRecordTypeForRecovery() {
   CopySerializeInputBE input(&buffer, sizeof(char));
   LogRecordType log_record_type = (LogRecordType)(input.ReadEnumInSingleByte());
 
+  // A zero byte marks the end of the log in a preallocated segment
+  if (log_record_type == LOGRECORD_TYPE_INVALID) {
+    LOG_TRACE("Reached the end of the log segment");
+    fseek(cur_file_handle.file, 0, SEEK_END);
+    return GetNextLogRecordTypeForRecovery();
+  }
+
   return log_record_type;
 }
 
@@ -745,6 +1018,7 @@ void WriteAheadFrontendLogger::InitLogFilesList() {
 
   // TODO need a better regular expression to match file name
   std::string base_name = "peloton_log_";
+  recycled_segments_.clear();
 
   LOG_TRACE("Trying to read log directory");
 
@@ -755,6 +1029,22 @@ void WriteAheadFrontendLogger::InitLogFilesList() {
 
   // XXX readdir is not thread safe???
   while ((file = readdir(dirp)) != NULL) {
+    if (strncmp(file->d_name, RECYCLED_SEGMENT_PREFIX.c_str(),
+                RECYCLED_SEGMENT_PREFIX.length()) == 0) {
+      // found a truncated segment, keep it for reuse
+      std::string file_name_with_dir =
+          peloton_log_directory + "/" + file->d_name;
+      recycled_segment_counter_ =
+          std::max(recycled_segment_counter_,
+                   LoggingUtil::ExtractNumberFromFileName(file->d_name) + 1);
+      if (recycled_segments_.size() < WAL_MAX_RECYCLED_SEGMENTS) {
+        recycled_segments_.push_back(file_name_with_dir);
+      } else {
+        remove(file_name_with_dir.c_str());
+      }
+      continue;
+    }
+
     if (strncmp(file->d_name, base_name.c_str(), base_name.length()) == 0) {
       // found a log file!
       LOG_TRACE("Found a log file with name %s", file->d_name);
@@ -955,6 +1245,12 @@ void WriteAheadFrontendLogger::CreateNewLogFile(bool close_old_file) {
 }
 
 bool WriteAheadFrontendLogger::FileSwitchCondIsTrue() {
+  // preallocated segments are as large as the limit from the start
+  if (segment_writer_ != nullptr && segment_writer_->IsOpen()) {
+    return segment_writer_->GetSize() >
+           LogManager::GetInstance().GetLogFileSizeLimit() * 1024UL;
+  }
+
   struct stat stat_buf;
   if (cur_file_handle.fd == -1) return false;
 
@@ -1047,7 +1343,11 @@ void WriteAheadFrontendLogger::TruncateLog(cid_t truncate_log_id) {
   for (int i = 0; i < (int)log_files_.size() - 1; i++) {
     if (truncate_log_id >= log_files_[i]->GetMaxLogId()) {
       // XXX Do we need directory prefix before log file name?
-      return_val = remove(log_files_[i]->GetLogFileName().c_str());
+      if (RecycleLogSegment(log_files_[i]->GetLogFileName())) {
+        return_val = 0;
+      } else {
+        return_val = remove(log_files_[i]->GetLogFileName().c_str());
+      }
       if (return_val != 0) {
         LOG_ERROR("Couldn't delete log file: %s error: %s",
                   log_files_[i]->GetLogFileName().c_str(), strerror(errno));
@@ -1060,6 +1360,73 @@ void WriteAheadFrontendLogger::TruncateLog(cid_t truncate_log_id) {
   }
 }
 
+void WriteAheadFrontendLogger::OpenLogSegment() {
+  if (segment_writer_ == nullptr) {
+    segment_writer_.reset(
+        new LogSegmentWriter(
+            [this](cid_t commit_id, int64_t duration, Result status) {
+              LogSegmentFlushed(commit_id, duration, status);
+            }));
+  }
+
+  std::string recycled_file_name;
+  if (recycled_segments_.empty() == false) {
+    recycled_file_name = recycled_segments_.back();
+    recycled_segments_.pop_back();
+  }
+
+  auto new_file_num = log_file_counter_;
+  auto new_file_name = GetFileNameFromVersion(new_file_num);
+  size_t segment_size =
+      LogManager::GetInstance().GetLogFileSizeLimit() * 1024UL;
+  if (segment_writer_->Open(new_file_name, recycled_file_name, segment_size) ==
+      false) {
+    return;
+  }
+
+  LogFile *new_log_file_object =
+      new LogFile(INVALID_FILE_HANDLE, new_file_name, new_file_num,
+                  INVALID_CID, INVALID_CID);
+  log_files_.push_back(new_log_file_object);
+
+  log_file_counter_++;
+  LOG_TRACE("log_file_counter is %d", log_file_counter_);
+}
+
+void WriteAheadFrontendLogger::CloseLogSegment() {
+  segment_writer_->Close(max_log_id_file, max_delimiter_file);
+
+  LogFile *cur_log_file_object = log_files_.back();
+  cur_log_file_object->SetMaxLogId(max_log_id_file);
+  cur_log_file_object->SetMaxDelimiter(max_delimiter_file);
+  cur_log_file_object->SetLogFileSize(segment_writer_->GetSize());
+
+  LOG_TRACE("Closed log segment with max log id %d and max delimiter %d",
+            (int)max_log_id_file, (int)max_delimiter_file);
+
+  max_log_id_file = 0;     // reset
+  max_delimiter_file = 0;  // reset
+}
+
+bool WriteAheadFrontendLogger::RecycleLogSegment(const std::string &file_name) {
+  if (segmented_io_ == false ||
+      recycled_segments_.size() >= WAL_MAX_RECYCLED_SEGMENTS) {
+    return false;
+  }
+
+  std::string recycled_file_name =
+      peloton_log_directory + "/" + RECYCLED_SEGMENT_PREFIX +
+      std::to_string(recycled_segment_counter_++) + LOG_FILE_SUFFIX;
+  if (rename(file_name.c_str(), recycled_file_name.c_str()) != 0) {
+    LOG_ERROR("Couldn't recycle log file: %s error: %s", file_name.c_str(),
+              strerror(errno));
+    return false;
+  }
+
+  recycled_segments_.push_back(recycled_file_name);
+  return true;
+}
+
 void WriteAheadFrontendLogger::InitLogDirectory() {
   // Get log directory
   auto &log_manager = logging::LogManager::GetInstance();
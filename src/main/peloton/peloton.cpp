@@ -19,6 +19,8 @@
 #include "common/config.h"
 #include "common/macros.h"
 
+#include "common/exception.h"
+#include "wire/event_server.h"
 #include "wire/socket_base.h"
 #include "wire/wire.h"
 
@@ -36,8 +38,20 @@ int main(UNUSED_ATTRIBUTE int argc, UNUSED_ATTRIBUTE char *argv[]) {
   peloton::wire::Server server(configuration);
 
   peloton::wire::StartServer(configuration, &server);
-  peloton::wire::HandleConnections<peloton::wire::PacketManager,
-                                   peloton::wire::PktBuf>(&server);
+
+  if (configuration.GetServerMode() == "THREAD_PER_CONNECTION") {
+    peloton::wire::HandleConnections<peloton::wire::PacketManager,
+                                     peloton::wire::PktBuf>(&server);
+  } else if (configuration.GetServerMode() == "EVENT_DRIVEN") {
+    peloton::wire::EventServer<peloton::wire::PacketManager,
+                               peloton::wire::PktBuf>
+        event_server(&server, configuration.GetIOThreadCount(),
+                     configuration.GetWorkerThreadCount());
+    event_server.HandleConnections();
+  } else {
+    throw peloton::Exception("Unknown server mode: " +
+                             configuration.GetServerMode());
+  }
 
 
 
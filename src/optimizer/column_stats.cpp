@@ -0,0 +1,242 @@
+//===----------------------------------------------------------------------===//
+//
+//                         Peloton
+//
+// column_stats.cpp
+//
+// Identification: src/optimizer/column_stats.cpp
+//
+// Copyright (c) 2015-16, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+
+#include "optimizer/column_stats.h"
+#include "common/value_peeker.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <functional>
+
+namespace peloton {
+namespace optimizer {
+
+//===--------------------------------------------------------------------===//
+// Helpers
+//===--------------------------------------------------------------------===//
+
+// Finalizer of splitmix64, spreads the entropy of the input over all bits
+static uint64_t MixHash(uint64_t hash) {
+  hash ^= hash >> 30;
+  hash *= 0xbf58476d1ce4e5b9ULL;
+  hash ^= hash >> 27;
+  hash *= 0x94d049bb133111ebULL;
+  hash ^= hash >> 31;
+  return hash;
+}
+
+static uint64_t HashValue(const Value &value) {
+  auto value_type = value.GetValueType();
+
+  if (IsIntegralType(value_type)) {
+    return MixHash(ValuePeeker::PeekAsBigInt(value));
+  }
+
+  switch (value_type) {
+    case VALUE_TYPE_DOUBLE: {
+      double raw_value = ValuePeeker::PeekDouble(value);
+      uint64_t bits;
+      std::memcpy(&bits, &raw_value, sizeof(bits));
+      return MixHash(bits);
+    }
+    case VALUE_TYPE_VARCHAR:
+    case VALUE_TYPE_VARBINARY:
+      return MixHash(static_cast<uint32_t>(value.MurmurHash3()));
+    default:
+      return MixHash(std::hash<std::string>()(value.GetInfo()));
+  }
+}
+
+//===--------------------------------------------------------------------===//
+// Column Stats
+//===--------------------------------------------------------------------===//
+
+ColumnStats::ColumnStats(ValueType type)
+    : type(type), registers(1 << HLL_PRECISION, 0), generator(type) {}
+
+void ColumnStats::AddValue(const Value &value) {
+  value_count++;
+
+  if (value.IsNull()) {
+    null_count++;
+    return;
+  }
+
+  AddToSketch(value);
+
+  if (IsNumeric(type)) {
+    AddToSample(value);
+  }
+}
+
+void ColumnStats::AddToSketch(const Value &value) {
+  uint64_t hash = HashValue(value);
+
+  // the first bits pick the register, the rank of the first set bit in
+  // the remaining ones is the observation
+  size_t register_id = hash >> (64 - HLL_PRECISION);
+  uint64_t remaining_bits = hash << HLL_PRECISION;
+  uint8_t rank = (remaining_bits == 0)
+                     ? (64 - HLL_PRECISION + 1)
+                     : (__builtin_clzll(remaining_bits) + 1);
+
+  registers[register_id] = std::max(registers[register_id], rank);
+}
+
+void ColumnStats::AddToSample(const Value &value) {
+  double raw_value =
+      ValuePeeker::PeekDouble(value.CastAs(VALUE_TYPE_DOUBLE));
+  sampled_value_count++;
+
+  // reservoir sampling
+  if (sample.size() < HISTOGRAM_SAMPLE_SIZE) {
+    sample.push_back(raw_value);
+    return;
+  }
+
+  std::uniform_int_distribution<size_t> distribution(0,
+                                                     sampled_value_count - 1);
+  size_t slot = distribution(generator);
+  if (slot < HISTOGRAM_SAMPLE_SIZE) {
+    sample[slot] = raw_value;
+  }
+}
+
+void ColumnStats::Finalize() {
+  histogram_bounds.clear();
+  if (sample.empty()) {
+    return;
+  }
+
+  std::sort(sample.begin(), sample.end());
+  min_value = sample.front();
+
+  size_t sample_size = sample.size();
+  for (size_t bucket_itr = 1; bucket_itr <= HISTOGRAM_BUCKET_COUNT;
+       bucket_itr++) {
+    size_t position = (bucket_itr * sample_size) / HISTOGRAM_BUCKET_COUNT;
+    histogram_bounds.push_back(sample[std::max<size_t>(position, 1) - 1]);
+  }
+
+  // the sample is not needed anymore
+  std::vector<double>().swap(sample);
+}
+
+double ColumnStats::GetNullFraction() const {
+  if (value_count == 0) {
+    return 0;
+  }
+  return static_cast<double>(null_count) / value_count;
+}
+
+double ColumnStats::GetDistinctCount() const {
+  const double register_count = registers.size();
+  const double alpha = 0.7213 / (1 + 1.079 / register_count);
+
+  double harmonic_sum = 0;
+  size_t zero_count = 0;
+  for (auto rank : registers) {
+    harmonic_sum += std::ldexp(1.0, -rank);
+    zero_count += (rank == 0);
+  }
+
+  double estimate = alpha * register_count * register_count / harmonic_sum;
+
+  // small range correction (linear counting)
+  if (estimate <= 2.5 * register_count && zero_count != 0) {
+    estimate = register_count * std::log(register_count / zero_count);
+  }
+
+  double non_null_count = value_count - null_count;
+  return std::max(std::min(estimate, non_null_count), 1.0);
+}
+
+double ColumnStats::GetLessThanFraction(double value, bool inclusive) const {
+  if (HasHistogram() == false) {
+    return DEFAULT_RANGE_SELECTIVITY;
+  }
+
+  double equal_fraction = inclusive ? (1.0 / GetDistinctCount()) : 0;
+
+  if (value < min_value) {
+    return 0;
+  }
+
+  // first bucket whose upper bound is not below the value
+  auto bound_itr = std::lower_bound(histogram_bounds.begin(),
+                                    histogram_bounds.end(), value);
+  if (bound_itr == histogram_bounds.end()) {
+    return 1;
+  }
+
+  size_t bucket = bound_itr - histogram_bounds.begin();
+  double lower_bound = (bucket == 0) ? min_value : histogram_bounds[bucket - 1];
+  double upper_bound = *bound_itr;
+
+  // assume the values are spread uniformly inside the bucket
+  double bucket_fraction = 0;
+  if (upper_bound > lower_bound) {
+    bucket_fraction = (value - lower_bound) / (upper_bound - lower_bound);
+  }
+
+  double fraction = (bucket + bucket_fraction) / HISTOGRAM_BUCKET_COUNT;
+  return std::min(fraction + equal_fraction, 1.0);
+}
+
+double ColumnStats::EstimateSelectivity(ExpressionType expr_type,
+                                        const Value &constant) const {
+  // a comparison with NULL is never true
+  if (constant.IsNull()) {
+    return 0;
+  }
+
+  double non_null_fraction = 1 - GetNullFraction();
+  double distinct_count = GetDistinctCount();
+
+  switch (expr_type) {
+    case EXPRESSION_TYPE_COMPARE_EQUAL:
+      return non_null_fraction / distinct_count;
+    case EXPRESSION_TYPE_COMPARE_NOTEQUAL:
+      return non_null_fraction * (1 - 1 / distinct_count);
+    case EXPRESSION_TYPE_COMPARE_LESSTHAN:
+    case EXPRESSION_TYPE_COMPARE_LESSTHANOREQUALTO:
+    case EXPRESSION_TYPE_COMPARE_GREATERTHAN:
+    case EXPRESSION_TYPE_COMPARE_GREATERTHANOREQUALTO:
+      break;
+    default:
+      return DEFAULT_SELECTIVITY;
+  }
+
+  if (HasHistogram() == false || IsNumeric(constant.GetValueType()) == false) {
+    return DEFAULT_RANGE_SELECTIVITY;
+  }
+
+  double value = ValuePeeker::PeekDouble(constant.CastAs(VALUE_TYPE_DOUBLE));
+
+  switch (expr_type) {
+    case EXPRESSION_TYPE_COMPARE_LESSTHAN:
+      return non_null_fraction * GetLessThanFraction(value, false);
+    case EXPRESSION_TYPE_COMPARE_LESSTHANOREQUALTO:
+      return non_null_fraction * GetLessThanFraction(value, true);
+    case EXPRESSION_TYPE_COMPARE_GREATERTHAN:
+      return non_null_fraction * (1 - GetLessThanFraction(value, true));
+    case EXPRESSION_TYPE_COMPARE_GREATERTHANOREQUALTO:
+      return non_null_fraction * (1 - GetLessThanFraction(value, false));
+    default:
+      return DEFAULT_SELECTIVITY;
+  }
+}
+
+} /* namespace optimizer */
+} /* namespace peloton */
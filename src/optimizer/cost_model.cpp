@@ -0,0 +1,297 @@
+//===----------------------------------------------------------------------===//
+//
+//                         Peloton
+//
+// cost_model.cpp
+//
+// Identification: src/optimizer/cost_model.cpp
+//
+// Copyright (c) 2015-16, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+
+#include "optimizer/cost_model.h"
+#include "optimizer/column.h"
+#include "optimizer/operator_visitor.h"
+#include "optimizer/operators.h"
+#include "storage/data_table.h"
+
+#include <algorithm>
+#include <cassert>
+#include <numeric>
+
+namespace peloton {
+namespace optimizer {
+
+namespace {
+
+// Comparison to use when the operands of a comparison are swapped
+ExpressionType CommuteComparison(ExpressionType expr_type) {
+  switch (expr_type) {
+    case EXPRESSION_TYPE_COMPARE_LESSTHAN:
+      return EXPRESSION_TYPE_COMPARE_GREATERTHAN;
+    case EXPRESSION_TYPE_COMPARE_GREATERTHAN:
+      return EXPRESSION_TYPE_COMPARE_LESSTHAN;
+    case EXPRESSION_TYPE_COMPARE_LESSTHANOREQUALTO:
+      return EXPRESSION_TYPE_COMPARE_GREATERTHANOREQUALTO;
+    case EXPRESSION_TYPE_COMPARE_GREATERTHANOREQUALTO:
+      return EXPRESSION_TYPE_COMPARE_LESSTHANOREQUALTO;
+    default:
+      return expr_type;
+  }
+}
+
+class StatsAndCostCalculator : public OperatorVisitor {
+ public:
+  StatsAndCostCalculator(const std::vector<std::shared_ptr<Stats>> &child_stats,
+                         const std::vector<double> &child_costs)
+      : child_stats(child_stats), child_costs(child_costs) {
+    // By default an operator passes its first input through and costs as
+    // much as its children
+    double cardinality = 1;
+    if (child_stats.empty() == false && child_stats[0] != nullptr) {
+      cardinality = child_stats[0]->GetCardinality();
+    }
+    output_stats = std::make_shared<Stats>(cardinality);
+    output_cost = std::accumulate(child_costs.begin(), child_costs.end(), 0.0);
+  }
+
+  void visit(const PhysicalScan *op) override {
+    double cardinality = DEFAULT_TABLE_CARDINALITY;
+    if (op->table != nullptr) {
+      auto table_stats = StatsManager::GetInstance().GetTableStats(op->table);
+      cardinality = table_stats->GetRowCount();
+    }
+
+    output_stats = std::make_shared<Stats>(cardinality);
+    output_cost = cardinality * SCAN_TUPLE_COST;
+  }
+
+  void visit(const PhysicalComputeExprs *) override {
+    assert(child_stats.size() == 2);
+    double input_cardinality = GetCardinality(0);
+
+    output_stats = std::make_shared<Stats>(input_cardinality);
+    output_cost = child_costs[0] + input_cardinality * PROJECT_TUPLE_COST;
+  }
+
+  void visit(const PhysicalFilter *) override {
+    assert(child_stats.size() == 2);
+    double input_cardinality = GetCardinality(0);
+
+    output_stats =
+        std::make_shared<Stats>(input_cardinality * GetSelectivity(1));
+    output_cost = child_costs[0] + input_cardinality * PREDICATE_TUPLE_COST;
+  }
+
+  void visit(const PhysicalInnerNLJoin *) override {
+    CostNLJoin(JOIN_TYPE_INNER);
+  }
+
+  void visit(const PhysicalLeftNLJoin *) override { CostNLJoin(JOIN_TYPE_LEFT); }
+
+  void visit(const PhysicalRightNLJoin *) override {
+    CostNLJoin(JOIN_TYPE_RIGHT);
+  }
+
+  void visit(const PhysicalOuterNLJoin *) override {
+    CostNLJoin(JOIN_TYPE_OUTER);
+  }
+
+  void visit(const PhysicalInnerHashJoin *) override {
+    CostHashJoin(JOIN_TYPE_INNER);
+  }
+
+  void visit(const PhysicalLeftHashJoin *) override {
+    CostHashJoin(JOIN_TYPE_LEFT);
+  }
+
+  void visit(const PhysicalRightHashJoin *) override {
+    CostHashJoin(JOIN_TYPE_RIGHT);
+  }
+
+  void visit(const PhysicalOuterHashJoin *) override {
+    CostHashJoin(JOIN_TYPE_OUTER);
+  }
+
+  void visit(const ExprVariable *op) override {
+    output_stats = std::make_shared<Stats>(1);
+    output_cost = 0;
+
+    // Only columns of base tables have stats
+    TableColumn *table_column = dynamic_cast<TableColumn *>(op->column);
+    if (table_column == nullptr) {
+      return;
+    }
+
+    auto table_stats =
+        StatsManager::GetInstance().GetTableStats(table_column->BaseTableOid());
+    if (table_stats != nullptr) {
+      output_stats->SetColumnStats(
+          table_stats,
+          table_stats->GetColumnStats(table_column->ColumnIndexOid()));
+    }
+  }
+
+  void visit(const ExprConstant *op) override {
+    output_stats = std::make_shared<Stats>(1);
+    output_cost = 0;
+
+    output_stats->SetConstant(op->value);
+    if (op->value.GetValueType() == VALUE_TYPE_BOOLEAN) {
+      output_stats->SetSelectivity(op->value.IsTrue() ? 1 : 0);
+    }
+  }
+
+  void visit(const ExprCompare *op) override {
+    assert(child_stats.size() == 2);
+    output_stats = std::make_shared<Stats>(1);
+    output_cost = 0;
+
+    auto &left = child_stats[0];
+    auto &right = child_stats[1];
+    auto left_column = (left != nullptr) ? left->GetColumnStats() : nullptr;
+    auto right_column = (right != nullptr) ? right->GetColumnStats() : nullptr;
+
+    double selectivity;
+    if (left_column != nullptr && right != nullptr && right->HasConstant()) {
+      // column <op> constant
+      selectivity =
+          left_column->EstimateSelectivity(op->expr_type, right->GetConstant());
+    } else if (right_column != nullptr && left != nullptr &&
+               left->HasConstant()) {
+      // constant <op> column
+      selectivity = right_column->EstimateSelectivity(
+          CommuteComparison(op->expr_type), left->GetConstant());
+    } else if (left_column != nullptr && right_column != nullptr &&
+               op->expr_type == EXPRESSION_TYPE_COMPARE_EQUAL) {
+      // equi-join: every value of the side with fewer distinct values is
+      // assumed to find its matches on the other side
+      selectivity = 1.0 / std::max(left_column->GetDistinctCount(),
+                                   right_column->GetDistinctCount());
+    } else if (op->expr_type == EXPRESSION_TYPE_COMPARE_EQUAL) {
+      selectivity = DEFAULT_SELECTIVITY;
+    } else {
+      selectivity = DEFAULT_RANGE_SELECTIVITY;
+    }
+
+    output_stats->SetSelectivity(selectivity);
+  }
+
+  void visit(const ExprBoolOp *op) override {
+    output_stats = std::make_shared<Stats>(1);
+    output_cost = 0;
+
+    double selectivity;
+    switch (op->bool_type) {
+      case BoolOpType::Not:
+        assert(child_stats.size() == 1);
+        selectivity = 1 - GetSelectivity(0);
+        break;
+      case BoolOpType::And:
+        // assume the conjuncts are independent
+        selectivity = 1;
+        for (size_t child_itr = 0; child_itr < child_stats.size();
+             child_itr++) {
+          selectivity *= GetSelectivity(child_itr);
+        }
+        break;
+      case BoolOpType::Or: {
+        double rejected = 1;
+        for (size_t child_itr = 0; child_itr < child_stats.size();
+             child_itr++) {
+          rejected *= (1 - GetSelectivity(child_itr));
+        }
+        selectivity = 1 - rejected;
+      } break;
+      default:
+        selectivity = DEFAULT_SELECTIVITY;
+        break;
+    }
+
+    output_stats->SetSelectivity(selectivity);
+  }
+
+  void visit(const ExprOp *) override {
+    output_stats = std::make_shared<Stats>(1);
+    output_stats->SetSelectivity(DEFAULT_SELECTIVITY);
+    output_cost = 0;
+  }
+
+  std::shared_ptr<Stats> output_stats;
+
+  double output_cost;
+
+ private:
+  double GetCardinality(size_t child_itr) const {
+    auto &stats = child_stats[child_itr];
+    return (stats != nullptr) ? stats->GetCardinality() : 1;
+  }
+
+  double GetSelectivity(size_t child_itr) const {
+    auto &stats = child_stats[child_itr];
+    return (stats != nullptr) ? stats->GetSelectivity() : DEFAULT_SELECTIVITY;
+  }
+
+  double GetJoinCardinality(PelotonJoinType join_type) const {
+    double left_cardinality = GetCardinality(0);
+    double right_cardinality = GetCardinality(1);
+    double cardinality = left_cardinality * right_cardinality * GetSelectivity(2);
+
+    // outer joins keep the unmatched tuples of their outer side(s)
+    switch (join_type) {
+      case JOIN_TYPE_LEFT:
+        return std::max(cardinality, left_cardinality);
+      case JOIN_TYPE_RIGHT:
+        return std::max(cardinality, right_cardinality);
+      case JOIN_TYPE_OUTER:
+        return std::max(cardinality, left_cardinality + right_cardinality);
+      default:
+        return cardinality;
+    }
+  }
+
+  // Every pair of tuples is compared
+  void CostNLJoin(PelotonJoinType join_type) {
+    assert(child_stats.size() == 3);
+    double cardinality = GetJoinCardinality(join_type);
+
+    output_stats = std::make_shared<Stats>(cardinality);
+    output_cost = child_costs[0] + child_costs[1] +
+                  GetCardinality(0) * GetCardinality(1) * PREDICATE_TUPLE_COST +
+                  cardinality * OUTPUT_TUPLE_COST;
+  }
+
+  // The hash table is built on the right child and probed with the left one
+  void CostHashJoin(PelotonJoinType join_type) {
+    assert(child_stats.size() == 3);
+    double cardinality = GetJoinCardinality(join_type);
+
+    output_stats = std::make_shared<Stats>(cardinality);
+    output_cost = child_costs[0] + child_costs[1] +
+                  GetCardinality(1) * HASH_BUILD_TUPLE_COST +
+                  GetCardinality(0) * HASH_PROBE_TUPLE_COST +
+                  cardinality * (PREDICATE_TUPLE_COST + OUTPUT_TUPLE_COST);
+  }
+
+  const std::vector<std::shared_ptr<Stats>> &child_stats;
+
+  const std::vector<double> &child_costs;
+};
+
+}
+
+void DeriveOperatorStatsAndCost(
+    const Operator &op, const std::vector<std::shared_ptr<Stats>> &child_stats,
+    const std::vector<double> &child_costs,
+    std::shared_ptr<Stats> &output_stats, double &output_cost) {
+  StatsAndCostCalculator calculator(child_stats, child_costs);
+  op.accept(&calculator);
+
+  output_stats = calculator.output_stats;
+  output_cost = calculator.output_cost;
+}
+
+} /* namespace optimizer */
+} /* namespace peloton */
@@ -13,6 +13,7 @@
 
 #include "optimizer/group_expression.h"
 #include "optimizer/group.h"
+#include "optimizer/cost_model.h"
 
 namespace peloton {
 namespace optimizer {
@@ -21,7 +22,10 @@ namespace optimizer {
 // Group Expression
 //===--------------------------------------------------------------------===//
 GroupExpression::GroupExpression(Operator op, std::vector<GroupID> child_groups)
-    : group_id(UNDEFINED_GROUP), op(op), child_groups(child_groups) {}
+    : group_id(UNDEFINED_GROUP),
+      op(op),
+      child_groups(child_groups),
+      cost(0) {}
 
 GroupID GroupExpression::GetGroupID() const { return group_id; }
 
@@ -40,8 +44,7 @@ double GroupExpression::GetCost() const { return cost; }
 void GroupExpression::DeriveStatsAndCost(
     std::vector<std::shared_ptr<Stats>> child_stats,
     std::vector<double> child_costs) {
-  (void)child_stats;
-  (void)child_costs;
+  DeriveOperatorStatsAndCost(op, child_stats, child_costs, stats, cost);
 }
 
 hash_t GroupExpression::Hash() const {
@@ -40,7 +40,7 @@ Optimizer::Optimizer() {
   rules.emplace_back(new LeftJoinToLeftNLJoin());
   rules.emplace_back(new RightJoinToRightNLJoin());
   rules.emplace_back(new OuterJoinToOuterNLJoin());
-  // rules.emplace_back(new InnerJoinToInnerHashJoin());
+  rules.emplace_back(new InnerJoinToInnerHashJoin());
 }
 
 Optimizer &Optimizer::GetInstance() {
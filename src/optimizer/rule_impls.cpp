@@ -307,7 +307,11 @@ InnerJoinToInnerHashJoin::InnerJoinToInnerHashJoin() {
   // Make three node types for pattern matching
   std::shared_ptr<Pattern> left_child(std::make_shared<Pattern>(OpType::Leaf));
   std::shared_ptr<Pattern> right_child(std::make_shared<Pattern>(OpType::Leaf));
-  std::shared_ptr<Pattern> predicate(std::make_shared<Pattern>(OpType::Leaf));
+
+  // The predicate must be a comparison between two columns
+  std::shared_ptr<Pattern> predicate(std::make_shared<Pattern>(OpType::Compare));
+  predicate->AddChild(std::make_shared<Pattern>(OpType::Variable));
+  predicate->AddChild(std::make_shared<Pattern>(OpType::Variable));
 
   // Initialize a pattern for optimizer to match
   match_pattern = std::make_shared<Pattern>(OpType::InnerJoin);
@@ -321,9 +325,14 @@ InnerJoinToInnerHashJoin::InnerJoinToInnerHashJoin() {
 }
 
 bool InnerJoinToInnerHashJoin::Check(std::shared_ptr<OpExpression> plan) const {
-  (void)plan;
-  // TODO(abpoms): Figure out how to determine if the join condition is hashable
-  return false;
+  // The join condition is hashable if it is an equality between two columns
+  std::vector<std::shared_ptr<OpExpression>> children = plan->Children();
+  assert(children.size() == 3);
+  const ExprCompare *predicate = children[2]->Op().as<ExprCompare>();
+  if (predicate == nullptr) {
+    return false;
+  }
+  return (predicate->expr_type == EXPRESSION_TYPE_COMPARE_EQUAL);
 }
 
 void InnerJoinToInnerHashJoin::Transform(
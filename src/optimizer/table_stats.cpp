@@ -0,0 +1,183 @@
+//===----------------------------------------------------------------------===//
+//
+//                         Peloton
+//
+// table_stats.cpp
+//
+// Identification: src/optimizer/table_stats.cpp
+//
+// Copyright (c) 2015-16, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+
+#include "optimizer/table_stats.h"
+#include "catalog/schema.h"
+#include "common/logger.h"
+#include "storage/data_table.h"
+#include "storage/tile_group.h"
+#include "storage/tile_group_header.h"
+
+#include <algorithm>
+#include <cmath>
+
+namespace peloton {
+namespace optimizer {
+
+//===--------------------------------------------------------------------===//
+// Table Stats
+//===--------------------------------------------------------------------===//
+
+std::shared_ptr<TableStats> TableStats::Analyze(storage::DataTable *table) {
+  std::shared_ptr<TableStats> stats(new TableStats(table->GetOid()));
+  stats->analyzed_tuple_count = table->GetNumberOfTuples();
+
+  auto schema = table->GetSchema();
+  oid_t column_count = schema->GetColumnCount();
+  for (oid_t column_id = 0; column_id < column_count; column_id++) {
+    stats->column_stats.emplace_back(schema->GetType(column_id));
+  }
+
+  size_t tile_group_count = table->GetTileGroupCount();
+  for (size_t tile_group_offset = 0; tile_group_offset < tile_group_count;
+       tile_group_offset++) {
+    auto tile_group = table->GetTileGroup(tile_group_offset);
+    auto tile_group_header = tile_group->GetHeader();
+    oid_t tuple_count = tile_group->GetNextTupleSlot();
+
+    for (oid_t tuple_id = 0; tuple_id < tuple_count; tuple_id++) {
+      // only count the latest committed version of each tuple
+      if (tile_group_header->GetTransactionId(tuple_id) != INITIAL_TXN_ID ||
+          tile_group_header->GetEndCommitId(tuple_id) != MAX_CID) {
+        continue;
+      }
+
+      stats->row_count++;
+      for (oid_t column_id = 0; column_id < column_count; column_id++) {
+        stats->column_stats[column_id].AddValue(
+            tile_group->GetValue(tuple_id, column_id));
+      }
+    }
+  }
+
+  for (auto &column_stats : stats->column_stats) {
+    column_stats.Finalize();
+  }
+
+  LOG_TRACE("Analyzed table %u : %.0f rows", stats->table_oid,
+            stats->row_count);
+  return stats;
+}
+
+const ColumnStats *TableStats::GetColumnStats(oid_t column_id) const {
+  if (column_id >= column_stats.size()) {
+    return nullptr;
+  }
+  return &column_stats[column_id];
+}
+
+//===--------------------------------------------------------------------===//
+// Stats Manager
+//===--------------------------------------------------------------------===//
+
+StatsManager &StatsManager::GetInstance() {
+  static StatsManager stats_manager;
+  return stats_manager;
+}
+
+std::shared_ptr<TableStats> StatsManager::GetTableStats(
+    storage::DataTable *table) {
+  auto table_oid = table->GetOid();
+  std::promise<std::shared_ptr<TableStats>> analysis;
+  std::shared_future<std::shared_ptr<TableStats>> running_analysis;
+
+  {
+    std::lock_guard<std::mutex> lock(stats_mutex);
+    auto &entry = table_stats[table_oid];
+
+    if (entry.stats != nullptr) {
+      double analyzed_tuple_count = entry.stats->GetAnalyzedTupleCount();
+      double drift =
+          std::fabs(table->GetNumberOfTuples() - analyzed_tuple_count);
+      bool stale = drift > STATS_STALENESS_THRESHOLD *
+                               std::max(analyzed_tuple_count, 1.0);
+
+      // stale stats are good enough while someone else refreshes them
+      if (stale == false || entry.analyzing == true) {
+        return entry.stats;
+      }
+    }
+
+    if (entry.analyzing == true) {
+      running_analysis = entry.analysis;
+    } else {
+      entry.analyzing = true;
+      entry.analysis = analysis.get_future().share();
+    }
+  }
+
+  // there are no stats to fall back on, wait for the running analyze
+  if (running_analysis.valid()) {
+    return running_analysis.get();
+  }
+
+  std::shared_ptr<TableStats> stats;
+  try {
+    stats = TableStats::Analyze(table);
+  } catch (...) {
+    {
+      std::lock_guard<std::mutex> lock(stats_mutex);
+      auto entry_itr = table_stats.find(table_oid);
+      if (entry_itr != table_stats.end()) {
+        entry_itr->second.analyzing = false;
+      }
+    }
+    analysis.set_exception(std::current_exception());
+    throw;
+  }
+
+  {
+    std::lock_guard<std::mutex> lock(stats_mutex);
+    // the stats might have been dropped in the meantime
+    auto entry_itr = table_stats.find(table_oid);
+    if (entry_itr != table_stats.end()) {
+      entry_itr->second.stats = stats;
+      entry_itr->second.analyzing = false;
+    }
+  }
+
+  analysis.set_value(stats);
+  return stats;
+}
+
+std::shared_ptr<TableStats> StatsManager::GetTableStats(oid_t table_oid) {
+  std::lock_guard<std::mutex> lock(stats_mutex);
+  auto stats_itr = table_stats.find(table_oid);
+  if (stats_itr == table_stats.end()) {
+    return nullptr;
+  }
+  return stats_itr->second.stats;
+}
+
+std::shared_ptr<TableStats> StatsManager::AnalyzeTable(
+    storage::DataTable *table) {
+  // an explicit analyze always scans the table
+  auto stats = TableStats::Analyze(table);
+
+  std::lock_guard<std::mutex> lock(stats_mutex);
+  table_stats[table->GetOid()].stats = stats;
+  return stats;
+}
+
+void StatsManager::DropTableStats(oid_t table_oid) {
+  std::lock_guard<std::mutex> lock(stats_mutex);
+  table_stats.erase(table_oid);
+}
+
+void StatsManager::Clear() {
+  std::lock_guard<std::mutex> lock(stats_mutex);
+  table_stats.clear();
+}
+
+} /* namespace optimizer */
+} /* namespace peloton */
@@ -0,0 +1,40 @@
+//===----------------------------------------------------------------------===//
+//
+//                         Peloton
+//
+// import_plan.cpp
+//
+// Identification: src/planner/import_plan.cpp
+//
+// Copyright (c) 2015-16, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+
+#include "planner/import_plan.h"
+
+#include "storage/data_table.h"
+#include "parser/statement_import.h"
+
+namespace peloton {
+namespace planner {
+
+ImportPlan::ImportPlan(storage::DataTable *table, std::string file_path,
+                       char delimiter)
+    : target_table_(table),
+      table_name_(table->GetName()),
+      file_path_(file_path),
+      delimiter_(delimiter) {}
+
+ImportPlan::ImportPlan(parser::ImportStatement *parse_tree)
+    : table_name_(parse_tree->table_name),
+      file_path_(parse_tree->file_path) {
+  if (parse_tree->type == parser::ImportStatement::kImportTSV) {
+    delimiter_ = '\t';
+  } else {
+    delimiter_ = ',';
+  }
+}
+
+}  // namespace planner
+}  // namespace peloton
@@ -19,6 +19,7 @@
 #include "common/exception.h"
 #include "common/logger.h"
 #include "common/platform.h"
+#include "common/plan_cache.h"
 #include "catalog/foreign_key.h"
 #include "concurrency/transaction_manager_factory.h"
 #include "gc/gc_manager_factory.h"
@@ -66,6 +67,10 @@ DataTable::DataTable(catalog::Schema *schema, const std::string &table_name,
 }
 
 DataTable::~DataTable() {
+  // release the tile groups held by the insert buffers
+  for (auto &insert_buffer : insert_buffers_) {
+    insert_buffer.tile_group.reset();
+  }
 
   // clean up tile groups by dropping the references in the catalog
   oid_t tile_group_count = GetTileGroupCount();
@@ -124,14 +129,23 @@ bool DataTable::CheckConstraints(const storage::Tuple *tuple) const {
   return true;
 }
 
+namespace {
+
+// Insert buffer of the calling thread
+size_t GetInsertBufferOffset() {
+  static std::atomic<size_t> next_thread_id(0);
+  thread_local static size_t thread_id = next_thread_id++;
+  return thread_id % DATA_TABLE_INSERT_BUFFER_COUNT;
+}
+
+}  // namespace
+
 // this function is called when update/delete/insert is performed.
-// this function first checks whether there's available slot.
-// if yes, then directly return the available slot.
-// in particular, if this is the last slot, a new tile group is created.
-// if there's no available slot, then some other threads must be allocating a
-// new tile group.
-// we just wait until a new tuple slot in the newly allocated tile group is
-// available.
+// this function first tries to reuse a slot recycled by the GC.
+// otherwise it claims the next slot of the tile group owned by the insert
+// buffer of the calling thread.
+// in particular, if this is the last slot of that tile group, the tile group
+// is released and a new one is prepared for the next buffer that needs one.
 ItemPointer DataTable::GetEmptyTupleSlot(const storage::Tuple *tuple,
                                          UNUSED_ATTRIBUTE bool check_constraint) {
   PL_ASSERT(tuple);
@@ -142,48 +156,87 @@ ItemPointer DataTable::GetEmptyTupleSlot(const storage::Tuple *tuple,
   }
    */
 
+  auto &insert_buffer = insert_buffers_[GetInsertBufferOffset()];
+  insert_buffer.lock.Lock();
+
   //=============== garbage collection==================
   // check if there are recycled tuple slots
-  /*
-  auto &gc_manager = gc::GCManagerFactory::GetInstance();
-  auto free_item_pointer = gc_manager.ReturnFreeSlot(this->table_oid);
-  if (free_item_pointer.IsNull() == false) {
-    return free_item_pointer;
+  ItemPointer location = GetRecycledTupleSlot(insert_buffer, tuple);
+  if (location.IsNull() == false) {
+    insert_buffer.lock.Unlock();
+    return location;
   }
-   */
   //====================================================
 
-  std::shared_ptr<storage::TileGroup> tile_group;
   oid_t tuple_slot = INVALID_OID;
-  oid_t tile_group_id = INVALID_OID;
 
   // get valid tuple.
   while (true) {
-    // get the last tile group.
-    tile_group = GetTileGroup(tile_group_count_ - 1);
+    if (insert_buffer.tile_group == nullptr) {
+      insert_buffer.tile_group = ClaimTileGroup();
+    }
 
-    tuple_slot = tile_group->InsertTuple(tuple);
+    tuple_slot = insert_buffer.tile_group->InsertTuple(tuple);
 
     // now we have already obtained a new tuple slot.
     if (tuple_slot != INVALID_OID) {
-      tile_group_id = tile_group->GetTileGroupId();
       break;
     }
+
+    // the tile group is full
+    insert_buffer.tile_group.reset();
   }
 
+  auto tile_group = insert_buffer.tile_group;
+  location = ItemPointer(tile_group->GetTileGroupId(), tuple_slot);
+
   // if this is the last tuple slot we can get
-  // then create a new tile group
+  // then release the tile group
   if (tuple_slot == tile_group->GetAllocatedTupleCount() - 1) {
-    AddDefaultTileGroup();
+    insert_buffer.tile_group.reset();
+    PrepareTileGroup();
   }
 
+  insert_buffer.lock.Unlock();
+
   LOG_TRACE("tile group count: %lu, tile group id: %u, address: %p",
             tile_group_count_.load(), tile_group->GetTileGroupId(),
             tile_group.get());
 
-  // Set tuple location
-  ItemPointer location(tile_group_id, tuple_slot);
+  return location;
+}
+
+// Reuse a slot recycled by the GC. The recycled slots are taken from the GC
+// in batches, and when the GC has none the next inserts do not ask again.
+ItemPointer DataTable::GetRecycledTupleSlot(InsertBuffer &insert_buffer,
+                                            const storage::Tuple *tuple) {
+  auto &free_slots = insert_buffer.free_slots;
+  if (free_slots.empty()) {
+    if (insert_buffer.free_slot_backoff > 0) {
+      insert_buffer.free_slot_backoff--;
+      return INVALID_ITEMPOINTER;
+    }
+
+    auto &gc_manager = gc::GCManagerFactory::GetInstance();
+    gc_manager.ReturnFreeSlots(this->table_oid, free_slots,
+                               DATA_TABLE_FREE_SLOT_BATCH_SIZE);
+    if (free_slots.empty()) {
+      insert_buffer.free_slot_backoff = DATA_TABLE_FREE_SLOT_BATCH_SIZE;
+      return INVALID_ITEMPOINTER;
+    }
+  }
+
+  ItemPointer location = free_slots.back();
+  free_slots.pop_back();
 
+  auto tile_group = catalog::Manager::GetInstance().GetTileGroup(location.block);
+  if (tile_group == nullptr) {
+    return INVALID_ITEMPOINTER;
+  }
+
+  tile_group->CopyTuple(tuple, location.offset);
+
+  LOG_TRACE("Reuse tuple slot (%u, %u)", location.block, location.offset);
   return location;
 }
 
@@ -501,15 +554,19 @@ column_map_type DataTable::GetTileGroupLayout(LayoutType layout_type) {
   return column_map;
 }
 
-oid_t DataTable::AddDefaultTileGroup() {
-  column_map_type column_map;
-  oid_t tile_group_id = INVALID_OID;
-
+TileGroup *DataTable::GetDefaultTileGroup() {
   // Figure out the partitioning for given tilegroup layout
-  column_map = GetTileGroupLayout((LayoutType) peloton_layout_mode);
+  column_map_type column_map =
+      GetTileGroupLayout((LayoutType) peloton_layout_mode);
 
   // Create a tile group with that partitioning
-  std::shared_ptr<TileGroup> tile_group(GetTileGroupWithLayout(column_map));
+  return GetTileGroupWithLayout(column_map);
+}
+
+oid_t DataTable::AddDefaultTileGroup() {
+  oid_t tile_group_id = INVALID_OID;
+
+  std::shared_ptr<TileGroup> tile_group(GetDefaultTileGroup());
   PL_ASSERT(tile_group.get());
   tile_group_id = tile_group->GetTileGroupId();
 
@@ -536,6 +593,31 @@ oid_t DataTable::AddDefaultTileGroup() {
   return tile_group_id;
 }
 
+std::shared_ptr<storage::TileGroup> DataTable::ClaimTileGroup() {
+  std::lock_guard<std::mutex> lock(claim_mutex_);
+
+  // take the oldest unclaimed tile group that still has free slots
+  while (next_unclaimed_offset_ < tile_group_count_) {
+    auto tile_group = GetTileGroup(next_unclaimed_offset_++);
+    if (tile_group != nullptr &&
+        tile_group->GetNextTupleSlot() < tile_group->GetAllocatedTupleCount()) {
+      return tile_group;
+    }
+  }
+
+  auto tile_group_id = AddDefaultTileGroup();
+  next_unclaimed_offset_ = tile_group_count_;
+  return GetTileGroupById(tile_group_id);
+}
+
+void DataTable::PrepareTileGroup() {
+  std::lock_guard<std::mutex> lock(claim_mutex_);
+
+  if (next_unclaimed_offset_ >= tile_group_count_) {
+    AddDefaultTileGroup();
+  }
+}
+
 void DataTable::AddTileGroupWithOidForRecovery(const oid_t &tile_group_id) {
   PL_ASSERT(tile_group_id);
 
@@ -613,6 +695,18 @@ std::shared_ptr<storage::TileGroup> DataTable::GetTileGroupById(
 }
 
 void DataTable::DropTileGroups() {
+  for (auto &insert_buffer : insert_buffers_) {
+    insert_buffer.lock.Lock();
+    insert_buffer.tile_group.reset();
+    insert_buffer.free_slots.clear();
+    insert_buffer.lock.Unlock();
+  }
+
+  {
+    std::lock_guard<std::mutex> lock(claim_mutex_);
+    next_unclaimed_offset_ = 0;
+  }
+
   tile_group_count_ = 0;
   auto &catalog_manager = catalog::Manager::GetInstance();
   for (auto tile_group_id : tile_groups_) {
@@ -671,6 +765,9 @@ void DataTable::AddIndex(index::Index *index) {
   } else if (index_type == INDEX_CONSTRAINT_TYPE_UNIQUE) {
     unique_constraint_count_++;
   }
+
+  // Cached plans may pick other access paths now
+  PlanCache::GetInstance().Invalidate();
 }
 
 index::Index *DataTable::GetIndexWithOid(const oid_t &index_oid) const {
@@ -694,6 +791,9 @@ void DataTable::DropIndexWithOid(const oid_t &index_id) {
     // Drop the index
     indexes_.erase(indexes_.begin() + index_offset);
   }
+
+  // Cached plans may reference the index
+  PlanCache::GetInstance().Invalidate();
 }
 
 index::Index *DataTable::GetIndex(const oid_t &index_offset) const {
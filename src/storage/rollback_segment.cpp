@@ -14,6 +14,7 @@
 #include "storage/rollback_segment.h"
 #include "logging/log_manager.h"
 #include "planner/project_info.h"
+#include "storage/tuple.h"
 
 namespace peloton {
 namespace storage {
@@ -55,6 +56,7 @@ RBSegType RollbackSegmentPool::CreateSegmentFromTuple(
   // Fill in the header
   SetNextPtr(rb_seg, nullptr);
   SetTimeStamp(rb_seg, MAX_CID);
+  SetBeginTimeStamp(rb_seg, MAX_CID);
   SetColCount(rb_seg, col_count);
 
   // Fill in the col_id & offset pair and set the data field
@@ -102,5 +104,20 @@ Value RollbackSegmentPool::GetValue(RBSegType rb_seg,
   return Value::InitFromTupleStorage(data_ptr, column_type, is_inlined);
 }
 
+/**
+ * @brief Restore the columns recorded on the rollback segment in a tuple
+ *
+ * @param tuple A tuple with the schema of the table
+ */
+void RollbackSegmentPool::ApplyToTuple(RBSegType rb_seg,
+                                       const catalog::Schema *schema,
+                                       Tuple *tuple, VarlenPool *data_pool) {
+  auto col_count = GetColCount(rb_seg);
+  for (size_t idx = 0; idx < col_count; ++idx) {
+    auto col_id = GetIdOffsetPair(rb_seg, idx)->col_id;
+    tuple->SetValue(col_id, GetValue(rb_seg, schema, idx), data_pool);
+  }
+}
+
 }  // End storage namespace
 }  // End peloton namespace
@@ -15,8 +15,10 @@
 
 #include "common/macros.h"
 #include "common/portal.h"
+#include "common/plan_cache.h"
 #include "common/logger.h"
 #include "common/types.h"
+#include "common/value_factory.h"
 
 #include "optimizer/simple_optimizer.h"
 #include "executor/plan_executor.h"
@@ -78,30 +80,103 @@ Result TrafficCop::ExecuteStatement(UNUSED_ATTRIBUTE const std::shared_ptr<State
   LOG_INFO("Execute Statement %s", statement->GetStatementName().c_str());
   std::vector<Value> params;
   bridge::PlanExecutor::PrintPlan(statement->GetPlanTree().get(), "Shit");
-  bridge::peloton_status status = bridge::PlanExecutor::ExecutePlan(statement->GetPlanTree().get(), params);
+  bridge::peloton_status status = bridge::PlanExecutor::ExecutePlan(statement->GetPlanTree(), params);
   LOG_INFO("Statement executed. Result: %d", status.m_result);
   return status.m_result;
 
 }
 
+Result TrafficCop::ExecuteStatement(const std::shared_ptr<Statement>& statement,
+                                    const std::vector<Value> &params,
+                                    const bridge::ResultTileCallback &callback,
+                                    int &rows_changed,
+                                    UNUSED_ATTRIBUTE std::string &error_message){
+
+  LOG_INFO("Execute Statement %s", statement->GetStatementName().c_str());
+  bridge::peloton_status status = bridge::PlanExecutor::ExecutePlan(
+      statement->GetPlanTree(), params, callback);
+  rows_changed = status.m_processed;
+  LOG_INFO("Statement executed. Result: %d", status.m_result);
+  return status.m_result;
+}
+
 std::shared_ptr<Statement> TrafficCop::PrepareStatement(const std::string& statement_name,
                                                         const std::string& query_string,
-                                                        UNUSED_ATTRIBUTE std::string &error_message){
+                                                        UNUSED_ATTRIBUTE std::string &error_message,
+                                                        const std::vector<int32_t>& param_types){
   std::shared_ptr<Statement> statement;
 
   LOG_INFO("Prepare Statement %s", query_string.c_str());
 
   statement.reset(new Statement(statement_name, query_string));
+  statement->SetParamTypes(param_types);
+
+  // Reuse the plan if any connection prepared the same statement already
+  auto &plan_cache = PlanCache::GetInstance();
+  auto cache_key = PlanCache::GetKey(query_string, param_types);
+  auto cached_statement = plan_cache.Find(cache_key);
+  if (cached_statement.get() != nullptr) {
+    LOG_TRACE("Plan cache hit : %s", query_string.c_str());
+    statement->SetPlanTree(cached_statement->GetPlanTree());
+    statement->SetTupleDescriptor(cached_statement->GetTupleDescriptor());
+    return statement;
+  }
+
+  // Read the version before planning, so that a plan built against a catalog
+  // that changed in the meantime is not cached
+  auto cache_version = plan_cache.GetVersion();
 
   // TODO: Use parser
+  // Parsing and planning are not wired up yet, so no statement gets a plan
+  // tree here: nothing is ever inserted into the plan cache and the lookup
+  // above always misses. Until they are, neither the plan cache nor the
+  // executor tree reuse of the plan executor is reachable from the wire.
   //auto& postgres_parser = parser::PostgresParser::GetInstance();
   //auto parse_tree = postgres_parser.BuildParseTree(query_string);
 
   //statement->SetPlanTree(optimizer::SimpleOptimizer::BuildPlanTree(parse_tree));
 
+  if (statement->GetPlanTree().get() != nullptr) {
+    // The cached copy is shared by all connections, so it must not be the
+    // statement the caller is about to modify
+    std::shared_ptr<Statement> plan_entry(new Statement("", query_string));
+    plan_entry->SetParamTypes(param_types);
+    plan_entry->SetPlanTree(statement->GetPlanTree());
+    plan_entry->SetTupleDescriptor(statement->GetTupleDescriptor());
+    plan_cache.Insert(cache_key, plan_entry, cache_version);
+  }
+
   return statement;
 }
 
+std::vector<Value> TrafficCop::BindParameters(
+    const std::vector<std::pair<int, std::string>> &parameters) {
+  std::vector<Value> params;
+  params.reserve(parameters.size());
+
+  for (auto &parameter : parameters) {
+    auto type = static_cast<ValueType>(parameter.first);
+    auto &value = parameter.second;
+    switch (type) {
+      case VALUE_TYPE_INTEGER:
+        if (value.empty()) {
+          params.push_back(ValueFactory::GetNullValueByType(type));
+        } else {
+          params.push_back(ValueFactory::GetIntegerValue(std::stoi(value)));
+        }
+        break;
+      case VALUE_TYPE_DOUBLE:
+        params.push_back(ValueFactory::GetDoubleValue(std::stod(value)));
+        break;
+      default:
+        params.push_back(ValueFactory::GetStringValue(value));
+        break;
+    }
+  }
+
+  return params;
+}
+
 
 }  // End tcop namespace
 } // End peloton namespace
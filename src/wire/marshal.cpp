@@ -16,6 +16,7 @@
 #include <iterator>
 
 #include "wire/marshal.h"
+#include "common/value_peeker.h"
 
 #include <netinet/in.h>
 
@@ -133,6 +134,26 @@ void PacketPutBytes(std::unique_ptr<Packet> &pkt,
   pkt->len += data.size();
 }
 
+void PacketPutValue(std::unique_ptr<Packet> &pkt, const Value &value) {
+  if (value.IsNull()) {
+    PacketPutInt(pkt, -1, 4);
+    return;
+  }
+
+  if (value.GetValueType() == VALUE_TYPE_BOOLEAN) {
+    PacketPutInt(pkt, 1, 4);
+    PacketPutByte(pkt, ValuePeeker::PeekBoolean(value) ? 't' : 'f');
+    return;
+  }
+
+  Value text = value.CastAs(VALUE_TYPE_VARCHAR);
+  auto data = reinterpret_cast<const uchar *>(
+      ValuePeeker::PeekObjectValueWithoutNull(text));
+  auto len = ValuePeeker::PeekObjectLengthWithoutNull(text);
+  PacketPutInt(pkt, len, 4);
+  PacketPutCbytes(pkt, data, len);
+}
+
 void PacketPutInt(std::unique_ptr<Packet> &pkt, int n, int base) {
   switch (base) {
     case 2:
@@ -210,6 +231,15 @@ bool ReadPacket(Packet *pkt, bool has_type_field, Client *client) {
 
 bool WritePackets(std::vector<std::unique_ptr<Packet>> &packets,
                   Client *client) {
+  if (!BufferPackets(packets, client)) {
+    return false;
+  }
+
+  return client->sock->FlushWriteBuffer();
+}
+
+bool BufferPackets(std::vector<std::unique_ptr<Packet>> &packets,
+                   Client *client) {
   // iterate through all the packets
   for (size_t i = 0; i < packets.size(); i++) {
     auto pkt = packets[i].get();
@@ -221,7 +251,7 @@ bool WritePackets(std::vector<std::unique_ptr<Packet>> &packets,
 
   // clear packets
   packets.clear();
-  return client->sock->FlushWriteBuffer();
+  return true;
 }
 
 }  // end wire
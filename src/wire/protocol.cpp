@@ -20,6 +20,7 @@
 
 #include "wire/marshal.h"
 #include "common/portal.h"
+#include "executor/logical_tile.h"
 #include "tcop/tcop.h"
 
 #include <boost/algorithm/string.hpp>
@@ -29,12 +30,6 @@
 namespace peloton {
 namespace wire {
 
-// Prepares statment cache
-thread_local peloton::Cache<std::string, Statement> statement_cache_;
-
-// Query portal handler
-thread_local std::unordered_map<std::string, std::shared_ptr<Portal>> portals_;
-
 // Hardcoded authentication strings used during session startup. To be removed
 const std::unordered_map<std::string, std::string>
     PacketManager::parameter_status_map =
@@ -145,29 +140,61 @@ void PacketManager::PutTupleDescriptor(
   responses.push_back(std::move(pkt));
 }
 
-void PacketManager::SendDataRows(std::vector<ResultType> &results, int colcount,
-                                 int &rows_affected,
-                                 ResponseBuffer &responses) {
-  if (!results.size() || !colcount) return;
-
-  LOG_INFO("Flatten result size: %lu", results.size());
-  size_t numrows = results.size() / colcount;
-
-  // 1 packet per row
-  for (size_t i = 0; i < numrows; i++) {
-    std::unique_ptr<Packet> pkt(new Packet());
-    pkt->msg_type = 'D';
-    PacketPutInt(pkt, colcount, 2);
-    for (int j = 0; j < colcount; j++) {
-      // length of the row attribute
-      PacketPutInt(pkt, results[i * colcount + j].second.size(), 4);
-      // contents of the row attribute
-      PacketPutBytes(pkt, results[i * colcount + j].second);
+bool PacketManager::SendDataTile(executor::LogicalTile *tile,
+                                 int &rows_sent) {
+  auto colcount = tile->GetColumnCount();
+
+  // 1 packet per row, serialized into the same buffer
+  for (oid_t tuple_id : *tile) {
+    row_packet_->buf.clear();
+    row_packet_->len = 0;
+    PacketPutInt(row_packet_, colcount, 2);
+    for (oid_t column_itr = 0; column_itr < colcount; column_itr++) {
+      PacketPutValue(row_packet_, tile->GetValue(tuple_id, column_itr));
+    }
+
+    // the socket buffer is flushed whenever it fills up. a slow client
+    // holds back the execution, in event-driven mode only once the write
+    // backlog is full
+    if (!client.sock->BufferWriteBytes(row_packet_->buf, row_packet_->len,
+                                       'D')) {
+      return false;
     }
-    responses.push_back(std::move(pkt));
+    rows_sent++;
+  }
+
+  return true;
+}
+
+Result PacketManager::ExecuteStreamingStatement(
+    const std::shared_ptr<Statement> &statement,
+    const std::vector<Value> &params, ResponseBuffer &responses,
+    int &rows_affected, std::string &error_message) {
+  // the rows must follow the responses batched so far
+  if (!BufferPackets(responses, &client)) {
+    error_message = "Failed to write to the client";
+    return Result::RESULT_FAILURE;
+  }
+
+  // without a row description, the client would not expect any rows
+  int rows_sent = 0;
+  bridge::ResultTileCallback send_tile = nullptr;
+  if (!statement->GetTupleDescriptor().empty()) {
+    send_tile = [this, &rows_sent](executor::LogicalTile *tile) {
+      return SendDataTile(tile, rows_sent);
+    };
+  }
+
+  auto &tcop = tcop::TrafficCop::GetInstance();
+  auto status = tcop.ExecuteStatement(statement, params, send_tile,
+                                      rows_affected, error_message);
+
+  if (send_tile != nullptr) {
+    rows_affected = rows_sent;
   }
-  rows_affected = numrows;
   LOG_INFO("Rows affected: %d", rows_affected);
+
+  return status;
 }
 
 /* Gets the first token of a query */
@@ -251,27 +278,32 @@ void PacketManager::ExecQueryMessage(Packet *pkt, ResponseBuffer &responses) {
       return;
     }
 
-    std::vector<ResultType> result;
-    std::vector<FieldInfoType> tuple_descriptor;
     std::string error_message;
-    int rows_affected;
-
-    // execute the query in Sqlite
-    auto status = tcop.ExecuteStatement(query, result, tuple_descriptor,
-                                        rows_affected, error_message);
+    int rows_affected = 0;
 
-    // check status
-    if (status == Result::RESULT_FAILURE) {
+    // prepare first, the attribute names have to precede the result rows
+    std::string unnamed_statement = "unnamed";
+    auto statement =
+        tcop.PrepareStatement(unnamed_statement, query, error_message);
+    if (statement.get() == nullptr) {
       SendErrorResponse({{'M', error_message}}, responses);
       LOG_INFO("Error Response Sent!");
       break;
     }
 
     // send the attribute names
-    PutTupleDescriptor(tuple_descriptor, responses);
+    PutTupleDescriptor(statement->GetTupleDescriptor(), responses);
 
-    // send the result rows
-    SendDataRows(result, tuple_descriptor.size(), rows_affected, responses);
+    // execute the query, sending the result rows as they are produced
+    auto status = ExecuteStreamingStatement(statement, {}, responses,
+                                            rows_affected, error_message);
+
+    // check status
+    if (status == Result::RESULT_FAILURE) {
+      SendErrorResponse({{'M', error_message}}, responses);
+      LOG_INFO("Error Response Sent!");
+      break;
+    }
 
     // TODO: should change to query_type
     CompleteCommand(query, rows_affected, responses);
@@ -309,18 +341,6 @@ void PacketManager::ExecParseMessage(Packet *pkt, ResponseBuffer &responses) {
     return;
   }
 
-  // Prepare statement
-  std::shared_ptr<Statement> statement;
-  auto &tcop = tcop::TrafficCop::GetInstance();
-  statement = std::move(
-      tcop.PrepareStatement(statement_name, query_string, error_message));
-
-  if (statement.get() == nullptr) {
-    SendErrorResponse({{'M', error_message}}, responses);
-    SendReadyForQuery(txn_state, responses);
-    return;
-  }
-
   // Read number of params
   int num_params = PacketGetInt(pkt, 2);
   LOG_INFO("NumParams: %d", num_params);
@@ -332,10 +352,22 @@ void PacketManager::ExecParseMessage(Packet *pkt, ResponseBuffer &responses) {
     param_types[i] = param_type;
   }
 
+  // Prepare statement, the plan is shared with other connections through
+  // the plan cache
+  std::shared_ptr<Statement> statement;
+  auto &tcop = tcop::TrafficCop::GetInstance();
+  statement = std::move(tcop.PrepareStatement(statement_name, query_string,
+                                              error_message, param_types));
+
+  if (statement.get() == nullptr) {
+    SendErrorResponse({{'M', error_message}}, responses);
+    SendReadyForQuery(txn_state, responses);
+    return;
+  }
+
   // Cache the received query
   bool unnamed_query = statement_name.empty();
   statement->SetQueryType(query_type);
-  statement->SetParamTypes(param_types);
 
   // Unnamed statement
   if (unnamed_query) {
@@ -540,7 +572,6 @@ void PacketManager::ExecDescribeMessage(Packet *pkt,
 void PacketManager::ExecExecuteMessage(Packet *pkt, ResponseBuffer &responses) {
   // EXECUTE message
   LOG_INFO("EXECUTE message");
-  std::vector<ResultType> results;
   std::string error_message, portal_name;
   int rows_affected = 0;
   GetStringToken(pkt, portal_name);
@@ -574,9 +605,6 @@ void PacketManager::ExecExecuteMessage(Packet *pkt, ResponseBuffer &responses) {
   const auto &query_string = statement->GetQueryString();
   const auto &query_type = statement->GetQueryType();
 
-  auto statement_name = statement->GetStatementName();
-  bool unnamed = statement_name.empty();
-
   LOG_INFO("Executing query: %s", query_string.c_str());
 
   // acquire the mutex if we are starting a txn
@@ -584,9 +612,13 @@ void PacketManager::ExecExecuteMessage(Packet *pkt, ResponseBuffer &responses) {
     LOG_WARN("BEGIN - acquire lock");
   }
 
-  auto &tcop = tcop::TrafficCop::GetInstance();
-  auto status = tcop.ExecuteStatement(statement, unnamed, results,
-                                      rows_affected, error_message);
+  // the parameters are bound for this execution only, the statement and its
+  // plan may be shared with other portals and connections
+  auto params = tcop::TrafficCop::BindParameters(portal->GetBindParameters());
+
+  // the result rows are sent as they are produced
+  auto status = ExecuteStreamingStatement(statement, params, responses,
+                                          rows_affected, error_message);
 
   if (status == Result::RESULT_FAILURE) {
     LOG_INFO("Failed to execute: %s", error_message.c_str());
@@ -599,9 +631,6 @@ void PacketManager::ExecExecuteMessage(Packet *pkt, ResponseBuffer &responses) {
     LOG_WARN("COMMIT - release lock");
   }
 
-  // put_row_desc(portal->rowdesc, responses);
-  auto tuple_descriptor = statement->GetTupleDescriptor();
-  SendDataRows(results, tuple_descriptor.size(), rows_affected, responses);
   CompleteCommand(query_type, rows_affected, responses);
 }
 
@@ -678,7 +707,7 @@ void PacketManager::SendReadyForQuery(uchar txn_status,
  * PacketManager - Main wire protocol logic.
  * 		Always return with a closed socket.
  */
-void PacketManager::ManagePackets() {
+bool PacketManager::ManageStartupPacket() {
   Packet pkt;
   ResponseBuffer responses;
   bool status;
@@ -686,27 +715,128 @@ void PacketManager::ManagePackets() {
   // fetch the startup packet
   if (!ReadPacket(&pkt, false, &client)) {
     CloseClient();
-    return;
+    return false;
   }
 
   status = ProcessStartupPacket(&pkt, responses);
   if (!WritePackets(responses, &client) || !status) {
     // close client on write failure or status failure
     CloseClient();
-    return;
+    return false;
   }
+  return true;
+}
+
+bool PacketManager::ManagePacket() {
+  Packet pkt;
+  ResponseBuffer responses;
+  bool status;
+
+  if (!ReadPacket(&pkt, true, &client)) {
+    CloseClient();
+    return false;
+  }
+
+  status = ProcessPacket(&pkt, responses);
+  if (!WritePackets(responses, &client) || !status) {
+    // close client on write failure or status failure
+    CloseClient();
+    return false;
+  }
+  return true;
+}
+
+bool PacketManager::TryReadPacket(bool has_type_field, bool &complete) {
+  size_t header_size = sizeof(int32_t) + (has_type_field ? 1 : 0);
+  complete = false;
+
+  // type and size of the packet
+  if (partial_header_.size() < header_size) {
+    auto bytes_read = client.sock->TryReadBytes(
+        partial_header_, header_size - partial_header_.size());
+    if (bytes_read < 0) {
+      return false;
+    }
+    if (partial_header_.size() < header_size) {
+      return true;
+    }
+
+    uint32_t pkt_size = 0;
+    if (has_type_field) {
+      partial_packet_->msg_type = partial_header_[0];
+    }
+    std::copy(partial_header_.end() - sizeof(int32_t), partial_header_.end(),
+              reinterpret_cast<uchar *>(&pkt_size));
+
+    // packet size includes the size field as well
+    partial_packet_size_ = ntohl(pkt_size) - sizeof(int32_t);
+  }
+
+  // contents of the packet
+  auto &buf = partial_packet_->buf;
+  if (buf.size() < partial_packet_size_) {
+    auto bytes_read =
+        client.sock->TryReadBytes(buf, partial_packet_size_ - buf.size());
+    if (bytes_read < 0) {
+      return false;
+    }
+    if (buf.size() < partial_packet_size_) {
+      return true;
+    }
+  }
+
+  partial_packet_->len = partial_packet_size_;
+  complete = true;
+  return true;
+}
+
+bool PacketManager::ManageAvailablePackets() {
+  for (;;) {
+    bool complete;
+    if (!TryReadPacket(started_, complete)) {
+      CloseClient();
+      return false;
+    }
+
+    // go back to the event loop until the rest arrives
+    if (complete == false) {
+      return true;
+    }
+
+    std::unique_ptr<Packet> pkt(std::move(partial_packet_));
+    partial_packet_.reset(new Packet());
+    partial_header_.clear();
+
+    ResponseBuffer responses;
+    bool status;
+    if (started_) {
+      status = ProcessPacket(pkt.get(), responses);
+    } else {
+      status = ProcessStartupPacket(pkt.get(), responses);
+      started_ = true;
+    }
 
-  pkt.Reset();
-  while (ReadPacket(&pkt, true, &client)) {
-    status = ProcessPacket(&pkt, responses);
     if (!WritePackets(responses, &client) || !status) {
       // close client on write failure or status failure
       CloseClient();
-      return;
+      return false;
+    }
+
+    // the next packets wait until the client has read the responses
+    if (client.sock->HasPendingWrites()) {
+      return true;
     }
-    pkt.Reset();
   }
 }
 
+void PacketManager::ManagePackets() {
+  if (!ManageStartupPacket()) {
+    return;
+  }
+
+  while (ManagePacket())
+    ;
+}
+
 }  // End wire namespace
 }  // End peloton namespace
@@ -14,7 +14,9 @@
 #include "wire/socket_base.h"
 #include "common/exception.h"
 
+#include <poll.h>
 #include <sys/un.h>
+#include <algorithm>
 #include <string>
 
 namespace peloton {
@@ -153,8 +155,46 @@ bool SocketManager<B>::RefillReadBuffer() {
   }
 }
 
+template <typename B>
+int SocketManager<B>::TryRefillReadBuffer() {
+  ssize_t bytes_read;
+
+  // our buffer is to be emptied
+  rbuf.Reset();
+
+  for (;;) {
+    bytes_read = recv(sock_fd, &rbuf.buf[0], SOCKET_BUFFER_SIZE, MSG_DONTWAIT);
+    if (bytes_read < 0) {
+      if (errno == EINTR) {
+        // interrupts are OK
+        continue;
+      }
+
+      if (errno == EAGAIN || errno == EWOULDBLOCK) {
+        // the rest has not arrived yet
+        return 0;
+      }
+
+      LOG_ERROR("Socket error: could not receive data from client");
+      return -1;
+    }
+
+    if (bytes_read == 0) {
+      // EOF
+      return -1;
+    }
+
+    rbuf.buf_size = bytes_read;
+    return 1;
+  }
+}
+
 template <typename B>
 bool SocketManager<B>::FlushWriteBuffer() {
+  if (nonblocking_writes) {
+    return FlushWriteBufferNonBlocking();
+  }
+
   ssize_t written_bytes = 0;
   wbuf.buf_ptr = 0;
   // still outstanding bytes
@@ -188,6 +228,98 @@ bool SocketManager<B>::FlushWriteBuffer() {
   return true;
 }
 
+template <typename B>
+bool SocketManager<B>::FlushWriteBufferNonBlocking() {
+  size_t written_bytes = 0;
+
+  // the bytes must follow the backlog
+  if (!HasPendingWrites()) {
+    auto status = TryWrite(&wbuf.buf[0], wbuf.buf_size);
+    if (status < 0) {
+      return false;
+    }
+    written_bytes = status;
+  }
+
+  write_backlog.insert(std::end(write_backlog),
+                       std::begin(wbuf.buf) + written_bytes,
+                       std::begin(wbuf.buf) + wbuf.buf_size);
+  wbuf.Reset();
+
+  // a client that does not keep up holds back the worker once the backlog
+  // is full, so that its results do not pile up in memory
+  while (write_backlog.size() - write_backlog_ptr >
+         SOCKET_WRITE_BACKLOG_LIMIT) {
+    auto status = TryFlushWriteBacklog();
+    if (status < 0) {
+      return false;
+    }
+    if (status == 0) {
+      struct pollfd poll_fd;
+      poll_fd.fd = sock_fd;
+      poll_fd.events = POLLOUT;
+      if (poll(&poll_fd, 1, -1) < 0 && errno != EINTR) {
+        return false;
+      }
+    }
+  }
+
+  return true;
+}
+
+template <typename B>
+int SocketManager<B>::TryFlushWriteBacklog() {
+  while (HasPendingWrites()) {
+    auto written_bytes = TryWrite(&write_backlog[write_backlog_ptr],
+                                  write_backlog.size() - write_backlog_ptr);
+    if (written_bytes < 0) {
+      return -1;
+    }
+    if (written_bytes == 0) {
+      // drop the written bytes once they make up most of the backlog
+      if (write_backlog_ptr > write_backlog.size() / 2) {
+        write_backlog.erase(std::begin(write_backlog),
+                            std::begin(write_backlog) + write_backlog_ptr);
+        write_backlog_ptr = 0;
+      }
+      return 0;
+    }
+    write_backlog_ptr += written_bytes;
+  }
+
+  write_backlog.clear();
+  write_backlog_ptr = 0;
+  return 1;
+}
+
+template <typename B>
+ssize_t SocketManager<B>::TryWrite(const uchar *data, size_t len) {
+  size_t written_bytes = 0;
+
+  while (written_bytes < len) {
+    auto status = send(sock_fd, data + written_bytes, len - written_bytes,
+                       MSG_DONTWAIT | MSG_NOSIGNAL);
+    if (status < 0) {
+      if (errno == EINTR) {
+        // interrupts are ok, try again
+        continue;
+      }
+
+      if (errno == EAGAIN || errno == EWOULDBLOCK) {
+        // the socket buffer is full
+        break;
+      }
+
+      LOG_ERROR("Socket error: could not send data to client");
+      return -1;
+    }
+
+    written_bytes += status;
+  }
+
+  return written_bytes;
+}
+
 /*
  * read - Tries to read "bytes" bytes into packet's buffer. Returns true on
  * success.
@@ -235,6 +367,33 @@ bool SocketManager<B>::ReadBytes(B &pkt_buf, size_t bytes) {
   return true;
 }
 
+template <typename B>
+ssize_t SocketManager<B>::TryReadBytes(B &pkt_buf, size_t bytes) {
+  size_t bytes_read = 0;
+
+  while (bytes_read < bytes) {
+    size_t window = rbuf.buf_size - rbuf.buf_ptr;
+    if (window == 0) {
+      auto status = TryRefillReadBuffer();
+      if (status < 0) {
+        return -1;
+      }
+      if (status == 0) {
+        break;
+      }
+      continue;
+    }
+
+    window = std::min(window, bytes - bytes_read);
+    pkt_buf.insert(std::end(pkt_buf), std::begin(rbuf.buf) + rbuf.buf_ptr,
+                   std::begin(rbuf.buf) + rbuf.buf_ptr + window);
+    rbuf.buf_ptr += window;
+    bytes_read += window;
+  }
+
+  return bytes_read;
+}
+
 template <typename B>
 bool SocketManager<B>::BufferWriteBytes(B &pkt_buf, size_t len, uchar type) {
   size_t window, pkt_buf_ptr = 0;
@@ -243,7 +402,7 @@ bool SocketManager<B>::BufferWriteBytes(B &pkt_buf, size_t len, uchar type) {
   // check if we don't have enough space in the buffer
   if (wbuf.GetMaxSize() - wbuf.buf_ptr < 1 + sizeof(int32_t)) {
     // buffer needs to be flushed before adding header
-    FlushWriteBuffer();
+    if (!FlushWriteBuffer()) return false;
   }
 
   // assuming wbuf is now large enough to
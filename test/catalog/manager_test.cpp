@@ -14,6 +14,7 @@
 #include "common/harness.h"
 
 #include "common/macros.h"
+#include "common/thread_epoch.h"
 #include "catalog/manager.h"
 #include "catalog/schema.h"
 #include "storage/tile_group.h"
@@ -70,5 +71,102 @@ TEST_F(ManagerTests, TransactionTest) {
   // EXPECT_EQ(catalog::Manager::GetInstance().GetCurrentOid(), 800);
 }
 
+void LocateTileGroup(UNUSED_ATTRIBUTE uint64_t thread_id) {
+  auto &manager = catalog::Manager::GetInstance();
+
+  std::vector<catalog::Schema> schemas;
+  std::vector<catalog::Column> columns;
+
+  catalog::Column column1(VALUE_TYPE_INTEGER, GetTypeSize(VALUE_TYPE_INTEGER),
+                          "A", true);
+  columns.push_back(column1);
+  schemas.push_back(catalog::Schema(columns));
+
+  std::map<oid_t, std::pair<oid_t, oid_t>> column_map;
+  column_map[0] = std::make_pair(0, 0);
+
+  for (oid_t tile_group_itr = 0; tile_group_itr < 100; tile_group_itr++) {
+    auto tile_group_id = manager.GetNextOid();
+    std::shared_ptr<storage::TileGroup> tile_group(
+        storage::TileGroupFactory::GetTileGroup(INVALID_OID, INVALID_OID,
+                                                tile_group_id, nullptr,
+                                                schemas, column_map, 3));
+
+    manager.AddTileGroup(tile_group_id, tile_group);
+    EXPECT_EQ(manager.GetTileGroup(tile_group_id).get(), tile_group.get());
+
+    manager.DropTileGroup(tile_group_id);
+    EXPECT_TRUE(manager.GetTileGroup(tile_group_id) == nullptr);
+  }
+}
+
+TEST_F(ManagerTests, TileGroupLocatorTest) {
+  LaunchParallelTest(8, LocateTileGroup);
+
+  // never added
+  EXPECT_TRUE(catalog::Manager::GetInstance().GetTileGroup(INVALID_OID - 1) ==
+              nullptr);
+}
+
+TEST_F(ManagerTests, TileGroupReclamationTest) {
+  auto &manager = catalog::Manager::GetInstance();
+
+  std::vector<catalog::Schema> schemas;
+  std::vector<catalog::Column> columns;
+
+  catalog::Column column1(VALUE_TYPE_INTEGER, GetTypeSize(VALUE_TYPE_INTEGER),
+                          "A", true);
+  columns.push_back(column1);
+  schemas.push_back(catalog::Schema(columns));
+
+  std::map<oid_t, std::pair<oid_t, oid_t>> column_map;
+  column_map[0] = std::make_pair(0, 0);
+
+  auto tile_group_id = manager.GetNextOid();
+  std::shared_ptr<storage::TileGroup> tile_group(
+      storage::TileGroupFactory::GetTileGroup(INVALID_OID, INVALID_OID,
+                                              tile_group_id, nullptr, schemas,
+                                              column_map, 3));
+
+  {
+    // a reader keeps the dropped entry alive
+    ThreadEpochGuard epoch_guard;
+
+    manager.AddTileGroup(tile_group_id, tile_group);
+    manager.DropTileGroup(tile_group_id);
+    EXPECT_EQ(2, tile_group.use_count());
+  }
+
+  // and the reader frees it on its way out
+  EXPECT_EQ(1, tile_group.use_count());
+}
+
+void HoldEpoch(std::atomic<size_t> *waiting_count, size_t thread_count,
+               UNUSED_ATTRIBUTE uint64_t thread_id) {
+  ThreadEpochGuard epoch_guard;
+
+  // every thread holds its slot at the same time
+  (*waiting_count)++;
+  while (waiting_count->load() < thread_count) {
+    std::this_thread::yield();
+  }
+
+  EXPECT_LT(ThreadEpochManager::GetInstance().GetMinActiveEpoch(),
+            ThreadEpochManager::INACTIVE_EPOCH);
+}
+
+TEST_F(ManagerTests, EpochSlotTest) {
+  // more threads than the slots of one segment
+  size_t thread_count = 3 * THREAD_SLOT_SEGMENT_SIZE;
+  std::atomic<size_t> waiting_count(0);
+
+  LaunchParallelTest(thread_count, HoldEpoch, &waiting_count, thread_count);
+
+  // the slots were given back along with their epochs
+  auto &epoch_manager = ThreadEpochManager::GetInstance();
+  EXPECT_EQ(epoch_manager.GetCurrentEpoch(),
+            epoch_manager.GetMinActiveEpoch());
+}
+
 }  // End test namespace
 }  // End peloton namespace
@@ -0,0 +1,109 @@
+//===----------------------------------------------------------------------===//
+//
+//                         Peloton
+//
+// plan_cache_test.cpp
+//
+// Identification: test/common/plan_cache_test.cpp
+//
+// Copyright (c) 2015-16, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+
+#include "common/harness.h"
+
+#include "common/plan_cache.h"
+#include "planner/mock_plan.h"
+#include "tcop/tcop.h"
+
+namespace peloton {
+namespace test {
+
+//===--------------------------------------------------------------------===//
+// Plan Cache Test
+//===--------------------------------------------------------------------===//
+
+class PlanCacheTest : public PelotonTest {};
+
+static std::shared_ptr<Statement> MakeStatement(const std::string &query) {
+  std::shared_ptr<Statement> statement(new Statement("", query));
+  statement->SetPlanTree(std::shared_ptr<planner::AbstractPlan>(new MockPlan()));
+  return statement;
+}
+
+TEST_F(PlanCacheTest, NormalizeTest) {
+  EXPECT_EQ("select * from foo where a = 'Bar  Baz'",
+            PlanCache::NormalizeQuery(
+                "  SELECT *\n  FROM   Foo\tWHERE a = 'Bar  Baz' ;  "));
+  EXPECT_EQ("select \"Foo\" from t",
+            PlanCache::NormalizeQuery("SELECT \"Foo\" FROM t;"));
+
+  // the parameter types are part of the key
+  EXPECT_EQ(PlanCache::GetKey("SELECT $1", {23}),
+            PlanCache::GetKey("select  $1;", {23}));
+  EXPECT_NE(PlanCache::GetKey("SELECT $1", {23}),
+            PlanCache::GetKey("SELECT $1", {25}));
+  EXPECT_NE(PlanCache::GetKey("SELECT 'a'", {}),
+            PlanCache::GetKey("SELECT 'A'", {}));
+}
+
+TEST_F(PlanCacheTest, InsertAndInvalidateTest) {
+  auto &plan_cache = PlanCache::GetInstance();
+  plan_cache.Invalidate();
+
+  auto key = PlanCache::GetKey("SELECT a FROM foo", {});
+  auto statement = MakeStatement("SELECT a FROM foo");
+
+  // only statements prepared often enough are cached
+  for (size_t itr = 0; itr < DEFAULT_CACHE_INSERT_THRESHOLD; itr++) {
+    EXPECT_EQ(nullptr, plan_cache.Find(key));
+    plan_cache.Insert(key, statement, plan_cache.GetVersion());
+  }
+  EXPECT_EQ(statement, plan_cache.Find(key));
+  EXPECT_EQ(1UL, plan_cache.GetSize());
+
+  // DDL drops every cached plan
+  plan_cache.Invalidate();
+  EXPECT_EQ(nullptr, plan_cache.Find(key));
+  EXPECT_EQ(0UL, plan_cache.GetSize());
+
+  // a plan built before DDL is never cached
+  auto stale_version = plan_cache.GetVersion();
+  plan_cache.Invalidate();
+  for (size_t itr = 0; itr < DEFAULT_CACHE_INSERT_THRESHOLD; itr++) {
+    plan_cache.Insert(key, statement, stale_version);
+  }
+  EXPECT_EQ(nullptr, plan_cache.Find(key));
+}
+
+TEST_F(PlanCacheTest, PrepareStatementTest) {
+  auto &plan_cache = PlanCache::GetInstance();
+  plan_cache.Invalidate();
+
+  const std::string query = "SELECT a FROM foo WHERE b = $1";
+  std::vector<int32_t> param_types = {23};
+  auto cached = MakeStatement(query);
+  for (size_t itr = 0; itr < DEFAULT_CACHE_INSERT_THRESHOLD; itr++) {
+    plan_cache.Insert(PlanCache::GetKey(query, param_types), cached,
+                      plan_cache.GetVersion());
+  }
+
+  // every connection gets its own statement sharing the cached plan
+  std::string error_message;
+  auto &tcop = tcop::TrafficCop::GetInstance();
+  auto statement = tcop.PrepareStatement(
+      "s1", "select a from foo where b = $1;", error_message, param_types);
+  EXPECT_NE(cached, statement);
+  EXPECT_EQ("s1", statement->GetStatementName());
+  EXPECT_EQ(cached->GetPlanTree(), statement->GetPlanTree());
+
+  // different parameter types need a different plan
+  statement = tcop.PrepareStatement("s2", query, error_message, {25});
+  EXPECT_EQ(nullptr, statement->GetPlanTree());
+
+  plan_cache.Invalidate();
+}
+
+}  // End test namespace
+}  // End peloton namespace
@@ -33,5 +33,25 @@ TEST_F(ThreadPoolTests, BasicTest) {
 
 }
 
+TEST_F(ThreadPoolTests, EnqueueTest) {
+
+  ThreadPool thread_pool(4);
+  std::atomic<int> counter(0);
+
+  std::vector<std::future<int>> results;
+  for (int task_itr = 0; task_itr < 100; task_itr++) {
+    results.push_back(thread_pool.Enqueue([&counter](int value) {
+      counter++;
+      return value * 2;
+    }, task_itr));
+  }
+
+  for (int task_itr = 0; task_itr < 100; task_itr++) {
+    EXPECT_EQ(task_itr * 2, results[task_itr].get());
+  }
+  EXPECT_EQ(100, counter.load());
+
+}
+
 }  // End test namespace
 }  // End peloton namespace
@@ -0,0 +1,318 @@
+//===----------------------------------------------------------------------===//
+//
+//                         Peloton
+//
+// delta_storage_test.cpp
+//
+// Identification: test/concurrency/delta_storage_test.cpp
+//
+// Copyright (c) 2015-16, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+
+#include <memory>
+#include <thread>
+
+#include "common/harness.h"
+#include "common/value_factory.h"
+#include "common/value_peeker.h"
+#include "concurrency/transaction_tests_util.h"
+#include "concurrency/ts_order_txn_manager.h"
+#include "executor/executor_context.h"
+#include "executor/logical_tile.h"
+#include "executor/seq_scan_executor.h"
+#include "expression/comparison_expression.h"
+#include "expression/constant_value_expression.h"
+#include "expression/tuple_value_expression.h"
+#include "gc/gc_manager.h"
+#include "storage/data_table.h"
+#include "storage/rollback_segment.h"
+#include "storage/tile_group.h"
+#include "storage/tile_group_header.h"
+
+namespace peloton {
+
+namespace test {
+
+//===--------------------------------------------------------------------===//
+// Delta Storage Tests
+//===--------------------------------------------------------------------===//
+
+class DeltaStorageTests : public PelotonTest {};
+
+TEST_F(DeltaStorageTests, SnapshotReadTest) {
+  concurrency::TransactionManagerFactory::Configure(
+      CONCURRENCY_TYPE_TO, ISOLATION_LEVEL_TYPE_FULL,
+      VERSION_STORAGE_TYPE_DELTA);
+
+  auto &txn_manager = concurrency::TransactionManagerFactory::GetInstance();
+  std::unique_ptr<storage::DataTable> table(
+      TransactionTestsUtil::CreateTable());
+
+  // the older transaction reads the value the newer one overwrote in place
+  {
+    TransactionScheduler scheduler(3, table.get(), &txn_manager);
+    scheduler.Txn(1).Read(0);
+    scheduler.Txn(0).Update(0, 1);
+    scheduler.Txn(0).Update(9, 1);
+    scheduler.Txn(0).Read(0);
+    scheduler.Txn(0).Commit();
+    scheduler.Txn(1).Read(0);
+    scheduler.Txn(1).Scan(9);
+    scheduler.Txn(1).Commit();
+    scheduler.Txn(2).Read(0);
+    scheduler.Txn(2).Scan(9);
+    scheduler.Txn(2).Commit();
+
+    scheduler.Run();
+
+    EXPECT_EQ(RESULT_SUCCESS, scheduler.schedules[0].txn_result);
+    EXPECT_EQ(RESULT_SUCCESS, scheduler.schedules[1].txn_result);
+    EXPECT_EQ(RESULT_SUCCESS, scheduler.schedules[2].txn_result);
+    EXPECT_EQ(1, scheduler.schedules[0].results[0]);
+    EXPECT_EQ(0, scheduler.schedules[1].results[0]);
+    EXPECT_EQ(0, scheduler.schedules[1].results[1]);
+    EXPECT_EQ(0, scheduler.schedules[1].results[2]);
+    EXPECT_EQ(1, scheduler.schedules[2].results[0]);
+    EXPECT_EQ(1, scheduler.schedules[2].results[1]);
+  }
+
+  // the update does not create a new version
+  auto tile_group = table->GetTileGroup(0);
+  EXPECT_TRUE(tile_group->GetHeader()->GetNextItemPointer(0).IsNull());
+  EXPECT_TRUE(concurrency::TsOrderTxnManager::GetDeltaChainHead(
+                  tile_group->GetHeader(), 0) != nullptr);
+
+  concurrency::TransactionManagerFactory::Configure(CONCURRENCY_TYPE_TO);
+}
+
+TEST_F(DeltaStorageTests, AbortTest) {
+  concurrency::TransactionManagerFactory::Configure(
+      CONCURRENCY_TYPE_TO, ISOLATION_LEVEL_TYPE_FULL,
+      VERSION_STORAGE_TYPE_DELTA);
+
+  auto &txn_manager = concurrency::TransactionManagerFactory::GetInstance();
+  std::unique_ptr<storage::DataTable> table(
+      TransactionTestsUtil::CreateTable());
+
+  // the slot is restored from the rollback segments
+  {
+    TransactionScheduler scheduler(2, table.get(), &txn_manager);
+    scheduler.Txn(0).Update(0, 1);
+    scheduler.Txn(0).Update(0, 2);
+    scheduler.Txn(0).Read(0);
+    scheduler.Txn(0).Abort();
+    scheduler.Txn(1).Read(0);
+    scheduler.Txn(1).Commit();
+
+    scheduler.Run();
+
+    EXPECT_EQ(RESULT_ABORTED, scheduler.schedules[0].txn_result);
+    EXPECT_EQ(RESULT_SUCCESS, scheduler.schedules[1].txn_result);
+    EXPECT_EQ(2, scheduler.schedules[0].results[0]);
+    EXPECT_EQ(0, scheduler.schedules[1].results[0]);
+  }
+
+  auto tile_group = table->GetTileGroup(0);
+  EXPECT_TRUE(concurrency::TsOrderTxnManager::GetDeltaChainHead(
+                  tile_group->GetHeader(), 0) == nullptr);
+
+  // a tuple updated in place can be deleted
+  {
+    TransactionScheduler scheduler(3, table.get(), &txn_manager);
+    scheduler.Txn(1).Read(0);
+    scheduler.Txn(0).Update(0, 1);
+    scheduler.Txn(0).Delete(0);
+    scheduler.Txn(0).Commit();
+    scheduler.Txn(1).Read(0);
+    scheduler.Txn(1).Commit();
+    scheduler.Txn(2).Read(0);
+    scheduler.Txn(2).Commit();
+
+    scheduler.Run();
+
+    EXPECT_EQ(RESULT_SUCCESS, scheduler.schedules[0].txn_result);
+    EXPECT_EQ(RESULT_SUCCESS, scheduler.schedules[1].txn_result);
+    EXPECT_EQ(RESULT_SUCCESS, scheduler.schedules[2].txn_result);
+    EXPECT_EQ(0, scheduler.schedules[1].results[0]);
+    EXPECT_EQ(0, scheduler.schedules[1].results[1]);
+    EXPECT_EQ(-1, scheduler.schedules[2].results[0]);
+  }
+
+  concurrency::TransactionManagerFactory::Configure(CONCURRENCY_TYPE_TO);
+}
+
+TEST_F(DeltaStorageTests, TrimDeltaChainTest) {
+  concurrency::TransactionManagerFactory::Configure(
+      CONCURRENCY_TYPE_TO, ISOLATION_LEVEL_TYPE_FULL,
+      VERSION_STORAGE_TYPE_DELTA);
+
+  auto &txn_manager = concurrency::TransactionManagerFactory::GetInstance();
+  std::unique_ptr<storage::DataTable> table(
+      TransactionTestsUtil::CreateTable());
+
+  {
+    TransactionScheduler scheduler(1, table.get(), &txn_manager);
+    scheduler.Txn(0).Update(0, 1);
+    scheduler.Txn(0).Commit();
+
+    scheduler.Run();
+
+    EXPECT_EQ(RESULT_SUCCESS, scheduler.schedules[0].txn_result);
+  }
+
+  auto tile_group = table->GetTileGroup(0);
+  auto tile_group_header = tile_group->GetHeader();
+  ItemPointer location(tile_group->GetTileGroupId(), 0);
+  cid_t end_cid = tile_group_header->GetBeginCommitId(0);
+  EXPECT_TRUE(concurrency::TsOrderTxnManager::GetDeltaChainHead(
+                  tile_group_header, 0) != nullptr);
+
+  // Stopping the GC trims every committed rollback segment
+  gc::GCManager gc_manager(GC_TYPE_COOPERATIVE, 1);
+  std::shared_ptr<storage::RollbackSegmentPool> rb_seg_pool(
+      new storage::RollbackSegmentPool(BACKEND_TYPE_MM));
+  gc_manager.RecycleRollbackSegments(rb_seg_pool, {location}, end_cid);
+
+  gc_manager.StopGC();
+  EXPECT_EQ(0UL, gc_manager.GetRollbackSegmentBacklog());
+  EXPECT_EQ(1, rb_seg_pool.use_count());
+  EXPECT_TRUE(concurrency::TsOrderTxnManager::GetDeltaChainHead(
+                  tile_group_header, 0) == nullptr);
+
+  // The latest version is still there
+  {
+    TransactionScheduler scheduler(1, table.get(), &txn_manager);
+    scheduler.Txn(0).Read(0);
+    scheduler.Txn(0).Commit();
+
+    scheduler.Run();
+
+    EXPECT_EQ(RESULT_SUCCESS, scheduler.schedules[0].txn_result);
+    EXPECT_EQ(1, scheduler.schedules[0].results[0]);
+  }
+
+  concurrency::TransactionManagerFactory::Configure(CONCURRENCY_TYPE_TO);
+}
+
+// Count the rows of the table whose value column equals the given value
+size_t CountRowsWithValue(storage::DataTable *table,
+                          concurrency::Transaction *txn, const Value &value) {
+  std::unique_ptr<executor::ExecutorContext> context(
+      new executor::ExecutorContext(txn));
+
+  auto predicate = new expression::ComparisonExpression<expression::CmpEq>(
+      EXPRESSION_TYPE_COMPARE_EQUAL,
+      new expression::TupleValueExpression(VALUE_TYPE_INTEGER, 0, 1),
+      new expression::ConstantValueExpression(value));
+  std::vector<oid_t> column_ids = {0, 1};
+  planner::SeqScanPlan node(table, predicate, column_ids);
+  executor::SeqScanExecutor executor(&node, context.get());
+
+  size_t row_count = 0;
+  EXPECT_TRUE(executor.Init());
+  while (executor.Execute()) {
+    std::unique_ptr<executor::LogicalTile> result_tile(executor.GetOutput());
+    row_count += result_tile->GetTupleCount();
+  }
+  return row_count;
+}
+
+TEST_F(DeltaStorageTests, NullPredicateTest) {
+  concurrency::TransactionManagerFactory::Configure(
+      CONCURRENCY_TYPE_TO, ISOLATION_LEVEL_TYPE_FULL,
+      VERSION_STORAGE_TYPE_DELTA);
+
+  auto &txn_manager = concurrency::TransactionManagerFactory::GetInstance();
+  std::unique_ptr<storage::DataTable> table(
+      TransactionTestsUtil::CreateTable());
+
+  auto txn = txn_manager.BeginTransaction();
+
+  // a newer transaction updates the first row in place
+  std::thread writer([&table, &txn_manager] {
+    auto writer_txn = txn_manager.BeginTransaction();
+    EXPECT_TRUE(TransactionTestsUtil::ExecuteUpdate(writer_txn, table.get(),
+                                                    0, 1));
+    EXPECT_EQ(RESULT_SUCCESS, txn_manager.CommitTransaction());
+  });
+  writer.join();
+
+  // the rebuilt version is filtered like the others, a NULL comparison
+  // selects nothing
+  EXPECT_EQ(10, CountRowsWithValue(table.get(), txn,
+                                   ValueFactory::GetIntegerValue(0)));
+  EXPECT_EQ(0, CountRowsWithValue(
+                   table.get(), txn,
+                   ValueFactory::GetNullValueByType(VALUE_TYPE_INTEGER)));
+  txn_manager.CommitTransaction();
+
+  concurrency::TransactionManagerFactory::Configure(CONCURRENCY_TYPE_TO);
+}
+
+TEST_F(DeltaStorageTests, HeldResultTest) {
+  concurrency::TransactionManagerFactory::Configure(
+      CONCURRENCY_TYPE_TO, ISOLATION_LEVEL_TYPE_FULL,
+      VERSION_STORAGE_TYPE_DELTA);
+
+  auto &txn_manager = concurrency::TransactionManagerFactory::GetInstance();
+  std::unique_ptr<storage::DataTable> table(
+      TransactionTestsUtil::CreateTable());
+  auto tile_group = table->GetTileGroup(0);
+  auto tile_group_header = tile_group->GetHeader();
+
+  // the reader keeps the result of its scan, which reads the slots in place
+  auto txn = txn_manager.BeginTransaction();
+  std::unique_ptr<executor::ExecutorContext> context(
+      new executor::ExecutorContext(txn));
+  std::vector<oid_t> column_ids = {0, 1};
+  planner::SeqScanPlan node(table.get(), nullptr, column_ids);
+  executor::SeqScanExecutor executor(&node, context.get());
+  EXPECT_TRUE(executor.Init());
+  ASSERT_TRUE(executor.Execute());
+  std::unique_ptr<executor::LogicalTile> result_tile(executor.GetOutput());
+  EXPECT_EQ(10, result_tile->GetTupleCount());
+  EXPECT_EQ(1, tile_group_header->GetPinCount());
+
+  // a newer transaction updates the first row meanwhile
+  std::thread writer([&table, &txn_manager] {
+    auto writer_txn = txn_manager.BeginTransaction();
+    EXPECT_TRUE(TransactionTestsUtil::ExecuteUpdate(writer_txn, table.get(),
+                                                    0, 1));
+    EXPECT_EQ(RESULT_SUCCESS, txn_manager.CommitTransaction());
+  });
+  writer.join();
+
+  // the slot read by the result is left alone, the update created a new
+  // version
+  EXPECT_FALSE(tile_group_header->GetNextItemPointer(0).IsNull());
+  for (auto tuple_id : *result_tile) {
+    EXPECT_EQ(0,
+              ValuePeeker::PeekAsInteger(result_tile->GetValue(tuple_id, 1)));
+  }
+
+  result_tile.reset();
+  context.reset();
+  txn_manager.CommitTransaction();
+  EXPECT_EQ(0, tile_group_header->GetPinCount());
+
+  // without readers, the slot is overwritten in place again
+  {
+    TransactionScheduler scheduler(1, table.get(), &txn_manager);
+    scheduler.Txn(0).Update(1, 1);
+    scheduler.Txn(0).Commit();
+
+    scheduler.Run();
+
+    EXPECT_EQ(RESULT_SUCCESS, scheduler.schedules[0].txn_result);
+  }
+  EXPECT_TRUE(tile_group_header->GetNextItemPointer(1).IsNull());
+  EXPECT_TRUE(concurrency::TsOrderTxnManager::GetDeltaChainHead(
+                  tile_group_header, 1) != nullptr);
+
+  concurrency::TransactionManagerFactory::Configure(CONCURRENCY_TYPE_TO);
+}
+
+}  // End test namespace
+}  // End peloton namespace
@@ -0,0 +1,103 @@
+//===----------------------------------------------------------------------===//
+//
+//                         Peloton
+//
+// epoch_manager_test.cpp
+//
+// Identification: test/concurrency/epoch_manager_test.cpp
+//
+// Copyright (c) 2015-16, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+
+#include <atomic>
+#include <thread>
+#include <vector>
+
+#include "common/harness.h"
+#include "concurrency/epoch_manager.h"
+
+namespace peloton {
+
+namespace test {
+
+//===--------------------------------------------------------------------===//
+// Epoch Manager Tests
+//===--------------------------------------------------------------------===//
+
+class EpochManagerTests : public PelotonTest {};
+
+TEST_F(EpochManagerTests, DecentralizedDeadTxnCidTest) {
+  concurrency::EpochManagerFactory::Configure(EPOCH_TYPE_DECENTRALIZED);
+  auto &epoch_manager = concurrency::EpochManagerFactory::GetInstance();
+  epoch_manager.Reset();
+
+  // a running transaction holds back the dead cid
+  epoch_manager.PrepareEnterEpoch();
+  auto epoch_id = epoch_manager.EnterEpoch(5);
+  EXPECT_EQ(0, epoch_manager.GetMaxDeadTxnCid());
+
+  std::thread worker([&epoch_manager] {
+    for (cid_t begin_cid = 6; begin_cid < 10; begin_cid++) {
+      epoch_manager.PrepareEnterEpoch();
+      auto worker_epoch_id = epoch_manager.EnterEpoch(begin_cid);
+      epoch_manager.ExitEpoch(worker_epoch_id);
+    }
+  });
+  worker.join();
+
+  EXPECT_EQ(4, epoch_manager.GetMaxDeadTxnCid());
+
+  epoch_manager.ExitEpoch(epoch_id);
+  EXPECT_EQ(9, epoch_manager.GetMaxDeadTxnCid());
+
+  // a prepared transaction without a begin cid yet holds it back as well
+  epoch_manager.PrepareEnterEpoch();
+  EXPECT_EQ(9, epoch_manager.GetMaxDeadTxnCid());
+  epoch_id = epoch_manager.EnterEpoch(12);
+  epoch_manager.ExitEpoch(epoch_id);
+  EXPECT_EQ(12, epoch_manager.GetMaxDeadTxnCid());
+
+  epoch_manager.Reset();
+}
+
+TEST_F(EpochManagerTests, DecentralizedManyWorkersTest) {
+  concurrency::EpochManagerFactory::Configure(EPOCH_TYPE_DECENTRALIZED);
+  auto &epoch_manager = concurrency::EpochManagerFactory::GetInstance();
+  epoch_manager.Reset();
+
+  // more running workers than one segment of slots holds
+  const size_t worker_count = 2 * THREAD_SLOT_SEGMENT_SIZE;
+  std::atomic<size_t> entered_count(0);
+  std::atomic<bool> finish(false);
+
+  std::vector<std::thread> workers;
+  for (size_t worker_itr = 0; worker_itr < worker_count; worker_itr++) {
+    workers.emplace_back([&, worker_itr] {
+      epoch_manager.PrepareEnterEpoch();
+      auto epoch_id = epoch_manager.EnterEpoch(100 + worker_itr);
+      entered_count++;
+      while (finish.load() == false) {
+        std::this_thread::yield();
+      }
+      epoch_manager.ExitEpoch(epoch_id);
+    });
+  }
+
+  while (entered_count.load() < worker_count) {
+    std::this_thread::yield();
+  }
+  EXPECT_EQ(0, epoch_manager.GetMaxDeadTxnCid());
+
+  finish = true;
+  for (auto &worker : workers) {
+    worker.join();
+  }
+  EXPECT_EQ(100 + worker_count - 1, epoch_manager.GetMaxDeadTxnCid());
+
+  epoch_manager.Reset();
+}
+
+}  // End test namespace
+}  // End peloton namespace
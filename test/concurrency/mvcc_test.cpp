@@ -14,6 +14,7 @@
 #include "common/harness.h"
 
 #include "concurrency/transaction_tests_util.h"
+#include "executor/executor_tests_util.h"
 #include "gc/gc_manager_factory.h"
 
 namespace peloton {
@@ -319,5 +320,70 @@ TEST_F(MVCCTest, VersionChainTest) {
   }
 }
 
+TEST_F(MVCCTest, FrozenTileGroupTest) {
+  LOG_INFO("FrozenTileGroupTest");
+
+  for (auto protocol : TEST_TYPES) {
+    concurrency::TransactionManagerFactory::Configure(
+        protocol, ISOLATION_LEVEL_TYPE_FULL);
+
+    auto &txn_manager = concurrency::TransactionManagerFactory::GetInstance();
+    std::unique_ptr<storage::DataTable> table(
+        ExecutorTestsUtil::CreateAndPopulateTable());
+
+    auto tile_group = table->GetTileGroup(0);
+    auto tile_group_header = tile_group->GetHeader();
+    oid_t tuple_count = tile_group->GetNextTupleSlot();
+    EXPECT_EQ(tile_group->GetAllocatedTupleCount(), tuple_count);
+    EXPECT_EQ(INVALID_CID, tile_group_header->GetFrozenCommitId());
+
+    // The first scan checks every tuple and freezes the full tile group
+    txn_manager.BeginTransaction();
+    std::vector<oid_t> visible_tuples;
+    txn_manager.GetVisibleTuples(tile_group_header, tuple_count,
+                                 visible_tuples);
+    EXPECT_EQ(tuple_count, visible_tuples.size());
+    EXPECT_TRUE(txn_manager.PerformReads(tile_group->GetTileGroupId(),
+                                         tile_group_header, visible_tuples));
+    txn_manager.CommitTransaction();
+
+    cid_t frozen_cid = tile_group_header->GetFrozenCommitId();
+    EXPECT_NE(INVALID_CID, frozen_cid);
+
+    // Later scans take the fast path and see the same tuples
+    txn_manager.BeginTransaction();
+    visible_tuples.clear();
+    txn_manager.GetVisibleTuples(tile_group_header, tuple_count,
+                                 visible_tuples);
+    EXPECT_EQ(tuple_count, visible_tuples.size());
+    txn_manager.CommitTransaction();
+
+    // Taking ownership of a tuple thaws the tile group
+    tile_group_header->SetTransactionId(0, txn_manager.GetNextTransactionId());
+    EXPECT_EQ(INVALID_CID, tile_group_header->GetFrozenCommitId());
+
+    txn_manager.BeginTransaction();
+    visible_tuples.clear();
+    txn_manager.GetVisibleTuples(tile_group_header, tuple_count,
+                                 visible_tuples);
+    EXPECT_EQ(tuple_count - 1, visible_tuples.size());
+    txn_manager.CommitTransaction();
+
+    // ... and it is not frozen again while the tuple is owned
+    EXPECT_EQ(INVALID_CID, tile_group_header->GetFrozenCommitId());
+
+    tile_group_header->SetTransactionId(0, INITIAL_TXN_ID);
+
+    txn_manager.BeginTransaction();
+    visible_tuples.clear();
+    txn_manager.GetVisibleTuples(tile_group_header, tuple_count,
+                                 visible_tuples);
+    EXPECT_EQ(tuple_count, visible_tuples.size());
+    txn_manager.CommitTransaction();
+
+    EXPECT_EQ(frozen_cid, tile_group_header->GetFrozenCommitId());
+  }
+}
+
 }  // End test namespace
 }  // End peloton namespace
@@ -12,6 +12,7 @@
 
 
 #include "common/harness.h"
+#include "common/timer.h"
 #include "concurrency/transaction_tests_util.h"
 
 namespace peloton {
@@ -210,5 +211,83 @@ TEST_F(TransactionTests, AbortTest) {
   }
 }
 
+TEST_F(TransactionTests, ReadWriteSetTest) {
+  // grow the set past the linear search limit so that both lookups are used
+  const oid_t tuple_count = 4 * TXN_RW_SET_LINEAR_SEARCH_LIMIT;
+  concurrency::Transaction txn(1, 1);
+
+  for (oid_t tuple_itr = 0; tuple_itr < tuple_count; tuple_itr++) {
+    txn.RecordRead(ItemPointer(tuple_itr % 3, tuple_itr));
+  }
+  EXPECT_TRUE(txn.IsReadOnly());
+
+  for (oid_t tuple_itr = 0; tuple_itr < tuple_count; tuple_itr++) {
+    // reading a tuple again adds no entry
+    txn.RecordRead(ItemPointer(tuple_itr % 3, tuple_itr));
+    if (tuple_itr % 4 == 1) {
+      txn.RecordUpdate(ItemPointer(tuple_itr % 3, tuple_itr));
+    } else if (tuple_itr % 4 == 2) {
+      txn.RecordDelete(ItemPointer(tuple_itr % 3, tuple_itr));
+    }
+  }
+  EXPECT_FALSE(txn.IsReadOnly());
+
+  txn.RecordInsert(ItemPointer(5, 0));
+  txn.RecordInsert(ItemPointer(5, 1));
+  EXPECT_TRUE(txn.RecordDelete(ItemPointer(5, 1)));
+
+  auto &rw_set = txn.GetRWSet();
+  EXPECT_EQ(tuple_count + 2, rw_set.size());
+
+  // entries are kept in the order of the first access
+  for (oid_t tuple_itr = 0; tuple_itr < tuple_count; tuple_itr++) {
+    auto &rw_entry = rw_set[tuple_itr];
+    EXPECT_EQ(tuple_itr % 3, rw_entry.location.block);
+    EXPECT_EQ(tuple_itr, rw_entry.location.offset);
+    if (tuple_itr % 4 == 1) {
+      EXPECT_EQ(concurrency::RW_TYPE_UPDATE, rw_entry.type);
+    } else if (tuple_itr % 4 == 2) {
+      EXPECT_EQ(concurrency::RW_TYPE_DELETE, rw_entry.type);
+    } else {
+      EXPECT_EQ(concurrency::RW_TYPE_READ, rw_entry.type);
+    }
+  }
+  EXPECT_EQ(concurrency::RW_TYPE_INSERT, rw_set[tuple_count].type);
+  EXPECT_EQ(concurrency::RW_TYPE_INS_DEL, rw_set[tuple_count + 1].type);
+}
+
+TEST_F(TransactionTests, ReadWriteSetPerformanceTest) {
+  const size_t txn_count = 100000;
+  // a short OLTP transaction and one whose set needs the hash index
+  std::vector<oid_t> access_counts = {10, 8 * TXN_RW_SET_LINEAR_SEARCH_LIMIT};
+
+  for (auto access_count : access_counts) {
+    Timer<std::nano> timer;
+    size_t entry_count = 0;
+
+    timer.Start();
+    for (size_t txn_itr = 0; txn_itr < txn_count; txn_itr++) {
+      concurrency::Transaction txn(txn_itr, txn_itr);
+      for (oid_t tuple_itr = 0; tuple_itr < access_count; tuple_itr++) {
+        txn.RecordRead(ItemPointer(tuple_itr / 4, tuple_itr));
+      }
+      for (oid_t tuple_itr = 0; tuple_itr < access_count; tuple_itr += 5) {
+        txn.RecordUpdate(ItemPointer(tuple_itr / 4, tuple_itr));
+      }
+      // walk the set like the commit does
+      for (auto &rw_entry : txn.GetRWSet()) {
+        if (rw_entry.type == concurrency::RW_TYPE_UPDATE) {
+          entry_count++;
+        }
+      }
+    }
+    timer.Stop();
+
+    EXPECT_EQ(txn_count * ((access_count + 4) / 5), entry_count);
+    LOG_INFO("%u accesses per txn :: %.1f ns per txn", access_count,
+             timer.GetDuration() / txn_count);
+  }
+}
+
 }  // End test namespace
 }  // End peloton namespace
@@ -23,11 +23,13 @@
 #include "executor/executor_context.h"
 #include "executor/logical_tile.h"
 #include "executor/aggregate_executor.h"
+#include "executor/aggregator.h"
 #include "executor/logical_tile_factory.h"
 #include "expression/expression_util.h"
 #include "planner/abstract_plan.h"
 #include "planner/aggregate_plan.h"
 #include "storage/data_table.h"
+#include "storage/table_factory.h"
 #include "concurrency/transaction_manager_factory.h"
 
 #include "executor/executor_tests_util.h"
@@ -744,5 +746,120 @@ TEST_F(AggregateTests, PlainSumCountDistinctTest) {
                   .IsTrue());
 }
 
+
+TEST_F(AggregateTests, ParallelHashGroupByTest) {
+  /*
+   * SELECT a, COUNT(*), SUM(b), MAX(c), AVG(b) from table GROUP BY a;
+   */
+  const int tile_group_count = 8;
+  const int tuple_count = TESTS_TUPLES_PER_TILEGROUP * tile_group_count;
+
+  // Create a table and wrap every tile group in a logical tile
+  auto& txn_manager = concurrency::TransactionManagerFactory::GetInstance();
+  auto txn = txn_manager.BeginTransaction();
+  std::unique_ptr<storage::DataTable> data_table(
+      ExecutorTestsUtil::CreateTable(TESTS_TUPLES_PER_TILEGROUP, false));
+  ExecutorTestsUtil::PopulateTable(data_table.get(), tuple_count, false, false,
+                                   true);
+
+  std::vector<std::unique_ptr<executor::LogicalTile>> source_logical_tiles;
+  for (int tile_group_itr = 0; tile_group_itr < tile_group_count;
+       tile_group_itr++) {
+    source_logical_tiles.emplace_back(
+        executor::LogicalTileFactory::WrapTileGroup(
+            data_table->GetTileGroup(tile_group_itr)));
+  }
+
+  // (1-5) Setup plan node
+
+  // 1) Set up group-by columns
+  std::vector<oid_t> group_by_columns = {0};
+
+  // 2) Set up project info
+  DirectMapList direct_map_list = {
+      {0, {0, 0}}, {1, {1, 0}}, {2, {1, 1}}, {3, {1, 2}}, {4, {1, 3}}};
+
+  std::unique_ptr<const planner::ProjectInfo> proj_info(
+      new planner::ProjectInfo(TargetList(), std::move(direct_map_list)));
+
+  // 3) Set up unique aggregates
+  std::vector<planner::AggregatePlan::AggTerm> agg_terms;
+  agg_terms.emplace_back(EXPRESSION_TYPE_AGGREGATE_COUNT_STAR, nullptr);
+  agg_terms.emplace_back(
+      EXPRESSION_TYPE_AGGREGATE_SUM,
+      expression::ExpressionUtil::TupleValueFactory(VALUE_TYPE_INTEGER, 0, 1));
+  agg_terms.emplace_back(
+      EXPRESSION_TYPE_AGGREGATE_MAX,
+      expression::ExpressionUtil::TupleValueFactory(VALUE_TYPE_DOUBLE, 0, 2));
+  agg_terms.emplace_back(
+      EXPRESSION_TYPE_AGGREGATE_AVG,
+      expression::ExpressionUtil::TupleValueFactory(VALUE_TYPE_INTEGER, 0, 1));
+
+  // 4) Set up predicate (empty)
+  std::unique_ptr<const expression::AbstractExpression> predicate(nullptr);
+
+  // 5) Create output table schema
+  std::vector<catalog::Column> columns = {
+      data_table->GetSchema()->GetColumn(0),
+      catalog::Column(VALUE_TYPE_BIGINT, GetTypeSize(VALUE_TYPE_BIGINT),
+                      "count", true),
+      catalog::Column(VALUE_TYPE_BIGINT, GetTypeSize(VALUE_TYPE_BIGINT), "sum",
+                      true),
+      catalog::Column(VALUE_TYPE_DOUBLE, GetTypeSize(VALUE_TYPE_DOUBLE), "max",
+                      true),
+      catalog::Column(VALUE_TYPE_DOUBLE, GetTypeSize(VALUE_TYPE_DOUBLE), "avg",
+                      true)};
+  std::shared_ptr<const catalog::Schema> output_table_schema(
+      new catalog::Schema(columns));
+
+  // OK) Create the plan node
+  planner::AggregatePlan node(std::move(proj_info), std::move(predicate),
+                              std::move(agg_terms), std::move(group_by_columns),
+                              output_table_schema, AGGREGATE_TYPE_HASH);
+  EXPECT_TRUE(executor::ParallelHashAggregator::IsSupported(&node));
+
+  std::unique_ptr<executor::ExecutorContext> context(
+      new executor::ExecutorContext(txn));
+  std::unique_ptr<storage::DataTable> output_table(
+      storage::TableFactory::GetDataTable(
+          INVALID_OID, INVALID_OID,
+          const_cast<catalog::Schema*>(node.GetOutputSchema()),
+          "aggregate_temp_table", DEFAULT_TUPLES_PER_TILEGROUP, false, false));
+
+  executor::ParallelHashAggregator aggregator(
+      &node, output_table.get(), context.get(),
+      source_logical_tiles[0]->GetColumnCount());
+  EXPECT_TRUE(aggregator.Execute(source_logical_tiles));
+
+  txn_manager.CommitTransaction();
+
+  /* Verify result : the first half of the rows has a = 0, the rest a = 10 */
+  std::unique_ptr<executor::LogicalTile> result_tile(
+      executor::LogicalTileFactory::WrapTileGroup(
+          output_table->GetTileGroup(0)));
+  EXPECT_EQ(2UL, result_tile->GetTupleCount());
+
+  const int group_size = tuple_count / 2;
+  for (oid_t tuple_id : *result_tile) {
+    int group = ValuePeeker::PeekInteger(result_tile->GetValue(tuple_id, 0)) /
+                ExecutorTestsUtil::PopulatedValue(1, 0);
+    int64_t expected_sum = 0;
+    for (int row = group * group_size; row < (group + 1) * group_size; row++) {
+      expected_sum += ExecutorTestsUtil::PopulatedValue(row, 1);
+    }
+
+    EXPECT_EQ(group_size,
+              ValuePeeker::PeekBigInt(result_tile->GetValue(tuple_id, 1)));
+    EXPECT_EQ(expected_sum,
+              ValuePeeker::PeekBigInt(result_tile->GetValue(tuple_id, 2)));
+    EXPECT_DOUBLE_EQ(
+        ExecutorTestsUtil::PopulatedValue((group + 1) * group_size - 1, 2),
+        ValuePeeker::PeekDouble(result_tile->GetValue(tuple_id, 3)));
+    EXPECT_DOUBLE_EQ(
+        static_cast<double>(expected_sum) / group_size,
+        ValuePeeker::PeekDouble(result_tile->GetValue(tuple_id, 4)));
+  }
+}
+
 }  // namespace test
 }  // namespace peloton
@@ -0,0 +1,219 @@
+//===----------------------------------------------------------------------===//
+//
+//                         Peloton
+//
+// import_test.cpp
+//
+// Identification: test/executor/import_test.cpp
+//
+// Copyright (c) 2015-16, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+
+#include <cstdio>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "common/harness.h"
+
+#include "common/value_factory.h"
+#include "common/value_peeker.h"
+#include "concurrency/transaction_manager_factory.h"
+#include "executor/executor_context.h"
+#include "executor/import_executor.h"
+#include "executor/logical_tile.h"
+#include "executor/seq_scan_executor.h"
+#include "index/index.h"
+#include "planner/import_plan.h"
+#include "planner/seq_scan_plan.h"
+#include "storage/data_table.h"
+#include "storage/tile_group.h"
+#include "storage/tuple.h"
+
+#include "executor/executor_tests_util.h"
+
+namespace peloton {
+namespace test {
+
+class ImportTests : public PelotonTest {};
+
+// Write the rows to a temporary file, the caller removes it
+std::string WriteImportFile(const std::vector<std::string> &rows) {
+  char file_path[] = "/tmp/peloton_import_XXXXXX";
+  int fd = mkstemp(file_path);
+  EXPECT_NE(-1, fd);
+
+  FILE *file = fdopen(fd, "w");
+  for (auto &row : rows) {
+    fprintf(file, "%s\n", row.c_str());
+  }
+  fclose(file);
+
+  return std::string(file_path);
+}
+
+// Run an import of the file and return the number of loaded tuples
+size_t ImportFile(storage::DataTable *table, const std::string &file_path,
+                  char delimiter) {
+  auto &txn_manager = concurrency::TransactionManagerFactory::GetInstance();
+  auto txn = txn_manager.BeginTransaction();
+  std::unique_ptr<executor::ExecutorContext> context(
+      new executor::ExecutorContext(txn));
+
+  planner::ImportPlan node(table, file_path, delimiter);
+  executor::ImportExecutor executor(&node, context.get());
+
+  size_t loaded_tuple_count = 0;
+  try {
+    EXPECT_TRUE(executor.Init());
+    EXPECT_FALSE(executor.Execute());
+    loaded_tuple_count = executor.GetLoadedTupleCount();
+  } catch (...) {
+    txn_manager.AbortTransaction();
+    throw;
+  }
+
+  txn_manager.CommitTransaction();
+  return loaded_tuple_count;
+}
+
+// Count the tuples a new transaction sees
+size_t CountVisibleTuples(storage::DataTable *table) {
+  auto &txn_manager = concurrency::TransactionManagerFactory::GetInstance();
+  auto txn = txn_manager.BeginTransaction();
+  std::unique_ptr<executor::ExecutorContext> context(
+      new executor::ExecutorContext(txn));
+
+  std::vector<oid_t> column_ids = {0};
+  planner::SeqScanPlan node(table, nullptr, column_ids);
+  executor::SeqScanExecutor executor(&node, context.get());
+
+  size_t tuple_count = 0;
+  EXPECT_TRUE(executor.Init());
+  while (executor.Execute()) {
+    std::unique_ptr<executor::LogicalTile> result_tile(executor.GetOutput());
+    tuple_count += result_tile->GetTupleCount();
+  }
+
+  txn_manager.CommitTransaction();
+  return tuple_count;
+}
+
+TEST_F(ImportTests, CSVImportTest) {
+  const size_t tuple_count = 1000;
+
+  std::unique_ptr<storage::DataTable> table(
+      ExecutorTestsUtil::CreateTable(64));
+
+  std::vector<std::string> rows;
+  for (size_t tuple_itr = 0; tuple_itr < tuple_count; tuple_itr++) {
+    auto id = std::to_string(tuple_itr);
+    rows.push_back(id + "," + std::to_string(tuple_itr % 10) + "," + id +
+                   ".5,\"name, \"\"" + id + "\"\"\"");
+  }
+  auto file_path = WriteImportFile(rows);
+
+  // Parse with several workers so the rows span many chunks
+  executor::ImportExecutor::Configure(4);
+  EXPECT_EQ(tuple_count, ImportFile(table.get(), file_path, ','));
+  executor::ImportExecutor::Configure(0);
+  remove(file_path.c_str());
+
+  EXPECT_EQ(tuple_count, CountVisibleTuples(table.get()));
+
+  // Every index holds an entry for every tuple
+  for (oid_t index_itr = 0; index_itr < table->GetIndexCount(); index_itr++) {
+    std::vector<ItemPointer> locations;
+    table->GetIndex(index_itr)->ScanAllKeys(locations);
+    EXPECT_EQ(tuple_count, locations.size());
+  }
+
+  // Look up a tuple through the primary index
+  auto primary_index = table->GetIndex(0);
+  storage::Tuple key(primary_index->GetKeySchema(), true);
+  key.SetValue(0, ValueFactory::GetIntegerValue(421), nullptr);
+  std::vector<ItemPointer> locations;
+  primary_index->ScanKey(&key, locations);
+  ASSERT_EQ(1, locations.size());
+
+  auto tile_group = table->GetTileGroupById(locations[0].block);
+  EXPECT_EQ(1, ValuePeeker::PeekAsInteger(
+                   tile_group->GetValue(locations[0].offset, 1)));
+  EXPECT_EQ(421.5, ValuePeeker::PeekDouble(
+                       tile_group->GetValue(locations[0].offset, 2)));
+  Value name = tile_group->GetValue(locations[0].offset, 3);
+  std::string name_string(
+      static_cast<const char *>(ValuePeeker::PeekObjectValueWithoutNull(name)),
+      ValuePeeker::PeekObjectLengthWithoutNull(name));
+  EXPECT_EQ("name, \"421\"", name_string);
+}
+
+TEST_F(ImportTests, TSVImportTest) {
+  std::unique_ptr<storage::DataTable> table(
+      ExecutorTestsUtil::CreateTable(4));
+
+  std::vector<std::string> rows = {"1\t10\t1.5\tone", "2\t20\t2.5\ttwo,2",
+                                   "", "3\t30\t3.5\tthree"};
+  auto file_path = WriteImportFile(rows);
+
+  EXPECT_EQ(3, ImportFile(table.get(), file_path, '\t'));
+  remove(file_path.c_str());
+
+  EXPECT_EQ(3, CountVisibleTuples(table.get()));
+}
+
+TEST_F(ImportTests, MalformedImportTest) {
+  std::unique_ptr<storage::DataTable> table(
+      ExecutorTestsUtil::CreateTable(4));
+
+  // the second record misses a field and the third one is not a number
+  std::vector<std::string> rows = {"1,10,1.5,one", "2,20,2.5", "x,30,3.5,x"};
+  auto file_path = WriteImportFile(rows);
+
+  EXPECT_THROW(ImportFile(table.get(), file_path, ','), ExecutorException);
+  remove(file_path.c_str());
+
+  // nothing of the failed batch is loaded
+  EXPECT_EQ(0, CountVisibleTuples(table.get()));
+  // only the tile group the table starts with
+  EXPECT_EQ(1, table->GetTileGroupCount());
+}
+
+TEST_F(ImportTests, DuplicateKeyImportTest) {
+  std::unique_ptr<storage::DataTable> table(
+      ExecutorTestsUtil::CreateTable(4));
+
+  // the batch repeats a primary key
+  auto file_path =
+      WriteImportFile({"1,10,1.5,one", "2,20,2.5,two", "1,30,3.5,three"});
+  EXPECT_THROW(ImportFile(table.get(), file_path, ','), ExecutorException);
+  remove(file_path.c_str());
+
+  EXPECT_EQ(0, CountVisibleTuples(table.get()));
+  for (oid_t index_itr = 0; index_itr < table->GetIndexCount(); index_itr++) {
+    std::vector<ItemPointer> locations;
+    table->GetIndex(index_itr)->ScanAllKeys(locations);
+    EXPECT_EQ(0, locations.size());
+  }
+
+  file_path = WriteImportFile({"1,10,1.5,one", "2,20,2.5,two"});
+  EXPECT_EQ(2, ImportFile(table.get(), file_path, ','));
+  remove(file_path.c_str());
+
+  // the batch holds a primary key the table already has
+  file_path = WriteImportFile({"3,30,3.5,three", "2,40,4.5,four"});
+  EXPECT_THROW(ImportFile(table.get(), file_path, ','), ExecutorException);
+  remove(file_path.c_str());
+
+  EXPECT_EQ(2, CountVisibleTuples(table.get()));
+  for (oid_t index_itr = 0; index_itr < table->GetIndexCount(); index_itr++) {
+    std::vector<ItemPointer> locations;
+    table->GetIndex(index_itr)->ScanAllKeys(locations);
+    EXPECT_EQ(2, locations.size());
+  }
+}
+
+}  // End test namespace
+}  // End peloton namespace
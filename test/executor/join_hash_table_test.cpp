@@ -0,0 +1,101 @@
+//===----------------------------------------------------------------------===//
+//
+//                         Peloton
+//
+// join_hash_table_test.cpp
+//
+// Identification: test/executor/join_hash_table_test.cpp
+//
+// Copyright (c) 2015-16, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+
+#include <memory>
+#include <vector>
+
+#include "common/harness.h"
+
+#include "concurrency/transaction_manager_factory.h"
+#include "executor/join_hash_table.h"
+#include "executor/logical_tile.h"
+#include "executor/logical_tile_factory.h"
+#include "storage/data_table.h"
+
+#include "executor/executor_tests_util.h"
+
+namespace peloton {
+namespace test {
+
+//===--------------------------------------------------------------------===//
+// Join Hash Table Tests
+//===--------------------------------------------------------------------===//
+
+class JoinHashTableTests : public PelotonTest {};
+
+// Build the table over the given key columns and probe it
+void BuildAndFind(const std::vector<oid_t> &column_ids) {
+  size_t tile_size = 20;
+  auto &txn_manager = concurrency::TransactionManagerFactory::GetInstance();
+  txn_manager.BeginTransaction();
+  std::unique_ptr<storage::DataTable> data_table(
+      ExecutorTestsUtil::CreateTable(tile_size));
+  ExecutorTestsUtil::PopulateTable(data_table.get(), tile_size * 3, false,
+                                   false, false);
+  txn_manager.CommitTransaction();
+
+  // The tuples of the first tile group show up twice
+  std::vector<std::unique_ptr<executor::LogicalTile>> tiles;
+  tiles.emplace_back(
+      executor::LogicalTileFactory::WrapTileGroup(data_table->GetTileGroup(0)));
+  tiles.emplace_back(
+      executor::LogicalTileFactory::WrapTileGroup(data_table->GetTileGroup(1)));
+  tiles.emplace_back(
+      executor::LogicalTileFactory::WrapTileGroup(data_table->GetTileGroup(0)));
+
+  executor::JoinHashTable hash_table;
+  hash_table.Build(tiles, &column_ids);
+
+  EXPECT_EQ(tile_size * 3, hash_table.GetSize());
+  EXPECT_EQ(tile_size * 2, hash_table.GetKeyCount());
+
+  std::unique_ptr<executor::LogicalTile> probe_tile(
+      executor::LogicalTileFactory::WrapTileGroup(data_table->GetTileGroup(0)));
+  for (oid_t tuple_id : *probe_tile) {
+    executor::JoinHashTable::KeyType key(probe_tile.get(), tuple_id,
+                                         &column_ids);
+    auto range = hash_table.Find(key, executor::JoinHashTable::HashKey(key));
+
+    // the matches are returned in the order of the tiles
+    ASSERT_EQ(2, range.second - range.first);
+    EXPECT_EQ(std::make_pair(0U, tuple_id), range.first[0]);
+    EXPECT_EQ(std::make_pair(2U, tuple_id), range.first[1]);
+  }
+
+  // The tuples of the last tile group are not in the table
+  probe_tile.reset(
+      executor::LogicalTileFactory::WrapTileGroup(data_table->GetTileGroup(2)));
+  for (oid_t tuple_id : *probe_tile) {
+    executor::JoinHashTable::KeyType key(probe_tile.get(), tuple_id,
+                                         &column_ids);
+    auto range = hash_table.Find(key, executor::JoinHashTable::HashKey(key));
+    EXPECT_EQ(range.first, range.second);
+  }
+}
+
+TEST_F(JoinHashTableTests, BuildAndFindTest) {
+  // an integer key kept inline in the slots
+  BuildAndFind({0});
+
+  // a composite key kept inline in the slots
+  BuildAndFind({0, 1});
+
+  // a string key compared through the tiles
+  BuildAndFind({3});
+
+  // too many columns to be kept inline
+  BuildAndFind({0, 1, 3});
+}
+
+}  // End test namespace
+}  // End peloton namespace
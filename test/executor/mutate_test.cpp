@@ -32,6 +32,7 @@
 #include "executor/seq_scan_executor.h"
 #include "executor/update_executor.h"
 #include "executor/logical_tile_factory.h"
+#include "executor/plan_executor.h"
 #include "expression/expression_util.h"
 #include "expression/tuple_value_expression.h"
 #include "expression/comparison_expression.h"
@@ -415,5 +416,51 @@ TEST_F(MutateTests, UpdateTest) {
   tuple_id = 0;
 }
 
+TEST_F(MutateTests, ReusedExecutorTreeTest) {
+  storage::DataTable *table = ExecutorTestsUtil::CreateTable();
+  auto testing_pool = TestingHarness::GetInstance().GetTestingPool();
+
+  LaunchParallelTest(1, InsertTuple, table, testing_pool);
+
+  // UPDATE SET ATTR_2 = 23.5 WHERE ATTR_0 < 70
+  TargetList target_list;
+  DirectMapList direct_map_list;
+  target_list.emplace_back(2, expression::ExpressionUtil::ConstantValueFactory(
+                                  ValueFactory::GetDoubleValue(23.5)));
+  direct_map_list.emplace_back(0, std::pair<oid_t, oid_t>(0, 0));
+  direct_map_list.emplace_back(1, std::pair<oid_t, oid_t>(0, 1));
+  direct_map_list.emplace_back(3, std::pair<oid_t, oid_t>(0, 3));
+
+  std::unique_ptr<const planner::ProjectInfo> project_info(
+      new planner::ProjectInfo(std::move(target_list),
+                               std::move(direct_map_list)));
+  std::shared_ptr<planner::AbstractPlan> update_node(
+      new planner::UpdatePlan(table, std::move(project_info)));
+
+  auto predicate = new expression::ComparisonExpression<expression::CmpLt>(
+      EXPRESSION_TYPE_COMPARE_LESSTHAN,
+      new expression::TupleValueExpression(VALUE_TYPE_INTEGER, 0, 0),
+      new expression::ConstantValueExpression(
+          ValueFactory::GetIntegerValue(70)));
+  std::vector<oid_t> column_ids = {0};
+  std::unique_ptr<planner::SeqScanPlan> seq_scan_node(
+      new planner::SeqScanPlan(table, predicate, column_ids));
+  update_node->AddChild(std::move(seq_scan_node));
+
+  // the second execution re-initializes the executor tree of the first one
+  std::vector<Value> params;
+  for (int execution_itr = 0; execution_itr < 2; execution_itr++) {
+    auto status = bridge::PlanExecutor::ExecutePlan(update_node, params);
+    EXPECT_EQ(RESULT_SUCCESS, status.m_result);
+    EXPECT_EQ(6, status.m_processed);
+  }
+
+  auto tuple_cnt = SeqScanCount(table, column_ids, nullptr);
+  EXPECT_EQ(tuple_cnt, 10);
+
+  delete table;
+  tuple_id = 0;
+}
+
 }  // namespace test
 }  // namespace peloton
@@ -11,6 +11,8 @@
 //===----------------------------------------------------------------------===//
 
 
+#include <algorithm>
+#include <functional>
 #include <memory>
 #include <set>
 #include <string>
@@ -21,11 +23,13 @@
 #include "planner/order_by_plan.h"
 #include "common/types.h"
 #include "common/value.h"
+#include "common/value_peeker.h"
 #include "executor/executor_context.h"
 #include "executor/logical_tile.h"
 #include "executor/order_by_executor.h"
 #include "executor/logical_tile_factory.h"
 #include "storage/data_table.h"
+#include "storage/tile_group.h"
 #include "concurrency/transaction_manager_factory.h"
 
 #include "executor/executor_tests_util.h"
@@ -68,6 +72,33 @@ void RunTest(executor::OrderByExecutor &executor, size_t expected_num_tuples,
   }
 }
 
+// Check that consecutive output tuples are ordered on the sort keys
+void VerifyOrder(
+    const std::vector<std::unique_ptr<executor::LogicalTile>> &result_tiles,
+    const std::vector<oid_t> &sort_keys,
+    const std::vector<bool> &descend_flags) {
+  std::vector<Value> previous;
+  for (auto &tile : result_tiles) {
+    for (oid_t tuple_id : *tile) {
+      std::vector<Value> current;
+      for (auto sort_key : sort_keys) {
+        current.push_back(tile->GetValue(tuple_id, sort_key));
+      }
+
+      for (size_t key_itr = 0; key_itr < previous.size(); key_itr++) {
+        auto &before = descend_flags[key_itr] ? current[key_itr]
+                                              : previous[key_itr];
+        auto &after = descend_flags[key_itr] ? previous[key_itr]
+                                             : current[key_itr];
+        if (before.OpLessThan(after).IsTrue()) break;
+        EXPECT_TRUE(before.OpEquals(after).IsTrue());
+      }
+
+      previous = current;
+    }
+  }
+}
+
 TEST_F(OrderByTests, IntAscTest) {
   // Create the plan node
   std::vector<oid_t> sort_keys({1});
@@ -300,6 +331,147 @@ TEST_F(OrderByTests, StringDescIntAscTest) {
 
   RunTest(executor, tile_size * 2, sort_keys, descend_flags);
 }
+
+TEST_F(OrderByTests, ExternalSortTest) {
+  // Create the plan node
+  std::vector<oid_t> sort_keys({1, 3});
+  std::vector<bool> descend_flags({false, true});
+  std::vector<oid_t> output_columns({0, 1, 2, 3});
+  planner::OrderByPlan node(sort_keys, descend_flags, output_columns);
+
+  std::unique_ptr<executor::ExecutorContext> context(
+      new executor::ExecutorContext(nullptr));
+
+  // Spill a run every few tuples
+  auto memory_budget = executor::OrderByExecutor::GetMemoryBudget();
+  executor::OrderByExecutor::Configure(256);
+
+  // Create and set up executor
+  executor::OrderByExecutor executor(&node, context.get());
+  MockExecutor child_executor;
+  executor.AddChild(&child_executor);
+
+  EXPECT_CALL(child_executor, DInit()).WillOnce(Return(true));
+
+  EXPECT_CALL(child_executor, DExecute())
+      .WillOnce(Return(true))
+      .WillOnce(Return(true))
+      .WillOnce(Return(false));
+
+  // Create a table and wrap it in logical tile
+  size_t tile_size = 20;
+  auto &txn_manager = concurrency::TransactionManagerFactory::GetInstance();
+  txn_manager.BeginTransaction();
+  std::unique_ptr<storage::DataTable> data_table(
+      ExecutorTestsUtil::CreateTable(tile_size));
+  bool random = true;
+  ExecutorTestsUtil::PopulateTable(data_table.get(), tile_size * 2, false,
+                                   random, false);
+  txn_manager.CommitTransaction();
+
+  std::unique_ptr<executor::LogicalTile> source_logical_tile1(
+      executor::LogicalTileFactory::WrapTileGroup(data_table->GetTileGroup(0)));
+
+  std::unique_ptr<executor::LogicalTile> source_logical_tile2(
+      executor::LogicalTileFactory::WrapTileGroup(data_table->GetTileGroup(1)));
+
+  EXPECT_CALL(child_executor, GetOutput())
+      .WillOnce(Return(source_logical_tile1.release()))
+      .WillOnce(Return(source_logical_tile2.release()));
+
+  EXPECT_TRUE(executor.Init());
+
+  std::vector<std::unique_ptr<executor::LogicalTile>> result_tiles;
+  while (executor.Execute()) {
+    result_tiles.emplace_back(executor.GetOutput());
+  }
+
+  size_t num_tuples_returned = 0;
+  for (auto &tile : result_tiles) {
+    num_tuples_returned += tile->GetTupleCount();
+  }
+  EXPECT_EQ(tile_size * 2, num_tuples_returned);
+
+  VerifyOrder(result_tiles, sort_keys, descend_flags);
+
+  executor::OrderByExecutor::Configure(memory_budget);
+}
+
+TEST_F(OrderByTests, TopNTest) {
+  // Create the plan node
+  std::vector<oid_t> sort_keys({1});
+  std::vector<bool> descend_flags({true});
+  std::vector<oid_t> output_columns({0, 1, 2, 3});
+  planner::OrderByPlan node(sort_keys, descend_flags, output_columns);
+
+  std::unique_ptr<executor::ExecutorContext> context(
+      new executor::ExecutorContext(nullptr));
+
+  // Create and set up executor, only the first few tuples are needed
+  size_t limit = 7;
+  executor::OrderByExecutor executor(&node, context.get());
+  executor.SetLimit(limit);
+  MockExecutor child_executor;
+  executor.AddChild(&child_executor);
+
+  EXPECT_CALL(child_executor, DInit()).WillOnce(Return(true));
+
+  EXPECT_CALL(child_executor, DExecute())
+      .WillOnce(Return(true))
+      .WillOnce(Return(true))
+      .WillOnce(Return(false));
+
+  // Create a table and wrap it in logical tile
+  size_t tile_size = 20;
+  auto &txn_manager = concurrency::TransactionManagerFactory::GetInstance();
+  txn_manager.BeginTransaction();
+  std::unique_ptr<storage::DataTable> data_table(
+      ExecutorTestsUtil::CreateTable(tile_size));
+  bool random = true;
+  ExecutorTestsUtil::PopulateTable(data_table.get(), tile_size * 2, false,
+                                   random, false);
+  txn_manager.CommitTransaction();
+
+  // The largest values of the sort key
+  std::vector<int32_t> expected_values;
+  for (oid_t tile_group_itr = 0; tile_group_itr < 2; tile_group_itr++) {
+    auto tile_group = data_table->GetTileGroup(tile_group_itr);
+    for (oid_t tuple_itr = 0; tuple_itr < tile_size; tuple_itr++) {
+      expected_values.push_back(ValuePeeker::PeekInteger(
+          tile_group->GetValue(tuple_itr, sort_keys[0])));
+    }
+  }
+  std::sort(expected_values.begin(), expected_values.end(),
+            std::greater<int32_t>());
+  expected_values.resize(limit);
+
+  std::unique_ptr<executor::LogicalTile> source_logical_tile1(
+      executor::LogicalTileFactory::WrapTileGroup(data_table->GetTileGroup(0)));
+
+  std::unique_ptr<executor::LogicalTile> source_logical_tile2(
+      executor::LogicalTileFactory::WrapTileGroup(data_table->GetTileGroup(1)));
+
+  EXPECT_CALL(child_executor, GetOutput())
+      .WillOnce(Return(source_logical_tile1.release()))
+      .WillOnce(Return(source_logical_tile2.release()));
+
+  EXPECT_TRUE(executor.Init());
+
+  std::vector<std::unique_ptr<executor::LogicalTile>> result_tiles;
+  while (executor.Execute()) {
+    result_tiles.emplace_back(executor.GetOutput());
+  }
+
+  std::vector<int32_t> values;
+  for (auto &tile : result_tiles) {
+    for (oid_t tuple_id : *tile) {
+      values.push_back(
+          ValuePeeker::PeekInteger(tile->GetValue(tuple_id, sort_keys[0])));
+    }
+  }
+  EXPECT_EQ(expected_values, values);
+}
+
 }
 
 }  // namespace test
@@ -0,0 +1,71 @@
+//===----------------------------------------------------------------------===//
+//
+//                         Peloton
+//
+// plan_executor_test.cpp
+//
+// Identification: test/executor/plan_executor_test.cpp
+//
+// Copyright (c) 2015-16, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+
+#include <memory>
+#include <vector>
+
+#include "common/harness.h"
+#include "concurrency/transaction_manager_factory.h"
+#include "executor/logical_tile.h"
+#include "executor/plan_executor.h"
+#include "planner/seq_scan_plan.h"
+#include "storage/data_table.h"
+
+#include "executor/executor_tests_util.h"
+
+namespace peloton {
+namespace test {
+
+//===--------------------------------------------------------------------===//
+// Plan Executor Tests
+//===--------------------------------------------------------------------===//
+
+class PlanExecutorTests : public PelotonTest {};
+
+TEST_F(PlanExecutorTests, ResultTileCallbackTest) {
+  std::unique_ptr<storage::DataTable> table(
+      ExecutorTestsUtil::CreateAndPopulateTable());
+  std::vector<oid_t> column_ids = {0, 1};
+  planner::SeqScanPlan node(table.get(), nullptr, column_ids);
+  std::vector<Value> params;
+
+  // every tile group of the table reaches the callback as a tile
+  size_t tile_count = 0;
+  size_t tuple_count = 0;
+  auto status = bridge::PlanExecutor::ExecutePlan(
+      &node, params,
+      [&tile_count, &tuple_count](executor::LogicalTile *logical_tile) {
+        tile_count++;
+        tuple_count += logical_tile->GetTupleCount();
+        return true;
+      });
+  EXPECT_EQ(RESULT_SUCCESS, status.m_result);
+  EXPECT_EQ(DEFAULT_TILEGROUP_COUNT, tile_count);
+  EXPECT_EQ(TESTS_TUPLES_PER_TILEGROUP * DEFAULT_TILEGROUP_COUNT,
+            tuple_count);
+
+  // a callback that returns false stops the execution, and the transaction
+  // of the statement is aborted
+  tile_count = 0;
+  status = bridge::PlanExecutor::ExecutePlan(
+      &node, params, [&tile_count](executor::LogicalTile *) {
+        tile_count++;
+        return false;
+      });
+  EXPECT_EQ(RESULT_ABORTED, status.m_result);
+  EXPECT_EQ(1, tile_count);
+  EXPECT_TRUE(concurrency::current_txn == nullptr);
+}
+
+}  // End test namespace
+}  // End peloton namespace
@@ -30,6 +30,7 @@
 #include "executor/logical_tile_factory.h"
 #include "executor/seq_scan_executor.h"
 #include "expression/abstract_expression.h"
+#include "expression/container_tuple.h"
 #include "expression/expression_util.h"
 #include "planner/seq_scan_plan.h"
 #include "storage/data_table.h"
@@ -314,6 +315,66 @@ TEST_F(SeqScanTests, NonLeafNodePredicateTest) {
 
   txn_manager.CommitTransaction();
 }
+
+// Batch predicate evaluation must agree with tuple at a time evaluation.
+TEST_F(SeqScanTests, BatchPredicateTest) {
+  std::unique_ptr<storage::DataTable> table(CreateTable());
+
+  // (A >= 10 AND 40 > A) OR B = 41 OR D = '33'
+  auto lower_bound = expression::ExpressionUtil::ComparisonFactory(
+      EXPRESSION_TYPE_COMPARE_GREATERTHANOREQUALTO,
+      expression::ExpressionUtil::TupleValueFactory(VALUE_TYPE_INTEGER, 0, 0),
+      expression::ExpressionUtil::ConstantValueFactory(
+          ValueFactory::GetIntegerValue(10)));
+  auto upper_bound = expression::ExpressionUtil::ComparisonFactory(
+      EXPRESSION_TYPE_COMPARE_GREATERTHAN,
+      expression::ExpressionUtil::ConstantValueFactory(
+          ValueFactory::GetBigIntValue(40)),
+      expression::ExpressionUtil::TupleValueFactory(VALUE_TYPE_INTEGER, 0, 0));
+  auto point = expression::ExpressionUtil::ComparisonFactory(
+      EXPRESSION_TYPE_COMPARE_EQUAL,
+      expression::ExpressionUtil::TupleValueFactory(VALUE_TYPE_INTEGER, 0, 1),
+      expression::ExpressionUtil::ConstantValueFactory(
+          ValueFactory::GetIntegerValue(41)));
+  auto string_point = expression::ExpressionUtil::ComparisonFactory(
+      EXPRESSION_TYPE_COMPARE_EQUAL,
+      expression::ExpressionUtil::TupleValueFactory(VALUE_TYPE_VARCHAR, 0, 3),
+      expression::ExpressionUtil::ConstantValueFactory(
+          ValueFactory::GetStringValue("33")));
+
+  std::unique_ptr<expression::AbstractExpression> predicate(
+      expression::ExpressionUtil::ConjunctionFactory(
+          EXPRESSION_TYPE_CONJUNCTION_OR,
+          expression::ExpressionUtil::ConjunctionFactory(
+              EXPRESSION_TYPE_CONJUNCTION_OR,
+              expression::ExpressionUtil::ConjunctionFactory(
+                  EXPRESSION_TYPE_CONJUNCTION_AND, lower_bound, upper_bound),
+              point),
+          string_point));
+
+  for (oid_t tile_group_itr = 0; tile_group_itr < table->GetTileGroupCount();
+       tile_group_itr++) {
+    auto tile_group = table->GetTileGroup(tile_group_itr);
+
+    std::vector<oid_t> expected_selection;
+    std::vector<oid_t> selection;
+    for (oid_t tuple_id = 0; tuple_id < tile_group->GetNextTupleSlot();
+         tuple_id++) {
+      expression::ContainerTuple<storage::TileGroup> tuple(tile_group.get(),
+                                                           tuple_id);
+      if (predicate->Evaluate(&tuple, nullptr, nullptr).IsTrue()) {
+        expected_selection.push_back(tuple_id);
+      }
+      selection.push_back(tuple_id);
+    }
+
+    predicate->EvaluateBatch(tile_group.get(), selection, nullptr);
+
+    // tuples 1, 2, 3 and 4
+    EXPECT_EQ(4, selection.size());
+    EXPECT_EQ(expected_selection, selection);
+  }
+}
 }
 
 }  // namespace test
@@ -16,6 +16,10 @@
 #include "gc/gc_manager.h"
 #include "gc/gc_manager_factory.h"
 #include "concurrency/epoch_manager.h"
+#include "executor/executor_tests_util.h"
+#include "index/index.h"
+#include "storage/data_table.h"
+#include "storage/tile_group.h"
 
 namespace peloton {
 namespace test {
@@ -208,5 +212,100 @@ each time
 
 */
 
+TEST_F(GCTest, ParallelReclaimTest) {
+  std::unique_ptr<storage::DataTable> table(
+      ExecutorTestsUtil::CreateAndPopulateTable());
+  auto table_id = table->GetOid();
+  auto tile_group = table->GetTileGroup(0);
+  auto tile_group_id = tile_group->GetTileGroupId();
+  auto primary_index = table->GetIndex(0);
+  auto secondary_index = table->GetIndex(1);
+
+  std::vector<ItemPointer> locations;
+  primary_index->ScanAllKeys(locations);
+  size_t tuple_count = locations.size();
+  EXPECT_EQ((size_t)TESTS_TUPLES_PER_TILEGROUP * DEFAULT_TILEGROUP_COUNT,
+            tuple_count);
+
+  gc::GCManager gc_manager(GC_TYPE_COOPERATIVE, 2);
+  EXPECT_EQ(2UL, gc_manager.GetThreadCount());
+
+  // Hand the dead versions of the first tile group to the GC
+  const size_t garbage_count = 3;
+  for (oid_t tuple_id = 0; tuple_id < garbage_count; tuple_id++) {
+    gc_manager.RecycleTupleSlot(table_id, tile_group_id, tuple_id, 0);
+  }
+
+  // Stopping the GC reclaims every pending version
+  gc_manager.StopGC();
+  EXPECT_EQ(garbage_count, gc_manager.GetReclaimedCount());
+  EXPECT_EQ(0UL, gc_manager.GetQueueBacklog());
+
+  // The index entries of the reclaimed versions are gone
+  locations.clear();
+  primary_index->ScanAllKeys(locations);
+  EXPECT_EQ(tuple_count - garbage_count, locations.size());
+  locations.clear();
+  secondary_index->ScanAllKeys(locations);
+  EXPECT_EQ(tuple_count - garbage_count, locations.size());
+  for (auto location : locations) {
+    EXPECT_FALSE(location.block == tile_group_id &&
+                 location.offset < garbage_count);
+  }
+
+  // The slots wait to be reused
+  EXPECT_EQ(garbage_count, gc_manager.GetRecycleQueueBacklog());
+  std::vector<ItemPointer> free_slots;
+  gc_manager.ReturnFreeSlots(table_id, free_slots, garbage_count + 1);
+  EXPECT_EQ(garbage_count, free_slots.size());
+  EXPECT_EQ(0UL, gc_manager.GetRecycleQueueBacklog());
+}
+
+TEST_F(GCTest, PrimaryIndexSwapTest) {
+  std::unique_ptr<storage::DataTable> table(
+      ExecutorTestsUtil::CreateAndPopulateTable());
+  auto tile_group = table->GetTileGroup(0);
+  auto tile_group_id = tile_group->GetTileGroupId();
+  auto primary_index = table->GetIndex(0);
+
+  std::vector<ItemPointer> locations;
+  primary_index->ScanAllKeys(locations);
+  size_t tuple_count = locations.size();
+
+  // The first tuple has a newer version in the second tile group
+  auto next_tile_group = table->GetTileGroup(1);
+  ItemPointer location(tile_group_id, 0);
+  ItemPointer next_location(next_tile_group->GetTileGroupId(), 0);
+  tile_group->GetHeader()->SetNextItemPointer(0, next_location);
+  next_tile_group->GetHeader()->SetPrevItemPointer(0, location);
+
+  storage::Tuple key(primary_index->GetKeySchema(), true);
+  key.SetValue(0, tile_group->GetValue(0, 0), nullptr);
+  std::vector<ItemPointer *> entry_locations;
+  primary_index->ScanKey(&key, entry_locations);
+  ASSERT_EQ(1, entry_locations.size());
+  auto entry_location = entry_locations[0];
+
+  gc::GCManager gc_manager(GC_TYPE_COOPERATIVE, 1);
+  gc_manager.RecycleTupleSlot(table->GetOid(), tile_group_id, 0, 0);
+  gc_manager.StopGC();
+  EXPECT_EQ(1UL, gc_manager.GetReclaimedCount());
+
+  // The entry now points at the next version, without being reinserted
+  entry_locations.clear();
+  primary_index->ScanKey(&key, entry_locations);
+  ASSERT_EQ(1, entry_locations.size());
+  EXPECT_EQ(entry_location, entry_locations[0]);
+  EXPECT_EQ(next_location.block, entry_locations[0]->block);
+  EXPECT_EQ(next_location.offset, entry_locations[0]->offset);
+
+  locations.clear();
+  primary_index->ScanAllKeys(locations);
+  EXPECT_EQ(tuple_count, locations.size());
+
+  // The next version is the oldest one now
+  EXPECT_TRUE(next_tile_group->GetHeader()->GetPrevItemPointer(0).IsNull());
+}
+
 }  // End test namespace
 }  // End peloton namespace
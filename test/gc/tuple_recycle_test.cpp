@@ -0,0 +1,179 @@
+//===----------------------------------------------------------------------===//
+//
+//                         Peloton
+//
+// tuple_recycle_test.cpp
+//
+// Identification: test/gc/tuple_recycle_test.cpp
+//
+// Copyright (c) 2015-16, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+
+#include <chrono>
+#include <thread>
+
+#include "common/harness.h"
+#include "common/value_factory.h"
+#include "common/value_peeker.h"
+#include "concurrency/transaction_manager_factory.h"
+#include "gc/gc_manager.h"
+#include "gc/gc_manager_factory.h"
+#include "index/index.h"
+#include "storage/data_table.h"
+#include "storage/tile_group.h"
+#include "storage/tuple.h"
+
+#include "executor/executor_tests_util.h"
+
+namespace peloton {
+namespace test {
+
+//===--------------------------------------------------------------------===//
+// Tuple Recycle Tests
+//===--------------------------------------------------------------------===//
+
+// The tables insert through the GC of the factory, so every test of this file
+// configures it before the first insert
+class TupleRecycleTests : public PelotonTest {};
+
+// Wait for the GC to reclaim the given number of versions in total
+void WaitForReclaim(gc::GCManager &gc_manager, size_t reclaimed_count) {
+  for (int attempt = 0; attempt < 100; attempt++) {
+    if (gc_manager.GetReclaimedCount() >= reclaimed_count) return;
+    std::this_thread::sleep_for(
+        std::chrono::milliseconds(GC_PERIOD_MILLISECONDS));
+  }
+}
+
+// Number of primary index entries of the tuple populated with the id
+size_t CountPrimaryEntries(storage::DataTable *table, oid_t tuple_id) {
+  auto primary_index = table->GetIndex(0);
+  storage::Tuple key(primary_index->GetKeySchema(), true);
+  key.SetValue(0, ValueFactory::GetIntegerValue(
+                      ExecutorTestsUtil::PopulatedValue(tuple_id, 0)),
+               nullptr);
+  std::vector<ItemPointer> locations;
+  primary_index->ScanKey(&key, locations);
+  return locations.size();
+}
+
+TEST_F(TupleRecycleTests, RecycledSlotInsertTest) {
+  gc::GCManagerFactory::Configure(GC_TYPE_COOPERATIVE);
+  auto &gc_manager = gc::GCManagerFactory::GetInstance();
+  auto &txn_manager = concurrency::TransactionManagerFactory::GetInstance();
+
+  std::unique_ptr<storage::DataTable> table(
+      ExecutorTestsUtil::CreateAndPopulateTable());
+  auto tile_group_id = table->GetTileGroup(0)->GetTileGroupId();
+  ItemPointer recycled_location(tile_group_id, 0);
+  EXPECT_EQ(1, CountPrimaryEntries(table.get(), 0));
+
+  // Hand the version in the first slot to the GC as garbage
+  auto reclaimed_count = gc_manager.GetReclaimedCount();
+  gc_manager.RecycleTupleSlot(table->GetOid(), tile_group_id, 0, 0);
+  WaitForReclaim(gc_manager, reclaimed_count + 1);
+  ASSERT_EQ(reclaimed_count + 1, gc_manager.GetReclaimedCount());
+
+  // Its index entries are unlinked before the slot is handed out again
+  EXPECT_EQ(0, CountPrimaryEntries(table.get(), 0));
+
+  // An insert buffer asks the GC again within one batch of inserts
+  auto testing_pool = TestingHarness::GetInstance().GetTestingPool();
+  oid_t tuple_id = TESTS_TUPLES_PER_TILEGROUP * DEFAULT_TILEGROUP_COUNT;
+  oid_t reused_tuple_id = INVALID_OID;
+  txn_manager.BeginTransaction();
+  for (size_t insert_itr = 0; insert_itr <= DATA_TABLE_FREE_SLOT_BATCH_SIZE;
+       insert_itr++, tuple_id++) {
+    auto tuple = ExecutorTestsUtil::GetTuple(table.get(), tuple_id,
+                                             testing_pool);
+    auto location = table->InsertTuple(tuple.get());
+    ASSERT_FALSE(location.IsNull());
+    EXPECT_TRUE(txn_manager.PerformInsert(location));
+
+    if (location.block == recycled_location.block &&
+        location.offset == recycled_location.offset) {
+      reused_tuple_id = tuple_id;
+      break;
+    }
+  }
+  txn_manager.CommitTransaction();
+  ASSERT_NE(INVALID_OID, reused_tuple_id);
+
+  // The new tuple is found through the index in the recycled slot, and the
+  // key of the dead version is still gone
+  auto primary_index = table->GetIndex(0);
+  storage::Tuple key(primary_index->GetKeySchema(), true);
+  key.SetValue(0, ValueFactory::GetIntegerValue(
+                      ExecutorTestsUtil::PopulatedValue(reused_tuple_id, 0)),
+               nullptr);
+  std::vector<ItemPointer> locations;
+  primary_index->ScanKey(&key, locations);
+  ASSERT_EQ(1, locations.size());
+  EXPECT_EQ(recycled_location.block, locations[0].block);
+  EXPECT_EQ(recycled_location.offset, locations[0].offset);
+  EXPECT_EQ(0, CountPrimaryEntries(table.get(), 0));
+
+  auto tile_group = table->GetTileGroupById(tile_group_id);
+  EXPECT_EQ(ExecutorTestsUtil::PopulatedValue(reused_tuple_id, 1),
+            ValuePeeker::PeekAsInteger(tile_group->GetValue(0, 1)));
+}
+
+TEST_F(TupleRecycleTests, SteadyUpdateRecycleTest) {
+  gc::GCManagerFactory::Configure(GC_TYPE_COOPERATIVE);
+  auto &gc_manager = gc::GCManagerFactory::GetInstance();
+  auto &txn_manager = concurrency::TransactionManagerFactory::GetInstance();
+
+  std::unique_ptr<storage::DataTable> table(
+      ExecutorTestsUtil::CreateAndPopulateTable());
+  auto testing_pool = TestingHarness::GetInstance().GetTestingPool();
+  auto recycle_backlog = gc_manager.GetRecycleQueueBacklog();
+
+  // Every round retires the versions written by the previous one and writes
+  // as many new versions
+  const size_t version_count = 16;
+  const size_t round_count = 40;
+  std::vector<ItemPointer> versions;
+  for (oid_t tuple_slot = 0; tuple_slot < TESTS_TUPLES_PER_TILEGROUP;
+       tuple_slot++) {
+    versions.emplace_back(table->GetTileGroup(0)->GetTileGroupId(),
+                          tuple_slot);
+  }
+
+  oid_t tuple_id = TESTS_TUPLES_PER_TILEGROUP * DEFAULT_TILEGROUP_COUNT;
+  for (size_t round_itr = 0; round_itr < round_count; round_itr++) {
+    auto reclaimed_count = gc_manager.GetReclaimedCount();
+    for (auto &version : versions) {
+      gc_manager.RecycleTupleSlot(table->GetOid(), version.block,
+                                  version.offset, 0);
+    }
+    WaitForReclaim(gc_manager, reclaimed_count + versions.size());
+
+    // The inserts take the reclaimed slots, so the queue does not grow with
+    // the number of rounds
+    EXPECT_LE(gc_manager.GetRecycleQueueBacklog(),
+              recycle_backlog + 2 * (DATA_TABLE_FREE_SLOT_BATCH_SIZE +
+                                     version_count));
+
+    versions.clear();
+    txn_manager.BeginTransaction();
+    for (size_t version_itr = 0; version_itr < version_count;
+         version_itr++, tuple_id++) {
+      auto tuple =
+          ExecutorTestsUtil::GetTuple(table.get(), tuple_id, testing_pool);
+      auto location = table->InsertTuple(tuple.get());
+      EXPECT_FALSE(location.IsNull());
+      txn_manager.PerformInsert(location);
+      versions.push_back(location);
+    }
+    txn_manager.CommitTransaction();
+  }
+
+  // Without reuse, every version would take a new slot
+  EXPECT_LT(table->GetTileGroupCount() * TESTS_TUPLES_PER_TILEGROUP,
+            version_count * round_count / 2);
+}
+
+}  // End test namespace
+}  // End peloton namespace
@@ -104,14 +104,14 @@ void InsertTest(index::Index *index, size_t scale_factor, uint64_t thread_itr) {
 
 }
 
-static void TestIndexPerformance(const IndexType& index_type) {
+static void TestIndexPerformance(const IndexType& index_type,
+                                 const size_t num_threads) {
   std::vector<ItemPointer> locations;
 
   // INDEX
   std::unique_ptr<index::Index> index(BuildIndex(false, index_type));
 
   // Parallel Test
-  size_t num_threads = 2;
   size_t scale_factor = 1;
   Timer<> timer;
 
@@ -126,16 +126,21 @@ static void TestIndexPerformance(const IndexType& index_type) {
   locations.clear();
 
   timer.Stop();
-  LOG_INFO("Duration : %.2lf", timer.GetDuration());
+  LOG_INFO("%s Threads : %lu Duration : %.2lf", index->GetTypeName().c_str(),
+           num_threads, timer.GetDuration());
 
   delete tuple_schema;
 }
 
 TEST_F(IndexPerformanceTests, MultiThreadedTest) {
-  std::vector<IndexType> index_types = {INDEX_TYPE_BTREE, INDEX_TYPE_SKIPLIST};
+  std::vector<IndexType> index_types = {INDEX_TYPE_BTREE, INDEX_TYPE_SKIPLIST,
+                                        INDEX_TYPE_BWTREE, INDEX_TYPE_HASH};
+  std::vector<size_t> thread_counts = {1, 2, 4, 8};
 
   for(auto index_type : index_types) {
-    TestIndexPerformance(index_type);
+    for(auto num_threads : thread_counts) {
+      TestIndexPerformance(index_type, num_threads);
+    }
   }
 
 }
@@ -37,14 +37,14 @@ ItemPointer item0(120, 5);
 ItemPointer item1(120, 7);
 ItemPointer item2(123, 19);
 
+// index method used by BuildIndex
+IndexType index_type = INDEX_TYPE_BTREE;
+
 index::Index *BuildIndex(const bool unique_keys) {
   // Build tuple and key schema
   std::vector<std::vector<std::string>> column_names;
   std::vector<catalog::Column> columns;
   std::vector<catalog::Schema *> schemas;
-  IndexType index_type = INDEX_TYPE_BTREE;
-  // FIXME: Try to use BWTREE
-  // index_type = INDEX_TYPE_BWTREE;
 
   catalog::Column column1(VALUE_TYPE_INTEGER, GetTypeSize(VALUE_TYPE_INTEGER),
                           "A", true);
@@ -110,6 +110,49 @@ TEST_F(IndexTests, BasicTest) {
   delete tuple_schema;
 }
 
+TEST_F(IndexTests, InsertEntriesTest) {
+  auto pool = TestingHarness::GetInstance().GetTestingPool();
+  std::vector<ItemPointer> locations;
+
+  // INDEX
+  std::unique_ptr<index::Index> index(BuildIndex(false));
+
+  // keys in descending order, every key twice
+  std::vector<std::unique_ptr<storage::Tuple>> keys;
+  std::vector<const storage::Tuple *> key_pointers;
+  std::vector<ItemPointer> key_locations;
+  for (int key_itr = 99; key_itr >= 0; key_itr--) {
+    for (oid_t copy_itr = 0; copy_itr < 2; copy_itr++) {
+      std::unique_ptr<storage::Tuple> key(new storage::Tuple(key_schema, true));
+      key->SetValue(0, ValueFactory::GetIntegerValue(key_itr), pool);
+      key->SetValue(1, ValueFactory::GetStringValue("a"), pool);
+      key_pointers.push_back(key.get());
+      key_locations.push_back(ItemPointer(key_itr, copy_itr));
+      keys.push_back(std::move(key));
+    }
+  }
+
+  // an empty index is loaded in bulk
+  index->InsertEntries(key_pointers, key_locations);
+
+  index->ScanAllKeys(locations);
+  EXPECT_EQ(200UL, locations.size());
+  for (oid_t location_itr = 0; location_itr < locations.size();
+       location_itr++) {
+    EXPECT_EQ(location_itr / 2, locations[location_itr].block);
+    EXPECT_EQ(location_itr % 2, locations[location_itr].offset);
+  }
+  locations.clear();
+
+  // a populated index gets the entries inserted
+  index->InsertEntries({keys[0].get()}, {item0});
+  index->ScanKey(keys[0].get(), locations);
+  EXPECT_EQ(3UL, locations.size());
+  locations.clear();
+
+  delete tuple_schema;
+}
+
 // INSERT HELPER FUNCTION
 void InsertTest(index::Index *index, VarlenPool *pool, size_t scale_factor,
                 UNUSED_ATTRIBUTE uint64_t thread_itr) {
@@ -763,5 +806,337 @@ TEST_F(IndexTests, NonUniqueKeyMultiThreadedStressTest2) {
   delete tuple_schema;
 }
 
+//===--------------------------------------------------------------------===//
+// BWTree Tests
+//===--------------------------------------------------------------------===//
+
+TEST_F(IndexTests, BWTreeNonUniqueKeyMultiThreadedTest) {
+  auto pool = TestingHarness::GetInstance().GetTestingPool();
+  std::vector<ItemPointer> locations;
+
+  // INDEX
+  index_type = INDEX_TYPE_BWTREE;
+  std::unique_ptr<index::Index> index(BuildIndex(false));
+  index_type = INDEX_TYPE_BTREE;
+
+  // Parallel Test
+  size_t num_threads = 15;
+  size_t scale_factor = 3;
+  LaunchParallelTest(num_threads, InsertTest, index.get(), pool, scale_factor);
+  LaunchParallelTest(num_threads, DeleteTest, index.get(), pool, scale_factor);
+
+  index->ScanAllKeys(locations);
+  EXPECT_EQ(locations.size(), 3 * num_threads * scale_factor);
+  locations.clear();
+
+  std::unique_ptr<storage::Tuple> key0(new storage::Tuple(key_schema, true));
+  std::unique_ptr<storage::Tuple> key1(new storage::Tuple(key_schema, true));
+  std::unique_ptr<storage::Tuple> key2(new storage::Tuple(key_schema, true));
+
+  key0->SetValue(0, ValueFactory::GetIntegerValue(100), pool);
+  key0->SetValue(1, ValueFactory::GetStringValue("a"), pool);
+  key1->SetValue(0, ValueFactory::GetIntegerValue(100), pool);
+  key1->SetValue(1, ValueFactory::GetStringValue("b"), pool);
+  key2->SetValue(0, ValueFactory::GetIntegerValue(100), pool);
+  key2->SetValue(1, ValueFactory::GetStringValue("c"), pool);
+
+  index->ScanKey(key0.get(), locations);
+  EXPECT_EQ(locations.size(), 0);
+  locations.clear();
+
+  index->ScanKey(key1.get(), locations);
+  EXPECT_EQ(locations.size(), 2 * num_threads);
+  locations.clear();
+
+  index->ScanKey(key2.get(), locations);
+  EXPECT_EQ(locations.size(), num_threads);
+  EXPECT_EQ(locations[0].block, item1.block);
+  locations.clear();
+
+  // FORWARD SCAN
+  index->Scan({key1->GetValue(0)}, {0}, {EXPRESSION_TYPE_COMPARE_EQUAL},
+              SCAN_DIRECTION_TYPE_FORWARD, locations);
+  EXPECT_EQ(locations.size(), 3 * num_threads);
+  locations.clear();
+
+  index->Scan(
+      {key1->GetValue(0), key1->GetValue(1)}, {0, 1},
+      {EXPRESSION_TYPE_COMPARE_EQUAL, EXPRESSION_TYPE_COMPARE_GREATERTHAN},
+      SCAN_DIRECTION_TYPE_FORWARD, locations);
+  EXPECT_EQ(locations.size(), 1 * num_threads);
+  locations.clear();
+
+  delete tuple_schema;
+}
+
+// INSERT HELPER FUNCTION
+void DistinctKeyInsertTest(index::Index *index, VarlenPool *pool,
+                           size_t key_count, size_t num_threads,
+                           uint64_t thread_itr) {
+  std::unique_ptr<storage::Tuple> key(new storage::Tuple(key_schema, true));
+  key->SetValue(1, ValueFactory::GetStringValue("a"), pool);
+
+  // thread i inserts keys i, i + num_threads, i + 2 * num_threads, ...
+  for (size_t key_itr = 0; key_itr < key_count; key_itr++) {
+    auto key_value = key_itr * num_threads + thread_itr;
+    key->SetValue(0, ValueFactory::GetIntegerValue(key_value), pool);
+    index->InsertEntry(key.get(), ItemPointer(key_value, 0));
+  }
+}
+
+TEST_F(IndexTests, BWTreeSplitTest) {
+  auto pool = TestingHarness::GetInstance().GetTestingPool();
+  std::vector<ItemPointer> locations;
+
+  // INDEX
+  index_type = INDEX_TYPE_BWTREE;
+  std::unique_ptr<index::Index> index(BuildIndex(false));
+  index_type = INDEX_TYPE_BTREE;
+
+  // Enough keys to split leaf and inner nodes a few times
+  size_t num_threads = 4;
+  size_t key_count = 10000;
+  LaunchParallelTest(num_threads, DistinctKeyInsertTest, index.get(), pool,
+                     key_count, num_threads);
+
+  // at least every entry is accounted for
+  EXPECT_GT(index->GetMemoryFootprint(),
+            num_threads * key_count * sizeof(ItemPointer));
+
+  index->ScanAllKeys(locations);
+  EXPECT_EQ(locations.size(), num_threads * key_count);
+  for (size_t location_itr = 1; location_itr < locations.size();
+       location_itr++) {
+    EXPECT_LT(locations[location_itr - 1].block,
+              locations[location_itr].block);
+  }
+  locations.clear();
+
+  std::unique_ptr<storage::Tuple> key(new storage::Tuple(key_schema, true));
+  key->SetValue(0, ValueFactory::GetIntegerValue(12345), pool);
+  key->SetValue(1, ValueFactory::GetStringValue("a"), pool);
+
+  index->ScanKey(key.get(), locations);
+  EXPECT_EQ(locations.size(), 1);
+  EXPECT_EQ(locations[0].block, 12345);
+  locations.clear();
+
+  // RANGE SCAN : [1000, 2000)
+  index->Scan({ValueFactory::GetIntegerValue(1000),
+               ValueFactory::GetIntegerValue(2000)},
+              {0, 0}, {EXPRESSION_TYPE_COMPARE_GREATERTHANOREQUALTO,
+                       EXPRESSION_TYPE_COMPARE_LESSTHAN},
+              SCAN_DIRECTION_TYPE_FORWARD, locations);
+  EXPECT_EQ(locations.size(), 1000);
+  locations.clear();
+
+  // DELETE
+  index->DeleteEntry(key.get(), ItemPointer(12345, 0));
+  index->ScanKey(key.get(), locations);
+  EXPECT_EQ(locations.size(), 0);
+  locations.clear();
+
+  index->ScanAllKeys(locations);
+  EXPECT_EQ(locations.size(), num_threads * key_count - 1);
+  locations.clear();
+
+  delete tuple_schema;
+}
+
+//===--------------------------------------------------------------------===//
+// Hash Index Tests
+//===--------------------------------------------------------------------===//
+
+TEST_F(IndexTests, HashNonUniqueKeyMultiThreadedTest) {
+  auto pool = TestingHarness::GetInstance().GetTestingPool();
+  std::vector<ItemPointer> locations;
+
+  // INDEX
+  index_type = INDEX_TYPE_HASH;
+  std::unique_ptr<index::Index> index(BuildIndex(false));
+  index_type = INDEX_TYPE_BTREE;
+
+  // Parallel Test
+  size_t num_threads = 15;
+  size_t scale_factor = 3;
+  LaunchParallelTest(num_threads, InsertTest, index.get(), pool, scale_factor);
+  LaunchParallelTest(num_threads, DeleteTest, index.get(), pool, scale_factor);
+
+  index->ScanAllKeys(locations);
+  EXPECT_EQ(locations.size(), 3 * num_threads * scale_factor);
+  locations.clear();
+
+  std::unique_ptr<storage::Tuple> key0(new storage::Tuple(key_schema, true));
+  std::unique_ptr<storage::Tuple> key1(new storage::Tuple(key_schema, true));
+  std::unique_ptr<storage::Tuple> key2(new storage::Tuple(key_schema, true));
+
+  key0->SetValue(0, ValueFactory::GetIntegerValue(100), pool);
+  key0->SetValue(1, ValueFactory::GetStringValue("a"), pool);
+  key1->SetValue(0, ValueFactory::GetIntegerValue(100), pool);
+  key1->SetValue(1, ValueFactory::GetStringValue("b"), pool);
+  key2->SetValue(0, ValueFactory::GetIntegerValue(100), pool);
+  key2->SetValue(1, ValueFactory::GetStringValue("c"), pool);
+
+  index->ScanKey(key0.get(), locations);
+  EXPECT_EQ(locations.size(), 0);
+  locations.clear();
+
+  index->ScanKey(key1.get(), locations);
+  EXPECT_EQ(locations.size(), 2 * num_threads);
+  locations.clear();
+
+  index->ScanKey(key2.get(), locations);
+  EXPECT_EQ(locations.size(), num_threads);
+  EXPECT_EQ(locations[0].block, item1.block);
+  locations.clear();
+
+  // EQUALITY SCAN
+  index->Scan({key1->GetValue(0), key1->GetValue(1)}, {0, 1},
+              {EXPRESSION_TYPE_COMPARE_EQUAL, EXPRESSION_TYPE_COMPARE_EQUAL},
+              SCAN_DIRECTION_TYPE_FORWARD, locations);
+  EXPECT_EQ(locations.size(), 2 * num_threads);
+  locations.clear();
+
+  // A lookup needs an equality predicate on every key column
+  EXPECT_TRUE(index->SupportsScan(
+      {0, 1}, {EXPRESSION_TYPE_COMPARE_EQUAL, EXPRESSION_TYPE_COMPARE_EQUAL}));
+  EXPECT_FALSE(index->SupportsScan({0}, {EXPRESSION_TYPE_COMPARE_EQUAL}));
+  EXPECT_FALSE(index->SupportsScan(
+      {0, 1},
+      {EXPRESSION_TYPE_COMPARE_EQUAL, EXPRESSION_TYPE_COMPARE_GREATERTHAN}));
+
+  // Other scans filter every entry
+  index->Scan({key1->GetValue(0)}, {0}, {EXPRESSION_TYPE_COMPARE_EQUAL},
+              SCAN_DIRECTION_TYPE_FORWARD, locations);
+  EXPECT_EQ(locations.size(), 3 * num_threads);
+  locations.clear();
+
+  index->Scan(
+      {key1->GetValue(0), key1->GetValue(1)}, {0, 1},
+      {EXPRESSION_TYPE_COMPARE_EQUAL, EXPRESSION_TYPE_COMPARE_GREATERTHAN},
+      SCAN_DIRECTION_TYPE_FORWARD, locations);
+  EXPECT_EQ(locations.size(), num_threads);
+  locations.clear();
+
+  // CONDITIONAL INSERT
+  auto predicate = [](const ItemPointer &) { return true; };
+  EXPECT_FALSE(index->CondInsertEntry(key1.get(), item2, predicate));
+  EXPECT_TRUE(index->CondInsertEntry(key0.get(), item2, predicate));
+  EXPECT_FALSE(index->CondInsertEntry(key0.get(), item2, predicate));
+
+  index->ScanKey(key0.get(), locations);
+  EXPECT_EQ(locations.size(), 1);
+  locations.clear();
+
+  delete tuple_schema;
+}
+
+// Insert and delete locations of the same key
+void HashInsertDeleteTest(index::Index *index, VarlenPool *pool,
+                          uint64_t thread_itr) {
+  std::unique_ptr<storage::Tuple> key0(new storage::Tuple(key_schema, true));
+  key0->SetValue(0, ValueFactory::GetIntegerValue(100), pool);
+  key0->SetValue(1, ValueFactory::GetStringValue("a"), pool);
+
+  for (oid_t offset = 0; offset < 100; offset++) {
+    index->InsertEntry(key0.get(), ItemPointer(thread_itr, offset));
+    index->DeleteEntry(key0.get(), ItemPointer(thread_itr, offset));
+  }
+}
+
+TEST_F(IndexTests, HashDeleteLastLocationTest) {
+  auto pool = TestingHarness::GetInstance().GetTestingPool();
+  std::vector<ItemPointer> locations;
+
+  // INDEX
+  index_type = INDEX_TYPE_HASH;
+  std::unique_ptr<index::Index> index(BuildIndex(false));
+  index_type = INDEX_TYPE_BTREE;
+
+  std::unique_ptr<storage::Tuple> key0(new storage::Tuple(key_schema, true));
+  key0->SetValue(0, ValueFactory::GetIntegerValue(100), pool);
+  key0->SetValue(1, ValueFactory::GetStringValue("a"), pool);
+
+  index->InsertEntry(key0.get(), item0);
+  index->InsertEntry(key0.get(), item1);
+  EXPECT_GT(index->GetMemoryFootprint(), 0);
+
+  // The key stays while it has a location
+  index->DeleteEntry(key0.get(), item0);
+  index->ScanKey(key0.get(), locations);
+  EXPECT_EQ(locations.size(), 1);
+  EXPECT_EQ(locations[0].offset, item1.offset);
+  locations.clear();
+  EXPECT_GT(index->GetMemoryFootprint(), 0);
+
+  // Deleting the last location erases the key
+  index->DeleteEntry(key0.get(), item1);
+  EXPECT_EQ(index->GetMemoryFootprint(), 0);
+
+  // Threads racing on the same key leave nothing behind
+  size_t num_threads = 15;
+  LaunchParallelTest(num_threads, HashInsertDeleteTest, index.get(), pool);
+  EXPECT_EQ(index->GetMemoryFootprint(), 0);
+
+  // The key can be inserted again
+  index->InsertEntry(key0.get(), item2);
+  index->ScanKey(key0.get(), locations);
+  EXPECT_EQ(locations.size(), 1);
+  EXPECT_EQ(locations[0].block, item2.block);
+  locations.clear();
+
+  delete tuple_schema;
+}
+
+TEST_F(IndexTests, IndexStorageTypeTest) {
+  auto pool = TestingHarness::GetInstance().GetTestingPool();
+  std::vector<ItemPointer> locations;
+  std::vector<ItemPointer *> location_ptrs;
+
+  std::unique_ptr<storage::Tuple> key0;
+
+  // INDIRECT : every entry points to its own location
+  index::IndexFactory::Configure(INDEX_STORAGE_TYPE_INDIRECT);
+  std::unique_ptr<index::Index> index(BuildIndex(false));
+
+  key0.reset(new storage::Tuple(key_schema, true));
+  key0->SetValue(0, ValueFactory::GetIntegerValue(100), pool);
+  key0->SetValue(1, ValueFactory::GetStringValue("a"), pool);
+
+  index->InsertEntry(key0.get(), item0);
+  index->ScanKey(key0.get(), location_ptrs);
+  EXPECT_EQ(location_ptrs.size(), 1);
+  EXPECT_EQ(location_ptrs[0]->block, item0.block);
+  EXPECT_EQ(location_ptrs[0]->offset, item0.offset);
+  location_ptrs.clear();
+
+  delete tuple_schema;
+
+  // INLINE : locations live in the leaf nodes
+  index::IndexFactory::Configure(INDEX_STORAGE_TYPE_INLINE);
+  index.reset(BuildIndex(false));
+
+  key0.reset(new storage::Tuple(key_schema, true));
+  key0->SetValue(0, ValueFactory::GetIntegerValue(100), pool);
+  key0->SetValue(1, ValueFactory::GetStringValue("a"), pool);
+
+  index->InsertEntry(key0.get(), item0);
+  index->InsertEntry(key0.get(), item1);
+  index->ScanKey(key0.get(), locations);
+  EXPECT_EQ(locations.size(), 2);
+  locations.clear();
+
+  index->DeleteEntry(key0.get(), item0);
+  index->ScanKey(key0.get(), locations);
+  EXPECT_EQ(locations.size(), 1);
+  EXPECT_EQ(locations[0].offset, item1.offset);
+  locations.clear();
+
+  // there are no stable item pointers to hand out
+  EXPECT_THROW(index->ScanKey(key0.get(), location_ptrs), IndexException);
+
+  delete tuple_schema;
+}
+
 }  // End test namespace
 }  // End peloton namespace
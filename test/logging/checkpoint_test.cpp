@@ -16,6 +16,7 @@
 #include "logging/logging_util.h"
 #include "logging/loggers/wal_backend_logger.h"
 #include "logging/checkpoint/simple_checkpoint.h"
+#include "logging/checkpoint/streaming_checkpoint.h"
 #include "logging/checkpoint_manager.h"
 #include "storage/database.h"
 
@@ -113,6 +114,80 @@ TEST_F(CheckpointTests, CheckpointIntegrationTest) {
   logging::LoggingUtil::RemoveDirectory("pl_checkpoint", false);
 }
 
+TEST_F(CheckpointTests, StreamingCheckpointTest) {
+  logging::LoggingUtil::RemoveDirectory("pl_checkpoint", false);
+  auto &txn_manager = concurrency::TransactionManagerFactory::GetInstance();
+  txn_manager.BeginTransaction();
+
+  size_t tile_group_size = TESTS_TUPLES_PER_TILEGROUP;
+  size_t table_tile_group_count = 3;
+
+  oid_t default_table_oid = 14;
+  storage::DataTable *target_table =
+      ExecutorTestsUtil::CreateTable(tile_group_size, false, default_table_oid);
+  ExecutorTestsUtil::PopulateTable(target_table,
+                                   tile_group_size * table_tile_group_count,
+                                   false, false, false);
+  txn_manager.CommitTransaction();
+
+  auto &catalog_manager = catalog::Manager::GetInstance();
+  storage::Database *db(new storage::Database(DEFAULT_DB_ID));
+  db->AddTable(target_table);
+  catalog_manager.AddDatabase(db);
+
+  // create checkpoint spread over two files
+  auto &log_manager = logging::LogManager::GetInstance();
+  log_manager.SetGlobalMaxFlushedCommitId(txn_manager.GetNextCommitId());
+  std::unique_ptr<logging::StreamingCheckpoint> checkpointer(
+      new logging::StreamingCheckpoint(false));
+  checkpointer->SetFileCount(2);
+  checkpointer->DoCheckpoint();
+  EXPECT_NE(INVALID_CID, checkpointer->GetMostRecentCheckpointCid());
+
+  // restart with an empty table
+  catalog_manager.DropDatabaseWithOid(DEFAULT_DB_ID);
+  target_table =
+      ExecutorTestsUtil::CreateTable(tile_group_size, false, default_table_oid);
+  db = new storage::Database(DEFAULT_DB_ID);
+  db->AddTable(target_table);
+  catalog_manager.AddDatabase(db);
+  auto empty_tile_group_count = target_table->GetTileGroupCount();
+  checkpointer.reset(new logging::StreamingCheckpoint(false));
+
+  // recovery from checkpoint
+  auto recovered_cid = checkpointer->DoRecovery();
+  EXPECT_NE(0UL, recovered_cid);
+  EXPECT_EQ(tile_group_size * table_tile_group_count,
+            target_table->GetNumberOfTuples());
+  EXPECT_EQ(empty_tile_group_count + table_tile_group_count,
+            target_table->GetTileGroupCount());
+
+  // the recovered tuples, including their varchar column, are intact
+  size_t tuple_count = 0;
+  for (oid_t tile_group_offset = 0;
+       tile_group_offset < target_table->GetTileGroupCount();
+       tile_group_offset++) {
+    auto tile_group = target_table->GetTileGroup(tile_group_offset);
+    auto tile_group_header = tile_group->GetHeader();
+    for (oid_t tuple_id = 0; tuple_id < tile_group->GetNextTupleSlot();
+         tuple_id++) {
+      EXPECT_EQ(recovered_cid, tile_group_header->GetBeginCommitId(tuple_id));
+      EXPECT_EQ(MAX_CID, tile_group_header->GetEndCommitId(tuple_id));
+
+      int row = ValuePeeker::PeekAsInteger(tile_group->GetValue(tuple_id, 0)) /
+                10;
+      EXPECT_EQ(0, tile_group->GetValue(tuple_id, 3).Compare(
+                       ValueFactory::GetStringValue(std::to_string(
+                           ExecutorTestsUtil::PopulatedValue(row, 3)))));
+      tuple_count++;
+    }
+  }
+  EXPECT_EQ(tile_group_size * table_tile_group_count, tuple_count);
+
+  catalog_manager.DropDatabaseWithOid(db->GetOid());
+  logging::LoggingUtil::RemoveDirectory("pl_checkpoint", false);
+}
+
 TEST_F(CheckpointTests, CheckpointScanTest) {
   logging::LoggingUtil::RemoveDirectory("pl_checkpoint", false);
 
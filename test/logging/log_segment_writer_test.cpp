@@ -0,0 +1,131 @@
+//===----------------------------------------------------------------------===//
+//
+//                         Peloton
+//
+// log_segment_writer_test.cpp
+//
+// Identification: test/logging/log_segment_writer_test.cpp
+//
+// Copyright (c) 2015-16, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+
+#include <unistd.h>
+#include <algorithm>
+#include <cstdio>
+#include <cstring>
+#include <vector>
+
+#include "common/harness.h"
+
+#include "logging/log_segment_writer.h"
+
+namespace peloton {
+namespace test {
+
+//===--------------------------------------------------------------------===//
+// Log Segment Writer Tests
+//===--------------------------------------------------------------------===//
+
+class LogSegmentWriterTests : public PelotonTest {};
+
+// Read the whole file
+static std::vector<char> ReadFile(const std::string &file_name) {
+  std::vector<char> contents;
+  FILE *file = fopen(file_name.c_str(), "rb");
+  EXPECT_TRUE(file != nullptr);
+  if (file == nullptr) return contents;
+
+  char buffer[4096];
+  size_t read_size;
+  while ((read_size = fread(buffer, 1, sizeof(buffer), file)) > 0) {
+    contents.insert(contents.end(), buffer, buffer + read_size);
+  }
+  fclose(file);
+  return contents;
+}
+
+TEST_F(LogSegmentWriterTests, WriteAndRecycleTest) {
+  std::string file_name = "log_segment_writer_test_0.log";
+  std::string recycled_file_name = "log_segment_writer_test_1.log";
+  size_t segment_size = 4 * LOG_SEGMENT_BLOCK_SIZE;
+
+  std::vector<cid_t> flushed_cids;
+  logging::LogSegmentWriter writer(
+      [&flushed_cids](cid_t commit_id, int64_t, Result status) {
+        EXPECT_EQ(Result::RESULT_SUCCESS, status);
+        flushed_cids.push_back(commit_id);
+      });
+
+  // Batches that end in the middle of a block and span several blocks
+  std::vector<char> expected;
+  EXPECT_TRUE(writer.Open(file_name, "", segment_size));
+  for (cid_t commit_id = 1; commit_id <= 3; commit_id++) {
+    std::vector<char> record(commit_id * 3000, (char)commit_id);
+    writer.Append(record.data(), record.size());
+    expected.insert(expected.end(), record.begin(), record.end());
+    writer.Submit(commit_id);
+  }
+  writer.Close(3, 3);
+
+  EXPECT_EQ(std::vector<cid_t>({1, 2, 3}), flushed_cids);
+  EXPECT_EQ(LOG_SEGMENT_HEADER_SIZE + expected.size(), writer.GetSize());
+
+  auto contents = ReadFile(file_name);
+  ASSERT_LE(segment_size, contents.size());
+  cid_t header[2];
+  memcpy(header, contents.data(), sizeof(header));
+  EXPECT_EQ(3UL, header[0]);
+  EXPECT_EQ(3UL, header[1]);
+  EXPECT_TRUE(std::equal(expected.begin(), expected.end(),
+                         contents.begin() + LOG_SEGMENT_HEADER_SIZE));
+  EXPECT_EQ(0, contents[LOG_SEGMENT_HEADER_SIZE + expected.size()]);
+
+  // A recycled segment ends right after the new data
+  EXPECT_EQ(0, rename(file_name.c_str(), recycled_file_name.c_str()));
+  EXPECT_TRUE(writer.Open(file_name, recycled_file_name, segment_size));
+  std::vector<char> record(100, 'x');
+  writer.Append(record.data(), record.size());
+  writer.Close(4, 4);
+
+  contents = ReadFile(file_name);
+  ASSERT_LE(segment_size, contents.size());
+  memcpy(header, contents.data(), sizeof(header));
+  EXPECT_EQ(4UL, header[0]);
+  EXPECT_TRUE(std::equal(record.begin(), record.end(),
+                         contents.begin() + LOG_SEGMENT_HEADER_SIZE));
+  EXPECT_EQ(0, contents[LOG_SEGMENT_HEADER_SIZE + record.size()]);
+  EXPECT_EQ(nullptr, fopen(recycled_file_name.c_str(), "rb"));
+
+  remove(file_name.c_str());
+}
+
+TEST_F(LogSegmentWriterTests, WriteFailureTest) {
+  // Every write to /dev/full fails with ENOSPC
+  if (access("/dev/full", W_OK) != 0) {
+    return;
+  }
+
+  std::vector<std::pair<cid_t, Result>> flushed_batches;
+  logging::LogSegmentWriter writer(
+      [&flushed_batches](cid_t commit_id, int64_t, Result status) {
+        flushed_batches.emplace_back(commit_id, status);
+      });
+
+  EXPECT_TRUE(writer.Open("/dev/full", "", LOG_SEGMENT_BLOCK_SIZE));
+  std::vector<char> record(100, 'x');
+  writer.Append(record.data(), record.size());
+  writer.Submit(1);
+  writer.Drain();
+
+  // The failed batch is still reported
+  ASSERT_EQ(1, flushed_batches.size());
+  EXPECT_EQ(1UL, flushed_batches[0].first);
+  EXPECT_EQ(Result::RESULT_FAILURE, flushed_batches[0].second);
+
+  writer.Close(1, 1);
+}
+
+}  // End test namespace
+}  // End peloton namespace
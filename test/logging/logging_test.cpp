@@ -11,6 +11,9 @@
 //===----------------------------------------------------------------------===//
 
 
+#include <atomic>
+#include <thread>
+
 #include "common/harness.h"
 
 #include "concurrency/transaction_manager_factory.h"
@@ -374,5 +377,108 @@ TEST_F(LoggingTests, BasicLogManagerTest) {
   log_manager.EndLogging();
 }
 
+TEST_F(LoggingTests, GroupCommitFlushNotifyTest) {
+  auto &log_manager = logging::LogManager::GetInstance();
+  log_manager.DropFrontendLoggers();
+  log_manager.Configure(LOGGING_TYPE_NVM_WAL, true);
+  log_manager.SetGroupCommit(true);
+  log_manager.InitFrontendLoggers();
+
+  auto frontend_logger = log_manager.GetFrontendLogger(0);
+  EXPECT_TRUE(frontend_logger->IsGroupCommit());
+  frontend_logger->SetMaxFlushedCommitId(1);
+
+  // Each waiter returns once its own commit is durable
+  std::atomic<int> done_count(0);
+  std::vector<std::thread> waiters;
+  for (cid_t commit_id = 2; commit_id <= 5; commit_id++) {
+    waiters.push_back(std::thread([&log_manager, &done_count, commit_id] {
+      log_manager.WaitForFlush(commit_id);
+      done_count++;
+    }));
+  }
+
+  frontend_logger->SetMaxFlushedCommitId(3);
+  log_manager.FrontendLoggerFlushed();
+  frontend_logger->SetMaxFlushedCommitId(5);
+  log_manager.FrontendLoggerFlushed();
+
+  for (auto &waiter : waiters) {
+    waiter.join();
+  }
+  EXPECT_EQ(4, done_count);
+
+  // A durable commit does not wait at all
+  log_manager.WaitForFlush(4);
+
+  log_manager.SetGroupCommit(false);
+  log_manager.DropFrontendLoggers();
+}
+
+TEST_F(LoggingTests, LogStreamsTest) {
+  auto &log_manager = logging::LogManager::GetInstance();
+  log_manager.DropFrontendLoggers();
+  log_manager.ConfigureLogStreams(LOGGING_TYPE_NVM_WAL, true, 4);
+  log_manager.InitFrontendLoggers();
+  EXPECT_TRUE(log_manager.HasLogStreams());
+  EXPECT_EQ(4UL, log_manager.GetFrontendLoggersList().size());
+
+  // Every worker logs to the stream of its core
+  int frontend_logger_id = -1;
+  std::thread worker([&log_manager, &frontend_logger_id] {
+    frontend_logger_id = log_manager.GetBackendLogger()->GetFrontendLoggerID();
+  });
+  worker.join();
+  EXPECT_LE(0, frontend_logger_id);
+  EXPECT_GT(4, frontend_logger_id);
+
+  // Any stream raises the global max flushed commit id to the minimum over
+  // all the streams
+  auto &frontend_loggers = log_manager.GetFrontendLoggersList();
+  log_manager.SetGlobalMaxFlushedCommitId(0);
+  std::vector<cid_t> flushed_commit_ids({5, 3, 7, 4});
+  for (size_t stream_itr = 0; stream_itr < 4; stream_itr++) {
+    frontend_loggers[stream_itr]->SetMaxFlushedCommitId(
+        flushed_commit_ids[stream_itr]);
+  }
+  frontend_loggers[2]->UpdateGlobalMaxFlushId();
+  EXPECT_EQ(3UL, log_manager.GetGlobalMaxFlushedCommitId());
+
+  frontend_loggers[1]->SetMaxFlushedCommitId(6);
+  frontend_loggers[0]->UpdateGlobalMaxFlushId();
+  EXPECT_EQ(4UL, log_manager.GetGlobalMaxFlushedCommitId());
+
+  // a stream that falls behind never moves it back
+  frontend_loggers[3]->SetMaxFlushedCommitId(2);
+  frontend_loggers[3]->UpdateGlobalMaxFlushId();
+  EXPECT_EQ(4UL, log_manager.GetGlobalMaxFlushedCommitId());
+  log_manager.SetGlobalMaxFlushedCommitId(0);
+
+  log_manager.DropFrontendLoggers();
+  log_manager.Configure(peloton_logging_mode, false);
+  EXPECT_FALSE(log_manager.HasLogStreams());
+}
+
+TEST_F(LoggingTests, CommitLatencyMetricsTest) {
+  auto &log_manager = logging::LogManager::GetInstance();
+  log_manager.ResetCommitMetrics();
+  EXPECT_EQ(0UL, log_manager.GetCommitLatencyPercentile(99));
+
+  for (int i = 0; i < 98; i++) {
+    log_manager.RecordCommitLatency(100);
+  }
+  log_manager.RecordCommitLatency(3000);
+  log_manager.RecordCommitLatency(5000);
+
+  EXPECT_EQ(128UL, log_manager.GetCommitLatencyPercentile(50));
+  EXPECT_EQ(128UL, log_manager.GetCommitLatencyPercentile(98));
+  EXPECT_EQ(4096UL, log_manager.GetCommitLatencyPercentile(99));
+  EXPECT_EQ(8192UL, log_manager.GetCommitLatencyPercentile(100));
+  EXPECT_LE(0, log_manager.GetFsyncRate());
+
+  log_manager.ResetCommitMetrics();
+  EXPECT_EQ(0UL, log_manager.GetCommitLatencyPercentile(99));
+}
+
 }  // End test namespace
 }  // End peloton namespace
@@ -17,6 +17,7 @@
 #include <dirent.h>
 
 #include "common/harness.h"
+#include "common/value_peeker.h"
 
 #include "concurrency/transaction_manager_factory.h"
 #include "executor/logical_tile_factory.h"
@@ -98,6 +99,245 @@ std::vector<storage::Tuple *> BuildLoggingTuples(storage::DataTable *table,
   return tuples;
 }
 
+// Write one committed transaction with its tuple records into the log file
+void WriteLoggedTransaction(FILE *fp, cid_t commit_id,
+                            std::vector<logging::TupleRecord> &records) {
+  CopySerializeOutput output_buffer_begin;
+  logging::TransactionRecord record_begin(LOGRECORD_TYPE_TRANSACTION_BEGIN,
+                                          commit_id);
+  record_begin.Serialize(output_buffer_begin);
+  fwrite(record_begin.GetMessage(), sizeof(char),
+         record_begin.GetMessageLength(), fp);
+
+  for (auto &record : records) {
+    CopySerializeOutput output_buffer;
+    record.Serialize(output_buffer);
+    fwrite(record.GetMessage(), sizeof(char), record.GetMessageLength(), fp);
+  }
+
+  CopySerializeOutput output_buffer_commit;
+  logging::TransactionRecord record_commit(LOGRECORD_TYPE_TRANSACTION_COMMIT,
+                                           commit_id);
+  record_commit.Serialize(output_buffer_commit);
+  fwrite(record_commit.GetMessage(), sizeof(char),
+         record_commit.GetMessageLength(), fp);
+
+  CopySerializeOutput output_buffer_delim;
+  logging::TransactionRecord record_delim(LOGRECORD_TYPE_ITERATION_DELIMITER,
+                                          commit_id);
+  record_delim.Serialize(output_buffer_delim);
+  fwrite(record_delim.GetMessage(), sizeof(char),
+         record_delim.GetMessageLength(), fp);
+}
+
+// Runs before the other tests, which leave their databases in the catalog
+TEST_F(RecoveryTests, ParallelReplayTest) {
+  auto recovery_table = ExecutorTestsUtil::CreateTable(1024);
+  auto &manager = catalog::Manager::GetInstance();
+  auto &txn_manager = concurrency::TransactionManagerFactory::GetInstance();
+  auto testing_pool = TestingHarness::GetInstance().GetTestingPool();
+
+  auto db = new storage::Database(DEFAULT_DB_ID);
+  manager.AddDatabase(db);
+  db->AddTable(recovery_table);
+
+  // Every tile group is replayed by its own worker
+  const size_t recovery_thread_count = 4;
+  const oid_t first_block = 600;
+  const int num_rows = 16;
+  const cid_t insert_cid = 10, update_cid = 11, delete_cid = 12,
+              second_update_cid = 13;
+  cid_t default_commit_id = INVALID_CID;
+  cid_t default_delimiter = INVALID_CID;
+  std::string dir_name = logging::WriteAheadFrontendLogger::wal_directory_path;
+  auto table_oid = recovery_table->GetOid();
+
+  auto tuples =
+      LoggingTestsUtil::BuildTuples(recovery_table, num_rows, false, false);
+  auto updated_tuples =
+      LoggingTestsUtil::BuildTuples(recovery_table, num_rows, false, false);
+  for (int rowid = 0; rowid < num_rows; rowid++) {
+    updated_tuples[rowid]->SetValue(
+        1, ValueFactory::GetIntegerValue(
+               ExecutorTestsUtil::PopulatedValue(rowid, 1) + update_cid),
+        testing_pool);
+  }
+  auto second_updated_tuple =
+      LoggingTestsUtil::BuildTuples(recovery_table, 1, false, false)[0];
+  second_updated_tuple->SetValue(
+      1, ValueFactory::GetIntegerValue(
+             ExecutorTestsUtil::PopulatedValue(0, 1) + second_update_cid),
+      testing_pool);
+
+  // The rows are spread over the tile groups, the expected location of the
+  // latest version of every row is kept next to them
+  std::vector<ItemPointer> locations;
+  std::vector<logging::TupleRecord> insert_records;
+  for (int rowid = 0; rowid < num_rows; rowid++) {
+    ItemPointer location(first_block + rowid % recovery_thread_count,
+                         rowid / recovery_thread_count);
+    logging::TupleRecord record(LOGRECORD_TYPE_WAL_TUPLE_INSERT, insert_cid,
+                                table_oid, location, INVALID_ITEMPOINTER,
+                                tuples[rowid].get(), DEFAULT_DB_ID);
+    record.SetTuple(tuples[rowid].get());
+    insert_records.push_back(record);
+    locations.push_back(location);
+  }
+
+  // The first row of every tile group is moved to the next tile group
+  std::vector<ItemPointer> first_versions;
+  std::vector<logging::TupleRecord> update_records;
+  for (int rowid = 0; rowid < (int)recovery_thread_count; rowid++) {
+    ItemPointer new_location(
+        first_block + (rowid + 1) % recovery_thread_count,
+        num_rows / recovery_thread_count);
+    logging::TupleRecord record(LOGRECORD_TYPE_WAL_TUPLE_UPDATE, update_cid,
+                                table_oid, new_location, locations[rowid],
+                                updated_tuples[rowid].get(), DEFAULT_DB_ID);
+    record.SetTuple(updated_tuples[rowid].get());
+    update_records.push_back(record);
+    first_versions.push_back(locations[rowid]);
+    locations[rowid] = new_location;
+  }
+
+  // Delete two rows in place and one of the new versions
+  std::vector<int> deleted_rows = {1, 4, 9};
+  std::vector<logging::TupleRecord> delete_records;
+  for (auto rowid : deleted_rows) {
+    delete_records.emplace_back(LOGRECORD_TYPE_WAL_TUPLE_DELETE, delete_cid,
+                                table_oid, INVALID_ITEMPOINTER,
+                                locations[rowid], nullptr, DEFAULT_DB_ID);
+  }
+
+  // Move the first row again, its old version is written by the first update
+  ItemPointer second_location(first_block + recovery_thread_count - 1,
+                              num_rows / recovery_thread_count + 1);
+  std::vector<logging::TupleRecord> second_update_records;
+  second_update_records.emplace_back(
+      LOGRECORD_TYPE_WAL_TUPLE_UPDATE, second_update_cid, table_oid,
+      second_location, locations[0], second_updated_tuple.get(), DEFAULT_DB_ID);
+  second_update_records.back().SetTuple(second_updated_tuple.get());
+  auto second_version = locations[0];
+  locations[0] = second_location;
+
+  logging::LoggingUtil::RemoveDirectory(dir_name.c_str(), false);
+  auto status = logging::LoggingUtil::CreateDirectory(dir_name.c_str(), 0700);
+  EXPECT_EQ(status, true);
+  logging::LogManager::GetInstance().SetLogDirectoryName("./");
+
+  std::string file_name = dir_name + "/" + std::string("peloton_log_") +
+                          std::to_string(0) + std::string(".log");
+  FILE *fp = fopen(file_name.c_str(), "wb");
+  fwrite((void *)&default_commit_id, sizeof(default_commit_id), 1, fp);
+  fwrite((void *)&default_delimiter, sizeof(default_delimiter), 1, fp);
+  WriteLoggedTransaction(fp, insert_cid, insert_records);
+  WriteLoggedTransaction(fp, update_cid, update_records);
+  WriteLoggedTransaction(fp, delete_cid, delete_records);
+  WriteLoggedTransaction(fp, second_update_cid, second_update_records);
+  fclose(fp);
+
+  logging::WriteAheadFrontendLogger wal_fel;
+  wal_fel.SetRecoveryThreadCount(recovery_thread_count);
+
+  auto &log_manager = logging::LogManager::GetInstance();
+  log_manager.SetGlobalMaxFlushedIdForRecovery(second_update_cid);
+
+  wal_fel.DoRecovery();
+
+  EXPECT_EQ(recovery_table->GetNumberOfTuples(),
+            num_rows - deleted_rows.size());
+  for (oid_t block = first_block; block < first_block + recovery_thread_count;
+       block++) {
+    EXPECT_NE(manager.GetTileGroup(block), nullptr);
+  }
+
+  // The old versions end where the update committed and point to the new ones
+  for (int rowid = 0; rowid < (int)recovery_thread_count; rowid++) {
+    auto tile_group = manager.GetTileGroup(first_versions[rowid].block);
+    auto tile_group_header = tile_group->GetHeader();
+    auto tuple_id = first_versions[rowid].offset;
+    EXPECT_EQ(tile_group_header->GetBeginCommitId(tuple_id), update_cid);
+    EXPECT_EQ(tile_group_header->GetEndCommitId(tuple_id), update_cid);
+    EXPECT_EQ(tile_group_header->GetTransactionId(tuple_id), INVALID_TXN_ID);
+  }
+  auto first_update_header =
+      manager.GetTileGroup(first_versions[0].block)->GetHeader();
+  auto first_next_location =
+      first_update_header->GetNextItemPointer(first_versions[0].offset);
+  EXPECT_EQ(first_next_location.block, second_version.block);
+  EXPECT_EQ(first_next_location.offset, second_version.offset);
+  auto second_version_header =
+      manager.GetTileGroup(second_version.block)->GetHeader();
+  EXPECT_EQ(second_version_header->GetEndCommitId(second_version.offset),
+            second_update_cid);
+  auto second_next_location =
+      second_version_header->GetNextItemPointer(second_version.offset);
+  EXPECT_EQ(second_next_location.block, second_location.block);
+  EXPECT_EQ(second_next_location.offset, second_location.offset);
+
+  // The latest version of every row that is still there is visible
+  for (int rowid = 0; rowid < num_rows; rowid++) {
+    auto tile_group = manager.GetTileGroup(locations[rowid].block);
+    auto tile_group_header = tile_group->GetHeader();
+    auto tuple_id = locations[rowid].offset;
+    if (std::find(deleted_rows.begin(), deleted_rows.end(), rowid) !=
+        deleted_rows.end()) {
+      EXPECT_EQ(tile_group_header->GetTransactionId(tuple_id), INVALID_TXN_ID);
+      EXPECT_EQ(tile_group_header->GetEndCommitId(tuple_id), delete_cid);
+      continue;
+    }
+
+    cid_t expected_cid = insert_cid;
+    if (rowid == 0) {
+      expected_cid = second_update_cid;
+    } else if (rowid < (int)recovery_thread_count) {
+      expected_cid = update_cid;
+    }
+    EXPECT_EQ(tile_group_header->GetTransactionId(tuple_id), INITIAL_TXN_ID);
+    EXPECT_EQ(tile_group_header->GetBeginCommitId(tuple_id), expected_cid);
+    EXPECT_EQ(tile_group_header->GetEndCommitId(tuple_id), MAX_CID);
+
+    int expected_value = ExecutorTestsUtil::PopulatedValue(rowid, 1);
+    if (expected_cid != insert_cid) expected_value += expected_cid;
+    EXPECT_EQ(ExecutorTestsUtil::PopulatedValue(rowid, 0),
+              ValuePeeker::PeekAsInteger(tile_group->GetValue(tuple_id, 0)));
+    EXPECT_EQ(expected_value,
+              ValuePeeker::PeekAsInteger(tile_group->GetValue(tuple_id, 1)));
+  }
+
+  // The rebuilt indexes find the latest versions only
+  txn_manager.SetNextCid(second_update_cid + 1);
+  wal_fel.RecoverIndex();
+
+  int index_count = recovery_table->GetIndexCount();
+  for (int index_itr = index_count - 1; index_itr >= 0; --index_itr) {
+    auto index = recovery_table->GetIndex(index_itr);
+    EXPECT_EQ(index->GetNumberOfTuples(), num_rows - deleted_rows.size());
+  }
+
+  auto primary_index = recovery_table->GetIndex(0);
+  for (int rowid = 0; rowid < num_rows; rowid++) {
+    storage::Tuple key(primary_index->GetKeySchema(), true);
+    key.SetValue(0, ValueFactory::GetIntegerValue(
+                        ExecutorTestsUtil::PopulatedValue(rowid, 0)),
+                 testing_pool);
+    std::vector<ItemPointer> index_locations;
+    primary_index->ScanKey(&key, index_locations);
+    if (std::find(deleted_rows.begin(), deleted_rows.end(), rowid) !=
+        deleted_rows.end()) {
+      EXPECT_EQ(index_locations.size(), 0);
+      continue;
+    }
+    ASSERT_EQ(index_locations.size(), 1);
+    EXPECT_EQ(index_locations[0].block, locations[rowid].block);
+    EXPECT_EQ(index_locations[0].offset, locations[rowid].offset);
+  }
+
+  manager.DropDatabaseWithOid(DEFAULT_DB_ID);
+  status = logging::LoggingUtil::RemoveDirectory(dir_name.c_str(), false);
+  EXPECT_EQ(status, true);
+}
+
 TEST_F(RecoveryTests, RestartTest) {
   auto recovery_table = ExecutorTestsUtil::CreateTable(1024);
   auto &manager = catalog::Manager::GetInstance();
@@ -421,5 +661,102 @@ TEST_F(RecoveryTests, OutOfOrderCommitTest) {
   EXPECT_EQ(recovery_table->GetTileGroupCount(), 2);
 }
 
+TEST_F(RecoveryTests, MergedLogStreamsTest) {
+  auto recovery_table = ExecutorTestsUtil::CreateTable(1024);
+  auto &manager = catalog::Manager::GetInstance();
+  storage::Database db(DEFAULT_DB_ID);
+  manager.AddDatabase(&db);
+  db.AddTable(recovery_table);
+
+  auto tuples = BuildLoggingTuples(recovery_table, 2, false, false);
+  EXPECT_EQ(tuples.size(), 2);
+  logging::WriteAheadFrontendLogger fel(true);
+  cid_t test_commit_id = 10;
+
+  // The insert and the update of a tuple were logged to different streams,
+  // the stream of the update was read first
+  std::vector<logging::RecoveredTransaction> transactions;
+  auto update_rec = new logging::TupleRecord(
+      LOGRECORD_TYPE_WAL_TUPLE_UPDATE, test_commit_id + 1,
+      recovery_table->GetOid(), ItemPointer(100, 6), ItemPointer(100, 5),
+      tuples[1], DEFAULT_DB_ID);
+  update_rec->SetTuple(tuples[1]);
+  transactions.emplace_back(test_commit_id + 1,
+                            std::vector<logging::TupleRecord *>({update_rec}));
+
+  auto insert_rec = new logging::TupleRecord(
+      LOGRECORD_TYPE_WAL_TUPLE_INSERT, test_commit_id,
+      recovery_table->GetOid(), ItemPointer(100, 5), INVALID_ITEMPOINTER,
+      tuples[0], DEFAULT_DB_ID);
+  insert_rec->SetTuple(tuples[0]);
+  transactions.emplace_back(test_commit_id,
+                            std::vector<logging::TupleRecord *>({insert_rec}));
+
+  fel.ReplayRecoveredTransactions(transactions);
+  EXPECT_TRUE(transactions.empty());
+
+  auto tg_header = recovery_table->GetTileGroupById(100)->GetHeader();
+  EXPECT_EQ(tg_header->GetEndCommitId(5), test_commit_id + 1);
+  EXPECT_EQ(tg_header->GetEndCommitId(6), MAX_CID);
+  EXPECT_EQ(recovery_table->GetNumberOfTuples(), 1);
+}
+
+TEST_F(RecoveryTests, InterleavedLogStreamsTest) {
+  auto recovery_table = ExecutorTestsUtil::CreateTable(1024);
+  auto &manager = catalog::Manager::GetInstance();
+  storage::Database db(DEFAULT_DB_ID);
+  manager.AddDatabase(&db);
+  db.AddTable(recovery_table);
+
+  auto tuples = BuildLoggingTuples(recovery_table, 3, false, false);
+  EXPECT_EQ(tuples.size(), 3);
+  auto &log_manager = logging::LogManager::GetInstance();
+
+  // Two streams whose commits interleave : the first one logged the insert
+  // and the second update of a tuple, the second one its first update
+  logging::WriteAheadFrontendLogger first_stream(true);
+  logging::WriteAheadFrontendLogger second_stream(true);
+  first_stream.SetMergedRecovery(true);
+  second_stream.SetMergedRecovery(true);
+  cid_t test_commit_id = 10;
+
+  auto recover_record = [&](logging::WriteAheadFrontendLogger &stream,
+                            LogRecordType type, cid_t commit_id,
+                            ItemPointer insert_location,
+                            ItemPointer delete_location,
+                            storage::Tuple *tuple) {
+    auto record = new logging::TupleRecord(type, commit_id,
+                                           recovery_table->GetOid(),
+                                           insert_location, delete_location,
+                                           tuple, DEFAULT_DB_ID);
+    record->SetTuple(tuple);
+    stream.StartTransactionRecovery(commit_id);
+    stream.AddTupleRecordRecovery(record);
+    stream.CommitTransactionRecovery(commit_id);
+  };
+
+  // The streams are read one after the other, the second one first
+  recover_record(second_stream, LOGRECORD_TYPE_WAL_TUPLE_UPDATE,
+                 test_commit_id + 1, ItemPointer(100, 6), ItemPointer(100, 5),
+                 tuples[1]);
+  recover_record(first_stream, LOGRECORD_TYPE_WAL_TUPLE_INSERT,
+                 test_commit_id, ItemPointer(100, 5), INVALID_ITEMPOINTER,
+                 tuples[0]);
+  recover_record(first_stream, LOGRECORD_TYPE_WAL_TUPLE_UPDATE,
+                 test_commit_id + 2, ItemPointer(100, 7), ItemPointer(100, 6),
+                 tuples[2]);
+
+  // Nothing is replayed before all the streams are read
+  EXPECT_EQ(recovery_table->GetNumberOfTuples(), 0);
+
+  log_manager.ReplayRecoveredTransactions(&first_stream);
+
+  auto tg_header = recovery_table->GetTileGroupById(100)->GetHeader();
+  EXPECT_EQ(tg_header->GetEndCommitId(5), test_commit_id + 1);
+  EXPECT_EQ(tg_header->GetEndCommitId(6), test_commit_id + 2);
+  EXPECT_EQ(tg_header->GetEndCommitId(7), MAX_CID);
+  EXPECT_EQ(recovery_table->GetNumberOfTuples(), 1);
+}
+
 }  // End test namespace
 }  // End peloton namespace
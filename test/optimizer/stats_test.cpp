@@ -0,0 +1,170 @@
+//===----------------------------------------------------------------------===//
+//
+//                         Peloton
+//
+// stats_test.cpp
+//
+// Identification: test/optimizer/stats_test.cpp
+//
+// Copyright (c) 2015-16, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+
+#include "common/harness.h"
+
+#include "common/value_factory.h"
+#include "executor/executor_tests_util.h"
+#include "optimizer/column_stats.h"
+#include "optimizer/cost_model.h"
+#include "optimizer/operators.h"
+#include "optimizer/table_stats.h"
+#include "storage/data_table.h"
+
+namespace peloton {
+namespace test {
+
+//===--------------------------------------------------------------------===//
+// Stats Tests
+//===--------------------------------------------------------------------===//
+
+using namespace optimizer;
+
+class StatsTests : public PelotonTest {};
+
+TEST_F(StatsTests, ColumnStatsTest) {
+  const int value_count = 10000;
+  const int distinct_count = 1000;
+  const int null_count = 100;
+
+  ColumnStats column_stats(VALUE_TYPE_INTEGER);
+  for (int value_itr = 0; value_itr < value_count; value_itr++) {
+    column_stats.AddValue(
+        ValueFactory::GetIntegerValue(value_itr % distinct_count));
+  }
+  for (int value_itr = 0; value_itr < null_count; value_itr++) {
+    column_stats.AddValue(ValueFactory::GetNullValueByType(VALUE_TYPE_INTEGER));
+  }
+  column_stats.Finalize();
+
+  EXPECT_EQ(value_count + null_count, column_stats.GetValueCount());
+  EXPECT_NEAR(static_cast<double>(null_count) / (value_count + null_count),
+              column_stats.GetNullFraction(), 0.0001);
+
+  // the sketch is accurate to a few percent
+  EXPECT_NEAR(distinct_count, column_stats.GetDistinctCount(),
+              0.1 * distinct_count);
+
+  EXPECT_TRUE(column_stats.HasHistogram());
+  EXPECT_NEAR(0.5, column_stats.GetLessThanFraction(500, false), 0.05);
+  EXPECT_EQ(0, column_stats.GetLessThanFraction(-1, true));
+  EXPECT_EQ(1, column_stats.GetLessThanFraction(distinct_count, false));
+
+  auto constant = ValueFactory::GetIntegerValue(250);
+  EXPECT_NEAR(0.25, column_stats.EstimateSelectivity(
+                        EXPRESSION_TYPE_COMPARE_LESSTHAN, constant),
+              0.05);
+  EXPECT_NEAR(0.75, column_stats.EstimateSelectivity(
+                        EXPRESSION_TYPE_COMPARE_GREATERTHANOREQUALTO, constant),
+              0.05);
+  EXPECT_NEAR(1.0 / distinct_count,
+              column_stats.EstimateSelectivity(EXPRESSION_TYPE_COMPARE_EQUAL,
+                                               constant),
+              0.2 / distinct_count);
+  EXPECT_EQ(0, column_stats.EstimateSelectivity(
+                   EXPRESSION_TYPE_COMPARE_EQUAL,
+                   ValueFactory::GetNullValueByType(VALUE_TYPE_INTEGER)));
+}
+
+TEST_F(StatsTests, AnalyzeTableTest) {
+  std::unique_ptr<storage::DataTable> table(
+      ExecutorTestsUtil::CreateAndPopulateTable());
+  const double row_count = TESTS_TUPLES_PER_TILEGROUP * DEFAULT_TILEGROUP_COUNT;
+
+  auto &stats_manager = StatsManager::GetInstance();
+  EXPECT_EQ(nullptr, stats_manager.GetTableStats(table->GetOid()));
+
+  auto table_stats = stats_manager.GetTableStats(table.get());
+  EXPECT_EQ(row_count, table_stats->GetRowCount());
+  EXPECT_EQ(table_stats, stats_manager.GetTableStats(table->GetOid()));
+
+  // the first column holds distinct values
+  auto column_stats = table_stats->GetColumnStats(0);
+  EXPECT_NE(nullptr, column_stats);
+  EXPECT_NEAR(row_count, column_stats->GetDistinctCount(), 1);
+  EXPECT_EQ(0, column_stats->GetNullFraction());
+
+  EXPECT_EQ(nullptr, table_stats->GetColumnStats(100));
+
+  stats_manager.DropTableStats(table->GetOid());
+  EXPECT_EQ(nullptr, stats_manager.GetTableStats(table->GetOid()));
+}
+
+TEST_F(StatsTests, ConcurrentAnalyzeTest) {
+  std::unique_ptr<storage::DataTable> table(
+      ExecutorTestsUtil::CreateAndPopulateTable());
+  auto &stats_manager = StatsManager::GetInstance();
+
+  // planners racing on a table without stats share a single analyze
+  const size_t num_threads = 8;
+  std::vector<std::shared_ptr<TableStats>> thread_stats(num_threads);
+  LaunchParallelTest(num_threads, [&](uint64_t thread_itr) {
+    thread_stats[thread_itr] = stats_manager.GetTableStats(table.get());
+  });
+
+  for (auto &stats : thread_stats) {
+    EXPECT_EQ(thread_stats[0], stats);
+  }
+  EXPECT_EQ(thread_stats[0], stats_manager.GetTableStats(table->GetOid()));
+
+  stats_manager.DropTableStats(table->GetOid());
+}
+
+TEST_F(StatsTests, JoinCostTest) {
+  // an equi-join predicate between two columns with 1000 distinct values
+  ColumnStats column_stats(VALUE_TYPE_INTEGER);
+  for (int value_itr = 0; value_itr < 1000; value_itr++) {
+    column_stats.AddValue(ValueFactory::GetIntegerValue(value_itr));
+  }
+  column_stats.Finalize();
+
+  std::shared_ptr<TableStats> no_table_stats;
+  auto variable_stats = std::make_shared<Stats>(1);
+  variable_stats->SetColumnStats(no_table_stats, &column_stats);
+
+  std::shared_ptr<Stats> predicate_stats;
+  double predicate_cost;
+  DeriveOperatorStatsAndCost(ExprCompare::make(EXPRESSION_TYPE_COMPARE_EQUAL),
+                             {variable_stats, variable_stats}, {0, 0},
+                             predicate_stats, predicate_cost);
+  EXPECT_NEAR(0.001, predicate_stats->GetSelectivity(), 0.0002);
+
+  auto small_input = std::make_shared<Stats>(100);
+  auto large_input = std::make_shared<Stats>(10000);
+  std::vector<double> child_costs = {100, 10000, 0};
+
+  std::shared_ptr<Stats> nl_join_stats, hash_join_stats, swapped_join_stats;
+  double nl_join_cost, hash_join_cost, swapped_join_cost;
+  DeriveOperatorStatsAndCost(PhysicalInnerNLJoin::make(),
+                             {small_input, large_input, predicate_stats},
+                             child_costs, nl_join_stats, nl_join_cost);
+  DeriveOperatorStatsAndCost(PhysicalInnerHashJoin::make(),
+                             {small_input, large_input, predicate_stats},
+                             child_costs, hash_join_stats, hash_join_cost);
+  DeriveOperatorStatsAndCost(PhysicalInnerHashJoin::make(),
+                             {large_input, small_input, predicate_stats},
+                             child_costs, swapped_join_stats,
+                             swapped_join_cost);
+
+  // both joins produce the same output
+  EXPECT_NEAR(1000, nl_join_stats->GetCardinality(), 200);
+  EXPECT_EQ(nl_join_stats->GetCardinality(), hash_join_stats->GetCardinality());
+
+  // hashing beats comparing every pair, and building the hash table on the
+  // smaller input beats building it on the larger one
+  EXPECT_LT(hash_join_cost, nl_join_cost);
+  EXPECT_LT(swapped_join_cost, hash_join_cost);
+}
+
+}  // End test namespace
+}  // End peloton namespace
@@ -11,6 +11,8 @@
 //===----------------------------------------------------------------------===//
 
 
+#include <set>
+
 #include "common/harness.h"
 
 #include "storage/data_table.h"
@@ -88,5 +90,55 @@ TEST_F(DataTableTests, GlobalTableTest) {
   data_table_test_table.release();
 }
 
+void InsertTuples(storage::DataTable *table, size_t tuple_count,
+                  std::vector<std::vector<ItemPointer>> *locations,
+                  uint64_t thread_itr) {
+  auto testing_pool = TestingHarness::GetInstance().GetTestingPool();
+  for (size_t tuple_itr = 0; tuple_itr < tuple_count; tuple_itr++) {
+    auto tuple = ExecutorTestsUtil::GetTuple(table, tuple_itr, testing_pool);
+    (*locations)[thread_itr].push_back(table->InsertTuple(tuple.get()));
+  }
+}
+
+TEST_F(DataTableTests, ParallelInsertTest) {
+  const size_t tuples_per_tilegroup = TESTS_TUPLES_PER_TILEGROUP;
+  const size_t thread_count = 4;
+  const size_t tuple_count = 2 * tuples_per_tilegroup;
+
+  std::unique_ptr<storage::DataTable> data_table(
+      ExecutorTestsUtil::CreateTable(tuples_per_tilegroup, false));
+
+  std::vector<std::vector<ItemPointer>> locations(thread_count);
+  LaunchParallelTest(thread_count, InsertTuples, data_table.get(), tuple_count,
+                     &locations);
+
+  // Every insert got its own slot
+  std::set<std::pair<oid_t, oid_t>> slots;
+  for (auto &thread_locations : locations) {
+    EXPECT_EQ(tuple_count, thread_locations.size());
+    for (auto &location : thread_locations) {
+      EXPECT_FALSE(location.IsNull());
+      oid_t tile_group_id = location.block;
+      oid_t tuple_slot_id = location.offset;
+      slots.insert(std::make_pair(tile_group_id, tuple_slot_id));
+    }
+  }
+  EXPECT_EQ(thread_count * tuple_count, slots.size());
+
+  // At most one partially filled tile group per thread, plus the empty one
+  EXPECT_LE(data_table->GetTileGroupCount(),
+            thread_count * tuple_count / tuples_per_tilegroup + thread_count +
+                1);
+
+  // Every claimed slot holds a tuple
+  size_t filled_slot_count = 0;
+  for (oid_t tile_group_itr = 0;
+       tile_group_itr < data_table->GetTileGroupCount(); tile_group_itr++) {
+    filled_slot_count +=
+        data_table->GetTileGroup(tile_group_itr)->GetNextTupleSlot();
+  }
+  EXPECT_EQ(thread_count * tuple_count, filled_slot_count);
+}
+
 }  // End test namespace
 }  // End peloton namespace
@@ -0,0 +1,66 @@
+//===----------------------------------------------------------------------===//
+//
+//                         Peloton
+//
+// marshal_test.cpp
+//
+// Identification: test/wire/marshal_test.cpp
+//
+// Copyright (c) 2015-16, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+
+#include <memory>
+#include <string>
+
+#include "common/harness.h"
+#include "common/value_factory.h"
+#include "wire/marshal.h"
+
+namespace peloton {
+namespace test {
+
+//===--------------------------------------------------------------------===//
+// Marshal Tests
+//===--------------------------------------------------------------------===//
+
+class MarshalTests : public PelotonTest {};
+
+// Check the length and the text of the next column of a DataRow message
+void ExpectColumn(wire::Packet *pkt, int len, const std::string &text) {
+  EXPECT_EQ(len, wire::PacketGetInt(pkt, 4));
+  if (len < 0) return;
+
+  std::string column(pkt->buf.begin() + pkt->ptr,
+                     pkt->buf.begin() + pkt->ptr + len);
+  EXPECT_EQ(text, column);
+  pkt->ptr += len;
+}
+
+TEST_F(MarshalTests, PacketPutValueTest) {
+  std::unique_ptr<wire::Packet> pkt(new wire::Packet());
+
+  wire::PacketPutValue(pkt,
+                       ValueFactory::GetNullValueByType(VALUE_TYPE_INTEGER));
+  wire::PacketPutValue(pkt, ValueFactory::GetBooleanValue(true));
+  wire::PacketPutValue(pkt, ValueFactory::GetBooleanValue(false));
+  wire::PacketPutValue(pkt, ValueFactory::GetIntegerValue(-42));
+  wire::PacketPutValue(pkt, ValueFactory::GetBigIntValue(1234567890123));
+  wire::PacketPutValue(pkt, ValueFactory::GetStringValue("peloton"));
+  wire::PacketPutValue(pkt, ValueFactory::GetStringValue(""));
+
+  // NULL has no text, every other value is sent in text format
+  EXPECT_EQ(pkt->buf.size(), pkt->len);
+  ExpectColumn(pkt.get(), -1, "");
+  ExpectColumn(pkt.get(), 1, "t");
+  ExpectColumn(pkt.get(), 1, "f");
+  ExpectColumn(pkt.get(), 3, "-42");
+  ExpectColumn(pkt.get(), 13, "1234567890123");
+  ExpectColumn(pkt.get(), 7, "peloton");
+  ExpectColumn(pkt.get(), 0, "");
+  EXPECT_EQ(pkt->len, pkt->ptr);
+}
+
+}  // End test namespace
+}  // End peloton namespace
@@ -552,6 +552,37 @@ public:
         return (st == ok);
     }
 
+    //! erase_fn runs \p fn on the value associated with \p key, like
+    //! update_fn, and removes the key from the table if \p fn returns true.
+    //! Both happen under the same locks. If \p key is not there, it returns
+    //! false, otherwise it returns true.
+    template <typename Eraser>
+    bool erase_fn(const key_type& key, Eraser fn) {
+        size_t hv = hashed_key(key);
+        auto b = snapshot_and_lock_two(hv);
+        const partial_t partial = partial_key(hv);
+        for (size_t bucket : {b.i[0], b.i[1]}) {
+            Bucket& bk = buckets_[bucket];
+            for (size_t i = 0; i < slot_per_bucket; ++i) {
+                if (!bk.occupied(i)) {
+                    continue;
+                }
+                if (!is_simple && bk.partial(i) != partial) {
+                    continue;
+                }
+                if (key_eq()(bk.key(i), key)) {
+                    if (fn(bk.val(i))) {
+                        bk.eraseKV(i);
+                        num_deletes_[get_counterid()].num.fetch_add(
+                            1, std::memory_order_relaxed);
+                    }
+                    return true;
+                }
+            }
+        }
+        return false;
+    }
+
     //! upsert is a combination of update_fn and insert. It first tries updating
     //! the value associated with \p key using \p fn. If \p key is not in the
     //! table, then it runs an insert with \p key and \p val. It will always